@@ -0,0 +1,42 @@
+@extract @options @profiles
+Feature: osrm-extract command line options: several profiles
+# expansions:
+# {osm_file} => path to current input file
+# {profile_dir} => path to the profiles directory
+
+    Background:
+        Given the profile "car"
+        And the node map
+            """
+            a b c d
+                  e
+            """
+        And the nodes
+            | node | barrier | highway         |
+            | b    | bollard |                 |
+            | c    |         | traffic_signals |
+        And the ways
+            | nodes | highway     |
+            | ab    | residential |
+            | bc    | residential |
+            | cd    | primary     |
+            | ce    | cycleway    |
+        And the data has been saved to disk
+
+    Scenario: osrm-extract - The datasets are named after the profiles
+        When I run "osrm-extract {osm_file} -p {profile_dir}/car.lua -p {profile_dir}/bicycle.lua"
+        Then it should exit successfully
+        And the dataset "car" should exist
+        And the dataset "bicycle" should exist
+
+    Scenario: osrm-extract - Profile names have to be unique
+        When I try to run "osrm-extract {osm_file} -p {profile_dir}/car.lua -p {profile_dir}/car.lua"
+        Then it should exit with an error
+        And stderr should contain "Profile names must be unique"
+
+    Scenario: osrm-extract - Each dataset matches the dataset of a single profile
+        When I run "osrm-extract {osm_file} -p {profile_dir}/car.lua"
+        And I run "osrm-extract {osm_file} -p {profile_dir}/car.lua -p {profile_dir}/bicycle.lua"
+        Then the dataset "car" should match the single-profile dataset
+        When I run "osrm-extract {osm_file} -p {profile_dir}/bicycle.lua"
+        Then the dataset "bicycle" should match the single-profile dataset
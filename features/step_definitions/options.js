@@ -105,6 +105,25 @@ module.exports = function () {
         assert.equal(actualData, expectedData);
     });
 
+    // the files of a dataset that do not depend on padding bytes, the .osrm file has some
+    const datasetExtensions = ['ebg', 'edges', 'enw', 'nodes', 'geometry', 'names', 'restrictions', 'tls', 'tld'];
+    const datasetBase = () => this.processedCacheFile.replace(/\.osrm$/, '');
+
+    this.Then(/^the dataset "(.+)" should exist$/, (name) => {
+        ['osrm', 'osrm.properties'].concat(datasetExtensions.map(ext => 'osrm.' + ext)).forEach(ext => {
+            const file = datasetBase() + '.' + name + '.' + ext;
+            assert.ok(fs.existsSync(file), file + ' does not exist');
+        });
+    });
+
+    this.Then(/^the dataset "(.+)" should match the single-profile dataset$/, (name) => {
+        datasetExtensions.forEach(ext => {
+            const single = fs.readFileSync(datasetBase() + '.osrm.' + ext);
+            const multi = fs.readFileSync(datasetBase() + '.' + name + '.osrm.' + ext);
+            assert.ok(single.equals(multi), 'the .osrm.' + ext + ' files of ' + name + ' differ');
+        });
+    });
+
     this.Given(/^the query options$/, (table, callback) => {
         table.raw().forEach(tuple => {
             this.queryParams[tuple[0]] = tuple[1];
@@ -126,12 +126,26 @@ module.exports = function() {
             });
         };
 
+        var addNativeProfiles = (directory, callback) => {
+            fs.readdir(path.normalize(directory), (err, files) => {
+                if (err) return callback(err);
+
+                var profiles = files.filter(f => !!f.match(/^libosrm-profile-.*\.(so|dylib)$/)).sort().map(f => path.normalize(directory + '/' + f));
+                Array.prototype.push.apply(dependencies, profiles);
+
+                callback();
+            });
+        };
+
         // Note: we need a serialized queue here to ensure that the order of the files
         // passed is stable. Otherwise the hash will not be stable
-        d3.queue(1)
+        let queue = d3.queue(1)
             .defer(addLuaFiles, this.PROFILES_PATH)
-            .defer(addLuaFiles, this.PROFILES_PATH + '/lib')
-            .awaitAll(hash.hashOfFiles.bind(hash, dependencies, callback));
+            .defer(addLuaFiles, this.PROFILES_PATH + '/lib');
+        if (this.NATIVE_PROFILES_PATH) {
+            queue.defer(addNativeProfiles, this.NATIVE_PROFILES_PATH);
+        }
+        queue.awaitAll(hash.hashOfFiles.bind(hash, dependencies, callback));
     };
 
     // test/cache/bicycle/bollards/{HASH}/
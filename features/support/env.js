@@ -20,6 +20,8 @@ module.exports = function () {
         this.LOGS_PATH = path.resolve(this.TEST_PATH, 'logs');
 
         this.PROFILES_PATH = path.resolve(this.ROOT_PATH, 'profiles');
+        // directory of the compiled profiles (libosrm-profile-car.so, ...) that replace the Lua profiles of the same name
+        this.NATIVE_PROFILES_PATH = process.env.OSRM_NATIVE_PROFILES_DIR && path.resolve(process.env.OSRM_NATIVE_PROFILES_DIR);
         this.FIXTURES_PATH = path.resolve(this.ROOT_PATH, 'unit_tests/fixtures');
         this.BIN_PATH = process.env.OSRM_BUILD_DIR && process.env.OSRM_BUILD_DIR || path.resolve(this.ROOT_PATH, 'build');
         var stxxl_config = path.resolve(this.ROOT_PATH, 'test/.stxxl');
@@ -94,6 +96,10 @@ module.exports = function () {
     };
 
     this.getProfilePath = (profile) => {
+        if (this.NATIVE_PROFILES_PATH) {
+            let nativeProfile = path.resolve(this.NATIVE_PROFILES_PATH, 'libosrm-profile-' + profile + (process.platform === 'darwin' ? '.dylib' : '.so'));
+            if (fs.existsSync(nativeProfile)) return nativeProfile;
+        }
         return path.resolve(this.PROFILES_PATH, profile + '.lua');
     };
 
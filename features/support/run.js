@@ -12,13 +12,14 @@ module.exports = function () {
             '{osm_file}': this.inputCacheFile,
             '{processed_file}': this.processedCacheFile,
             '{profile_file}': this.profileFile,
+            '{profile_dir}': this.PROFILES_PATH,
             '{rastersource_file}': this.rasterCacheFile,
             '{speeds_file}': this.speedsCacheFile,
             '{penalties_file}': this.penaltiesCacheFile
         };
 
         for (let k in table) {
-            opts = opts.replace(k, table[k]);
+            opts = opts.split(k).join(table[k]);
         }
 
         return opts;
@@ -0,0 +1,54 @@
+@routing @testbot @cch
+Feature: Routing on a Customizable Contraction Hierarchy
+
+    Background:
+        Given the profile "testbot"
+        And the contract extra arguments "--cch"
+
+    Scenario: Target behind the source on the same oneway
+        Given the node map
+            """
+              x       e
+              a 1 2 3 b
+            g d       c f
+            """
+
+        And the ways
+            | nodes | oneway |
+            | xa    |        |
+            | eb    |        |
+            | cf    |        |
+            | dg    |        |
+            | ab    | yes    |
+            | bc    | yes    |
+            | cd    | yes    |
+            | da    | yes    |
+
+        When I route I should get
+            | waypoints | route                               | distance  |
+            | 1,3       | ab,ab                               | 200m +-1  |
+            | 3,1       | ab,bc,cd,da,ab,ab                   | 800m +-1  |
+            | 1,3,2     | ab,ab,ab,bc,cd,da,ab,ab             | 1100m +-1 |
+
+    Scenario: Target behind the source on a ring of oneways
+        Given the node map
+            """
+            a 1 2 b
+            8     3
+            7     4
+            d 6 5 c
+            """
+
+        And the ways
+            | nodes | oneway |
+            | ab    | yes    |
+            | bc    | yes    |
+            | cd    | yes    |
+            | da    | yes    |
+
+        When I route I should get
+            | waypoints | route             | distance  |
+            | 2,1       | ab,bc,cd,da,ab,ab | 1100m +-1 |
+            | 4,3       | bc,cd,da,ab,bc,bc | 1100m +-1 |
+            | 6,5       | cd,da,ab,bc,cd,cd | 1100m +-1 |
+            | 8,7       | da,ab,bc,cd,da,da | 1100m +-1 |
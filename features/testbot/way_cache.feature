@@ -0,0 +1,69 @@
+@routing @testbot @way_cache
+Feature: Testbot - Way cache
+
+    Background:
+        Given the profile file "testbot" extended with
+        """
+        function get_way_cache_keys(vector)
+          for _, key in ipairs({"highway", "oneway", "route", "duration", "junction",
+                                "maxspeed", "maxspeed:forward", "maxspeed:backward", "ref"}) do
+            vector:Add(key)
+          end
+        end
+
+        local testbot_way_function = way_function
+        function way_function(way, result)
+          testbot_way_function(way, result)
+          local ref = way:get_value_by_key("ref")
+          if ref then
+            result.ref = ref
+          end
+        end
+        """
+
+    Scenario: Testbot - Ways with the same tags keep their speeds
+        Then routability should be
+            | highway   | maxspeed | maxspeed:forward | oneway | forw    | backw   |
+            | primary   |          |                  |        | 36 km/h | 36 km/h |
+            | primary   |          |                  |        | 36 km/h | 36 km/h |
+            | primary   | 18       |                  |        | 18 km/h | 18 km/h |
+            | primary   | 18       |                  |        | 18 km/h | 18 km/h |
+            | primary   | 9        | 18               |        | 18 km/h | 9 km/h  |
+            | primary   | 9        | 18               |        | 18 km/h | 9 km/h  |
+            | primary   |          |                  | yes    | 36 km/h |         |
+            | primary   |          |                  | yes    | 36 km/h |         |
+            | primary   |          |                  | -1     |         | 36 km/h |
+
+    Scenario: Testbot - Ways with the same tags keep their names
+        Given the node map
+            """
+            a b c d
+            """
+
+        And the ways
+            | nodes | highway | name   |
+            | ab    | primary | first  |
+            | bc    | primary | second |
+            | cd    | primary | third  |
+
+        When I route I should get
+            | from | to | route                    |
+            | a    | d  | first,second,third,third |
+            | d    | a  | third,second,first,first |
+
+    Scenario: Testbot - Ways with the same tags keep their refs
+        Given the node map
+            """
+            a b c d
+            """
+
+        And the ways
+            | nodes | highway | name   | ref |
+            | ab    | primary | first  | A 1 |
+            | bc    | primary | second | A 2 |
+            | cd    | primary | third  |     |
+
+        When I route I should get
+            | from | to | route                    | ref          |
+            | a    | d  | first,second,third,third | A 1,A 2,,    |
+            | d    | a  | third,second,first,first | ,A 2,A 1,A 1 |
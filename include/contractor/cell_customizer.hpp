@@ -0,0 +1,28 @@
+#ifndef OSRM_CONTRACTOR_CELL_CUSTOMIZER_HPP
+#define OSRM_CONTRACTOR_CELL_CUSTOMIZER_HPP
+
+#include "contractor/cell_storage.hpp"
+#include "contractor/multi_level_partition.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/// Computes the weights between the sources and destinations of all cells for the edge weights
+/// of the given edges. The cells of the lowest level are searched on the edges, every higher
+/// level reuses the weights of the level below, so a full customization only takes a few
+/// seconds and can be repeated after every traffic update.
+std::vector<EdgeWeight>
+customizeCells(const MultiLevelPartition<> &partition,
+               const CellStorage<> &cells,
+               const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list);
+}
+}
+
+#endif // OSRM_CONTRACTOR_CELL_CUSTOMIZER_HPP
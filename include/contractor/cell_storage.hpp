@@ -0,0 +1,160 @@
+#ifndef OSRM_CONTRACTOR_CELL_STORAGE_HPP
+#define OSRM_CONTRACTOR_CELL_STORAGE_HPP
+
+#include "contractor/multi_level_partition.hpp"
+#include "util/shared_memory_vector_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+struct CellData
+{
+    // first weight of the cell, the weights are stored row by row for every source
+    std::uint64_t weight_offset;
+    // first boundary node of the cell, the sources are followed by the destinations
+    std::uint32_t boundary_offset;
+    std::uint32_t number_of_sources;
+    std::uint32_t number_of_destinations;
+};
+
+/// View of the boundary of a cell: the sources are the nodes that can be entered from outside
+/// of the cell, the destinations the ones that can be left. The weight between a source and a
+/// destination is the shortest path that does not leave the cell.
+class Cell
+{
+  public:
+    Cell(const CellData &data, const NodeID *const boundary_nodes, const EdgeWeight *const weights)
+        : sources(boundary_nodes + data.boundary_offset),
+          destinations(sources + data.number_of_sources),
+          weights(weights == nullptr ? nullptr : weights + data.weight_offset),
+          number_of_sources(data.number_of_sources),
+          number_of_destinations(data.number_of_destinations)
+    {
+    }
+
+    std::uint32_t GetNumberOfSources() const { return number_of_sources; }
+    std::uint32_t GetNumberOfDestinations() const { return number_of_destinations; }
+
+    NodeID GetSource(const std::uint32_t index) const { return sources[index]; }
+    NodeID GetDestination(const std::uint32_t index) const { return destinations[index]; }
+
+    // index of the node among the sources, GetNumberOfSources() if it is none
+    std::uint32_t FindSource(const NodeID node) const
+    {
+        return Find(sources, number_of_sources, node);
+    }
+
+    // index of the node among the destinations, GetNumberOfDestinations() if it is none
+    std::uint32_t FindDestination(const NodeID node) const
+    {
+        return Find(destinations, number_of_destinations, node);
+    }
+
+    // INVALID_EDGE_WEIGHT if the destination can not be reached inside of the cell
+    EdgeWeight GetWeight(const std::uint32_t source, const std::uint32_t destination) const
+    {
+        BOOST_ASSERT(weights != nullptr);
+        BOOST_ASSERT(source < number_of_sources && destination < number_of_destinations);
+        return weights[source * number_of_destinations + destination];
+    }
+
+  private:
+    static std::uint32_t
+    Find(const NodeID *const nodes, const std::uint32_t size, const NodeID node)
+    {
+        const auto iter = std::lower_bound(nodes, nodes + size, node);
+        return (iter != nodes + size && *iter == node) ? static_cast<std::uint32_t>(iter - nodes)
+                                                       : size;
+    }
+
+    const NodeID *sources;
+    const NodeID *destinations;
+    const EdgeWeight *weights;
+    std::uint32_t number_of_sources;
+    std::uint32_t number_of_destinations;
+};
+
+/// Boundaries and weights of the cells of all levels of a MultiLevelPartition. The boundaries
+/// only depend on the structure of the graph, the weights on the metric. A storage without
+/// weights describes the topology of the cells only.
+template <bool UseSharedMemory = false> class CellStorage
+{
+    template <typename T> using Vector = typename util::ShM<T, UseSharedMemory>::vector;
+
+  public:
+    CellStorage() = default;
+
+    /// The cells are ordered by level and then by cell id
+    template <bool PartitionUsesSharedMemory>
+    CellStorage(const MultiLevelPartition<PartitionUsesSharedMemory> &partition,
+                Vector<CellData> cells_,
+                Vector<NodeID> boundary_nodes_,
+                Vector<EdgeWeight> weights_)
+        : cells(std::move(cells_)), boundary_nodes(std::move(boundary_nodes_)),
+          weights(std::move(weights_))
+    {
+        std::size_t offset = 0;
+        level_offsets.reserve(partition.GetNumberOfLevels());
+        for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+        {
+            level_offsets.push_back(offset);
+            offset += partition.GetNumberOfCells(level);
+        }
+        BOOST_ASSERT(offset == cells.size());
+    }
+
+    Cell GetCell(const LevelID level, const CellID cell) const
+    {
+        return Cell{GetCellData(level, cell),
+                    boundary_nodes.empty() ? nullptr : &boundary_nodes[0],
+                    weights.empty() ? nullptr : &weights[0]};
+    }
+
+    const CellData &GetCellData(const LevelID level, const CellID cell) const
+    {
+        BOOST_ASSERT(level > 0 && level <= level_offsets.size());
+        return cells[level_offsets[level - 1] + cell];
+    }
+
+    // number of weights that a customization of the cells computes
+    std::size_t GetNumberOfWeights() const
+    {
+        if (cells.empty())
+        {
+            return 0;
+        }
+        const auto &last = cells[cells.size() - 1];
+        return last.weight_offset +
+               std::size_t{last.number_of_sources} * last.number_of_destinations;
+    }
+
+    const Vector<CellData> &GetCells() const { return cells; }
+    const Vector<NodeID> &GetBoundaryNodes() const { return boundary_nodes; }
+    const Vector<EdgeWeight> &GetWeights() const { return weights; }
+    void SetWeights(Vector<EdgeWeight> weights_)
+    {
+        BOOST_ASSERT(weights_.size() == GetNumberOfWeights());
+        weights = std::move(weights_);
+    }
+
+  private:
+    Vector<CellData> cells;
+    Vector<NodeID> boundary_nodes;
+    Vector<EdgeWeight> weights;
+    std::vector<std::size_t> level_offsets;
+};
+}
+}
+
+#endif // OSRM_CONTRACTOR_CELL_STORAGE_HPP
@@ -58,6 +58,10 @@ class Contractor
 
     int Run();
 
+    /// Re-weights the Customizable Contraction Hierarchy written by Run() with --cch or the cells
+    /// of the multi-level partition written with --mld
+    int Customize();
+
   protected:
     void ContractGraph(const unsigned max_edge_id,
                        util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
@@ -65,9 +69,19 @@ class Contractor
                        std::vector<EdgeWeight> &&node_weights,
                        std::vector<bool> &is_core_node,
                        std::vector<float> &inout_node_levels) const;
+    void ContractGraphCustomizable(
+        const unsigned max_edge_id,
+        const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+        util::DeallocatingVector<QueryEdge> &contracted_edge_list) const;
+    void PartitionGraph(
+        const unsigned max_edge_id,
+        const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+        util::DeallocatingVector<QueryEdge> &base_edge_list) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
     void WriteNodeLevels(std::vector<float> &&node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
+    void ReadNodeWeights(std::vector<EdgeWeight> &node_weights) const;
+    void ReportPeakMemory() const;
     std::size_t
     WriteContractedGraph(unsigned number_of_edge_based_nodes,
                          const util::DeallocatingVector<QueryEdge> &contracted_edge_list);
@@ -78,6 +92,8 @@ class Contractor
   private:
     ContractorConfig config;
 
+    EdgeID
+    LoadEdgeExpandedGraph(util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list);
     EdgeID
     LoadEdgeExpandedGraph(const std::string &edge_based_graph_path,
                           util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
@@ -89,7 +105,7 @@ class Contractor
                           const std::string &geometry_filename,
                           const std::string &datasource_names_filename,
                           const std::string &datasource_indexes_filename,
-                          const std::string &rtree_leaf_filename,
+                          const std::string &edge_segment_index_filename,
                           const double log_edge_updates_factor);
 };
 }
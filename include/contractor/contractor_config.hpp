@@ -39,7 +39,11 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig()
+        : use_cch(false), use_mld(false), max_cell_size(128), eager_compaction(false),
+          checkpoint_interval(0), resume(false), requested_num_threads(0)
+    {
+    }
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
@@ -47,12 +51,17 @@ struct ContractorConfig
         level_output_path = osrm_input_path.string() + ".level";
         core_output_path = osrm_input_path.string() + ".core";
         graph_output_path = osrm_input_path.string() + ".hsgr";
+        checkpoint_path = osrm_input_path.string() + ".checkpoint";
+        cch_path = osrm_input_path.string() + ".cch";
+        partition_path = osrm_input_path.string() + ".partition";
+        cells_path = osrm_input_path.string() + ".cells";
+        cell_metrics_path = osrm_input_path.string() + ".cell_metrics";
         edge_based_graph_path = osrm_input_path.string() + ".ebg";
         edge_segment_lookup_path = osrm_input_path.string() + ".edge_segment_lookup";
         edge_penalty_path = osrm_input_path.string() + ".edge_penalties";
         node_based_graph_path = osrm_input_path.string() + ".nodes";
         geometry_path = osrm_input_path.string() + ".geometry";
-        rtree_leaf_path = osrm_input_path.string() + ".fileIndex";
+        edge_segment_index_path = osrm_input_path.string() + ".edge_segment_index";
         datasource_names_path = osrm_input_path.string() + ".datasource_names";
         datasource_indexes_path = osrm_input_path.string() + ".datasource_indexes";
     }
@@ -63,15 +72,40 @@ struct ContractorConfig
     std::string level_output_path;
     std::string core_output_path;
     std::string graph_output_path;
+    std::string checkpoint_path;
+    std::string cch_path;
+    std::string partition_path;
+    std::string cells_path;
+    std::string cell_metrics_path;
     std::string edge_based_graph_path;
 
     std::string edge_segment_lookup_path;
     std::string edge_penalty_path;
     std::string node_based_graph_path;
     std::string geometry_path;
-    std::string rtree_leaf_path;
+    std::string edge_segment_index_path;
     bool use_cached_priority;
 
+    // Build a Customizable Contraction Hierarchy: a metric-independent order and shortcut
+    // topology is written to .cch, which osrm-customize re-weights after traffic updates
+    bool use_cch;
+
+    // Partition the graph for Multi-Level Dijkstra instead of contracting it: the partition is
+    // written to .partition, the cell boundaries to .cells and their weights to .cell_metrics
+    bool use_mld;
+    // Upper bound of the number of nodes in the cells of the lowest level
+    unsigned max_cell_size;
+
+    // The contracted nodes are compacted out of the graph whenever half of its nodes are
+    // contracted instead of once. The peak resident memory is logged, it is not bounded: the
+    // whole edge-based graph is still loaded before the contraction.
+    bool eager_compaction;
+
+    // Minutes between two checkpoints of the contraction, 0 disables them. With resume the
+    // contraction continues from the checkpoint of an interrupted run.
+    unsigned checkpoint_interval;
+    bool resume;
+
     unsigned requested_num_threads;
     double log_edge_updates_factor;
 
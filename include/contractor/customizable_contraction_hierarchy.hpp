@@ -0,0 +1,81 @@
+#ifndef OSRM_CONTRACTOR_CUSTOMIZABLE_CONTRACTION_HIERARCHY_HPP
+#define OSRM_CONTRACTOR_CUSTOMIZABLE_CONTRACTION_HIERARCHY_HPP
+
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/// Customizable Contraction Hierarchy of the edge-based graph.
+///
+/// The metric-independent part is a nested dissection order of the nodes and the shortcut
+/// topology that results from contracting the nodes in this order without witness searches.
+/// It only depends on the structure of the graph and is computed once by osrm-contract.
+/// Customize() assigns weights to all shortcuts for a given metric, which only needs a pass
+/// over the lower triangles of every arc and is run by osrm-customize after traffic updates.
+///
+/// All arcs are stored at their lower ranked node and point upwards. The forward direction of
+/// an arc goes from its lower to its higher node.
+class CustomizableContractionHierarchy
+{
+  public:
+    /// Computes the order and the shortcut topology of the graph given by its edges
+    CustomizableContractionHierarchy(
+        const NodeID number_of_nodes,
+        const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list);
+
+    /// Reads a topology that was written by Write()
+    explicit CustomizableContractionHierarchy(const std::string &topology_path);
+
+    void Write(const std::string &topology_path) const;
+
+    /// Computes the shortcut weights for the edge weights of the given edges and appends the
+    /// edges of the resulting contraction hierarchy. The edges need to be the ones the topology
+    /// was built from, but may carry different weights. The node weights of the .enw file decide
+    /// which self-loops are added, as in the contraction without a topology.
+    void Customize(const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                   const std::vector<EdgeWeight> &node_weights,
+                   util::DeallocatingVector<QueryEdge> &contracted_edge_list) const;
+
+    NodeID GetNumberOfNodes() const { return static_cast<NodeID>(node_rank.size()); }
+    std::size_t GetNumberOfArcs() const { return arc_head.size(); }
+    NodeID GetRank(const NodeID node) const { return node_rank[node]; }
+
+  private:
+    // Builds the downward arcs and the levels of the elimination tree from the upward arcs
+    void BuildCustomizationOrder();
+
+    EdgeID FindArc(const NodeID lower_rank, const NodeID higher_rank) const;
+
+    // contraction order: nodes are contracted by increasing rank
+    std::vector<NodeID> node_rank;
+    std::vector<NodeID> rank_node;
+
+    // upward arcs of the rank r are [first_arc[r], first_arc[r+1]), sorted by the head rank
+    std::vector<EdgeID> first_arc;
+    std::vector<NodeID> arc_head;
+
+    // downward arcs of the rank r are [first_down_arc[r], first_down_arc[r+1]) and refer to
+    // the upward arc of the lower rank
+    std::vector<EdgeID> first_down_arc;
+    std::vector<NodeID> down_arc_tail;
+    std::vector<EdgeID> down_arc;
+
+    // ranks grouped by their level: all lower neighbours of a rank are on a lower level, so the
+    // ranks of a level can be customized in parallel
+    std::vector<std::size_t> first_level_rank;
+    std::vector<NodeID> level_ranks;
+};
+}
+}
+
+#endif // OSRM_CONTRACTOR_CUSTOMIZABLE_CONTRACTION_HIERARCHY_HPP
@@ -5,7 +5,9 @@
 #include "util/binary_heap.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/dynamic_graph.hpp"
+#include "util/exception.hpp"
 #include "util/integer_range.hpp"
+#include "util/io.hpp"
 #include "util/percent.hpp"
 #include "util/simple_logger.hpp"
 #include "util/timing_util.hpp"
@@ -19,11 +21,19 @@
 
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 #include <tbb/parallel_sort.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -80,16 +90,40 @@ class GraphContractor
                                             ContractorHeapData,
                                             util::XORFastHashStorage<NodeID, NodeID>>;
     using ContractorEdge = ContractorGraph::InputEdge;
+    using NodeDepth = int;
 
     struct ContractorThreadData
     {
         ContractorHeap heap;
         std::vector<ContractorEdge> inserted_edges;
         std::vector<NodeID> neighbours;
+        // neighbours of the contracted nodes and their new depth, their priorities are stale
+        std::vector<std::pair<NodeID, NodeDepth>> stale_neighbours;
         explicit ContractorThreadData(NodeID nodes) : heap(nodes) {}
     };
 
-    using NodeDepth = int;
+    // A witness search stops after settling max_settled_nodes nodes and does not relax the edges
+    // of nodes that are max_hops edges away from the source. Stopping early only costs additional
+    // shortcuts, the limits grow with the average degree of the remaining graph since the
+    // witnesses of dense levels are longer.
+    struct WitnessSearchLimits
+    {
+        short max_hops;
+        int max_settled_nodes;
+    };
+
+    // Accumulated wall clock time of the phases of Run in seconds
+    struct PhaseTimings
+    {
+        double priority_initialization = 0;
+        double renumbering = 0;
+        double checkpoints = 0;
+        double independent_sets = 0;
+        double contraction = 0;
+        double edge_deletion = 0;
+        double edge_insertion = 0;
+        double priority_updates = 0;
+    };
 
     struct ContractionStats
     {
@@ -111,6 +145,25 @@ class GraphContractor
         bool is_independent : 1;
     };
 
+    // The state of Run at a level boundary, the vectors and the graph follow in the checkpoint.
+    // A checkpoint is only resumed with the same input and the same options of Run. The padding
+    // is explicit, so that value-initialized headers are written without indeterminate bytes.
+    struct CheckpointHeader
+    {
+        std::uint64_t input_fingerprint;
+        double core_factor;
+        std::uint32_t number_of_nodes;
+        std::uint32_t number_of_graph_nodes;
+        std::uint32_t number_of_contracted_nodes;
+        std::uint32_t current_level;
+        std::uint8_t flushed_contractor;
+        std::uint8_t use_cached_node_priorities;
+        std::uint8_t eager_compaction;
+        std::uint8_t padding[5];
+    };
+    static_assert(sizeof(CheckpointHeader) == 40,
+                  "CheckpointHeader must not have implicit padding");
+
     struct ThreadDataContainer
     {
         explicit ThreadDataContainer(int number_of_nodes) : number_of_nodes(number_of_nodes) {}
@@ -256,7 +309,27 @@ class GraphContractor
         util::SimpleLogger().Write() << "contractor finished initalization";
     }
 
-    void Run(double core_factor = 1.0)
+    // Run writes its state to path at the first level boundary after every interval, with resume
+    // it continues from the state in path if there is one. The input fingerprint identifies the
+    // files the graph was built from, a checkpoint of other files is rejected.
+    void SetCheckpoint(std::string path,
+                       std::chrono::steady_clock::duration interval,
+                       bool resume,
+                       std::uint64_t input_fingerprint = 0)
+    {
+        checkpoint_path = std::move(path);
+        checkpoint_interval = interval;
+        resume_from_checkpoint = resume;
+        checkpoint_input_fingerprint = input_fingerprint;
+    }
+
+    // Called with the level of every checkpoint after it was written
+    void SetCheckpointHandler(std::function<void(unsigned)> handler)
+    {
+        checkpoint_handler = std::move(handler);
+    }
+
+    void Run(double core_factor = 1.0, bool eager_compaction = false)
     {
         // for the preperation we can use a big grain size, which is much faster (probably cache)
         const constexpr size_t InitGrainSize = 100000;
@@ -271,6 +344,7 @@ class GraphContractor
 
         const NodeID number_of_nodes = contractor_graph->GetNumberOfNodes();
         util::Percent p(number_of_nodes);
+        timings = PhaseTimings{};
 
         ThreadDataContainer thread_data_list(number_of_nodes);
 
@@ -279,18 +353,49 @@ class GraphContractor
         std::vector<float> node_priorities;
         is_core_node.resize(number_of_nodes, false);
 
-        std::vector<RemainingNodeData> remaining_nodes(number_of_nodes);
-        // initialize priorities in parallel
-        tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, InitGrainSize),
-                          [this, &remaining_nodes](const tbb::blocked_range<int> &range) {
-                              for (int x = range.begin(), end = range.end(); x != end; ++x)
-                              {
-                                  remaining_nodes[x].id = x;
-                              }
-                          });
-
-        bool use_cached_node_priorities = !node_levels.empty();
-        if (use_cached_node_priorities)
+        unsigned current_level = 0;
+        bool flushed_contractor = false;
+        const bool use_cached_node_priorities = !node_levels.empty();
+
+        std::vector<RemainingNodeData> remaining_nodes;
+        CheckpointHeader header{};
+        header.input_fingerprint = checkpoint_input_fingerprint;
+        header.core_factor = core_factor;
+        header.number_of_nodes = number_of_nodes;
+        header.use_cached_node_priorities = use_cached_node_priorities;
+        header.eager_compaction = eager_compaction;
+        const bool resumed = resume_from_checkpoint &&
+                             ReadCheckpoint(header, remaining_nodes, node_priorities, node_depth);
+        if (resume_from_checkpoint && !resumed)
+        {
+            util::SimpleLogger().Write(logWARNING) << "No checkpoint found at " << checkpoint_path
+                                                   << ", contracting from scratch";
+        }
+
+        if (!resumed)
+        {
+            remaining_nodes.resize(number_of_nodes);
+            // initialize priorities in parallel
+            tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, InitGrainSize),
+                              [this, &remaining_nodes](const tbb::blocked_range<int> &range) {
+                                  for (int x = range.begin(), end = range.end(); x != end; ++x)
+                                  {
+                                      remaining_nodes[x].id = x;
+                                  }
+                              });
+        }
+
+        if (resumed)
+        {
+            number_of_contracted_nodes = header.number_of_contracted_nodes;
+            current_level = header.current_level;
+            flushed_contractor = header.flushed_contractor;
+            thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
+            util::SimpleLogger().Write() << "Resuming the contraction at level " << current_level
+                                         << " with " << number_of_contracted_nodes << " of "
+                                         << number_of_nodes << " nodes contracted";
+        }
+        else if (use_cached_node_priorities)
         {
             std::cout << "using cached node priorities ..." << std::flush;
             node_priorities.swap(node_levels);
@@ -303,6 +408,8 @@ class GraphContractor
             node_levels.resize(number_of_nodes);
 
             std::cout << "initializing elimination PQ ..." << std::flush;
+            TIMER_START(priority_initialization);
+            UpdateWitnessSearchLimits(remaining_nodes);
             tbb::parallel_for(tbb::blocked_range<int>(0, number_of_nodes, PQGrainSize),
                               [this, &node_priorities, &node_depth, &thread_data_list](
                                   const tbb::blocked_range<int> &range) {
@@ -313,119 +420,59 @@ class GraphContractor
                                           this->EvaluateNodePriority(data, node_depth[x], x);
                                   }
                               });
+            TIMER_STOP(priority_initialization);
+            timings.priority_initialization += TIMER_SEC(priority_initialization);
             std::cout << "ok" << std::endl;
         }
-        BOOST_ASSERT(node_priorities.size() == number_of_nodes);
+        BOOST_ASSERT(node_priorities.size() == contractor_graph->GetNumberOfNodes());
 
         std::cout << "preprocessing " << number_of_nodes << " nodes ..." << std::flush;
 
-        unsigned current_level = 0;
-        bool flushed_contractor = false;
+        auto last_checkpoint = std::chrono::steady_clock::now();
         while (number_of_nodes > 2 &&
                number_of_contracted_nodes < static_cast<NodeID>(number_of_nodes * core_factor))
         {
-            if (!flushed_contractor && (number_of_contracted_nodes >
-                                        static_cast<NodeID>(number_of_nodes * 0.65 * core_factor)))
+            // The contracted nodes are flushed out of the graph once most of them are contracted.
+            // With eager_compaction this happens whenever half of the nodes of the graph are
+            // contracted, which keeps the graph, its deleted edges and the heaps small.
+            const bool flush_contracted_nodes =
+                eager_compaction
+                    ? remaining_nodes.size() <= contractor_graph->GetNumberOfNodes() / 2
+                    : !flushed_contractor &&
+                          (number_of_contracted_nodes >
+                           static_cast<NodeID>(number_of_nodes * 0.65 * core_factor));
+            if (flush_contracted_nodes)
             {
-                util::DeallocatingVector<ContractorEdge>
-                    new_edge_set; // this one is not explicitely
-                                  // cleared since it goes out of
-                                  // scope anywa
                 std::cout << " [flush " << number_of_contracted_nodes << " nodes] " << std::flush;
+                TIMER_START(renumbering);
+                RenumberGraph(remaining_nodes, node_priorities, node_depth, thread_data_list);
+                TIMER_STOP(renumbering);
+                timings.renumbering += TIMER_SEC(renumbering);
+                flushed_contractor = true;
+            }
 
-                // Delete old heap data to free memory that we need for the coming operations
-                thread_data_list.data.clear();
-
-                // Create new priority array
-                std::vector<float> new_node_priority(remaining_nodes.size());
-                std::vector<EdgeWeight> new_node_weights(remaining_nodes.size());
-                // this map gives the old IDs from the new ones, necessary to get a consistent graph
-                // at the end of contraction
-                orig_node_id_from_new_node_id_map.resize(remaining_nodes.size());
-                // this map gives the new IDs from the old ones, necessary to remap targets from the
-                // remaining graph
-                std::vector<NodeID> new_node_id_from_orig_id_map(number_of_nodes, SPECIAL_NODEID);
-
-                for (const auto new_node_id :
-                     util::irange<std::size_t>(0UL, remaining_nodes.size()))
-                {
-                    auto &node = remaining_nodes[new_node_id];
-                    BOOST_ASSERT(node_priorities.size() > node.id);
-                    new_node_priority[new_node_id] = node_priorities[node.id];
-                    BOOST_ASSERT(node_weights.size() > node.id);
-                    new_node_weights[new_node_id] = node_weights[node.id];
-                }
-
-                // build forward and backward renumbering map and remap ids in remaining_nodes
-                for (const auto new_node_id :
-                     util::irange<std::size_t>(0UL, remaining_nodes.size()))
-                {
-                    auto &node = remaining_nodes[new_node_id];
-                    // create renumbering maps in both directions
-                    orig_node_id_from_new_node_id_map[new_node_id] = node.id;
-                    new_node_id_from_orig_id_map[node.id] = new_node_id;
-                    node.id = new_node_id;
-                }
-                // walk over all nodes
-                for (const auto source :
-                     util::irange<NodeID>(0UL, contractor_graph->GetNumberOfNodes()))
+            if (!checkpoint_path.empty() && checkpoint_interval.count() > 0 &&
+                std::chrono::steady_clock::now() - last_checkpoint >= checkpoint_interval)
+            {
+                std::cout << " [checkpoint] " << std::flush;
+                TIMER_START(checkpoint);
+                header.number_of_graph_nodes = contractor_graph->GetNumberOfNodes();
+                header.number_of_contracted_nodes = number_of_contracted_nodes;
+                header.current_level = current_level;
+                header.flushed_contractor = flushed_contractor;
+                WriteCheckpoint(header, remaining_nodes, node_priorities, node_depth);
+                if (checkpoint_handler)
                 {
-                    for (auto current_edge : contractor_graph->GetAdjacentEdgeRange(source))
-                    {
-                        ContractorGraph::EdgeData &data =
-                            contractor_graph->GetEdgeData(current_edge);
-                        const NodeID target = contractor_graph->GetTarget(current_edge);
-                        if (SPECIAL_NODEID == new_node_id_from_orig_id_map[source])
-                        {
-                            external_edge_list.push_back({source, target, data});
-                        }
-                        else
-                        {
-                            // node is not yet contracted.
-                            // add (renumbered) outgoing edges to new util::DynamicGraph.
-                            ContractorEdge new_edge = {new_node_id_from_orig_id_map[source],
-                                                       new_node_id_from_orig_id_map[target],
-                                                       data};
-
-                            new_edge.data.is_original_via_node_ID = true;
-                            BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[source],
-                                             "new source id not resolveable");
-                            BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[target],
-                                             "new target id not resolveable");
-                            new_edge_set.push_back(new_edge);
-                        }
-                    }
+                    checkpoint_handler(current_level);
                 }
-
-                // Delete map from old NodeIDs to new ones.
-                new_node_id_from_orig_id_map.clear();
-                new_node_id_from_orig_id_map.shrink_to_fit();
-
-                // Replace old priorities array by new one
-                node_priorities.swap(new_node_priority);
-                // Delete old node_priorities vector
-                // Due to the scope, these should get cleared automatically? @daniel-j-h do you
-                // agree?
-                new_node_priority.clear();
-                new_node_priority.shrink_to_fit();
-
-                node_weights.swap(new_node_weights);
-                // old Graph is removed
-                contractor_graph.reset();
-
-                // create new graph
-                tbb::parallel_sort(new_edge_set.begin(), new_edge_set.end());
-                contractor_graph =
-                    std::make_shared<ContractorGraph>(remaining_nodes.size(), new_edge_set);
-
-                new_edge_set.clear();
-                flushed_contractor = true;
-
-                // INFO: MAKE SURE THIS IS THE LAST OPERATION OF THE FLUSH!
-                // reinitialize heaps and ThreadData objects with appropriate size
-                thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
+                TIMER_STOP(checkpoint);
+                timings.checkpoints += TIMER_SEC(checkpoint);
+                last_checkpoint = std::chrono::steady_clock::now();
             }
 
+            UpdateWitnessSearchLimits(remaining_nodes);
+
+            TIMER_START(independent_sets);
             tbb::parallel_for(
                 tbb::blocked_range<std::size_t>(0, remaining_nodes.size(), IndependentGrainSize),
                 [this, &node_priorities, &remaining_nodes, &thread_data_list](
@@ -448,6 +495,8 @@ class GraphContractor
             auto begin_independent_nodes_idx =
                 std::distance(remaining_nodes.begin(), begin_independent_nodes);
             auto end_independent_nodes_idx = remaining_nodes.size();
+            TIMER_STOP(independent_sets);
+            timings.independent_sets += TIMER_SEC(independent_sets);
 
             if (!use_cached_node_priorities)
             {
@@ -479,6 +528,7 @@ class GraphContractor
             }
 
             // contract independent nodes
+            TIMER_START(contraction);
             tbb::parallel_for(
                 tbb::blocked_range<std::size_t>(
                     begin_independent_nodes_idx, end_independent_nodes_idx, ContractGrainSize),
@@ -492,7 +542,10 @@ class GraphContractor
                         this->ContractNode<false>(data, x);
                     }
                 });
+            TIMER_STOP(contraction);
+            timings.contraction += TIMER_SEC(contraction);
 
+            TIMER_START(edge_deletion);
             tbb::parallel_for(
                 tbb::blocked_range<int>(
                     begin_independent_nodes_idx, end_independent_nodes_idx, DeleteGrainSize),
@@ -505,8 +558,11 @@ class GraphContractor
                         this->DeleteIncomingEdges(data, x);
                     }
                 });
+            TIMER_STOP(edge_deletion);
+            timings.edge_deletion += TIMER_SEC(edge_deletion);
 
             // make sure we really sort each block
+            TIMER_START(edge_insertion);
             tbb::parallel_for(
                 thread_data_list.data.range(),
                 [&](const ThreadDataContainer::EnumerableThreadData::range_type &range) {
@@ -539,23 +595,29 @@ class GraphContractor
                 }
                 data->inserted_edges.clear();
             }
+            TIMER_STOP(edge_insertion);
+            timings.edge_insertion += TIMER_SEC(edge_insertion);
 
             if (!use_cached_node_priorities)
             {
+                TIMER_START(priority_updates);
                 tbb::parallel_for(
                     tbb::blocked_range<int>(begin_independent_nodes_idx,
                                             end_independent_nodes_idx,
                                             NeighboursGrainSize),
-                    [this, &node_priorities, &remaining_nodes, &node_depth, &thread_data_list](
+                    [this, &remaining_nodes, &node_depth, &thread_data_list](
                         const tbb::blocked_range<int> &range) {
                         ContractorThreadData *data = thread_data_list.GetThreadData();
                         for (int position = range.begin(), end = range.end(); position != end;
                              ++position)
                         {
                             NodeID x = remaining_nodes[position].id;
-                            this->UpdateNodeNeighbours(node_priorities, node_depth, data, x);
+                            this->CollectStaleNeighbours(node_depth, data, x);
                         }
                     });
+                UpdateStalePriorities(node_priorities, node_depth, thread_data_list);
+                TIMER_STOP(priority_updates);
+                timings.priority_updates += TIMER_SEC(priority_updates);
             }
 
             // remove contracted nodes from the pool
@@ -602,6 +664,13 @@ class GraphContractor
         util::SimpleLogger().Write() << "[core] " << remaining_nodes.size() << " nodes "
                                      << contractor_graph->GetNumberOfEdges() << " edges."
                                      << std::endl;
+        util::SimpleLogger().Write()
+            << "Contraction phases: priority initialization " << timings.priority_initialization
+            << "s, independent sets " << timings.independent_sets << "s, contraction "
+            << timings.contraction << "s, edge deletion " << timings.edge_deletion
+            << "s, edge insertion " << timings.edge_insertion << "s, priority updates "
+            << timings.priority_updates << "s, renumbering " << timings.renumbering
+            << "s, checkpoints " << timings.checkpoints << "s";
 
         thread_data_list.data.clear();
     }
@@ -673,6 +742,219 @@ class GraphContractor
     }
 
   private:
+    // Moves the edges of all contracted nodes to the external edge list and rebuilds the graph
+    // from the remaining nodes, which are renumbered to 0..remaining_nodes.size()-1. The rebuilt
+    // graph has no deleted edges or slack left.
+    void RenumberGraph(std::vector<RemainingNodeData> &remaining_nodes,
+                       std::vector<float> &node_priorities,
+                       std::vector<NodeDepth> &node_depth,
+                       ThreadDataContainer &thread_data_list)
+    {
+        util::DeallocatingVector<ContractorEdge> new_edge_set;
+
+        // Delete old heap data to free memory that we need for the coming operations
+        thread_data_list.data.clear();
+
+        // ids of a previous renumbering are translated back to the original ids
+        const bool renumbered = !orig_node_id_from_new_node_id_map.empty();
+        const auto orig_node_id = [&](const NodeID node) {
+            return renumbered ? orig_node_id_from_new_node_id_map[node] : node;
+        };
+
+        // Create new priority array
+        std::vector<float> new_node_priority(remaining_nodes.size());
+        std::vector<EdgeWeight> new_node_weights(remaining_nodes.size());
+        std::vector<NodeDepth> new_node_depth(node_depth.empty() ? 0 : remaining_nodes.size());
+        // this map gives the original IDs from the new ones, necessary to get a consistent graph
+        // at the end of contraction
+        std::vector<NodeID> new_orig_node_id_from_new_node_id_map(remaining_nodes.size());
+        // this map gives the new IDs from the current ones, necessary to remap targets from the
+        // remaining graph
+        std::vector<NodeID> new_node_id_from_current_id_map(contractor_graph->GetNumberOfNodes(),
+                                                            SPECIAL_NODEID);
+
+        // build forward and backward renumbering map and remap ids in remaining_nodes
+        for (const auto new_node_id : util::irange<std::size_t>(0UL, remaining_nodes.size()))
+        {
+            auto &node = remaining_nodes[new_node_id];
+            BOOST_ASSERT(node_priorities.size() > node.id);
+            new_node_priority[new_node_id] = node_priorities[node.id];
+            BOOST_ASSERT(node_weights.size() > node.id);
+            new_node_weights[new_node_id] = node_weights[node.id];
+            if (!node_depth.empty())
+            {
+                new_node_depth[new_node_id] = node_depth[node.id];
+            }
+            // create renumbering maps in both directions
+            new_orig_node_id_from_new_node_id_map[new_node_id] = orig_node_id(node.id);
+            new_node_id_from_current_id_map[node.id] = new_node_id;
+            node.id = new_node_id;
+        }
+
+        // walk over all nodes
+        for (const auto source : util::irange<NodeID>(0UL, contractor_graph->GetNumberOfNodes()))
+        {
+            for (auto current_edge : contractor_graph->GetAdjacentEdgeRange(source))
+            {
+                ContractorGraph::EdgeData data = contractor_graph->GetEdgeData(current_edge);
+                const NodeID target = contractor_graph->GetTarget(current_edge);
+                // shortcuts inserted since the last renumbering name their middle node by its
+                // current id
+                if (!data.is_original_via_node_ID && renumbered)
+                {
+                    data.id = orig_node_id_from_new_node_id_map[data.id];
+                }
+
+                if (SPECIAL_NODEID == new_node_id_from_current_id_map[source])
+                {
+                    external_edge_list.push_back(
+                        {orig_node_id(source), orig_node_id(target), data});
+                }
+                else
+                {
+                    // node is not yet contracted.
+                    // add (renumbered) outgoing edges to new util::DynamicGraph.
+                    ContractorEdge new_edge = {new_node_id_from_current_id_map[source],
+                                               new_node_id_from_current_id_map[target],
+                                               data};
+
+                    new_edge.data.is_original_via_node_ID = true;
+                    BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_current_id_map[source],
+                                     "new source id not resolveable");
+                    BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_current_id_map[target],
+                                     "new target id not resolveable");
+                    new_edge_set.push_back(new_edge);
+                }
+            }
+        }
+
+        // Delete map from current NodeIDs to new ones.
+        new_node_id_from_current_id_map.clear();
+        new_node_id_from_current_id_map.shrink_to_fit();
+
+        orig_node_id_from_new_node_id_map.swap(new_orig_node_id_from_new_node_id_map);
+        node_priorities.swap(new_node_priority);
+        node_weights.swap(new_node_weights);
+        node_depth.swap(new_node_depth);
+
+        // old Graph is removed
+        contractor_graph.reset();
+
+        // create new graph
+        tbb::parallel_sort(new_edge_set.begin(), new_edge_set.end());
+        contractor_graph = std::make_shared<ContractorGraph>(remaining_nodes.size(), new_edge_set);
+
+        new_edge_set.clear();
+
+        // INFO: MAKE SURE THIS IS THE LAST OPERATION OF THE FLUSH!
+        // reinitialize heaps and ThreadData objects with appropriate size
+        thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
+    }
+
+    // The checkpoint is written to a temporary file first, an interruption while writing keeps the
+    // previous checkpoint intact
+    void WriteCheckpoint(const CheckpointHeader &header,
+                         const std::vector<RemainingNodeData> &remaining_nodes,
+                         const std::vector<float> &node_priorities,
+                         const std::vector<NodeDepth> &node_depth) const
+    {
+        std::vector<ContractorEdge> edges;
+        edges.reserve(contractor_graph->GetNumberOfEdges());
+        for (const auto source : util::irange(0u, contractor_graph->GetNumberOfNodes()))
+        {
+            for (auto edge : contractor_graph->GetAdjacentEdgeRange(source))
+            {
+                edges.emplace_back(
+                    source, contractor_graph->GetTarget(edge), contractor_graph->GetEdgeData(edge));
+            }
+        }
+
+        const auto temporary_path = checkpoint_path + ".tmp";
+        std::ofstream stream(temporary_path, std::ios::binary);
+        if (!util::writeFingerprint(stream))
+        {
+            throw util::exception("Could not open " + temporary_path + " for writing");
+        }
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (!util::serializeVector(stream, remaining_nodes) ||
+            !util::serializeVector(stream, node_priorities) ||
+            !util::serializeVector(stream, node_depth) ||
+            !util::serializeVector(stream, node_weights) ||
+            !util::serializeVector(stream, node_levels) ||
+            !util::serializeVector(stream, orig_node_id_from_new_node_id_map) ||
+            !util::serializeVector(stream, edges) ||
+            !util::serializeVector(stream, external_edge_list))
+        {
+            throw util::exception("Could not write " + temporary_path);
+        }
+        stream.close();
+
+        if (std::rename(temporary_path.c_str(), checkpoint_path.c_str()) != 0)
+        {
+            throw util::exception("Could not replace " + checkpoint_path);
+        }
+    }
+
+    // Replaces the graph with the one of the checkpoint, returns false if there is none
+    bool ReadCheckpoint(CheckpointHeader &header,
+                        std::vector<RemainingNodeData> &remaining_nodes,
+                        std::vector<float> &node_priorities,
+                        std::vector<NodeDepth> &node_depth)
+    {
+        std::ifstream stream(checkpoint_path, std::ios::binary);
+        if (!stream)
+        {
+            return false;
+        }
+        if (!util::readAndCheckFingerprint(stream))
+        {
+            throw util::exception(checkpoint_path + " was written by a different build");
+        }
+
+        CheckpointHeader checkpoint_header{};
+        stream.read(reinterpret_cast<char *>(&checkpoint_header), sizeof(checkpoint_header));
+        if (!stream)
+        {
+            throw util::exception("Could not read " + checkpoint_path);
+        }
+        if (checkpoint_header.input_fingerprint != header.input_fingerprint ||
+            checkpoint_header.number_of_nodes != header.number_of_nodes)
+        {
+            throw util::exception(checkpoint_path +
+                                  " was written for a different graph or traffic files");
+        }
+        if (checkpoint_header.use_cached_node_priorities != header.use_cached_node_priorities ||
+            checkpoint_header.core_factor != header.core_factor ||
+            checkpoint_header.eager_compaction != header.eager_compaction)
+        {
+            throw util::exception(checkpoint_path +
+                                  " was written with different --level-cache, --core or "
+                                  "--eager-compaction options");
+        }
+        header = checkpoint_header;
+
+        // free the input graph before the one of the checkpoint is read
+        contractor_graph.reset();
+        external_edge_list.clear();
+
+        std::vector<ContractorEdge> edges;
+        if (!util::deserializeVector(stream, remaining_nodes) ||
+            !util::deserializeVector(stream, node_priorities) ||
+            !util::deserializeVector(stream, node_depth) ||
+            !util::deserializeVector(stream, node_weights) ||
+            !util::deserializeVector(stream, node_levels) ||
+            !util::deserializeVector(stream, orig_node_id_from_new_node_id_map) ||
+            !util::deserializeVector(stream, edges) ||
+            !util::deserializeVector(stream, external_edge_list))
+        {
+            throw util::exception("Could not read " + checkpoint_path);
+        }
+
+        tbb::parallel_sort(edges.begin(), edges.end());
+        contractor_graph = std::make_shared<ContractorGraph>(header.number_of_graph_nodes, edges);
+        return true;
+    }
+
     inline void RelaxNode(const NodeID node,
                           const NodeID forbidden_node,
                           const int weight,
@@ -709,7 +991,7 @@ class GraphContractor
 
     inline void Dijkstra(const int max_weight,
                          const unsigned number_of_targets,
-                         const int max_nodes,
+                         const WitnessSearchLimits &limits,
                          ContractorThreadData &data,
                          const NodeID middle_node)
     {
@@ -722,7 +1004,7 @@ class GraphContractor
         {
             const NodeID node = heap.DeleteMin();
             const auto weight = heap.GetKey(node);
-            if (++nodes > max_nodes)
+            if (++nodes > limits.max_settled_nodes)
             {
                 return;
             }
@@ -741,8 +1023,42 @@ class GraphContractor
                 }
             }
 
-            RelaxNode(node, middle_node, weight, heap);
+            if (heap.GetData(node).hop < limits.max_hops)
+            {
+                RelaxNode(node, middle_node, weight, heap);
+            }
+        }
+    }
+
+    // Sets the witness search limits of the next level from the average degree of the remaining
+    // nodes
+    void UpdateWitnessSearchLimits(const std::vector<RemainingNodeData> &remaining_nodes)
+    {
+        if (remaining_nodes.empty())
+        {
+            return;
         }
+
+        const auto degree_sum = tbb::parallel_reduce(
+            tbb::blocked_range<std::size_t>(0, remaining_nodes.size()),
+            std::uint64_t{0},
+            [this, &remaining_nodes](const tbb::blocked_range<std::size_t> &range,
+                                     std::uint64_t sum) {
+                for (auto i = range.begin(), end = range.end(); i != end; ++i)
+                {
+                    sum += contractor_graph->GetOutDegree(remaining_nodes[i].id);
+                }
+                return sum;
+            },
+            [](const std::uint64_t lhs, const std::uint64_t rhs) { return lhs + rhs; });
+        const double average_degree = static_cast<double>(degree_sum) / remaining_nodes.size();
+
+        // The simulation only estimates the number of shortcuts, hop limits as in Geisberger et
+        // al. "Contraction Hierarchies: Faster and Simpler Hierarchical Routing in Road Networks"
+        const short simulation_hops = average_degree < 3.3 ? 1 : average_degree < 10 ? 2 : 3;
+        simulation_limits = WitnessSearchLimits{simulation_hops, 1000};
+        contraction_limits =
+            WitnessSearchLimits{static_cast<short>(average_degree < 10 ? 5 : 10), 2000};
     }
 
     inline float EvaluateNodePriority(ContractorThreadData *const data,
@@ -873,16 +1189,11 @@ class GraphContractor
                 }
             }
 
-            if (RUNSIMULATION)
-            {
-                const int constexpr SIMULATION_SEARCH_SPACE_SIZE = 1000;
-                Dijkstra(max_weight, number_of_targets, SIMULATION_SEARCH_SPACE_SIZE, *data, node);
-            }
-            else
-            {
-                const int constexpr FULL_SEARCH_SPACE_SIZE = 2000;
-                Dijkstra(max_weight, number_of_targets, FULL_SEARCH_SPACE_SIZE, *data, node);
-            }
+            Dijkstra(max_weight,
+                     number_of_targets,
+                     RUNSIMULATION ? simulation_limits : contraction_limits,
+                     *data,
+                     node);
             for (auto out_edge : contractor_graph->GetAdjacentEdgeRange(node))
             {
                 const ContractorEdgeData &out_data = contractor_graph->GetEdgeData(out_edge);
@@ -992,35 +1303,61 @@ class GraphContractor
         }
     }
 
-    inline bool UpdateNodeNeighbours(std::vector<float> &priorities,
-                                     std::vector<NodeDepth> &node_depth,
-                                     ContractorThreadData *const data,
-                                     const NodeID node)
+    // Remembers the neighbours of a contracted node, their priorities are updated once per level
+    // by UpdateStalePriorities no matter how many of their neighbours were contracted
+    inline void CollectStaleNeighbours(const std::vector<NodeDepth> &node_depth,
+                                       ContractorThreadData *const data,
+                                       const NodeID node)
     {
-        std::vector<NodeID> &neighbours = data->neighbours;
-        neighbours.clear();
-
-        // find all neighbours
         for (auto e : contractor_graph->GetAdjacentEdgeRange(node))
         {
             const NodeID u = contractor_graph->GetTarget(e);
-            if (u == node)
+            if (u != node)
             {
-                continue;
+                data->stale_neighbours.emplace_back(u, node_depth[node] + 1);
             }
-            neighbours.push_back(u);
-            node_depth[u] = std::max(node_depth[node] + 1, node_depth[u]);
         }
-        // eliminate duplicate entries ( forward + backward edges )
-        std::sort(neighbours.begin(), neighbours.end());
-        neighbours.resize(std::unique(neighbours.begin(), neighbours.end()) - neighbours.begin());
+    }
 
-        // re-evaluate priorities of neighboring nodes
-        for (const NodeID u : neighbours)
+    // The priorities of all other nodes and the witnesses they are based on are still valid
+    void UpdateStalePriorities(std::vector<float> &priorities,
+                               std::vector<NodeDepth> &node_depth,
+                               ThreadDataContainer &thread_data_list)
+    {
+        std::vector<std::pair<NodeID, NodeDepth>> stale_neighbours;
+        for (auto &data : thread_data_list.data)
         {
-            priorities[u] = EvaluateNodePriority(data, node_depth[u], u);
+            stale_neighbours.insert(stale_neighbours.end(),
+                                    data->stale_neighbours.begin(),
+                                    data->stale_neighbours.end());
+            data->stale_neighbours.clear();
         }
-        return true;
+        tbb::parallel_sort(stale_neighbours.begin(), stale_neighbours.end());
+
+        // the largest depth of every neighbour is the last of its entries
+        std::vector<NodeID> stale_nodes;
+        for (const auto i : util::irange<std::size_t>(0, stale_neighbours.size()))
+        {
+            const NodeID u = stale_neighbours[i].first;
+            if (i + 1 == stale_neighbours.size() || stale_neighbours[i + 1].first != u)
+            {
+                node_depth[u] = std::max(node_depth[u], stale_neighbours[i].second);
+                stale_nodes.push_back(u);
+            }
+        }
+
+        const constexpr size_t PriorityGrainSize = 1;
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, stale_nodes.size(), PriorityGrainSize),
+            [this, &priorities, &node_depth, &stale_nodes, &thread_data_list](
+                const tbb::blocked_range<std::size_t> &range) {
+                ContractorThreadData *data = thread_data_list.GetThreadData();
+                for (auto i = range.begin(), end = range.end(); i != end; ++i)
+                {
+                    const NodeID u = stale_nodes[i];
+                    priorities[u] = this->EvaluateNodePriority(data, node_depth[u], u);
+                }
+            });
     }
 
     inline bool IsNodeIndependent(const std::vector<float> &priorities,
@@ -1114,6 +1451,16 @@ class GraphContractor
     std::vector<EdgeWeight> node_weights;
     std::vector<bool> is_core_node;
     util::XORFastHash<> fast_hash;
+
+    std::string checkpoint_path;
+    std::chrono::steady_clock::duration checkpoint_interval{};
+    bool resume_from_checkpoint = false;
+    std::uint64_t checkpoint_input_fingerprint = 0;
+    std::function<void(unsigned)> checkpoint_handler;
+
+    WitnessSearchLimits simulation_limits{1, 1000};
+    WitnessSearchLimits contraction_limits{5, 2000};
+    PhaseTimings timings;
 };
 }
 }
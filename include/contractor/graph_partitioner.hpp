@@ -0,0 +1,33 @@
+#ifndef OSRM_CONTRACTOR_GRAPH_PARTITIONER_HPP
+#define OSRM_CONTRACTOR_GRAPH_PARTITIONER_HPP
+
+#include "contractor/cell_storage.hpp"
+#include "contractor/multi_level_partition.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/// Recursively bisects the edge-based graph until no cell has more than max_cell_size nodes.
+/// Every level of the resulting partition merges several bisections, so the cells of a level
+/// are considerably larger than the ones of the level below.
+MultiLevelPartition<>
+partitionGraph(const NodeID number_of_nodes,
+               const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+               const std::size_t max_cell_size);
+
+/// Finds the sources and destinations of all cells of the partition. The returned storage has
+/// no weights yet, see customizeCells().
+CellStorage<>
+buildCellStorage(const MultiLevelPartition<> &partition,
+                 const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list);
+}
+}
+
+#endif // OSRM_CONTRACTOR_GRAPH_PARTITIONER_HPP
@@ -0,0 +1,136 @@
+#ifndef OSRM_CONTRACTOR_MULTI_LEVEL_FILES_HPP
+#define OSRM_CONTRACTOR_MULTI_LEVEL_FILES_HPP
+
+#include "contractor/cell_storage.hpp"
+#include "contractor/multi_level_partition.hpp"
+#include "util/exception.hpp"
+#include "util/io.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// The files of the multi-level overlay are written by osrm-contract --mld:
+//  .partition    fingerprint, level shifts, partition id of every node
+//  .cells        fingerprint, cells of all levels, boundary nodes
+//  .cell_metrics fingerprint, weights of all cells (rewritten by osrm-customize)
+
+namespace detail
+{
+inline std::ifstream openMultiLevelFile(const std::string &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        throw util::exception("Could not open " + path + " for reading.");
+    }
+    if (!util::readAndCheckFingerprint(stream))
+    {
+        throw util::exception(path + " was prepared with a different build, rerun osrm-contract");
+    }
+    return stream;
+}
+
+inline std::ofstream createMultiLevelFile(const std::string &path)
+{
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream || !util::writeFingerprint(stream))
+    {
+        throw util::exception("Could not open " + path + " for writing.");
+    }
+    return stream;
+}
+
+template <typename T> inline void readVector(std::istream &stream, const std::string &path, T &data)
+{
+    if (!util::deserializeVector(stream, data))
+    {
+        throw util::exception("Could not read " + path);
+    }
+}
+
+template <typename T>
+inline void writeVector(std::ostream &stream, const std::string &path, const T &data)
+{
+    if (!util::serializeVector(stream, data))
+    {
+        throw util::exception("Could not write " + path);
+    }
+}
+}
+
+inline void writePartition(const std::string &path, const MultiLevelPartition<> &partition)
+{
+    auto stream = detail::createMultiLevelFile(path);
+    detail::writeVector(stream, path, partition.GetLevelShifts());
+    detail::writeVector(stream, path, partition.GetPartitionIDs());
+}
+
+inline MultiLevelPartition<> readPartition(const std::string &path)
+{
+    auto stream = detail::openMultiLevelFile(path);
+    std::vector<std::uint8_t> level_shifts;
+    std::vector<std::uint32_t> partition_ids;
+    detail::readVector(stream, path, level_shifts);
+    detail::readVector(stream, path, partition_ids);
+    return MultiLevelPartition<>{std::move(partition_ids), std::move(level_shifts)};
+}
+
+inline void writeCells(const std::string &path, const CellStorage<> &cells)
+{
+    auto stream = detail::createMultiLevelFile(path);
+    detail::writeVector(stream, path, cells.GetCells());
+    detail::writeVector(stream, path, cells.GetBoundaryNodes());
+}
+
+/// Reads the cells without weights
+inline CellStorage<> readCells(const std::string &path, const MultiLevelPartition<> &partition)
+{
+    auto stream = detail::openMultiLevelFile(path);
+    std::vector<CellData> cells;
+    std::vector<NodeID> boundary_nodes;
+    detail::readVector(stream, path, cells);
+    detail::readVector(stream, path, boundary_nodes);
+    std::size_t number_of_cells = 0;
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        number_of_cells += partition.GetNumberOfCells(level);
+    }
+    if (cells.size() != number_of_cells)
+    {
+        throw util::exception(path + " does not match the partition, rerun osrm-contract");
+    }
+    return CellStorage<>{partition, std::move(cells), std::move(boundary_nodes), {}};
+}
+
+inline void writeCellMetrics(const std::string &path, const std::vector<EdgeWeight> &weights)
+{
+    auto stream = detail::createMultiLevelFile(path);
+    detail::writeVector(stream, path, weights);
+}
+
+inline std::vector<EdgeWeight> readCellMetrics(const std::string &path,
+                                               const CellStorage<> &cells)
+{
+    auto stream = detail::openMultiLevelFile(path);
+    std::vector<EdgeWeight> weights;
+    detail::readVector(stream, path, weights);
+    if (weights.size() != cells.GetNumberOfWeights())
+    {
+        throw util::exception(path + " does not match the cells, rerun osrm-customize");
+    }
+    return weights;
+}
+}
+}
+
+#endif // OSRM_CONTRACTOR_MULTI_LEVEL_FILES_HPP
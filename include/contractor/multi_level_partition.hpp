@@ -0,0 +1,86 @@
+#ifndef OSRM_CONTRACTOR_MULTI_LEVEL_PARTITION_HPP
+#define OSRM_CONTRACTOR_MULTI_LEVEL_PARTITION_HPP
+
+#include "util/shared_memory_vector_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+
+using LevelID = std::uint8_t;
+using CellID = std::uint32_t;
+
+/// Nested partition of the nodes into cells on several levels.
+///
+/// Every node stores its path in the recursive bisection of the graph, the first cut being the
+/// most significant bit. A level drops the last bits of the paths, so the cells of a level are
+/// unions of the cells of the level below. Level 1 holds the smallest cells, level 0 stands for
+/// the nodes themselves.
+template <bool UseSharedMemory = false> class MultiLevelPartition
+{
+    template <typename T> using Vector = typename util::ShM<T, UseSharedMemory>::vector;
+
+  public:
+    MultiLevelPartition() = default;
+
+    /// level_shifts holds the number of bits every level drops from the partition ids, followed
+    /// by the total number of bits of the partition ids
+    MultiLevelPartition(Vector<std::uint32_t> partition_ids_, Vector<std::uint8_t> level_shifts_)
+        : partition_ids(std::move(partition_ids_)), level_shifts(std::move(level_shifts_))
+    {
+        BOOST_ASSERT(level_shifts.empty() || level_shifts[level_shifts.size() - 1] < 32);
+    }
+
+    LevelID GetNumberOfLevels() const
+    {
+        return level_shifts.empty() ? 0 : static_cast<LevelID>(level_shifts.size() - 1);
+    }
+
+    std::size_t GetNumberOfNodes() const { return partition_ids.size(); }
+
+    CellID GetNumberOfCells(const LevelID level) const
+    {
+        BOOST_ASSERT(level > 0 && level <= GetNumberOfLevels());
+        return CellID{1} << (level_shifts[level_shifts.size() - 1] - level_shifts[level - 1]);
+    }
+
+    CellID GetCell(const LevelID level, const NodeID node) const
+    {
+        BOOST_ASSERT(level > 0 && level <= GetNumberOfLevels());
+        BOOST_ASSERT(node < partition_ids.size());
+        return partition_ids[node] >> level_shifts[level - 1];
+    }
+
+    /// Highest level on which the two nodes are in different cells, 0 if they share all cells
+    LevelID GetHighestDifferentLevel(const NodeID first, const NodeID second) const
+    {
+        const auto different_bits = partition_ids[first] ^ partition_ids[second];
+        for (auto level = GetNumberOfLevels(); level > 0; --level)
+        {
+            if ((different_bits >> level_shifts[level - 1]) != 0)
+            {
+                return level;
+            }
+        }
+        return 0;
+    }
+
+    const Vector<std::uint32_t> &GetPartitionIDs() const { return partition_ids; }
+    const Vector<std::uint8_t> &GetLevelShifts() const { return level_shifts; }
+
+  private:
+    Vector<std::uint32_t> partition_ids;
+    Vector<std::uint8_t> level_shifts;
+};
+}
+}
+
+#endif // OSRM_CONTRACTOR_MULTI_LEVEL_PARTITION_HPP
@@ -16,8 +16,33 @@ struct QueryEdge
     NodeID target;
     struct EdgeData
     {
+        // The part of the data that is read by the searches
+        struct SearchData
+        {
+            SearchData() : weight(0), forward(false), backward(false) {}
+
+            int weight : 30;
+            bool forward : 1;
+            bool backward : 1;
+        };
+
+        // The part of the data that is only read when unpacking shortcuts
+        struct UnpackData
+        {
+            UnpackData() : id(0), shortcut(false) {}
+
+            NodeID id : 31;
+            bool shortcut : 1;
+        };
+
         EdgeData() : id(0), shortcut(false), weight(0), forward(false), backward(false) {}
 
+        EdgeData(const SearchData &search_data, const UnpackData &unpack_data)
+            : id(unpack_data.id), shortcut(unpack_data.shortcut), weight(search_data.weight),
+              forward(search_data.forward), backward(search_data.backward)
+        {
+        }
+
         template <class OtherT> EdgeData(const OtherT &other)
         {
             weight = other.weight;
@@ -26,6 +51,24 @@ struct QueryEdge
             forward = other.forward;
             backward = other.backward;
         }
+
+        SearchData GetSearchData() const
+        {
+            SearchData search_data;
+            search_data.weight = weight;
+            search_data.forward = forward;
+            search_data.backward = backward;
+            return search_data;
+        }
+
+        UnpackData GetUnpackData() const
+        {
+            UnpackData unpack_data;
+            unpack_data.id = id;
+            unpack_data.shortcut = shortcut;
+            return unpack_data;
+        }
+
         NodeID id : 31;
         bool shortcut : 1;
         int weight : 30;
@@ -0,0 +1,52 @@
+#ifndef OSRM_CONTRACTOR_TRAFFIC_FILES_HPP
+#define OSRM_CONTRACTOR_TRAFFIC_FILES_HPP
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// A traffic update is either a CSV file or a binary file written by osrm-convert-traffic:
+//  CSV    one "from,to,speed[,...]" or "from,via,to,penalty[,...]" line per record
+//  binary 8 byte magic, number of records (uint64), records as below in host byte order
+// The binary files do not depend on the dataset or the build, so they can be generated by any
+// tool and reused for all datasets of a region.
+
+struct SegmentSpeedRecord
+{
+    std::uint64_t from;
+    std::uint64_t to;
+    std::uint64_t speed;
+};
+
+struct TurnPenaltyRecord
+{
+    std::uint64_t from;
+    std::uint64_t via;
+    std::uint64_t to;
+    double penalty;
+};
+
+static_assert(sizeof(SegmentSpeedRecord) == 24, "SegmentSpeedRecord is written as is");
+static_assert(sizeof(TurnPenaltyRecord) == 32, "TurnPenaltyRecord is written as is");
+static_assert(std::is_trivial<SegmentSpeedRecord>::value, "SegmentSpeedRecord is written as is");
+static_assert(std::is_trivial<TurnPenaltyRecord>::value, "TurnPenaltyRecord is written as is");
+
+/// Reads a CSV or binary segment speed file, in the order of the file
+std::vector<SegmentSpeedRecord> readSegmentSpeeds(const std::string &path);
+
+/// Reads a CSV or binary turn penalty file, in the order of the file
+std::vector<TurnPenaltyRecord> readTurnPenalties(const std::string &path);
+
+void writeSegmentSpeeds(const std::string &path, const std::vector<SegmentSpeedRecord> &records);
+
+void writeTurnPenalties(const std::string &path, const std::vector<TurnPenaltyRecord> &records);
+}
+}
+
+#endif // OSRM_CONTRACTOR_TRAFFIC_FILES_HPP
@@ -0,0 +1,31 @@
+#ifndef OSRM_CONTRACTOR_UNDIRECTED_GRAPH_HPP
+#define OSRM_CONTRACTOR_UNDIRECTED_GRAPH_HPP
+
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Undirected adjacency array of the edge-based graph without self-loops and parallel edges.
+// The structure of the graph is all that orders and partitions of the nodes look at.
+struct UndirectedGraph
+{
+    NodeID GetNumberOfNodes() const { return static_cast<NodeID>(first_edge.size() - 1); }
+
+    std::vector<EdgeID> first_edge;
+    std::vector<NodeID> targets;
+};
+
+UndirectedGraph
+buildUndirectedGraph(const NodeID number_of_nodes,
+                     const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_list);
+}
+}
+
+#endif // OSRM_CONTRACTOR_UNDIRECTED_GRAPH_HPP
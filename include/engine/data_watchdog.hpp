@@ -30,10 +30,11 @@ namespace engine
 class DataWatchdog
 {
   public:
-    DataWatchdog()
+    // lock_memory locks the pinned blocks of every dataset to RAM
+    explicit DataWatchdog(const bool lock_memory_)
         : shared_barriers{std::make_shared<storage::SharedBarriers>()},
           shared_regions(storage::makeSharedMemory(storage::CURRENT_REGIONS)),
-          current_timestamp{storage::LAYOUT_NONE, storage::DATA_NONE, 0}
+          current_timestamp{storage::LAYOUT_NONE, storage::DATA_NONE, 0}, lock_memory(lock_memory_)
     {
     }
 
@@ -105,7 +106,8 @@ class DataWatchdog
         facade = std::make_shared<datafacade::SharedDataFacade>(shared_barriers,
                                                                 current_timestamp.layout,
                                                                 current_timestamp.data,
-                                                                current_timestamp.timestamp);
+                                                                current_timestamp.timestamp,
+                                                                lock_memory);
 
         return get_locked_facade();
     }
@@ -121,6 +123,7 @@ class DataWatchdog
     mutable boost::shared_mutex facade_mutex;
     std::shared_ptr<datafacade::SharedDataFacade> facade;
     storage::SharedDataTimestamp current_timestamp;
+    const bool lock_memory;
 };
 }
 }
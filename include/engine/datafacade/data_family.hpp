@@ -0,0 +1,34 @@
+#ifndef OSRM_ENGINE_DATAFACADE_DATA_FAMILY_HPP
+#define OSRM_ENGINE_DATAFACADE_DATA_FAMILY_HPP
+
+#include <cstdint>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// Groups of data that are only needed to answer some of the services. A data facade may defer
+// loading a family that is not requested until it is used for the first time. Every plugin
+// declares the families it reads to answer requests as REQUIRED_DATA.
+namespace DataFamily
+{
+typedef std::uint8_t Mask;
+const constexpr Mask none = 0u;
+// street names, refs, pronunciations and destinations
+const constexpr Mask names = 1u << 0;
+// per-edge turn instructions, lane data ids, entry class ids and turn bearings
+const constexpr Mask turn_instructions = 1u << 1;
+// bearing classes and entry classes of intersections
+const constexpr Mask intersection_classes = 1u << 2;
+// lane tuples and turn lane descriptions
+const constexpr Mask turn_lanes = 1u << 3;
+const constexpr Mask all = names | turn_instructions | intersection_classes | turn_lanes;
+}
+}
+}
+}
+
+#endif // OSRM_ENGINE_DATAFACADE_DATA_FAMILY_HPP
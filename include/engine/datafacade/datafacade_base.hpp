@@ -3,6 +3,8 @@
 
 // Exposes all data access interfaces to the algorithms via base class ptr
 
+#include "contractor/cell_storage.hpp"
+#include "contractor/multi_level_partition.hpp"
 #include "contractor/query_edge.hpp"
 #include "extractor/edge_based_node.hpp"
 #include "extractor/external_memory_node.hpp"
@@ -36,10 +38,30 @@ namespace datafacade
 
 using EdgeRange = util::range<EdgeID>;
 
+// A contiguous range of memory holding part of the dataset
+struct MemoryBlock
+{
+    enum class Location
+    {
+        // heap of this process
+        Process,
+        // shared memory region created by osrm-datastore
+        SharedMemory,
+        // memory mapped file, pages may be evicted
+        MappedFile
+    };
+
+    std::string name;
+    const void *address;
+    std::size_t bytes;
+    Location location;
+};
+
 class BaseDataFacade
 {
   public:
     using EdgeData = contractor::QueryEdge::EdgeData;
+    using EdgeSearchData = EdgeData::SearchData;
     using RTreeLeaf = extractor::EdgeBasedNode;
     BaseDataFacade() {}
     virtual ~BaseDataFacade() {}
@@ -53,7 +75,11 @@ class BaseDataFacade
 
     virtual NodeID GetTarget(const EdgeID e) const = 0;
 
-    virtual const EdgeData &GetEdgeData(const EdgeID e) const = 0;
+    virtual EdgeData GetEdgeData(const EdgeID e) const = 0;
+
+    // Only the weight and the direction flags of an edge, this is all that the searches need and
+    // does not touch the middle nodes of the shortcuts
+    virtual EdgeSearchData GetEdgeSearchData(const EdgeID e) const = 0;
 
     virtual EdgeID BeginEdges(const NodeID n) const = 0;
 
@@ -169,8 +195,22 @@ class BaseDataFacade
 
     virtual std::size_t GetCoreSize() const = 0;
 
+    // multi-level partition of datasets prepared by osrm-contract --mld, no levels otherwise
+    virtual contractor::LevelID GetNumberOfLevels() const = 0;
+
+    virtual contractor::CellID GetCellID(const contractor::LevelID level,
+                                         const NodeID node) const = 0;
+
+    virtual contractor::LevelID GetHighestDifferentLevel(const NodeID first,
+                                                         const NodeID second) const = 0;
+
+    virtual contractor::Cell GetCell(const contractor::LevelID level,
+                                     const contractor::CellID cell) const = 0;
+
     virtual std::string GetTimestamp() const = 0;
 
+    virtual std::vector<MemoryBlock> GetMemoryBlocks() const = 0;
+
     virtual bool GetContinueStraightDefault() const = 0;
 
     virtual double GetMapMatchingMaxSpeed() const = 0;
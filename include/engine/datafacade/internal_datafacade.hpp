@@ -3,12 +3,14 @@
 
 // implements all data storage when shared memory is _NOT_ used
 
+#include "engine/datafacade/data_family.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "extractor/guidance/turn_instruction.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
 
+#include "contractor/multi_level_files.hpp"
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/original_edge_data.hpp"
 #include "extractor/profile_properties.hpp"
@@ -18,6 +20,7 @@
 #include "engine/geospatial_query.hpp"
 #include "util/graph_loader.hpp"
 #include "util/guidance/turn_bearing.hpp"
+#include "util/huge_pages.hpp"
 #include "util/guidance/turn_lanes.hpp"
 #include "util/io.hpp"
 #include "util/packed_vector.hpp"
@@ -25,7 +28,7 @@
 #include "util/rectangle.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
 #include "util/simple_logger.hpp"
-#include "util/static_graph.hpp"
+#include "util/split_static_graph.hpp"
 #include "util/static_rtree.hpp"
 #include "util/typedefs.hpp"
 
@@ -35,10 +38,12 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <ios>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -62,15 +67,18 @@ class InternalDataFacade final : public BaseDataFacade
 
   private:
     using super = BaseDataFacade;
-    using QueryGraph = util::StaticGraph<typename super::EdgeData>;
+    using QueryGraph = util::SplitStaticGraph<typename super::EdgeData>;
     using InputEdge = QueryGraph::InputEdge;
     using RTreeLeaf = super::RTreeLeaf;
     using InternalRTree =
         util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, false>::vector, false>;
     using InternalGeospatialQuery = GeospatialQuery<InternalRTree, BaseDataFacade>;
 
-    InternalDataFacade() {}
+    InternalDataFacade() : m_use_huge_pages(false) {}
 
+    // back the large blocks (graph, coordinates, geometries) with transparent huge pages
+    bool m_use_huge_pages;
+    storage::StorageConfig m_storage_config;
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
     std::string m_timestamp;
@@ -89,6 +97,8 @@ class InternalDataFacade final : public BaseDataFacade
     util::ShM<EdgeWeight, false>::vector m_geometry_fwd_weight_list;
     util::ShM<EdgeWeight, false>::vector m_geometry_rev_weight_list;
     util::ShM<bool, false>::vector m_is_core_node;
+    contractor::MultiLevelPartition<false> m_partition;
+    contractor::CellStorage<false> m_cell_storage;
     util::ShM<uint8_t, false>::vector m_datasource_list;
     util::ShM<std::string, false>::vector m_datasource_names;
     util::ShM<std::uint32_t, false>::vector m_lane_description_offsets;
@@ -116,6 +126,13 @@ class InternalDataFacade final : public BaseDataFacade
     util::RangeTable<16, false> m_bearing_ranges_table;
     util::ShM<DiscreteBearing, false>::vector m_bearing_values_table;
 
+    // data families that were not preloaded are loaded by the first query that needs them
+    mutable std::once_flag m_names_loaded;
+    mutable std::once_flag m_turn_instructions_loaded;
+    mutable std::once_flag m_intersection_classes_loaded;
+    mutable std::once_flag m_turn_lanes_loaded;
+    std::atomic<DataFamily::Mask> m_loaded_families{DataFamily::none};
+
     void LoadProfileProperties(const boost::filesystem::path &properties_path)
     {
         boost::filesystem::ifstream in_stream(properties_path);
@@ -167,22 +184,29 @@ class InternalDataFacade final : public BaseDataFacade
         const auto header = storage::io::readHSGRHeader(hsgr_input_stream);
         m_check_sum = header.checksum;
 
-        util::ShM<QueryGraph::NodeArrayEntry, false>::vector node_list(header.number_of_nodes);
-        util::ShM<QueryGraph::EdgeArrayEntry, false>::vector edge_list(header.number_of_edges);
+        util::ShM<QueryGraph::NodeArrayEntry, false>::vector node_list;
+        util::ShM<QueryGraph::SearchEdgeArrayEntry, false>::vector edge_list;
+        util::ShM<QueryGraph::UnpackEdgeArrayEntry, false>::vector edge_unpack_list;
+        util::resizeWithHugePages(node_list, header.number_of_nodes, m_use_huge_pages);
+        util::resizeWithHugePages(edge_list, header.number_of_edges, m_use_huge_pages);
+        util::resizeWithHugePages(edge_unpack_list, header.number_of_edges, m_use_huge_pages);
 
         storage::io::readHSGR(hsgr_input_stream,
                               node_list.data(),
                               header.number_of_nodes,
                               edge_list.data(),
+                              edge_unpack_list.data(),
                               header.number_of_edges);
 
-        m_query_graph = std::unique_ptr<QueryGraph>(new QueryGraph(node_list, edge_list));
+        m_query_graph = std::unique_ptr<QueryGraph>(
+            new QueryGraph(node_list, edge_list, edge_unpack_list));
 
         util::SimpleLogger().Write() << "Data checksum is " << m_check_sum;
     }
 
     void LoadNodeAndEdgeInformation(const boost::filesystem::path &nodes_file_path,
-                                    const boost::filesystem::path &edges_file_path)
+                                    const boost::filesystem::path &edges_file_path,
+                                    const bool load_turn_instructions)
     {
         boost::filesystem::ifstream nodes_input_stream(nodes_file_path, std::ios::binary);
         if (!nodes_input_stream)
@@ -191,7 +215,7 @@ class InternalDataFacade final : public BaseDataFacade
         }
 
         const auto number_of_coordinates = storage::io::readElementCount(nodes_input_stream);
-        m_coordinate_list.resize(number_of_coordinates);
+        util::resizeWithHugePages(m_coordinate_list, number_of_coordinates, m_use_huge_pages);
         m_osmnodeid_list.reserve(number_of_coordinates);
         storage::io::readNodes(
             nodes_input_stream, m_coordinate_list.data(), m_osmnodeid_list, number_of_coordinates);
@@ -204,25 +228,97 @@ class InternalDataFacade final : public BaseDataFacade
         const auto number_of_edges = storage::io::readElementCount(edges_input_stream);
         m_via_geometry_list.resize(number_of_edges);
         m_name_ID_list.resize(number_of_edges);
+        m_travel_mode_list.resize(number_of_edges);
+        if (load_turn_instructions)
+        {
+            ResizeTurnInstructions(number_of_edges);
+        }
+
+        storage::io::readEdges(edges_input_stream,
+                               m_via_geometry_list.data(),
+                               m_name_ID_list.data(),
+                               load_turn_instructions ? m_turn_instruction_list.data() : nullptr,
+                               load_turn_instructions ? m_lane_data_id.data() : nullptr,
+                               m_travel_mode_list.data(),
+                               load_turn_instructions ? m_entry_class_id_list.data() : nullptr,
+                               load_turn_instructions ? m_pre_turn_bearing.data() : nullptr,
+                               load_turn_instructions ? m_post_turn_bearing.data() : nullptr,
+                               number_of_edges);
+    }
+
+    void ResizeTurnInstructions(const std::uint64_t number_of_edges)
+    {
         m_turn_instruction_list.resize(number_of_edges);
         m_lane_data_id.resize(number_of_edges);
-        m_travel_mode_list.resize(number_of_edges);
         m_entry_class_id_list.resize(number_of_edges);
         m_pre_turn_bearing.resize(number_of_edges);
         m_post_turn_bearing.resize(number_of_edges);
+    }
+
+    // Reads the per-edge guidance data that was skipped by LoadNodeAndEdgeInformation
+    void LoadTurnInstructions(const boost::filesystem::path &edges_file_path)
+    {
+        boost::filesystem::ifstream edges_input_stream(edges_file_path, std::ios::binary);
+        if (!edges_input_stream)
+        {
+            throw util::exception("Could not open " + edges_file_path.string() + " for reading.");
+        }
+        const auto number_of_edges = storage::io::readElementCount(edges_input_stream);
+        ResizeTurnInstructions(number_of_edges);
 
         storage::io::readEdges(edges_input_stream,
-                               m_via_geometry_list.data(),
-                               m_name_ID_list.data(),
+                               nullptr,
+                               nullptr,
                                m_turn_instruction_list.data(),
                                m_lane_data_id.data(),
-                               m_travel_mode_list.data(),
+                               nullptr,
                                m_entry_class_id_list.data(),
                                m_pre_turn_bearing.data(),
                                m_post_turn_bearing.data(),
                                number_of_edges);
     }
 
+    void LoadDataFamily(const DataFamily::Mask family) const
+    {
+        // loading fills in members, the once flags make this safe for concurrent queries
+        auto *self = const_cast<InternalDataFacade *>(this);
+        switch (family)
+        {
+        case DataFamily::names:
+            std::call_once(m_names_loaded, [self] {
+                util::SimpleLogger().Write() << "loading street names";
+                self->LoadStreetNames(self->m_storage_config.names_data_path);
+                self->m_loaded_families |= DataFamily::names;
+            });
+            break;
+        case DataFamily::turn_instructions:
+            std::call_once(m_turn_instructions_loaded, [self] {
+                util::SimpleLogger().Write() << "loading turn instructions";
+                self->LoadTurnInstructions(self->m_storage_config.edges_data_path);
+                self->m_loaded_families |= DataFamily::turn_instructions;
+            });
+            break;
+        case DataFamily::intersection_classes:
+            std::call_once(m_intersection_classes_loaded, [self] {
+                util::SimpleLogger().Write() << "loading intersection class data";
+                self->LoadIntersectionClasses(self->m_storage_config.intersection_class_path);
+                self->m_loaded_families |= DataFamily::intersection_classes;
+            });
+            break;
+        case DataFamily::turn_lanes:
+            std::call_once(m_turn_lanes_loaded, [self] {
+                util::SimpleLogger().Write() << "loading lane tags";
+                self->LoadLaneDescriptions(self->m_storage_config.turn_lane_description_path);
+                util::SimpleLogger().Write() << "Loading Lane Data Pairs";
+                self->LoadLaneTupleIdPairs(self->m_storage_config.turn_lane_data_path);
+                self->m_loaded_families |= DataFamily::turn_lanes;
+            });
+            break;
+        default:
+            BOOST_ASSERT_MSG(false, "unknown data family");
+        }
+    }
+
     void LoadCoreInformation(const boost::filesystem::path &core_data_file)
     {
         std::ifstream core_stream(core_data_file.string().c_str(), std::ios::binary);
@@ -246,6 +342,19 @@ class InternalDataFacade final : public BaseDataFacade
         }
     }
 
+    // Datasets prepared by osrm-contract --mld have a partition instead of a core
+    void LoadMultiLevelPartition(const storage::StorageConfig &config)
+    {
+        if (!boost::filesystem::exists(config.partition_path))
+        {
+            return;
+        }
+        m_partition = contractor::readPartition(config.partition_path.string());
+        m_cell_storage = contractor::readCells(config.cells_path.string(), m_partition);
+        m_cell_storage.SetWeights(
+            contractor::readCellMetrics(config.cell_metrics_path.string(), m_cell_storage));
+    }
+
     void LoadGeometries(const boost::filesystem::path &geometry_file)
     {
         std::ifstream geometry_stream(geometry_file.string().c_str(), std::ios::binary);
@@ -254,7 +363,7 @@ class InternalDataFacade final : public BaseDataFacade
 
         geometry_stream.read((char *)&number_of_indices, sizeof(unsigned));
 
-        m_geometry_indices.resize(number_of_indices);
+        util::resizeWithHugePages(m_geometry_indices, number_of_indices, m_use_huge_pages);
         if (number_of_indices > 0)
         {
             geometry_stream.read((char *)&(m_geometry_indices[0]),
@@ -264,9 +373,12 @@ class InternalDataFacade final : public BaseDataFacade
         geometry_stream.read((char *)&number_of_compressed_geometries, sizeof(unsigned));
 
         BOOST_ASSERT(m_geometry_indices.back() == number_of_compressed_geometries);
-        m_geometry_node_list.resize(number_of_compressed_geometries);
-        m_geometry_fwd_weight_list.resize(number_of_compressed_geometries);
-        m_geometry_rev_weight_list.resize(number_of_compressed_geometries);
+        util::resizeWithHugePages(
+            m_geometry_node_list, number_of_compressed_geometries, m_use_huge_pages);
+        util::resizeWithHugePages(
+            m_geometry_fwd_weight_list, number_of_compressed_geometries, m_use_huge_pages);
+        util::resizeWithHugePages(
+            m_geometry_rev_weight_list, number_of_compressed_geometries, m_use_huge_pages);
 
         if (number_of_compressed_geometries > 0)
         {
@@ -411,7 +523,11 @@ class InternalDataFacade final : public BaseDataFacade
         m_geospatial_query.reset();
     }
 
-    explicit InternalDataFacade(const storage::StorageConfig &config)
+    // Only the data families in preload are loaded up front, the others on first use.
+    explicit InternalDataFacade(const storage::StorageConfig &config,
+                                const bool use_huge_pages = false,
+                                const DataFamily::Mask preload = DataFamily::all)
+        : m_use_huge_pages(use_huge_pages), m_storage_config(config)
     {
         ram_index_path = config.ram_index_path;
         file_index_path = config.file_index_path;
@@ -420,11 +536,22 @@ class InternalDataFacade final : public BaseDataFacade
         LoadGraph(config.hsgr_data_path);
 
         util::SimpleLogger().Write() << "loading edge information";
-        LoadNodeAndEdgeInformation(config.nodes_data_path, config.edges_data_path);
+        const bool preload_turn_instructions = preload & DataFamily::turn_instructions;
+        LoadNodeAndEdgeInformation(
+            config.nodes_data_path, config.edges_data_path, preload_turn_instructions);
+        if (preload_turn_instructions)
+        {
+            // already read along with the edge information
+            std::call_once(m_turn_instructions_loaded,
+                           [this] { m_loaded_families |= DataFamily::turn_instructions; });
+        }
 
         util::SimpleLogger().Write() << "loading core information";
         LoadCoreInformation(config.core_data_path);
 
+        util::SimpleLogger().Write() << "loading multi-level partition";
+        LoadMultiLevelPartition(config);
+
         util::SimpleLogger().Write() << "loading geometries";
         LoadGeometries(config.geometries_path);
 
@@ -437,20 +564,18 @@ class InternalDataFacade final : public BaseDataFacade
         util::SimpleLogger().Write() << "loading profile properties";
         LoadProfileProperties(config.properties_path);
 
-        util::SimpleLogger().Write() << "loading street names";
-        LoadStreetNames(config.names_data_path);
-
-        util::SimpleLogger().Write() << "loading lane tags";
-        LoadLaneDescriptions(config.turn_lane_description_path);
-
         util::SimpleLogger().Write() << "loading rtree";
         LoadRTree();
 
-        util::SimpleLogger().Write() << "loading intersection class data";
-        LoadIntersectionClasses(config.intersection_class_path);
-
-        util::SimpleLogger().Write() << "Loading Lane Data Pairs";
-        LoadLaneTupleIdPairs(config.turn_lane_data_path);
+        for (const auto family : {DataFamily::names,
+                                  DataFamily::intersection_classes,
+                                  DataFamily::turn_lanes})
+        {
+            if (preload & family)
+            {
+                LoadDataFamily(family);
+            }
+        }
     }
 
     // search graph access
@@ -465,11 +590,16 @@ class InternalDataFacade final : public BaseDataFacade
 
     NodeID GetTarget(const EdgeID e) const override final { return m_query_graph->GetTarget(e); }
 
-    EdgeData &GetEdgeData(const EdgeID e) const override final
+    EdgeData GetEdgeData(const EdgeID e) const override final
     {
         return m_query_graph->GetEdgeData(e);
     }
 
+    EdgeSearchData GetEdgeSearchData(const EdgeID e) const override final
+    {
+        return m_query_graph->GetEdgeSearchData(e);
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -517,6 +647,7 @@ class InternalDataFacade final : public BaseDataFacade
     extractor::guidance::TurnInstruction
     GetTurnInstructionForEdgeID(const unsigned id) const override final
     {
+        LoadDataFamily(DataFamily::turn_instructions);
         return m_turn_instruction_list.at(id);
     }
 
@@ -653,6 +784,7 @@ class InternalDataFacade final : public BaseDataFacade
         {
             return "";
         }
+        LoadDataFamily(DataFamily::names);
         auto range = m_name_table.GetRange(name_id);
 
         std::string result;
@@ -713,6 +845,29 @@ class InternalDataFacade final : public BaseDataFacade
         }
     }
 
+    contractor::LevelID GetNumberOfLevels() const override final
+    {
+        return m_partition.GetNumberOfLevels();
+    }
+
+    contractor::CellID GetCellID(const contractor::LevelID level,
+                                 const NodeID node) const override final
+    {
+        return m_partition.GetCell(level, node);
+    }
+
+    contractor::LevelID GetHighestDifferentLevel(const NodeID first,
+                                                 const NodeID second) const override final
+    {
+        return m_partition.GetHighestDifferentLevel(first, second);
+    }
+
+    contractor::Cell GetCell(const contractor::LevelID level,
+                             const contractor::CellID cell) const override final
+    {
+        return m_cell_storage.GetCell(level, cell);
+    }
+
     virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
         /*
@@ -894,6 +1049,72 @@ class InternalDataFacade final : public BaseDataFacade
 
     std::string GetTimestamp() const override final { return m_timestamp; }
 
+    std::vector<MemoryBlock> GetMemoryBlocks() const override final
+    {
+        std::vector<MemoryBlock> blocks;
+        const auto add_block = [&blocks](const char *name,
+                                         const std::pair<const void *, std::size_t> &memory) {
+            blocks.push_back({name, memory.first, memory.second, MemoryBlock::Location::Process});
+        };
+        const auto add_vector = [&blocks](const char *name, const auto &vector) {
+            blocks.push_back({name,
+                              vector.data(),
+                              vector.capacity() * sizeof(vector[0]),
+                              MemoryBlock::Location::Process});
+        };
+
+        add_block("GRAPH_NODE_LIST", m_query_graph->GetNodeArrayMemory());
+        add_block("GRAPH_EDGE_LIST", m_query_graph->GetEdgeArrayMemory());
+        add_block("GRAPH_EDGE_UNPACK_LIST", m_query_graph->GetUnpackArrayMemory());
+        add_vector("COORDINATE_LIST", m_coordinate_list);
+        add_vector("VIA_NODE_LIST", m_via_geometry_list);
+        add_vector("NAME_ID_LIST", m_name_ID_list);
+        add_vector("TRAVEL_MODE", m_travel_mode_list);
+        add_vector("GEOMETRIES_INDEX", m_geometry_indices);
+        add_vector("GEOMETRIES_NODE_LIST", m_geometry_node_list);
+        add_vector("GEOMETRIES_FWD_WEIGHT_LIST", m_geometry_fwd_weight_list);
+        add_vector("GEOMETRIES_REV_WEIGHT_LIST", m_geometry_rev_weight_list);
+        add_vector("DATASOURCES_LIST", m_datasource_list);
+        add_vector("MLD_PARTITION", m_partition.GetPartitionIDs());
+        add_vector("MLD_LEVEL_SHIFTS", m_partition.GetLevelShifts());
+        add_vector("MLD_CELLS", m_cell_storage.GetCells());
+        add_vector("MLD_CELL_BOUNDARY", m_cell_storage.GetBoundaryNodes());
+        add_vector("MLD_CELL_WEIGHTS", m_cell_storage.GetWeights());
+        add_block("R_SEARCH_TREE", m_static_rtree->GetSearchTreeMemory());
+        blocks.push_back({"R_TREE_LEAVES",
+                          m_static_rtree->GetLeavesMemory().first,
+                          m_static_rtree->GetLeavesMemory().second,
+                          MemoryBlock::Location::MappedFile});
+
+        // data families that are not loaded yet may be written to concurrently
+        const DataFamily::Mask loaded_families = m_loaded_families;
+        if (loaded_families & DataFamily::names)
+        {
+            add_vector("NAME_CHAR_LIST", m_names_char_list);
+        }
+        if (loaded_families & DataFamily::turn_instructions)
+        {
+            add_vector("TURN_INSTRUCTION", m_turn_instruction_list);
+            add_vector("LANE_DATA_ID", m_lane_data_id);
+            add_vector("ENTRY_CLASSID", m_entry_class_id_list);
+            add_vector("PRE_TURN_BEARING", m_pre_turn_bearing);
+            add_vector("POST_TURN_BEARING", m_post_turn_bearing);
+        }
+        if (loaded_families & DataFamily::intersection_classes)
+        {
+            add_vector("BEARING_CLASSID", m_bearing_class_id_table);
+            add_vector("BEARING_VALUES", m_bearing_values_table);
+            add_vector("ENTRY_CLASS", m_entry_class_table);
+        }
+        if (loaded_families & DataFamily::turn_lanes)
+        {
+            add_vector("TURN_LANE_DATA", m_lane_tuple_id_pairs);
+            add_vector("LANE_DESCRIPTION_OFFSETS", m_lane_description_offsets);
+            add_vector("LANE_DESCRIPTION_MASKS", m_lane_description_masks);
+        }
+        return blocks;
+    }
+
     bool GetContinueStraightDefault() const override final
     {
         return m_profile_properties.continue_straight_at_waypoint;
@@ -906,6 +1127,7 @@ class InternalDataFacade final : public BaseDataFacade
 
     BearingClassID GetBearingClassID(const NodeID nid) const override final
     {
+        LoadDataFamily(DataFamily::intersection_classes);
         return m_bearing_class_id_table.at(nid);
     }
 
@@ -913,6 +1135,7 @@ class InternalDataFacade final : public BaseDataFacade
     GetBearingClass(const BearingClassID bearing_class_id) const override final
     {
         BOOST_ASSERT(bearing_class_id != INVALID_BEARING_CLASSID);
+        LoadDataFamily(DataFamily::intersection_classes);
         auto range = m_bearing_ranges_table.GetRange(bearing_class_id);
 
         util::guidance::BearingClass result;
@@ -927,31 +1150,38 @@ class InternalDataFacade final : public BaseDataFacade
 
     EntryClassID GetEntryClassID(const EdgeID eid) const override final
     {
+        LoadDataFamily(DataFamily::turn_instructions);
         return m_entry_class_id_list.at(eid);
     }
 
     util::guidance::TurnBearing PreTurnBearing(const EdgeID eid) const override final
     {
+        LoadDataFamily(DataFamily::turn_instructions);
         return m_pre_turn_bearing.at(eid);
     }
     util::guidance::TurnBearing PostTurnBearing(const EdgeID eid) const override final
     {
+        LoadDataFamily(DataFamily::turn_instructions);
         return m_post_turn_bearing.at(eid);
     }
 
     util::guidance::EntryClass GetEntryClass(const EntryClassID entry_class_id) const override final
     {
+        LoadDataFamily(DataFamily::intersection_classes);
         return m_entry_class_table.at(entry_class_id);
     }
 
     bool hasLaneData(const EdgeID id) const override final
     {
+        LoadDataFamily(DataFamily::turn_instructions);
         return m_lane_data_id[id] != INVALID_LANE_DATAID;
     }
 
     util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const override final
     {
         BOOST_ASSERT(hasLaneData(id));
+        LoadDataFamily(DataFamily::turn_instructions);
+        LoadDataFamily(DataFamily::turn_lanes);
         return m_lane_tuple_id_pairs[m_lane_data_id[id]];
     }
 
@@ -960,11 +1190,11 @@ class InternalDataFacade final : public BaseDataFacade
     {
         if (lane_description_id == INVALID_LANE_DESCRIPTIONID)
             return {};
-        else
-            return extractor::guidance::TurnLaneDescription(
-                m_lane_description_masks.begin() + m_lane_description_offsets[lane_description_id],
-                m_lane_description_masks.begin() +
-                    m_lane_description_offsets[lane_description_id + 1]);
+
+        LoadDataFamily(DataFamily::turn_lanes);
+        return extractor::guidance::TurnLaneDescription(
+            m_lane_description_masks.begin() + m_lane_description_offsets[lane_description_id],
+            m_lane_description_masks.begin() + m_lane_description_offsets[lane_description_id + 1]);
     }
 };
 }
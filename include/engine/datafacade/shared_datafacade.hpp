@@ -22,15 +22,22 @@
 #include "util/range_table.hpp"
 #include "util/rectangle.hpp"
 #include "util/simple_logger.hpp"
-#include "util/static_graph.hpp"
+#include "util/split_static_graph.hpp"
 #include "util/static_rtree.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/named_sharable_mutex.hpp>
 #include <boost/interprocess/sync/sharable_lock.hpp>
 #include <boost/thread/tss.hpp>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 #include <algorithm>
 #include <cstddef>
 #include <iterator>
@@ -52,9 +59,10 @@ class SharedDataFacade final : public BaseDataFacade
 
   private:
     using super = BaseDataFacade;
-    using QueryGraph = util::StaticGraph<EdgeData, true>;
+    using QueryGraph = util::SplitStaticGraph<EdgeData, true>;
     using GraphNode = QueryGraph::NodeArrayEntry;
-    using GraphEdge = QueryGraph::EdgeArrayEntry;
+    using GraphSearchEdge = QueryGraph::SearchEdgeArrayEntry;
+    using GraphUnpackEdge = QueryGraph::UnpackEdgeArrayEntry;
     using IndexBlock = util::RangeTable<16, true>::BlockT;
     using InputEdge = QueryGraph::InputEdge;
     using RTreeLeaf = super::RTreeLeaf;
@@ -65,16 +73,21 @@ class SharedDataFacade final : public BaseDataFacade
 
     storage::SharedDataLayout *data_layout;
     char *shared_memory;
+    // blocks with BlockResidency::Mapped, nullptr if all blocks are pinned
+    char *mapped_memory;
 
     std::shared_ptr<storage::SharedBarriers> shared_barriers;
     storage::SharedDataType layout_region;
     storage::SharedDataType data_region;
     unsigned shared_timestamp;
+    // the pinned region is locked to RAM, osrm-routed was asked to lock its memory
+    bool lock_memory;
 
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
     std::unique_ptr<storage::SharedMemory> m_layout_memory;
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    boost::interprocess::mapped_region m_mapped_blocks;
     std::string m_timestamp;
     extractor::ProfileProperties *m_profile_properties;
 
@@ -94,6 +107,8 @@ class SharedDataFacade final : public BaseDataFacade
     util::ShM<EdgeWeight, true>::vector m_geometry_fwd_weight_list;
     util::ShM<EdgeWeight, true>::vector m_geometry_rev_weight_list;
     util::ShM<bool, true>::vector m_is_core_node;
+    contractor::MultiLevelPartition<true> m_partition;
+    contractor::CellStorage<true> m_cell_storage;
     util::ShM<uint8_t, true>::vector m_datasource_list;
     util::ShM<std::uint32_t, true>::vector m_lane_description_offsets;
     util::ShM<extractor::guidance::TurnLaneType::Mask, true>::vector m_lane_description_masks;
@@ -123,21 +138,21 @@ class SharedDataFacade final : public BaseDataFacade
 
     void LoadChecksum()
     {
-        m_check_sum = *data_layout->GetBlockPtr<unsigned>(shared_memory,
-                                                          storage::SharedDataLayout::HSGR_CHECKSUM);
+        m_check_sum = *data_layout->GetBlockPtr<unsigned>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::HSGR_CHECKSUM);
         util::SimpleLogger().Write() << "set checksum: " << m_check_sum;
     }
 
     void LoadProfileProperties()
     {
         m_profile_properties = data_layout->GetBlockPtr<extractor::ProfileProperties>(
-            shared_memory, storage::SharedDataLayout::PROPERTIES);
+            shared_memory, mapped_memory, storage::SharedDataLayout::PROPERTIES);
     }
 
     void LoadTimestamp()
     {
-        auto timestamp_ptr =
-            data_layout->GetBlockPtr<char>(shared_memory, storage::SharedDataLayout::TIMESTAMP);
+        auto timestamp_ptr = data_layout->GetBlockPtr<char>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::TIMESTAMP);
         m_timestamp.resize(data_layout->GetBlockSize(storage::SharedDataLayout::TIMESTAMP));
         std::copy(timestamp_ptr,
                   timestamp_ptr + data_layout->GetBlockSize(storage::SharedDataLayout::TIMESTAMP),
@@ -149,7 +164,7 @@ class SharedDataFacade final : public BaseDataFacade
         BOOST_ASSERT_MSG(!m_coordinate_list.empty(), "coordinates must be loaded before r-tree");
 
         const auto file_index_ptr = data_layout->GetBlockPtr<char>(
-            shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
+            shared_memory, mapped_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
         file_index_path = boost::filesystem::path(file_index_ptr);
         if (!boost::filesystem::exists(file_index_path))
         {
@@ -159,7 +174,7 @@ class SharedDataFacade final : public BaseDataFacade
         }
 
         auto tree_ptr = data_layout->GetBlockPtr<RTreeNode>(
-            shared_memory, storage::SharedDataLayout::R_SEARCH_TREE);
+            shared_memory, mapped_memory, storage::SharedDataLayout::R_SEARCH_TREE);
         m_static_rtree.reset(
             new SharedRTree(tree_ptr,
                             data_layout->num_entries[storage::SharedDataLayout::R_SEARCH_TREE],
@@ -172,22 +187,28 @@ class SharedDataFacade final : public BaseDataFacade
     void LoadGraph()
     {
         auto graph_nodes_ptr = data_layout->GetBlockPtr<GraphNode>(
-            shared_memory, storage::SharedDataLayout::GRAPH_NODE_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::GRAPH_NODE_LIST);
+
+        auto graph_edges_ptr = data_layout->GetBlockPtr<GraphSearchEdge>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::GRAPH_EDGE_LIST);
 
-        auto graph_edges_ptr = data_layout->GetBlockPtr<GraphEdge>(
-            shared_memory, storage::SharedDataLayout::GRAPH_EDGE_LIST);
+        auto graph_edge_unpack_ptr = data_layout->GetBlockPtr<GraphUnpackEdge>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::GRAPH_EDGE_UNPACK_LIST);
 
         util::ShM<GraphNode, true>::vector node_list(
             graph_nodes_ptr, data_layout->num_entries[storage::SharedDataLayout::GRAPH_NODE_LIST]);
-        util::ShM<GraphEdge, true>::vector edge_list(
+        util::ShM<GraphSearchEdge, true>::vector edge_list(
             graph_edges_ptr, data_layout->num_entries[storage::SharedDataLayout::GRAPH_EDGE_LIST]);
-        m_query_graph.reset(new QueryGraph(node_list, edge_list));
+        util::ShM<GraphUnpackEdge, true>::vector edge_unpack_list(
+            graph_edge_unpack_ptr,
+            data_layout->num_entries[storage::SharedDataLayout::GRAPH_EDGE_UNPACK_LIST]);
+        m_query_graph.reset(new QueryGraph(node_list, edge_list, edge_unpack_list));
     }
 
     void LoadNodeAndEdgeInformation()
     {
         const auto coordinate_list_ptr = data_layout->GetBlockPtr<util::Coordinate>(
-            shared_memory, storage::SharedDataLayout::COORDINATE_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::COORDINATE_LIST);
         m_coordinate_list.reset(
             coordinate_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::COORDINATE_LIST]);
@@ -198,7 +219,7 @@ class SharedDataFacade final : public BaseDataFacade
         }
 
         const auto osmnodeid_list_ptr = data_layout->GetBlockPtr<std::uint64_t>(
-            shared_memory, storage::SharedDataLayout::OSM_NODE_ID_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::OSM_NODE_ID_LIST);
         m_osmnodeid_list.reset(
             osmnodeid_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::OSM_NODE_ID_LIST]);
@@ -207,20 +228,20 @@ class SharedDataFacade final : public BaseDataFacade
             data_layout->num_entries[storage::SharedDataLayout::COORDINATE_LIST]);
 
         const auto travel_mode_list_ptr = data_layout->GetBlockPtr<extractor::TravelMode>(
-            shared_memory, storage::SharedDataLayout::TRAVEL_MODE);
+            shared_memory, mapped_memory, storage::SharedDataLayout::TRAVEL_MODE);
         util::ShM<extractor::TravelMode, true>::vector travel_mode_list(
             travel_mode_list_ptr, data_layout->num_entries[storage::SharedDataLayout::TRAVEL_MODE]);
         m_travel_mode_list = std::move(travel_mode_list);
 
         const auto lane_data_id_ptr = data_layout->GetBlockPtr<LaneDataID>(
-            shared_memory, storage::SharedDataLayout::LANE_DATA_ID);
+            shared_memory, mapped_memory, storage::SharedDataLayout::LANE_DATA_ID);
         util::ShM<LaneDataID, true>::vector lane_data_id(
             lane_data_id_ptr, data_layout->num_entries[storage::SharedDataLayout::LANE_DATA_ID]);
         m_lane_data_id = std::move(lane_data_id);
 
         const auto lane_tupel_id_pair_ptr =
             data_layout->GetBlockPtr<util::guidance::LaneTupleIdPair>(
-                shared_memory, storage::SharedDataLayout::TURN_LANE_DATA);
+                shared_memory, mapped_memory, storage::SharedDataLayout::TURN_LANE_DATA);
         util::ShM<util::guidance::LaneTupleIdPair, true>::vector lane_tupel_id_pair(
             lane_tupel_id_pair_ptr,
             data_layout->num_entries[storage::SharedDataLayout::TURN_LANE_DATA]);
@@ -228,34 +249,34 @@ class SharedDataFacade final : public BaseDataFacade
 
         const auto turn_instruction_list_ptr =
             data_layout->GetBlockPtr<extractor::guidance::TurnInstruction>(
-                shared_memory, storage::SharedDataLayout::TURN_INSTRUCTION);
+                shared_memory, mapped_memory, storage::SharedDataLayout::TURN_INSTRUCTION);
         util::ShM<extractor::guidance::TurnInstruction, true>::vector turn_instruction_list(
             turn_instruction_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::TURN_INSTRUCTION]);
         m_turn_instruction_list = std::move(turn_instruction_list);
 
         const auto name_id_list_ptr = data_layout->GetBlockPtr<unsigned>(
-            shared_memory, storage::SharedDataLayout::NAME_ID_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::NAME_ID_LIST);
         util::ShM<unsigned, true>::vector name_id_list(
             name_id_list_ptr, data_layout->num_entries[storage::SharedDataLayout::NAME_ID_LIST]);
         m_name_ID_list = std::move(name_id_list);
 
         const auto entry_class_id_list_ptr = data_layout->GetBlockPtr<EntryClassID>(
-            shared_memory, storage::SharedDataLayout::ENTRY_CLASSID);
+            shared_memory, mapped_memory, storage::SharedDataLayout::ENTRY_CLASSID);
         typename util::ShM<EntryClassID, true>::vector entry_class_id_list(
             entry_class_id_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::ENTRY_CLASSID]);
         m_entry_class_id_list = std::move(entry_class_id_list);
 
         const auto pre_turn_bearing_ptr = data_layout->GetBlockPtr<util::guidance::TurnBearing>(
-            shared_memory, storage::SharedDataLayout::PRE_TURN_BEARING);
+            shared_memory, mapped_memory, storage::SharedDataLayout::PRE_TURN_BEARING);
         typename util::ShM<util::guidance::TurnBearing, true>::vector pre_turn_bearing(
             pre_turn_bearing_ptr,
             data_layout->num_entries[storage::SharedDataLayout::PRE_TURN_BEARING]);
         m_pre_turn_bearing = std::move(pre_turn_bearing);
 
         const auto post_turn_bearing_ptr = data_layout->GetBlockPtr<util::guidance::TurnBearing>(
-            shared_memory, storage::SharedDataLayout::POST_TURN_BEARING);
+            shared_memory, mapped_memory, storage::SharedDataLayout::POST_TURN_BEARING);
         typename util::ShM<util::guidance::TurnBearing, true>::vector post_turn_bearing(
             post_turn_bearing_ptr,
             data_layout->num_entries[storage::SharedDataLayout::POST_TURN_BEARING]);
@@ -265,7 +286,7 @@ class SharedDataFacade final : public BaseDataFacade
     void LoadViaNodeList()
     {
         auto via_geometry_list_ptr = data_layout->GetBlockPtr<GeometryID>(
-            shared_memory, storage::SharedDataLayout::VIA_NODE_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::VIA_NODE_LIST);
         util::ShM<GeometryID, true>::vector via_geometry_list(
             via_geometry_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::VIA_NODE_LIST]);
@@ -275,16 +296,16 @@ class SharedDataFacade final : public BaseDataFacade
     void LoadNames()
     {
         auto offsets_ptr = data_layout->GetBlockPtr<unsigned>(
-            shared_memory, storage::SharedDataLayout::NAME_OFFSETS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::NAME_OFFSETS);
         auto blocks_ptr = data_layout->GetBlockPtr<IndexBlock>(
-            shared_memory, storage::SharedDataLayout::NAME_BLOCKS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::NAME_BLOCKS);
         util::ShM<unsigned, true>::vector name_offsets(
             offsets_ptr, data_layout->num_entries[storage::SharedDataLayout::NAME_OFFSETS]);
         util::ShM<IndexBlock, true>::vector name_blocks(
             blocks_ptr, data_layout->num_entries[storage::SharedDataLayout::NAME_BLOCKS]);
 
         auto names_list_ptr = data_layout->GetBlockPtr<char>(
-            shared_memory, storage::SharedDataLayout::NAME_CHAR_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::NAME_CHAR_LIST);
         util::ShM<char, true>::vector names_char_list(
             names_list_ptr, data_layout->num_entries[storage::SharedDataLayout::NAME_CHAR_LIST]);
         m_name_table = std::make_unique<util::RangeTable<16, true>>(
@@ -296,14 +317,14 @@ class SharedDataFacade final : public BaseDataFacade
     void LoadTurnLaneDescriptions()
     {
         auto offsets_ptr = data_layout->GetBlockPtr<std::uint32_t>(
-            shared_memory, storage::SharedDataLayout::LANE_DESCRIPTION_OFFSETS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::LANE_DESCRIPTION_OFFSETS);
         util::ShM<std::uint32_t, true>::vector offsets(
             offsets_ptr,
             data_layout->num_entries[storage::SharedDataLayout::LANE_DESCRIPTION_OFFSETS]);
         m_lane_description_offsets = std::move(offsets);
 
         auto masks_ptr = data_layout->GetBlockPtr<extractor::guidance::TurnLaneType::Mask>(
-            shared_memory, storage::SharedDataLayout::LANE_DESCRIPTION_MASKS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::LANE_DESCRIPTION_MASKS);
 
         util::ShM<extractor::guidance::TurnLaneType::Mask, true>::vector masks(
             masks_ptr, data_layout->num_entries[storage::SharedDataLayout::LANE_DESCRIPTION_MASKS]);
@@ -313,65 +334,100 @@ class SharedDataFacade final : public BaseDataFacade
     void LoadCoreInformation()
     {
         auto core_marker_ptr = data_layout->GetBlockPtr<unsigned>(
-            shared_memory, storage::SharedDataLayout::CORE_MARKER);
+            shared_memory, mapped_memory, storage::SharedDataLayout::CORE_MARKER);
         util::ShM<bool, true>::vector is_core_node(
             core_marker_ptr, data_layout->num_entries[storage::SharedDataLayout::CORE_MARKER]);
         m_is_core_node = std::move(is_core_node);
     }
 
+    void LoadMultiLevelPartition()
+    {
+        auto partition_ptr = data_layout->GetBlockPtr<std::uint32_t>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::MLD_PARTITION);
+        util::ShM<std::uint32_t, true>::vector partition_ids(
+            partition_ptr, data_layout->num_entries[storage::SharedDataLayout::MLD_PARTITION]);
+
+        auto level_shifts_ptr = data_layout->GetBlockPtr<std::uint8_t>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::MLD_LEVEL_SHIFTS);
+        util::ShM<std::uint8_t, true>::vector level_shifts(
+            level_shifts_ptr,
+            data_layout->num_entries[storage::SharedDataLayout::MLD_LEVEL_SHIFTS]);
+
+        m_partition = contractor::MultiLevelPartition<true>(std::move(partition_ids),
+                                                            std::move(level_shifts));
+
+        auto cells_ptr = data_layout->GetBlockPtr<contractor::CellData>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::MLD_CELLS);
+        util::ShM<contractor::CellData, true>::vector cells(
+            cells_ptr, data_layout->num_entries[storage::SharedDataLayout::MLD_CELLS]);
+
+        auto boundary_ptr = data_layout->GetBlockPtr<NodeID>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::MLD_CELL_BOUNDARY);
+        util::ShM<NodeID, true>::vector boundary_nodes(
+            boundary_ptr, data_layout->num_entries[storage::SharedDataLayout::MLD_CELL_BOUNDARY]);
+
+        auto weights_ptr = data_layout->GetBlockPtr<EdgeWeight>(
+            shared_memory, mapped_memory, storage::SharedDataLayout::MLD_CELL_WEIGHTS);
+        util::ShM<EdgeWeight, true>::vector weights(
+            weights_ptr, data_layout->num_entries[storage::SharedDataLayout::MLD_CELL_WEIGHTS]);
+
+        m_cell_storage = contractor::CellStorage<true>(
+            m_partition, std::move(cells), std::move(boundary_nodes), std::move(weights));
+    }
+
     void LoadGeometries()
     {
         auto geometries_index_ptr = data_layout->GetBlockPtr<unsigned>(
-            shared_memory, storage::SharedDataLayout::GEOMETRIES_INDEX);
+            shared_memory, mapped_memory, storage::SharedDataLayout::GEOMETRIES_INDEX);
         util::ShM<unsigned, true>::vector geometry_begin_indices(
             geometries_index_ptr,
             data_layout->num_entries[storage::SharedDataLayout::GEOMETRIES_INDEX]);
         m_geometry_indices = std::move(geometry_begin_indices);
 
         auto geometries_node_list_ptr = data_layout->GetBlockPtr<NodeID>(
-            shared_memory, storage::SharedDataLayout::GEOMETRIES_NODE_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::GEOMETRIES_NODE_LIST);
         util::ShM<NodeID, true>::vector geometry_node_list(
             geometries_node_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::GEOMETRIES_NODE_LIST]);
         m_geometry_node_list = std::move(geometry_node_list);
 
         auto geometries_fwd_weight_list_ptr = data_layout->GetBlockPtr<EdgeWeight>(
-            shared_memory, storage::SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
         util::ShM<EdgeWeight, true>::vector geometry_fwd_weight_list(
             geometries_fwd_weight_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST]);
         m_geometry_fwd_weight_list = std::move(geometry_fwd_weight_list);
 
         auto geometries_rev_weight_list_ptr = data_layout->GetBlockPtr<EdgeWeight>(
-            shared_memory, storage::SharedDataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::GEOMETRIES_REV_WEIGHT_LIST);
         util::ShM<EdgeWeight, true>::vector geometry_rev_weight_list(
             geometries_rev_weight_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::GEOMETRIES_REV_WEIGHT_LIST]);
         m_geometry_rev_weight_list = std::move(geometry_rev_weight_list);
 
         auto datasources_list_ptr = data_layout->GetBlockPtr<uint8_t>(
-            shared_memory, storage::SharedDataLayout::DATASOURCES_LIST);
+            shared_memory, mapped_memory, storage::SharedDataLayout::DATASOURCES_LIST);
         util::ShM<uint8_t, true>::vector datasources_list(
             datasources_list_ptr,
             data_layout->num_entries[storage::SharedDataLayout::DATASOURCES_LIST]);
         m_datasource_list = std::move(datasources_list);
 
         auto datasource_name_data_ptr = data_layout->GetBlockPtr<char>(
-            shared_memory, storage::SharedDataLayout::DATASOURCE_NAME_DATA);
+            shared_memory, mapped_memory, storage::SharedDataLayout::DATASOURCE_NAME_DATA);
         util::ShM<char, true>::vector datasource_name_data(
             datasource_name_data_ptr,
             data_layout->num_entries[storage::SharedDataLayout::DATASOURCE_NAME_DATA]);
         m_datasource_name_data = std::move(datasource_name_data);
 
         auto datasource_name_offsets_ptr = data_layout->GetBlockPtr<std::size_t>(
-            shared_memory, storage::SharedDataLayout::DATASOURCE_NAME_OFFSETS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::DATASOURCE_NAME_OFFSETS);
         util::ShM<std::size_t, true>::vector datasource_name_offsets(
             datasource_name_offsets_ptr,
             data_layout->num_entries[storage::SharedDataLayout::DATASOURCE_NAME_OFFSETS]);
         m_datasource_name_offsets = std::move(datasource_name_offsets);
 
         auto datasource_name_lengths_ptr = data_layout->GetBlockPtr<std::size_t>(
-            shared_memory, storage::SharedDataLayout::DATASOURCE_NAME_LENGTHS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::DATASOURCE_NAME_LENGTHS);
         util::ShM<std::size_t, true>::vector datasource_name_lengths(
             datasource_name_lengths_ptr,
             data_layout->num_entries[storage::SharedDataLayout::DATASOURCE_NAME_LENGTHS]);
@@ -381,22 +437,22 @@ class SharedDataFacade final : public BaseDataFacade
     void LoadIntersectionClasses()
     {
         auto bearing_class_id_ptr = data_layout->GetBlockPtr<BearingClassID>(
-            shared_memory, storage::SharedDataLayout::BEARING_CLASSID);
+            shared_memory, mapped_memory, storage::SharedDataLayout::BEARING_CLASSID);
         typename util::ShM<BearingClassID, true>::vector bearing_class_id_table(
             bearing_class_id_ptr,
             data_layout->num_entries[storage::SharedDataLayout::BEARING_CLASSID]);
         m_bearing_class_id_table = std::move(bearing_class_id_table);
 
         auto bearing_class_ptr = data_layout->GetBlockPtr<DiscreteBearing>(
-            shared_memory, storage::SharedDataLayout::BEARING_VALUES);
+            shared_memory, mapped_memory, storage::SharedDataLayout::BEARING_VALUES);
         typename util::ShM<DiscreteBearing, true>::vector bearing_class_table(
             bearing_class_ptr, data_layout->num_entries[storage::SharedDataLayout::BEARING_VALUES]);
         m_bearing_values_table = std::move(bearing_class_table);
 
         auto offsets_ptr = data_layout->GetBlockPtr<unsigned>(
-            shared_memory, storage::SharedDataLayout::BEARING_OFFSETS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::BEARING_OFFSETS);
         auto blocks_ptr = data_layout->GetBlockPtr<IndexBlock>(
-            shared_memory, storage::SharedDataLayout::BEARING_BLOCKS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::BEARING_BLOCKS);
         util::ShM<unsigned, true>::vector bearing_offsets(
             offsets_ptr, data_layout->num_entries[storage::SharedDataLayout::BEARING_OFFSETS]);
         util::ShM<IndexBlock, true>::vector bearing_blocks(
@@ -406,7 +462,7 @@ class SharedDataFacade final : public BaseDataFacade
             bearing_offsets, bearing_blocks, static_cast<unsigned>(m_bearing_values_table.size()));
 
         auto entry_class_ptr = data_layout->GetBlockPtr<util::guidance::EntryClass>(
-            shared_memory, storage::SharedDataLayout::ENTRY_CLASS);
+            shared_memory, mapped_memory, storage::SharedDataLayout::ENTRY_CLASS);
         typename util::ShM<util::guidance::EntryClass, true>::vector entry_class_table(
             entry_class_ptr, data_layout->num_entries[storage::SharedDataLayout::ENTRY_CLASS]);
         m_entry_class_table = std::move(entry_class_table);
@@ -422,6 +478,13 @@ class SharedDataFacade final : public BaseDataFacade
                                            : shared_barriers->regions_2_mutex,
             boost::interprocess::defer_lock);
 
+#ifdef __linux__
+        if (lock_memory)
+        {
+            (void)munlock(shared_memory, data_layout->GetSizeOfLayout());
+        }
+#endif
+
         // if this returns false this is still in use
         if (exclusive_lock.try_lock())
         {
@@ -442,6 +505,8 @@ class SharedDataFacade final : public BaseDataFacade
             {
                 storage::SharedMemory::Remove(data_region);
                 storage::SharedMemory::Remove(layout_region);
+                boost::system::error_code ec;
+                boost::filesystem::remove(storage::mappedBlocksPath(data_region), ec);
             }
         }
     }
@@ -449,9 +514,11 @@ class SharedDataFacade final : public BaseDataFacade
     SharedDataFacade(const std::shared_ptr<storage::SharedBarriers> &shared_barriers_,
                      storage::SharedDataType layout_region_,
                      storage::SharedDataType data_region_,
-                     unsigned shared_timestamp_)
+                     unsigned shared_timestamp_,
+                     const bool lock_memory_)
         : shared_barriers(shared_barriers_), layout_region(layout_region_),
-          data_region(data_region_), shared_timestamp(shared_timestamp_)
+          data_region(data_region_), shared_timestamp(shared_timestamp_),
+          lock_memory(lock_memory_)
     {
         util::SimpleLogger().Write(logDEBUG) << "Loading new data with shared timestamp "
                                              << shared_timestamp;
@@ -464,6 +531,26 @@ class SharedDataFacade final : public BaseDataFacade
         BOOST_ASSERT(storage::SharedMemory::RegionExists(data_region));
         m_large_memory = storage::makeSharedMemory(data_region);
         shared_memory = (char *)(m_large_memory->Ptr());
+#ifdef __linux__
+        // Only the pinned blocks are locked. osrm-routed does not lock future mappings, that
+        // would fault in and pin the file mapping of the evictable blocks as well.
+        if (lock_memory && -1 == mlock(shared_memory, data_layout->GetSizeOfLayout()))
+        {
+            util::SimpleLogger().Write(logWARNING) << "could not lock shared memory to RAM";
+            lock_memory = false;
+        }
+#endif
+
+        mapped_memory = nullptr;
+        if (data_layout->GetSizeOfLayout(storage::BlockResidency::Mapped) > 0)
+        {
+            const boost::interprocess::file_mapping mapped_blocks_file(
+                storage::mappedBlocksPath(data_region).string().c_str(),
+                boost::interprocess::read_only);
+            m_mapped_blocks = boost::interprocess::mapped_region(mapped_blocks_file,
+                                                                 boost::interprocess::read_only);
+            mapped_memory = static_cast<char *>(m_mapped_blocks.get_address());
+        }
 
         LoadGraph();
         LoadChecksum();
@@ -474,6 +561,7 @@ class SharedDataFacade final : public BaseDataFacade
         LoadNames();
         LoadTurnLaneDescriptions();
         LoadCoreInformation();
+        LoadMultiLevelPartition();
         LoadProfileProperties();
         LoadRTree();
         LoadIntersectionClasses();
@@ -491,11 +579,16 @@ class SharedDataFacade final : public BaseDataFacade
 
     NodeID GetTarget(const EdgeID e) const override final { return m_query_graph->GetTarget(e); }
 
-    EdgeData &GetEdgeData(const EdgeID e) const override final
+    EdgeData GetEdgeData(const EdgeID e) const override final
     {
         return m_query_graph->GetEdgeData(e);
     }
 
+    EdgeSearchData GetEdgeSearchData(const EdgeID e) const override final
+    {
+        return m_query_graph->GetEdgeSearchData(e);
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -833,6 +926,29 @@ class SharedDataFacade final : public BaseDataFacade
 
     virtual std::size_t GetCoreSize() const override final { return m_is_core_node.size(); }
 
+    contractor::LevelID GetNumberOfLevels() const override final
+    {
+        return m_partition.GetNumberOfLevels();
+    }
+
+    contractor::CellID GetCellID(const contractor::LevelID level,
+                                 const NodeID node) const override final
+    {
+        return m_partition.GetCell(level, node);
+    }
+
+    contractor::LevelID GetHighestDifferentLevel(const NodeID first,
+                                                 const NodeID second) const override final
+    {
+        return m_partition.GetHighestDifferentLevel(first, second);
+    }
+
+    contractor::Cell GetCell(const contractor::LevelID level,
+                             const contractor::CellID cell) const override final
+    {
+        return m_cell_storage.GetCell(level, cell);
+    }
+
     // Returns the data source ids that were used to supply the edge
     // weights.
     virtual std::vector<uint8_t>
@@ -926,6 +1042,30 @@ class SharedDataFacade final : public BaseDataFacade
 
     std::string GetTimestamp() const override final { return m_timestamp; }
 
+    std::vector<MemoryBlock> GetMemoryBlocks() const override final
+    {
+        std::vector<MemoryBlock> blocks;
+        for (auto bid = 0; bid < storage::SharedDataLayout::NUM_BLOCKS; ++bid)
+        {
+            const auto block_id = static_cast<storage::SharedDataLayout::BlockID>(bid);
+            const auto location =
+                data_layout->residency[block_id] == storage::BlockResidency::Pinned
+                    ? MemoryBlock::Location::SharedMemory
+                    : MemoryBlock::Location::MappedFile;
+            const auto block_ptr =
+                data_layout->GetBlockPtr<char>(shared_memory, mapped_memory, block_id);
+            blocks.push_back({storage::block_id_to_name[block_id],
+                              block_ptr,
+                              data_layout->GetBlockSize(block_id),
+                              location});
+        }
+        blocks.push_back({"R_TREE_LEAVES",
+                          m_static_rtree->GetLeavesMemory().first,
+                          m_static_rtree->GetLeavesMemory().second,
+                          MemoryBlock::Location::MappedFile});
+        return blocks;
+    }
+
     bool GetContinueStraightDefault() const override final
     {
         return m_profile_properties->continue_straight_at_waypoint;
@@ -46,6 +46,7 @@ class Engine final
     Status Trip(const api::TripParameters &parameters, util::json::Object &result) const;
     Status Match(const api::MatchParameters &parameters, util::json::Object &result) const;
     Status Tile(const api::TileParameters &parameters, std::string &result) const;
+    Status MemoryReport(util::json::Object &result) const;
 
   private:
     std::unique_ptr<storage::SharedBarriers> lock;
@@ -31,8 +31,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "storage/storage_config.hpp"
 
 #include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
 
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -40,6 +42,20 @@ namespace osrm
 namespace engine
 {
 
+// The services an instance answers
+enum class ServiceName
+{
+    Route,
+    Table,
+    Nearest,
+    Trip,
+    Match,
+    Tile
+};
+
+// Parses the name of a service as used in request URLs, none for unknown names
+boost::optional<ServiceName> ParseServiceName(const std::string &name);
+
 /**
  * Configures an OSRM instance.
  *
@@ -53,7 +69,20 @@ namespace engine
  *  - Match
  *  - Nearest
  *
- * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * In addition, shared memory can be used for datasets loaded with osrm-datastore. With
+ * lock_memory the pinned blocks of these datasets are locked to RAM.
+ *
+ * Datasets loaded into process memory can be backed by transparent huge pages.
+ *
+ * The query heaps of each thread keep their memory between queries. A heap that holds more than
+ * max_heap_size MiB (-1 for unlimited) when the next query starts is released.
+ *
+ * The services an instance is expected to answer (route, table, nearest, trip, match, tile) can
+ * be listed. Data that only other services use is not loaded on startup but on first use.
+ * An empty list loads everything on startup.
+ *
+ * The algorithm has to match the preprocessing of the dataset: CH for contracted datasets,
+ * MLD for datasets partitioned by osrm-contract --mld.
  *
  * \see OSRM, StorageConfig
  */
@@ -61,13 +90,26 @@ struct EngineConfig final
 {
     bool IsValid() const;
 
+    enum class Algorithm
+    {
+        // Contraction Hierarchies, including the core and customizable variants
+        CH,
+        // Multi-Level Dijkstra on a multi-level partition
+        MLD
+    };
+
     storage::StorageConfig storage_config;
     int max_locations_trip = -1;
     int max_locations_viaroute = -1;
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
+    int max_heap_size = -1;
     bool use_shared_memory = true;
+    bool lock_memory = false;
+    bool use_huge_pages = false;
+    std::vector<std::string> services;
+    Algorithm algorithm = Algorithm::CH;
 };
 }
 }
@@ -26,6 +26,8 @@ class MatchPlugin : public BasePlugin
     using CandidateLists = routing_algorithms::CandidateLists;
     static const constexpr double DEFAULT_GPS_PRECISION = 5;
     static const constexpr double RADIUS_MULTIPLIER = 3;
+    static const constexpr datafacade::DataFamily::Mask REQUIRED_DATA =
+        datafacade::DataFamily::all;
 
     MatchPlugin(const int max_locations_map_matching)
         : map_matching(heaps, DEFAULT_GPS_PRECISION), shortest_path(heaps),
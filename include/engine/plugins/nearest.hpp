@@ -15,6 +15,9 @@ namespace plugins
 class NearestPlugin final : public BasePlugin
 {
   public:
+    static const constexpr datafacade::DataFamily::Mask REQUIRED_DATA =
+        datafacade::DataFamily::names;
+
     explicit NearestPlugin(const int max_results);
 
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
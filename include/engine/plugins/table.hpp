@@ -18,6 +18,9 @@ namespace plugins
 class TablePlugin final : public BasePlugin
 {
   public:
+    static const constexpr datafacade::DataFamily::Mask REQUIRED_DATA =
+        datafacade::DataFamily::names;
+
     explicit TablePlugin(const int max_locations_distance_table);
 
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
@@ -26,6 +26,9 @@ namespace plugins
 class TilePlugin final : public BasePlugin
 {
   public:
+    static const constexpr datafacade::DataFamily::Mask REQUIRED_DATA =
+        datafacade::DataFamily::names;
+
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                          const api::TileParameters &parameters,
                          std::string &pbf_buffer) const;
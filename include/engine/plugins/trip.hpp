@@ -39,6 +39,9 @@ class TripPlugin final : public BasePlugin
                                      const std::vector<NodeID> &trip) const;
 
   public:
+    static const constexpr datafacade::DataFamily::Mask REQUIRED_DATA =
+        datafacade::DataFamily::all;
+
     explicit TripPlugin(const int max_locations_trip_)
         : shortest_path(heaps), duration_table(heaps), max_locations_trip(max_locations_trip_)
     {
@@ -36,6 +36,9 @@ class ViaRoutePlugin final : public BasePlugin
     const int max_locations_viaroute;
 
   public:
+    static const constexpr datafacade::DataFamily::Mask REQUIRED_DATA =
+        datafacade::DataFamily::all;
+
     explicit ViaRoutePlugin(int max_locations_viaroute);
 
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
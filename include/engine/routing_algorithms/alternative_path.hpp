@@ -487,7 +487,7 @@ class AlternativeRouting final
             {
                 EdgeID edgeID = facade.FindEdgeInEitherDirection(packed_s_v_path[current_node],
                                                                  packed_s_v_path[current_node + 1]);
-                *sharing_of_via_path += facade.GetEdgeData(edgeID).weight;
+                *sharing_of_via_path += facade.GetEdgeSearchData(edgeID).weight;
             }
             else
             {
@@ -520,7 +520,7 @@ class AlternativeRouting final
             EdgeID selected_edge =
                 facade.FindEdgeInEitherDirection(partially_unpacked_via_path[current_node],
                                                  partially_unpacked_via_path[current_node + 1]);
-            *sharing_of_via_path += facade.GetEdgeData(selected_edge).weight;
+            *sharing_of_via_path += facade.GetEdgeSearchData(selected_edge).weight;
         }
 
         // Second, partially unpack v-->t in reverse order until paths deviate and note lengths
@@ -535,7 +535,7 @@ class AlternativeRouting final
             {
                 EdgeID edgeID = facade.FindEdgeInEitherDirection(
                     packed_v_t_path[via_path_index - 1], packed_v_t_path[via_path_index]);
-                *sharing_of_via_path += facade.GetEdgeData(edgeID).weight;
+                *sharing_of_via_path += facade.GetEdgeSearchData(edgeID).weight;
             }
             else
             {
@@ -567,7 +567,7 @@ class AlternativeRouting final
                 EdgeID edgeID = facade.FindEdgeInEitherDirection(
                     partially_unpacked_via_path[via_path_index - 1],
                     partially_unpacked_via_path[via_path_index]);
-                *sharing_of_via_path += facade.GetEdgeData(edgeID).weight;
+                *sharing_of_via_path += facade.GetEdgeSearchData(edgeID).weight;
             }
             else
             {
@@ -690,7 +690,7 @@ class AlternativeRouting final
 
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const EdgeData &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetEdgeSearchData(edge);
             const bool edge_is_forward_directed =
                 (is_forward_directed ? data.forward : data.backward);
             if (edge_is_forward_directed)
@@ -812,7 +812,7 @@ class AlternativeRouting final
         {
             const EdgeID current_edge_id =
                 facade.FindEdgeInEitherDirection(packed_s_v_path[i - 1], packed_s_v_path[i]);
-            const int length_of_current_edge = facade.GetEdgeData(current_edge_id).weight;
+            const int length_of_current_edge = facade.GetEdgeSearchData(current_edge_id).weight;
             if ((length_of_current_edge + unpacked_until_weight) >= T_threshold)
             {
                 unpack_stack.emplace(packed_s_v_path[i - 1], packed_s_v_path[i]);
@@ -843,7 +843,8 @@ class AlternativeRouting final
                 const NodeID via_path_middle_node_id = current_edge_data.id;
                 const EdgeID second_segment_edge_id =
                     facade.FindEdgeInEitherDirection(via_path_middle_node_id, via_path_edge.second);
-                const int second_segment_length = facade.GetEdgeData(second_segment_edge_id).weight;
+                const int second_segment_length =
+                    facade.GetEdgeSearchData(second_segment_edge_id).weight;
                 // attention: !unpacking in reverse!
                 // Check if second segment is the one to go over treshold? if yes add second segment
                 // to stack, else push first segment to stack and add weight of second one.
@@ -875,7 +876,7 @@ class AlternativeRouting final
         {
             const EdgeID edgeID =
                 facade.FindEdgeInEitherDirection(packed_v_t_path[i], packed_v_t_path[i + 1]);
-            int length_of_current_edge = facade.GetEdgeData(edgeID).weight;
+            int length_of_current_edge = facade.GetEdgeSearchData(edgeID).weight;
             if (length_of_current_edge + unpacked_until_weight >= T_threshold)
             {
                 unpack_stack.emplace(packed_v_t_path[i], packed_v_t_path[i + 1]);
@@ -905,7 +906,7 @@ class AlternativeRouting final
                 const NodeID middleOfViaPath = current_edge_data.id;
                 EdgeID edgeIDOfFirstSegment =
                     facade.FindEdgeInEitherDirection(via_path_edge.first, middleOfViaPath);
-                int lengthOfFirstSegment = facade.GetEdgeData(edgeIDOfFirstSegment).weight;
+                int lengthOfFirstSegment = facade.GetEdgeSearchData(edgeIDOfFirstSegment).weight;
                 // Check if first segment is the one to go over treshold? if yes first segment to
                 // stack, else push second segment to stack and add weight of first one.
                 if (unpacked_until_weight + lengthOfFirstSegment >= T_threshold)
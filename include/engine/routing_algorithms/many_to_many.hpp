@@ -7,9 +7,12 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -40,6 +43,9 @@ class ManyToManyRouting final
     // FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
     using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
 
+    // A core node that the search of a source reached and its weight
+    using CoreEntryPoint = std::pair<NodeID, EdgeWeight>;
+
   public:
     ManyToManyRouting(SearchEngineData &engine_working_data)
         : engine_working_data(engine_working_data)
@@ -61,10 +67,30 @@ class ManyToManyRouting final
 
         engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
 
+        if (facade.GetNumberOfLevels() > 0)
+        {
+            engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            MultiLevelTable(facade, phantom_nodes, source_indices, target_indices, result_table);
+            return result_table;
+        }
+
         QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
 
         SearchSpaceWithBuckets search_space_with_buckets;
 
+        // With an uncontracted core the searches of the hierarchy stop at the core nodes. The
+        // core nodes reached by the target searches get buckets of their own and every source
+        // continues with a Dijkstra search in the core from the core nodes it reached.
+        const bool use_core = facade.GetCoreSize() > 0;
+        SearchSpaceWithBuckets core_entries_with_buckets;
+        std::vector<CoreEntryPoint> core_entry_points;
+        if (use_core)
+        {
+            engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+                facade.GetNumberOfNodes());
+        }
+
         unsigned column_idx = 0;
         const auto search_target_phantom = [&](const PhantomNode &phantom) {
             query_heap.Clear();
@@ -86,6 +112,13 @@ class ManyToManyRouting final
             // explore search space
             while (!query_heap.Empty())
             {
+                if (use_core && facade.IsCoreNode(query_heap.Min()))
+                {
+                    const NodeID node = query_heap.DeleteMin();
+                    core_entries_with_buckets[node].emplace_back(column_idx,
+                                                                 query_heap.GetKey(node));
+                    continue;
+                }
                 BackwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets);
             }
             ++column_idx;
@@ -111,8 +144,15 @@ class ManyToManyRouting final
             }
 
             // explore search space
+            core_entry_points.clear();
             while (!query_heap.Empty())
             {
+                if (use_core && facade.IsCoreNode(query_heap.Min()))
+                {
+                    const NodeID node = query_heap.DeleteMin();
+                    core_entry_points.emplace_back(node, query_heap.GetKey(node));
+                    continue;
+                }
                 ForwardRoutingStep(facade,
                                    row_idx,
                                    number_of_targets,
@@ -120,6 +160,16 @@ class ManyToManyRouting final
                                    search_space_with_buckets,
                                    result_table);
             }
+
+            if (!core_entry_points.empty() && !core_entries_with_buckets.empty())
+            {
+                CoreSearch(facade,
+                           row_idx,
+                           number_of_targets,
+                           core_entry_points,
+                           core_entries_with_buckets,
+                           result_table);
+            }
             ++row_idx;
         };
 
@@ -158,6 +208,164 @@ class ManyToManyRouting final
         return result_table;
     }
 
+    // The backward searches of the buckets would cover the whole base graph of a multi-level
+    // dataset. Instead every source runs one forward search on the overlay until it settled the
+    // nodes of all targets. The cells that contain a target are entered on the levels below, so
+    // the weights of the targets are exact.
+    void MultiLevelTable(const DataFacadeT &facade,
+                         const std::vector<PhantomNode> &phantom_nodes,
+                         const std::vector<std::size_t> &source_indices,
+                         const std::vector<std::size_t> &target_indices,
+                         std::vector<EdgeWeight> &result_table) const
+    {
+        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+
+        const auto get_phantom = [&phantom_nodes](const std::vector<std::size_t> &indices,
+                                                  const std::size_t index) -> const PhantomNode & {
+            return indices.empty() ? phantom_nodes[index] : phantom_nodes[indices[index]];
+        };
+        const auto number_of_sources =
+            source_indices.empty() ? phantom_nodes.size() : source_indices.size();
+        const auto number_of_targets =
+            target_indices.empty() ? phantom_nodes.size() : target_indices.size();
+
+        // the nodes of the targets with the weight from the node to the target
+        SearchSpaceWithBuckets target_buckets;
+        std::vector<NodeID> target_nodes;
+        for (std::size_t column_idx = 0; column_idx < number_of_targets; ++column_idx)
+        {
+            const auto &target = get_phantom(target_indices, column_idx);
+            if (target.forward_segment_id.enabled)
+            {
+                target_buckets[target.forward_segment_id.id].emplace_back(
+                    column_idx, target.GetForwardWeightPlusOffset());
+                target_nodes.push_back(target.forward_segment_id.id);
+            }
+            if (target.reverse_segment_id.enabled)
+            {
+                target_buckets[target.reverse_segment_id.id].emplace_back(
+                    column_idx, target.GetReverseWeightPlusOffset());
+                target_nodes.push_back(target.reverse_segment_id.id);
+            }
+        }
+
+        std::vector<NodeID> search_nodes;
+        std::vector<std::size_t> loop_columns;
+        for (std::size_t row_idx = 0; row_idx < number_of_sources; ++row_idx)
+        {
+            const auto &source = get_phantom(source_indices, row_idx);
+            query_heap.Clear();
+            search_nodes = target_nodes;
+            if (source.forward_segment_id.enabled)
+            {
+                query_heap.Insert(source.forward_segment_id.id,
+                                  -source.GetForwardWeightPlusOffset(),
+                                  source.forward_segment_id.id);
+                search_nodes.push_back(source.forward_segment_id.id);
+            }
+            if (source.reverse_segment_id.enabled)
+            {
+                query_heap.Insert(source.reverse_segment_id.id,
+                                  -source.GetReverseWeightPlusOffset(),
+                                  source.reverse_segment_id.id);
+                search_nodes.push_back(source.reverse_segment_id.id);
+            }
+
+            auto unsettled_targets = target_buckets.size();
+            loop_columns.clear();
+            while (!query_heap.Empty() && unsettled_targets > 0)
+            {
+                const NodeID node = query_heap.DeleteMin();
+                const EdgeWeight weight = query_heap.GetKey(node);
+
+                const auto bucket_iterator = target_buckets.find(node);
+                if (bucket_iterator != target_buckets.end())
+                {
+                    --unsettled_targets;
+                    for (const NodeBucket &bucket : bucket_iterator->second)
+                    {
+                        auto &current_weight =
+                            result_table[row_idx * number_of_targets + bucket.target_id];
+                        const EdgeWeight new_weight = weight + bucket.weight;
+                        if (new_weight < 0)
+                        {
+                            loop_columns.push_back(bucket.target_id);
+                        }
+                        else if (new_weight < current_weight)
+                        {
+                            current_weight = new_weight;
+                        }
+                    }
+                }
+
+                const bool constexpr FORWARD_DIRECTION = true;
+                super::RelaxMultiLevelEdges(
+                    facade, query_heap, search_nodes, node, weight, FORWARD_DIRECTION);
+            }
+
+            // The target lies behind the source on the same segment, the route has to leave
+            // the node and come back. The bidirectional search finds the loop.
+            std::sort(loop_columns.begin(), loop_columns.end());
+            loop_columns.erase(std::unique(loop_columns.begin(), loop_columns.end()),
+                               loop_columns.end());
+            for (const auto column_idx : loop_columns)
+            {
+                result_table[row_idx * number_of_targets + column_idx] =
+                    LoopWeight(facade, source, get_phantom(target_indices, column_idx));
+            }
+        }
+    }
+
+    EdgeWeight LoopWeight(const DataFacadeT &facade,
+                          const PhantomNode &source,
+                          const PhantomNode &target) const
+    {
+        QueryHeap &forward_heap = *(engine_working_data.forward_heap_2);
+        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_2);
+        forward_heap.Clear();
+        reverse_heap.Clear();
+
+        if (source.forward_segment_id.enabled)
+        {
+            forward_heap.Insert(source.forward_segment_id.id,
+                                -source.GetForwardWeightPlusOffset(),
+                                source.forward_segment_id.id);
+        }
+        if (source.reverse_segment_id.enabled)
+        {
+            forward_heap.Insert(source.reverse_segment_id.id,
+                                -source.GetReverseWeightPlusOffset(),
+                                source.reverse_segment_id.id);
+        }
+        if (target.forward_segment_id.enabled)
+        {
+            reverse_heap.Insert(target.forward_segment_id.id,
+                                target.GetForwardWeightPlusOffset(),
+                                target.forward_segment_id.id);
+        }
+        if (target.reverse_segment_id.enabled)
+        {
+            reverse_heap.Insert(target.reverse_segment_id.id,
+                                target.GetReverseWeightPlusOffset(),
+                                target.reverse_segment_id.id);
+        }
+
+        const bool constexpr DO_NOT_FORCE_LOOPS = false;
+        const bool constexpr DO_NOT_RETRIEVE_PATH = false;
+        std::vector<NodeID> packed_leg;
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        super::MultiLevelSearch(facade,
+                                forward_heap,
+                                reverse_heap,
+                                weight,
+                                packed_leg,
+                                DO_NOT_FORCE_LOOPS,
+                                DO_NOT_FORCE_LOOPS,
+                                INVALID_EDGE_WEIGHT,
+                                DO_NOT_RETRIEVE_PATH);
+        return weight;
+    }
+
     void ForwardRoutingStep(const DataFacadeT &facade,
                             const unsigned row_idx,
                             const unsigned number_of_targets,
@@ -168,40 +376,125 @@ class ManyToManyRouting final
         const NodeID node = query_heap.DeleteMin();
         const int source_weight = query_heap.GetKey(node);
 
+        UpdateTableFromBuckets(facade,
+                               row_idx,
+                               number_of_targets,
+                               node,
+                               source_weight,
+                               search_space_with_buckets,
+                               result_table);
+        if (StallAtNode<true>(facade, node, source_weight, query_heap))
+        {
+            return;
+        }
+        RelaxOutgoingEdges<true>(facade, node, source_weight, query_heap);
+    }
+
+    // Dijkstra search in the core from the core nodes that the search of a source reached. Stops
+    // once no bucket can improve the entries of the row anymore.
+    void CoreSearch(const DataFacadeT &facade,
+                    const unsigned row_idx,
+                    const unsigned number_of_targets,
+                    const std::vector<CoreEntryPoint> &core_entry_points,
+                    const SearchSpaceWithBuckets &core_entries_with_buckets,
+                    std::vector<EdgeWeight> &result_table) const
+    {
+        QueryHeap &core_heap = *(engine_working_data.forward_heap_2);
+        core_heap.Clear();
+        for (const auto &entry_point : core_entry_points)
+        {
+            core_heap.Insert(entry_point.first, entry_point.second, entry_point.first);
+        }
+
+        EdgeWeight min_target_weight = INVALID_EDGE_WEIGHT;
+        std::vector<unsigned> core_columns;
+        for (const auto &node_and_buckets : core_entries_with_buckets)
+        {
+            for (const NodeBucket &bucket : node_and_buckets.second)
+            {
+                min_target_weight = std::min(min_target_weight, bucket.weight);
+                core_columns.push_back(bucket.target_id);
+            }
+        }
+        std::sort(core_columns.begin(), core_columns.end());
+        core_columns.erase(std::unique(core_columns.begin(), core_columns.end()),
+                           core_columns.end());
+
+        // the largest entry of a column that can still be improved through the core
+        const auto row_bound = [&]() {
+            EdgeWeight bound = 0;
+            for (const auto column_idx : core_columns)
+            {
+                bound = std::max(bound, result_table[row_idx * number_of_targets + column_idx]);
+            }
+            return bound;
+        };
+
+        EdgeWeight upper_bound = row_bound();
+        while (!core_heap.Empty() &&
+               static_cast<std::int64_t>(core_heap.MinKey()) + min_target_weight < upper_bound)
+        {
+            const NodeID node = core_heap.DeleteMin();
+            const int source_weight = core_heap.GetKey(node);
+
+            if (UpdateTableFromBuckets(facade,
+                                       row_idx,
+                                       number_of_targets,
+                                       node,
+                                       source_weight,
+                                       core_entries_with_buckets,
+                                       result_table))
+            {
+                upper_bound = row_bound();
+            }
+
+            // the core is not contracted, so there is nothing to stall on
+            RelaxOutgoingEdges<true>(facade, node, source_weight, core_heap);
+        }
+    }
+
+    // Combines the weight of a settled node with the buckets of the targets that reached it,
+    // returns whether there were any
+    bool UpdateTableFromBuckets(const DataFacadeT &facade,
+                                const unsigned row_idx,
+                                const unsigned number_of_targets,
+                                const NodeID node,
+                                const EdgeWeight source_weight,
+                                const SearchSpaceWithBuckets &search_space_with_buckets,
+                                std::vector<EdgeWeight> &result_table) const
+    {
         // check if each encountered node has an entry
         const auto bucket_iterator = search_space_with_buckets.find(node);
+        if (bucket_iterator == search_space_with_buckets.end())
+        {
+            return false;
+        }
+
         // iterate bucket if there exists one
-        if (bucket_iterator != search_space_with_buckets.end())
+        const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
+        for (const NodeBucket &current_bucket : bucket_list)
         {
-            const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-            for (const NodeBucket &current_bucket : bucket_list)
+            // get target id from bucket entry
+            const unsigned column_idx = current_bucket.target_id;
+            const int target_weight = current_bucket.weight;
+            auto &current_weight = result_table[row_idx * number_of_targets + column_idx];
+            // check if new weight is better
+            const EdgeWeight new_weight = source_weight + target_weight;
+            if (new_weight < 0)
             {
-                // get target id from bucket entry
-                const unsigned column_idx = current_bucket.target_id;
-                const int target_weight = current_bucket.weight;
-                auto &current_weight = result_table[row_idx * number_of_targets + column_idx];
-                // check if new weight is better
-                const EdgeWeight new_weight = source_weight + target_weight;
-                if (new_weight < 0)
+                const EdgeWeight loop_weight = super::GetLoopWeight(facade, node);
+                const int new_weight_with_loop = new_weight + loop_weight;
+                if (loop_weight != INVALID_EDGE_WEIGHT && new_weight_with_loop >= 0)
                 {
-                    const EdgeWeight loop_weight = super::GetLoopWeight(facade, node);
-                    const int new_weight_with_loop = new_weight + loop_weight;
-                    if (loop_weight != INVALID_EDGE_WEIGHT && new_weight_with_loop >= 0)
-                    {
-                        current_weight = std::min(current_weight, new_weight_with_loop);
-                    }
-                }
-                else if (new_weight < current_weight)
-                {
-                    result_table[row_idx * number_of_targets + column_idx] = new_weight;
+                    current_weight = std::min(current_weight, new_weight_with_loop);
                 }
             }
+            else if (new_weight < current_weight)
+            {
+                current_weight = new_weight;
+            }
         }
-        if (StallAtNode<true>(facade, node, source_weight, query_heap))
-        {
-            return;
-        }
-        RelaxOutgoingEdges<true>(facade, node, source_weight, query_heap);
+        return true;
     }
 
     void BackwardRoutingStep(const DataFacadeT &facade,
@@ -231,7 +524,7 @@ class ManyToManyRouting final
     {
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const auto &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetEdgeSearchData(edge);
             const bool direction_flag = (forward_direction ? data.forward : data.backward);
             if (direction_flag)
             {
@@ -266,7 +559,7 @@ class ManyToManyRouting final
     {
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const auto &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetEdgeSearchData(edge);
             const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
             if (reverse_flag)
             {
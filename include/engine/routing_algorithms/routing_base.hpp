@@ -1,6 +1,7 @@
 #ifndef ROUTING_BASE_HPP
 #define ROUTING_BASE_HPP
 
+#include "contractor/multi_level_partition.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "engine/edge_unpacker.hpp"
 #include "engine/internal_route_result.hpp"
@@ -93,7 +94,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                     // check whether there is a loop present at the node
                     for (const auto edge : facade.GetAdjacentEdgeRange(node))
                     {
-                        const EdgeData &data = facade.GetEdgeData(edge);
+                        const auto &data = facade.GetEdgeSearchData(edge);
                         bool forward_directionFlag =
                             (forward_direction ? data.forward : data.backward);
                         if (forward_directionFlag)
@@ -136,7 +137,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         {
             for (const auto edge : facade.GetAdjacentEdgeRange(node))
             {
-                const EdgeData &data = facade.GetEdgeData(edge);
+                const auto &data = facade.GetEdgeSearchData(edge);
                 const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
                 if (reverse_flag)
                 {
@@ -158,7 +159,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
 
         for (const auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const EdgeData &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetEdgeSearchData(edge);
             bool forward_directionFlag = (forward_direction ? data.forward : data.backward);
             if (forward_directionFlag)
             {
@@ -189,7 +190,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         EdgeWeight loop_weight = INVALID_EDGE_WEIGHT;
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const auto &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetEdgeSearchData(edge);
             if (data.forward)
             {
                 const NodeID to = facade.GetTarget(edge);
@@ -467,6 +468,327 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         }
     }
 
+    // Highest level on which the cell of the node contains none of the nodes the search started
+    // from. The multi-level search only enters the cells of this level through their weights.
+    contractor::LevelID GetQueryLevel(const DataFacadeT &facade,
+                                      const std::vector<NodeID> &search_nodes,
+                                      const NodeID node) const
+    {
+        auto level = facade.GetNumberOfLevels();
+        for (const auto search_node : search_nodes)
+        {
+            level = std::min(level, facade.GetHighestDifferentLevel(search_node, node));
+        }
+        return level;
+    }
+
+    // RoutingStep on the multi-level overlay, see RelaxMultiLevelEdges
+    void MultiLevelRoutingStep(const DataFacadeT &facade,
+                               SearchEngineData::QueryHeap &forward_heap,
+                               SearchEngineData::QueryHeap &reverse_heap,
+                               const std::vector<NodeID> &search_nodes,
+                               NodeID &middle_node_id,
+                               std::int32_t &upper_bound,
+                               const std::int32_t min_edge_offset,
+                               const bool forward_direction,
+                               const bool force_loop_forward,
+                               const bool force_loop_reverse) const
+    {
+        const NodeID node = forward_heap.DeleteMin();
+        const std::int32_t weight = forward_heap.GetKey(node);
+
+        if (reverse_heap.WasInserted(node))
+        {
+            const std::int32_t new_weight = reverse_heap.GetKey(node) + weight;
+            // the base graph has no loop edges, forced loops meet on any other node of the loop
+            const bool forced_loop =
+                (force_loop_forward && forward_heap.GetData(node).parent == node) ||
+                (force_loop_reverse && reverse_heap.GetData(node).parent == node);
+            if (!forced_loop && new_weight >= 0 && new_weight < upper_bound)
+            {
+                middle_node_id = node;
+                upper_bound = new_weight;
+            }
+        }
+
+        BOOST_ASSERT(min_edge_offset <= 0);
+        if (weight + min_edge_offset > upper_bound)
+        {
+            forward_heap.DeleteAll();
+            return;
+        }
+
+        RelaxMultiLevelEdges(facade, forward_heap, search_nodes, node, weight, forward_direction);
+    }
+
+    // Relaxes the overlay of the query level of a settled node: a node that enters a cell of its
+    // query level relaxes the weights to the destinations of the cell, the edges of the base
+    // graph are only relaxed if they leave the cell.
+    void RelaxMultiLevelEdges(const DataFacadeT &facade,
+                              SearchEngineData::QueryHeap &heap,
+                              const std::vector<NodeID> &search_nodes,
+                              const NodeID node,
+                              const std::int32_t weight,
+                              const bool forward_direction) const
+    {
+        const auto relax = [&heap, node](const NodeID to, const std::int32_t to_weight) {
+            if (!heap.WasInserted(to))
+            {
+                heap.Insert(to, to_weight, node);
+            }
+            else if (to_weight < heap.GetKey(to))
+            {
+                heap.GetData(to).parent = node;
+                heap.DecreaseKey(to, to_weight);
+            }
+        };
+
+        const auto level = GetQueryLevel(facade, search_nodes, node);
+        // edges of the base graph leave the cell of the query level, weights of a cell stay in it
+        const NodeID parent = heap.GetData(node).parent;
+        const bool from_cell =
+            parent != node && facade.GetHighestDifferentLevel(parent, node) < level;
+
+        if (level > 0 && !from_cell)
+        {
+            const auto cell = facade.GetCell(level, facade.GetCellID(level, node));
+            if (forward_direction)
+            {
+                const auto source = cell.FindSource(node);
+                for (std::uint32_t destination = 0; source < cell.GetNumberOfSources() &&
+                                                    destination < cell.GetNumberOfDestinations();
+                     ++destination)
+                {
+                    const EdgeWeight cell_weight = cell.GetWeight(source, destination);
+                    if (cell_weight != INVALID_EDGE_WEIGHT)
+                    {
+                        relax(cell.GetDestination(destination), weight + cell_weight);
+                    }
+                }
+            }
+            else
+            {
+                const auto destination = cell.FindDestination(node);
+                for (std::uint32_t source = 0; destination < cell.GetNumberOfDestinations() &&
+                                               source < cell.GetNumberOfSources();
+                     ++source)
+                {
+                    const EdgeWeight cell_weight = cell.GetWeight(source, destination);
+                    if (cell_weight != INVALID_EDGE_WEIGHT)
+                    {
+                        relax(cell.GetSource(source), weight + cell_weight);
+                    }
+                }
+            }
+        }
+
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeSearchData(edge);
+            if (forward_direction ? data.forward : data.backward)
+            {
+                const NodeID to = facade.GetTarget(edge);
+                if (facade.GetHighestDifferentLevel(node, to) >= level)
+                {
+                    BOOST_ASSERT_MSG(data.weight > 0, "edge_weight invalid");
+                    relax(to, weight + data.weight);
+                }
+            }
+        }
+    }
+
+    // Appends the path of the base graph that the weight of the cell from the source to the
+    // destination stands for, without the source. Repeats the search of the customization
+    // inside of the cell and unpacks the weights of the cells below recursively.
+    void UnpackCellPath(const DataFacadeT &facade,
+                        const contractor::LevelID level,
+                        const NodeID source,
+                        const NodeID destination,
+                        SearchEngineData::QueryHeap &heap,
+                        std::vector<NodeID> &unpacked_path) const
+    {
+        BOOST_ASSERT(level > 0);
+        const auto cell_id = facade.GetCellID(level, source);
+        const auto in_same_subcell = [&facade, level](const NodeID first, const NodeID second) {
+            return level > 1 &&
+                   facade.GetCellID(level - 1, first) == facade.GetCellID(level - 1, second);
+        };
+
+        heap.Clear();
+        heap.Insert(source, 0, source);
+        while (!heap.Empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            if (node == destination)
+            {
+                break;
+            }
+            const std::int32_t weight = heap.GetKey(node);
+            const auto relax = [&heap, node](const NodeID to, const std::int32_t to_weight) {
+                if (!heap.WasInserted(to))
+                {
+                    heap.Insert(to, to_weight, node);
+                }
+                else if (to_weight < heap.GetKey(to))
+                {
+                    heap.GetData(to).parent = node;
+                    heap.DecreaseKey(to, to_weight);
+                }
+            };
+
+            const NodeID parent = heap.GetData(node).parent;
+            if (level > 1 && (parent == node || !in_same_subcell(parent, node)))
+            {
+                const auto subcell = facade.GetCell(level - 1, facade.GetCellID(level - 1, node));
+                const auto index = subcell.FindSource(node);
+                for (std::uint32_t subcell_destination = 0;
+                     index < subcell.GetNumberOfSources() &&
+                     subcell_destination < subcell.GetNumberOfDestinations();
+                     ++subcell_destination)
+                {
+                    const EdgeWeight subcell_weight = subcell.GetWeight(index, subcell_destination);
+                    if (subcell_weight != INVALID_EDGE_WEIGHT)
+                    {
+                        relax(subcell.GetDestination(subcell_destination), weight + subcell_weight);
+                    }
+                }
+            }
+
+            for (const auto edge : facade.GetAdjacentEdgeRange(node))
+            {
+                const auto &data = facade.GetEdgeSearchData(edge);
+                const NodeID to = facade.GetTarget(edge);
+                if (data.forward && facade.GetCellID(level, to) == cell_id &&
+                    !in_same_subcell(node, to))
+                {
+                    relax(to, weight + data.weight);
+                }
+            }
+        }
+        BOOST_ASSERT_MSG(heap.WasInserted(destination), "cell weight without a path");
+
+        std::vector<NodeID> path;
+        for (NodeID node = destination; node != source; node = heap.GetData(node).parent)
+        {
+            path.push_back(node);
+        }
+        std::reverse(path.begin(), path.end());
+
+        // the heap is reused by the cells below
+        NodeID previous = source;
+        for (const auto node : path)
+        {
+            if (in_same_subcell(previous, node))
+            {
+                UnpackCellPath(facade, level - 1, previous, node, heap, unpacked_path);
+            }
+            else
+            {
+                unpacked_path.push_back(node);
+            }
+            previous = node;
+        }
+    }
+
+    // Bidirectional Dijkstra on the multi-level overlay of the base graph, takes the same heaps
+    // as Search. The packed leg only consists of nodes of the base graph.
+    void MultiLevelSearch(const DataFacadeT &facade,
+                          SearchEngineData::QueryHeap &forward_heap,
+                          SearchEngineData::QueryHeap &reverse_heap,
+                          std::int32_t &weight,
+                          std::vector<NodeID> &packed_leg,
+                          const bool force_loop_forward,
+                          const bool force_loop_reverse,
+                          const int duration_upper_bound = INVALID_EDGE_WEIGHT,
+                          const bool retrieve_path = true) const
+    {
+        NodeID middle = SPECIAL_NODEID;
+        weight = duration_upper_bound;
+
+        std::vector<NodeID> search_nodes;
+        for (const auto *heap : {&forward_heap, &reverse_heap})
+        {
+            for (std::size_t index = 0; index < heap->NumberOfInsertedNodes(); ++index)
+            {
+                search_nodes.push_back(heap->GetInsertedNode(index));
+            }
+        }
+
+        const auto min_edge_offset = std::min(0, forward_heap.MinKey());
+        BOOST_ASSERT(reverse_heap.MinKey() >= 0);
+
+        while (0 < (forward_heap.Size() + reverse_heap.Size()))
+        {
+            // no path over the nodes that are left can be shorter
+            if (!forward_heap.Empty() && !reverse_heap.Empty() &&
+                std::int64_t{forward_heap.MinKey()} + reverse_heap.MinKey() >= weight)
+            {
+                break;
+            }
+            if (!forward_heap.Empty())
+            {
+                MultiLevelRoutingStep(facade,
+                                      forward_heap,
+                                      reverse_heap,
+                                      search_nodes,
+                                      middle,
+                                      weight,
+                                      min_edge_offset,
+                                      true,
+                                      force_loop_forward,
+                                      force_loop_reverse);
+            }
+            if (!reverse_heap.Empty())
+            {
+                MultiLevelRoutingStep(facade,
+                                      reverse_heap,
+                                      forward_heap,
+                                      search_nodes,
+                                      middle,
+                                      weight,
+                                      min_edge_offset,
+                                      false,
+                                      force_loop_reverse,
+                                      force_loop_forward);
+            }
+        }
+
+        if (duration_upper_bound <= weight || SPECIAL_NODEID == middle)
+        {
+            weight = INVALID_EDGE_WEIGHT;
+            return;
+        }
+
+        if (!retrieve_path)
+        {
+            return;
+        }
+
+        std::vector<NodeID> packed_path;
+        RetrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_path);
+
+        // The third heaps of the thread are only used by the alternative routes, which are
+        // not computed on multi-level datasets
+        SearchEngineData engine_working_data;
+        engine_working_data.InitializeOrClearThirdThreadLocalStorage(facade.GetNumberOfNodes());
+        SearchEngineData::QueryHeap &unpack_heap = *engine_working_data.forward_heap_3;
+        packed_leg.push_back(packed_path.front());
+        for (std::size_t index = 1; index < packed_path.size(); ++index)
+        {
+            const NodeID from = packed_path[index - 1];
+            const NodeID to = packed_path[index];
+            const auto level = GetQueryLevel(facade, search_nodes, from);
+            if (facade.GetHighestDifferentLevel(from, to) < level)
+            {
+                UnpackCellPath(facade, level, from, to, unpack_heap, packed_leg);
+            }
+            else
+            {
+                packed_leg.push_back(to);
+            }
+        }
+    }
+
     // assumes that heaps are already setup correctly.
     // ATTENTION: This only works if no additional offset is supplied next to the Phantom Node
     // Offsets.
@@ -488,6 +810,19 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                 const bool force_loop_reverse,
                 const int duration_upper_bound = INVALID_EDGE_WEIGHT) const
     {
+        if (facade.GetNumberOfLevels() > 0)
+        {
+            MultiLevelSearch(facade,
+                             forward_heap,
+                             reverse_heap,
+                             weight,
+                             packed_leg,
+                             force_loop_forward,
+                             force_loop_reverse,
+                             duration_upper_bound);
+            return;
+        }
+
         NodeID middle = SPECIAL_NODEID;
         weight = duration_upper_bound;
 
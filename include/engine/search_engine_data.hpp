@@ -6,6 +6,10 @@
 #include "util/binary_heap.hpp"
 #include "util/typedefs.hpp"
 
+#include <array>
+#include <cstddef>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -35,6 +39,21 @@ struct SearchEngineData
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+    // forward_heap_1, reverse_heap_1, ..., reverse_heap_3
+    static const constexpr std::size_t NUMBER_OF_HEAPS = 6;
+    using HeapMemoryUsage = std::array<std::size_t, NUMBER_OF_HEAPS>;
+
+    // Bytes held by the heaps of every thread that ran a query, as of the last time the heaps of
+    // that thread were cleared. Threads are listed in no particular order.
+    static std::vector<HeapMemoryUsage> GetHeapMemoryUsage();
+
+    // Heaps that hold more than this many bytes when they are cleared are released and
+    // allocated anew. 0 disables the limit.
+    static void SetMaxHeapSize(const std::size_t bytes);
+
+    // Number of heaps that were released because they exceeded the limit or recent usage
+    static std::size_t GetNumberOfReleasedHeaps();
 };
 }
 }
@@ -3,8 +3,8 @@
 
 #include "util/typedefs.hpp"
 
-#include <unordered_map>
-
+#include <cstddef>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -13,6 +13,16 @@ namespace osrm
 namespace extractor
 {
 
+/**
+ * Stores the geometry of the edges that the GraphCompressor merged, and zips the geometries of
+ * both directions of an edge for the edge-based graph.
+ *
+ * While compressing, the geometry of an edge is a chain of records in one pool, so that merging
+ * two edges is a constant time relinking. InitializeBothwayVector compacts the chains into one
+ * flat array with an offset per edge, after that the geometries can be read but not changed.
+ * All indexes are dense arrays over the EdgeIDs of the node-based graph, there is no per-edge
+ * allocation.
+ */
 class CompressedEdgeContainer
 {
   public:
@@ -23,9 +33,35 @@ class CompressedEdgeContainer
         EdgeWeight weight; // the weight of the edge leading to this node
     };
 
-    using OnewayEdgeBucket = std::vector<OnewayCompressedEdge>;
+    // The geometry of one edge, a view into the compacted geometries
+    class OnewayEdgeBucket
+    {
+      public:
+        using const_iterator = std::vector<OnewayCompressedEdge>::const_iterator;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        OnewayEdgeBucket(const_iterator begin, const_iterator end) : first(begin), last(end) {}
+
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return last; }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(last); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(first); }
+
+        std::size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+
+        const OnewayCompressedEdge &operator[](const std::size_t index) const
+        {
+            return first[index];
+        }
+        const OnewayCompressedEdge &front() const { return *first; }
+        const OnewayCompressedEdge &back() const { return *(last - 1); }
+
+      private:
+        const_iterator first;
+        const_iterator last;
+    };
 
-    CompressedEdgeContainer();
     void CompressEdge(const EdgeID surviving_edge_id,
                       const EdgeID removed_edge_id,
                       const NodeID via_node_id,
@@ -36,36 +72,69 @@ class CompressedEdgeContainer
     void
     AddUncompressedEdge(const EdgeID edge_id, const NodeID target_node, const EdgeWeight weight);
 
+    // Ends the compression: compacts the geometries and prepares the zipping
     void InitializeBothwayVector();
-    unsigned ZipEdges(const unsigned f_edge_pos, const unsigned r_edge_pos);
+    // Reserves the zipped geometry of an edge, the geometries are filled by ZipAllEdges
+    unsigned ZipEdges(const EdgeID f_edge_id, const EdgeID r_edge_id);
+    // Fills the zipped geometries of all calls to ZipEdges in parallel
+    void ZipAllEdges();
 
     bool HasEntryForID(const EdgeID edge_id) const;
     bool HasZippedEntryForForwardID(const EdgeID edge_id) const;
     bool HasZippedEntryForReverseID(const EdgeID edge_id) const;
     void PrintStatistics() const;
     void SerializeInternalVector(const std::string &path) const;
-    unsigned GetPositionForID(const EdgeID edge_id) const;
     unsigned GetZippedPositionForForwardID(const EdgeID edge_id) const;
     unsigned GetZippedPositionForReverseID(const EdgeID edge_id) const;
-    const OnewayEdgeBucket &GetBucketReference(const EdgeID edge_id) const;
+    OnewayEdgeBucket GetBucketReference(const EdgeID edge_id) const;
     bool IsTrivial(const EdgeID edge_id) const;
     NodeID GetFirstEdgeTargetID(const EdgeID edge_id) const;
     NodeID GetLastEdgeTargetID(const EdgeID edge_id) const;
     NodeID GetLastEdgeSourceID(const EdgeID edge_id) const;
 
+    // Begin of every zipped geometry in the zipped node list, as written by
+    // SerializeInternalVector (without the sentinel)
+    const std::vector<unsigned> &GetZippedGeometryIndices() const;
+    const std::vector<NodeID> &GetZippedGeometryNodes() const;
+
   private:
-    int free_list_maximum = 0;
+    // A record of the chain that is the geometry of an edge while compressing
+    struct ChainedCompressedEdge
+    {
+        OnewayCompressedEdge edge;
+        unsigned next;
+    };
+
+    // The geometry of an edge while compressing, the length is zero for edges without entry
+    struct EdgeChain
+    {
+        unsigned first;
+        unsigned last;
+        unsigned second_to_last;
+        unsigned length;
+    };
+
+    void Append(const EdgeID edge_id, const OnewayCompressedEdge &compressed_edge);
+    unsigned GetLength(const EdgeID edge_id) const;
+    std::size_t GetNumberOfEdges() const;
+
+    bool m_is_compacted = false;
+    bool m_is_zipped = false;
+
+    // used while compressing
+    std::vector<ChainedCompressedEdge> m_chained_edges;
+    std::vector<EdgeChain> m_edge_chains;
+
+    // used after compacting, the geometry of edge i starts at offset i and ends at offset i + 1
+    std::vector<unsigned> m_compressed_geometry_offsets;
+    std::vector<OnewayCompressedEdge> m_compressed_oneway_geometries;
 
-    void IncreaseFreeList();
-    std::vector<OnewayEdgeBucket> m_compressed_oneway_geometries;
+    std::vector<unsigned> m_forward_edge_id_to_zipped_index;
+    std::vector<unsigned> m_reverse_edge_id_to_zipped_index;
     std::vector<unsigned> m_compressed_geometry_index;
     std::vector<NodeID> m_compressed_geometry_nodes;
     std::vector<EdgeWeight> m_compressed_geometry_fwd_weights;
     std::vector<EdgeWeight> m_compressed_geometry_rev_weights;
-    std::vector<unsigned> m_free_list;
-    std::unordered_map<EdgeID, unsigned> m_edge_id_to_list_index_map;
-    std::unordered_map<EdgeID, unsigned> m_forward_edge_id_to_zipped_index_map;
-    std::unordered_map<EdgeID, unsigned> m_reverse_edge_id_to_zipped_index_map;
 };
 }
 }
@@ -10,6 +10,8 @@
 #include "extractor/profile_properties.hpp"
 #include "extractor/query_node.hpp"
 #include "extractor/restriction_map.hpp"
+#include "extractor/segment_index.hpp"
+#include "extractor/turn_penalty_table.hpp"
 
 #include "extractor/guidance/turn_analysis.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
@@ -96,10 +98,12 @@ class EdgeBasedGraphFactory
                                    guidance::LaneDescriptionMap &lane_description_map);
 
     void Run(ScriptingEnvironment &scripting_environment,
+             const TurnPenaltyTable &turn_penalty_table,
              const std::string &original_edge_data_filename,
              const std::string &turn_lane_data_filename,
              const std::string &edge_segment_lookup_filename,
              const std::string &edge_penalty_filename,
+             const std::string &edge_segment_index_filename,
              const bool generate_edge_lookup);
 
     // The following get access functions destroy the content in the factory
@@ -162,10 +166,12 @@ class EdgeBasedGraphFactory
     unsigned RenumberEdges();
     void GenerateEdgeExpandedNodes();
     void GenerateEdgeExpandedEdges(ScriptingEnvironment &scripting_environment,
+                                   const TurnPenaltyTable &turn_penalty_table,
                                    const std::string &original_edge_data_filename,
                                    const std::string &turn_lane_data_filename,
                                    const std::string &edge_segment_lookup_filename,
                                    const std::string &edge_fixed_penalties_filename,
+                                   const std::string &edge_segment_index_filename,
                                    const bool generate_edge_lookup);
 
     void InsertEdgeBasedNode(const NodeID u, const NodeID v);
@@ -6,6 +6,7 @@
 #include "util/typedefs.hpp"
 
 #include <cstdint>
+#include <limits>
 
 namespace osrm
 {
@@ -54,6 +55,47 @@ struct ExternalMemoryNodeSTXXLCompare
         return left.node_id < right.node_id;
     }
 };
+
+// A node of the input without the flags of a profile, input_index is its position in the input
+// and indexes the flags that the profiles set for it
+struct SharedNode : QueryNode
+{
+    SharedNode(const util::FixedLongitude lon_,
+               const util::FixedLatitude lat_,
+               OSMNodeID node_id_,
+               std::uint64_t input_index_)
+        : QueryNode(lon_, lat_, node_id_), input_index(input_index_)
+    {
+    }
+
+    SharedNode() : input_index(0) {}
+
+    static SharedNode min_value()
+    {
+        return SharedNode(util::FixedLongitude{0}, util::FixedLatitude{0}, MIN_OSM_NODEID, 0);
+    }
+
+    static SharedNode max_value()
+    {
+        return SharedNode(util::FixedLongitude{std::numeric_limits<std::int32_t>::max()},
+                          util::FixedLatitude{std::numeric_limits<std::int32_t>::max()},
+                          MAX_OSM_NODEID,
+                          std::numeric_limits<std::uint64_t>::max());
+    }
+
+    std::uint64_t input_index;
+};
+
+struct SharedNodeSTXXLCompare
+{
+    using value_type = SharedNode;
+    value_type max_value() { return value_type::max_value(); }
+    value_type min_value() { return value_type::min_value(); }
+    bool operator()(const value_type &left, const value_type &right) const
+    {
+        return left.node_id < right.node_id;
+    }
+};
 }
 }
 
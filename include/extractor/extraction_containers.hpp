@@ -9,41 +9,122 @@
 #include "extractor/scripting_environment.hpp"
 
 #include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <stxxl/vector>
+#include <string>
 #include <unordered_map>
+#include <vector>
+
+namespace osmium
+{
+class Node;
+}
 
 namespace osrm
 {
 namespace extractor
 {
 
+/**
+ * The coordinates and OSM ids of the nodes of the input. With several profiles the nodes are
+ * stored once and shared by the ExtractionContainers of all profiles, the barrier and traffic
+ * signal flags depend on the profile and are kept by the containers.
+ *
+ * The nodes are sorted by their OSM id once and then read by every profile. They are copied into
+ * RAM for the sort if they fit, otherwise they are sorted and read with stxxl.
+ */
+class SharedNodeStore
+{
+  public:
+    using STXXLNodeVector = stxxl::vector<SharedNode>;
+
+    // Appends a node of the input and returns its input index, the caller synchronizes
+    std::uint64_t AddNode(const osmium::Node &node);
+    std::uint64_t GetNumberOfNodes() const { return number_of_nodes; }
+
+    // Sorts the nodes by their OSM id, only the first call sorts
+    void Sort(const bool use_external_memory);
+
+    // The sorted nodes are either in RAM or in the stxxl vector
+    bool IsInInternalMemory() const { return in_internal_memory; }
+    const std::vector<SharedNode> &GetInternalNodes() const { return internal_nodes; }
+    const STXXLNodeVector &GetExternalNodes() const { return external_nodes; }
+
+  private:
+    std::uint64_t number_of_nodes = 0;
+    bool is_sorted = false;
+    bool in_internal_memory = false;
+    STXXLNodeVector external_nodes;
+    std::vector<SharedNode> internal_nodes;
+};
+
 /**
  * Uses external memory containers from stxxl to store all the data that
  * is collected by the extractor callbacks.
  *
- * The data is the filtered, aggregated and finally written to disk.
+ * The data is the filtered, aggregated and finally written to disk. If it fits into RAM it is
+ * copied into std::vectors first and sorted in parallel, otherwise it is sorted with stxxl.
  */
 class ExtractionContainers
 {
-#ifndef _MSC_VER
-    constexpr static unsigned stxxl_memory =
-        ((sizeof(std::size_t) == 4) ? std::numeric_limits<int>::max()
-                                    : std::numeric_limits<unsigned>::max());
-#else
-    const static unsigned stxxl_memory = ((sizeof(std::size_t) == 4) ? INT_MAX : UINT_MAX);
-#endif
-    void PrepareNodes();
-    void PrepareRestrictions();
-    void PrepareEdges(ScriptingEnvironment &scripting_environment);
-
-    void WriteNodes(std::ofstream &file_out_stream) const;
-    void WriteRestrictions(const std::string &restrictions_file_name) const;
-    void WriteEdges(std::ofstream &file_out_stream) const;
+    template <typename NodeIDVectorT, typename NodeVectorT, typename SortT>
+    void
+    PrepareNodes(NodeIDVectorT &used_node_ids, const NodeVectorT &all_nodes, const SortT &sort);
+    template <typename RestrictionsVectorT, typename WayIDStartEndVectorT, typename SortT>
+    void PrepareRestrictions(RestrictionsVectorT &restrictions,
+                             WayIDStartEndVectorT &way_start_end_ids,
+                             const SortT &sort);
+    template <typename NodeVectorT,
+              typename EdgeVectorT,
+              typename NameCharDataT,
+              typename NameOffsetsT,
+              typename SortT>
+    void PrepareEdges(ScriptingEnvironment &scripting_environment,
+                      const NodeVectorT &all_nodes,
+                      EdgeVectorT &all_edges,
+                      const NameCharDataT &name_data,
+                      const NameOffsetsT &name_data_offsets,
+                      std::mutex *name_data_mutex,
+                      const SortT &sort);
+
+    template <typename NodeIDVectorT, typename NodeVectorT>
+    void WriteNodes(std::ofstream &file_out_stream,
+                    const NodeIDVectorT &used_node_ids,
+                    const NodeVectorT &all_nodes) const;
+    template <typename RestrictionsVectorT>
+    void WriteRestrictions(const std::string &restrictions_file_name,
+                           const RestrictionsVectorT &restrictions) const;
+    template <typename EdgeVectorT>
+    void WriteEdges(std::ofstream &file_out_stream, const EdgeVectorT &all_edges) const;
     void WriteCharData(const std::string &file_name);
 
+    // sorts and writes copies of the containers in RAM, all_nodes are the sorted shared nodes
+    template <typename NodeVectorT>
+    void PrepareDataInInternalMemory(ScriptingEnvironment &scripting_environment,
+                                     const NodeVectorT &all_nodes,
+                                     std::ofstream &file_out_stream,
+                                     const std::string &restrictions_file_name);
+    // sorts and writes the containers with stxxl
+    template <typename NodeVectorT>
+    void PrepareDataInExternalMemory(ScriptingEnvironment &scripting_environment,
+                                     const NodeVectorT &all_nodes,
+                                     std::ofstream &file_out_stream,
+                                     const std::string &restrictions_file_name);
+
+    // the flags that the node function of the profile set, indexed by the input index
+    bool IsBarrier(const std::uint64_t input_index) const
+    {
+        return input_index < barrier_nodes.size() && barrier_nodes[input_index];
+    }
+    bool IsTrafficLight(const std::uint64_t input_index) const
+    {
+        return input_index < traffic_light_nodes.size() && traffic_light_nodes[input_index];
+    }
+
   public:
     using STXXLNodeIDVector = stxxl::vector<OSMNodeID>;
-    using STXXLNodeVector = stxxl::vector<ExternalMemoryNode>;
     using STXXLEdgeVector = stxxl::vector<InternalExtractorEdge>;
     using STXXLRestrictionsVector = stxxl::vector<InputRestrictionContainer>;
     using STXXLWayIDStartEndVector = stxxl::vector<FirstAndLastSegmentOfWay>;
@@ -51,7 +132,10 @@ class ExtractionContainers
     using STXXLNameOffsets = stxxl::vector<unsigned>;
 
     STXXLNodeIDVector used_node_id_list;
-    STXXLNodeVector all_nodes_list;
+    std::shared_ptr<SharedNodeStore> node_store;
+    // bitmaps over the input indexes of the nodes
+    std::vector<bool> barrier_nodes;
+    std::vector<bool> traffic_light_nodes;
     STXXLEdgeVector all_edges_list;
     STXXLNameCharData name_char_data;
     STXXLNameOffsets name_offsets;
@@ -61,12 +145,17 @@ class ExtractionContainers
     std::unordered_map<OSMNodeID, NodeID> external_to_internal_node_id_map;
     unsigned max_internal_node_id;
 
-    ExtractionContainers();
+    explicit ExtractionContainers(std::shared_ptr<SharedNodeStore> node_store);
+
+    // Sets the flags of a node of the shared node store, the caller synchronizes
+    void
+    SetNodeFlags(const std::uint64_t input_index, const bool barrier, const bool traffic_lights);
 
     void PrepareData(ScriptingEnvironment &scripting_environment,
                      const std::string &output_file_name,
                      const std::string &restrictions_file_name,
-                     const std::string &names_file_name);
+                     const std::string &names_file_name,
+                     const bool use_external_memory);
 };
 }
 }
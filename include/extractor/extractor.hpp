@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/extractor_config.hpp"
 #include "extractor/graph_compressor.hpp"
+#include "extractor/turn_penalty_table.hpp"
 
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
@@ -44,6 +45,7 @@ namespace osrm
 namespace extractor
 {
 
+class ExtractionContainers;
 class ScriptingEnvironment;
 struct ProfileProperties;
 
@@ -53,9 +55,19 @@ class Extractor
     Extractor(ExtractorConfig extractor_config) : config(std::move(extractor_config)) {}
     int run(ScriptingEnvironment &scripting_environment);
 
+    // Extracts the datasets of several profiles with a single pass over the input file. The
+    // configurations of the extractors only differ in the profile and the output file names.
+    static int run(const std::vector<Extractor *> &extractors,
+                   const std::vector<ScriptingEnvironment *> &scripting_environments);
+
   private:
     ExtractorConfig config;
 
+    // writes the data that was extracted with the profile and builds the edge-expanded graph
+    int BuildDataset(ScriptingEnvironment &scripting_environment,
+                     ExtractionContainers &extraction_containers);
+
+    TurnPenaltyTable BuildTurnPenaltyTable(ScriptingEnvironment &scripting_environment);
     std::pair<std::size_t, EdgeID>
     BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
                            std::vector<QueryNode> &internal_to_external_node_map,
@@ -7,12 +7,12 @@
 #include <boost/functional/hash.hpp>
 #include <boost/optional/optional_fwd.hpp>
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
 namespace osmium
 {
-class Node;
 class Way;
 }
 
@@ -69,7 +69,7 @@ class ExtractorCallbacks
     ExtractorCallbacks &operator=(const ExtractorCallbacks &) = delete;
 
     // warning: caller needs to take care of synchronization!
-    void ProcessNode(const osmium::Node &current_node, const ExtractionNode &result_node);
+    void ProcessNode(const std::uint64_t input_index, const ExtractionNode &result_node);
 
     // warning: caller needs to take care of synchronization!
     void ProcessRestriction(const boost::optional<InputRestrictionContainer> &restriction);
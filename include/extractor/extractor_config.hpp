@@ -40,8 +40,13 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
-    void UseDefaultOutputNames()
+    ExtractorConfig() noexcept
+        : requested_num_threads(0), use_turn_penalty_table(false),
+          turn_penalty_validation_samples(0), use_external_memory(false)
+    {
+    }
+    // The output files are named after the input file, and after the dataset if it is not empty
+    void UseDefaultOutputNames(const std::string &dataset_name = "")
     {
         std::string basepath = input_path.string();
 
@@ -58,6 +63,11 @@ struct ExtractorConfig
             }
         }
 
+        if (!dataset_name.empty())
+        {
+            basepath += "." + dataset_name;
+        }
+
         output_file_name = basepath + ".osrm";
         restriction_file_name = basepath + ".osrm.restrictions";
         names_file_name = basepath + ".osrm.names";
@@ -72,6 +82,7 @@ struct ExtractorConfig
         rtree_leafs_output_path = basepath + ".osrm.fileIndex";
         edge_segment_lookup_path = basepath + ".osrm.edge_segment_lookup";
         edge_penalty_path = basepath + ".osrm.edge_penalties";
+        edge_segment_index_path = basepath + ".osrm.edge_segment_index";
         edge_based_node_weights_output_path = basepath + ".osrm.enw";
         profile_properties_output_path = basepath + ".osrm.properties";
         intersection_class_data_output_path = basepath + ".osrm.icd";
@@ -99,9 +110,17 @@ struct ExtractorConfig
     unsigned requested_num_threads;
     unsigned small_component_size;
 
+    // sample the turn function into a table even if the profile does not declare it pure
+    bool use_turn_penalty_table;
+    // compare the turn penalty table with the profile on this many random angles
+    unsigned turn_penalty_validation_samples;
+    // sort the extracted data with stxxl even if it fits into RAM
+    bool use_external_memory;
+
     bool generate_edge_lookup;
     std::string edge_penalty_path;
     std::string edge_segment_lookup_path;
+    std::string edge_segment_index_path;
 };
 }
 }
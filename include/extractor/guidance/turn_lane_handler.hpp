@@ -14,7 +14,6 @@
 #include "util/node_based_graph.hpp"
 #include "util/typedefs.hpp"
 
-#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <map>
@@ -69,27 +68,34 @@ class TurnLaneHandler
   public:
     typedef std::vector<TurnLaneData> LaneDataVector;
 
+    // The lane description map is only read. Descriptions that are combined for sliproads and
+    // are not part of it are added to new_lane_descriptions, their ids continue the ids of the
+    // lane description map. This allows a handler per thread, each with its own maps.
     TurnLaneHandler(const util::NodeBasedDynamicGraph &node_based_graph,
-                    std::vector<std::uint32_t> &turn_lane_offsets,
-                    std::vector<TurnLaneType::Mask> &turn_lane_masks,
-                    LaneDescriptionMap &lane_description_map,
+                    const std::vector<std::uint32_t> &turn_lane_offsets,
+                    const std::vector<TurnLaneType::Mask> &turn_lane_masks,
+                    const LaneDescriptionMap &lane_description_map,
+                    LaneDescriptionMap &new_lane_descriptions,
                     const TurnAnalysis &turn_analysis,
                     LaneDataIdMap &id_map);
 
-    ~TurnLaneHandler();
-
     OSRM_ATTR_WARN_UNUSED
     Intersection assignTurnLanes(const NodeID at, const EdgeID via_edge, Intersection intersection);
 
+    // number of intersections with turn lanes and how many of them could be assigned
+    std::size_t countCalled() const { return count_called; }
+    std::size_t countHandled() const { return count_handled; }
+
   private:
-    mutable std::atomic<std::size_t> count_handled;
-    mutable std::atomic<std::size_t> count_called;
+    std::size_t count_handled;
+    std::size_t count_called;
     // we need to be able to look at previous intersections to, in some cases, find the correct turn
     // lanes for a turn
     const util::NodeBasedDynamicGraph &node_based_graph;
-    std::vector<std::uint32_t> &turn_lane_offsets;
-    std::vector<TurnLaneType::Mask> &turn_lane_masks;
-    LaneDescriptionMap &lane_description_map;
+    const std::vector<std::uint32_t> &turn_lane_offsets;
+    const std::vector<TurnLaneType::Mask> &turn_lane_masks;
+    const LaneDescriptionMap &lane_description_map;
+    LaneDescriptionMap &new_lane_descriptions;
     const TurnAnalysis &turn_analysis;
     LaneDataIdMap &id_map;
 
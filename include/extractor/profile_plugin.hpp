@@ -0,0 +1,118 @@
+#ifndef PROFILE_PLUGIN_HPP
+#define PROFILE_PLUGIN_HPP
+
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/guidance/turn_lane_types.hpp"
+#include "extractor/internal_extractor_edge.hpp"
+#include "extractor/profile_properties.hpp"
+
+#include "util/coordinate.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osmium
+{
+class Node;
+class Way;
+}
+
+namespace osrm
+{
+namespace extractor
+{
+
+// A library that was built against a different version of the interface is rejected
+const constexpr std::uint32_t PROFILE_PLUGIN_API_VERSION = 2;
+
+namespace detail
+{
+// FNV-1a over the words of values
+constexpr std::uint64_t hashLayout(const std::uint64_t hash) { return hash; }
+template <typename... Values>
+constexpr std::uint64_t
+hashLayout(const std::uint64_t hash, const std::uint64_t value, const Values... values)
+{
+    return hashLayout((hash ^ value) * 1099511628211ULL, values...);
+}
+}
+
+// The sizes and alignments of the types that are passed between osrm-extract and the library.
+// A library that was built with other definitions of them, e.g. after a member was added to
+// ExtractionWay without a new API version or with another standard library, is rejected.
+const constexpr std::uint64_t PROFILE_PLUGIN_LAYOUT =
+    detail::hashLayout(14695981039346656037ULL,
+                       sizeof(ExtractionWay),
+                       alignof(ExtractionWay),
+                       sizeof(ExtractionNode),
+                       alignof(ExtractionNode),
+                       sizeof(ProfileProperties),
+                       alignof(ProfileProperties),
+                       sizeof(InternalExtractorEdge::WeightData),
+                       alignof(InternalExtractorEdge::WeightData),
+                       sizeof(util::Coordinate),
+                       sizeof(std::string),
+                       sizeof(std::vector<std::string>));
+
+/**
+ * Interface of profiles that are written in C++ and compiled into a shared library, the
+ * counterpart of the functions and globals of a Lua profile. osrm-extract loads a library when
+ * it is passed as --profile.
+ *
+ * The functions are called from several threads at once and must not modify the plugin.
+ * The library exports its plugin with OSRM_PROFILE_PLUGIN(ClassName).
+ */
+class ProfilePlugin
+{
+  public:
+    virtual ~ProfilePlugin() = default;
+
+    // the `properties` global of a Lua profile
+    virtual ProfileProperties GetProfileProperties() const = 0;
+
+    // get_name_suffix_list and get_restrictions
+    virtual std::vector<std::string> GetNameSuffixList() const { return {}; }
+    virtual std::vector<std::string> GetRestrictions() const { return {}; }
+
+    // node_function and way_function
+    virtual void ProcessNode(const osmium::Node &, ExtractionNode &) const {}
+    virtual void ProcessWay(const osmium::Way &way, ExtractionWay &result) const = 0;
+
+    // segment_function
+    virtual void ProcessSegment(const util::Coordinate &,
+                                const util::Coordinate &,
+                                double,
+                                InternalExtractorEdge::WeightData &) const
+    {
+    }
+
+    // turn_function, the penalty is in deci-seconds
+    virtual double GetTurnPenalty(double) const { return 0; }
+};
+}
+}
+
+#ifdef _WIN32
+#define OSRM_PROFILE_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define OSRM_PROFILE_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#define OSRM_PROFILE_PLUGIN(ClassName)                                                             \
+    extern "C" OSRM_PROFILE_PLUGIN_EXPORT std::uint32_t osrm_profile_plugin_api_version()          \
+    {                                                                                              \
+        return osrm::extractor::PROFILE_PLUGIN_API_VERSION;                                        \
+    }                                                                                              \
+    extern "C" OSRM_PROFILE_PLUGIN_EXPORT std::uint64_t osrm_profile_plugin_layout()               \
+    {                                                                                              \
+        return osrm::extractor::PROFILE_PLUGIN_LAYOUT;                                             \
+    }                                                                                              \
+    extern "C" OSRM_PROFILE_PLUGIN_EXPORT osrm::extractor::ProfilePlugin *                         \
+    osrm_create_profile_plugin()                                                                   \
+    {                                                                                              \
+        return new ClassName();                                                                    \
+    }
+
+#endif // PROFILE_PLUGIN_HPP
@@ -53,6 +53,13 @@ class ScriptingEnvironment
     virtual std::vector<std::string> GetNameSuffixList() = 0;
     virtual std::vector<std::string> GetRestrictions() = 0;
     virtual void SetupSources() = 0;
+    // logs statistics about the processing of the elements
+    virtual void LogStatistics() = 0;
+    // true if the turn penalty only depends on the angle, it is then sampled into a
+    // TurnPenaltyTable instead of calling the profile for every turn
+    virtual bool HasPureTurnFunction() = 0;
+    // the turn penalty in deci-seconds before it is converted to an integer
+    virtual double GetTurnFunctionValue(double angle) = 0;
     virtual int32_t GetTurnPenalty(double angle) = 0;
     virtual void ProcessSegment(const osrm::util::Coordinate &source,
                                 const osrm::util::Coordinate &target,
@@ -3,6 +3,7 @@
 
 #include "extractor/scripting_environment.hpp"
 
+#include "extractor/extraction_way.hpp"
 #include "extractor/raster_source.hpp"
 
 #include "util/lua_util.hpp"
@@ -12,6 +13,8 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct lua_State;
 
@@ -24,15 +27,26 @@ struct LuaScriptingContext final
 {
     void processNode(const osmium::Node &, ExtractionNode &result);
     void processWay(const osmium::Way &, ExtractionWay &result);
+    // Calls the way function only for the first way with the same values of the way cache keys
+    void processCachedWay(const osmium::Way &, ExtractionWay &result);
 
     ProfileProperties properties;
-    SourceContainer sources;
     util::LuaState state;
 
     bool has_turn_penalty_function;
+    // declared by the profile with turn_function_is_pure
+    bool has_pure_turn_function;
     bool has_node_function;
     bool has_way_function;
     bool has_segment_function;
+
+    // Tags that the way function reads, declared by the profile with get_way_cache_keys. Apart
+    // from the name, that is copied from the name tag, the result only depends on their values.
+    std::vector<std::string> way_cache_keys;
+    std::unordered_map<std::string, ExtractionWay> way_cache;
+    std::string way_cache_key;
+    std::size_t way_cache_hits = 0;
+    std::size_t way_cache_misses = 0;
 };
 
 /**
@@ -55,6 +69,9 @@ class LuaScriptingEnvironment final : public ScriptingEnvironment
     std::vector<std::string> GetNameSuffixList() override;
     std::vector<std::string> GetRestrictions() override;
     void SetupSources() override;
+    void LogStatistics() override;
+    bool HasPureTurnFunction() override;
+    double GetTurnFunctionValue(double angle) override;
     int32_t GetTurnPenalty(double angle) override;
     void ProcessSegment(const osrm::util::Coordinate &source,
                         const osrm::util::Coordinate &target,
@@ -72,6 +89,9 @@ class LuaScriptingEnvironment final : public ScriptingEnvironment
     void InitContext(LuaScriptingContext &context);
     std::mutex init_mutex;
     std::string file_name;
+    // shared by the contexts of all threads, source_function is called in each of them
+    SourceContainer sources;
+    bool has_sources;
     tbb::enumerable_thread_specific<std::unique_ptr<LuaScriptingContext>> script_contexts;
 };
 }
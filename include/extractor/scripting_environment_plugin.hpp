@@ -0,0 +1,58 @@
+#ifndef SCRIPTING_ENVIRONMENT_PLUGIN_HPP
+#define SCRIPTING_ENVIRONMENT_PLUGIN_HPP
+
+#include "extractor/profile_plugin.hpp"
+#include "extractor/scripting_environment.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Loads a profile that is compiled into a shared library (see ProfilePlugin) and calls it
+ * directly instead of going through an interpreter.
+ */
+class PluginScriptingEnvironment final : public ScriptingEnvironment
+{
+  public:
+    explicit PluginScriptingEnvironment(const std::string &file_name);
+    ~PluginScriptingEnvironment() override;
+
+    // true if the file name has the extension of a shared library on this platform
+    static bool IsPlugin(const std::string &file_name);
+
+    const ProfileProperties &GetProfileProperties() override;
+
+    std::vector<std::string> GetNameSuffixList() override;
+    std::vector<std::string> GetRestrictions() override;
+    void SetupSources() override;
+    void LogStatistics() override;
+    bool HasPureTurnFunction() override;
+    double GetTurnFunctionValue(double angle) override;
+    int32_t GetTurnPenalty(double angle) override;
+    void ProcessSegment(const osrm::util::Coordinate &source,
+                        const osrm::util::Coordinate &target,
+                        double distance,
+                        InternalExtractorEdge::WeightData &weight) override;
+    void
+    ProcessElements(const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
+                    const RestrictionParser &restriction_parser,
+                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
+                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
+                    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
+                        &resulting_restrictions) override;
+
+  private:
+    void *library;
+    std::unique_ptr<ProfilePlugin> plugin;
+    ProfileProperties properties;
+};
+}
+}
+
+#endif /* SCRIPTING_ENVIRONMENT_PLUGIN_HPP */
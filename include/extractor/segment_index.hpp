@@ -0,0 +1,184 @@
+#ifndef OSRM_EXTRACTOR_SEGMENT_INDEX_HPP
+#define OSRM_EXTRACTOR_SEGMENT_INDEX_HPP
+
+#include "util/exception.hpp"
+#include "util/io.hpp"
+#include "util/typedefs.hpp"
+
+#include <tbb/parallel_invoke.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+namespace lookup
+{
+// A directed OSM segment and the position of its weight in the compressed geometries:
+// the forward weight of the segment is at first_position + 1, the reverse weight at
+// first_position, just like the weights of a leaf of the r-tree.
+struct GeometrySegment
+{
+    OSMNodeID from;
+    OSMNodeID to;
+    std::uint32_t first_position;
+    std::uint32_t forward;
+};
+static_assert(sizeof(GeometrySegment) == 24, "GeometrySegment is written as is");
+
+// A directed OSM segment that contributes to the weight of an edge-based edge
+struct SegmentEdge
+{
+    OSMNodeID from;
+    OSMNodeID to;
+    EdgeID edge;
+    // written to the file instead of uninitialized bytes
+    std::uint32_t padding = 0;
+};
+static_assert(sizeof(SegmentEdge) == 24, "SegmentEdge is written as is");
+
+// The turn an edge-based edge takes, the edge receives its penalty
+struct TurnEdge
+{
+    OSMNodeID from;
+    OSMNodeID via;
+    OSMNodeID to;
+    EdgeID edge;
+    // written to the file instead of uninitialized bytes
+    std::uint32_t padding = 0;
+};
+static_assert(sizeof(TurnEdge) == 32, "TurnEdge is written as is");
+}
+
+/// Reverse index of the OSM node pairs and turns a traffic update refers to, written by
+/// osrm-extract --generate-edge-lookup. It allows osrm-contract to touch only the compressed
+/// geometries, edge-based edges and turn penalties that are part of the update.
+struct SegmentIndex
+{
+    using GeometrySegmentRange = std::pair<std::vector<lookup::GeometrySegment>::const_iterator,
+                                           std::vector<lookup::GeometrySegment>::const_iterator>;
+    using SegmentEdgeRange = std::pair<std::vector<lookup::SegmentEdge>::const_iterator,
+                                       std::vector<lookup::SegmentEdge>::const_iterator>;
+    using TurnEdgeRange = std::pair<std::vector<lookup::TurnEdge>::const_iterator,
+                                    std::vector<lookup::TurnEdge>::const_iterator>;
+
+    std::vector<lookup::GeometrySegment> geometry_segments;
+    std::vector<lookup::SegmentEdge> segment_edges;
+    std::vector<lookup::TurnEdge> turn_edges;
+    // byte offset of the segments of every edge-based edge in .edge_segment_lookup
+    std::vector<std::uint64_t> segment_offsets;
+
+    // The lookups below need the index to be sorted
+    void Sort()
+    {
+        tbb::parallel_invoke(
+            [this] {
+                tbb::parallel_sort(geometry_segments.begin(),
+                                   geometry_segments.end(),
+                                   [](const auto &lhs, const auto &rhs) {
+                                       return std::tie(lhs.from, lhs.to, lhs.first_position) <
+                                              std::tie(rhs.from, rhs.to, rhs.first_position);
+                                   });
+            },
+            [this] {
+                tbb::parallel_sort(segment_edges.begin(),
+                                   segment_edges.end(),
+                                   [](const auto &lhs, const auto &rhs) {
+                                       return std::tie(lhs.from, lhs.to, lhs.edge) <
+                                              std::tie(rhs.from, rhs.to, rhs.edge);
+                                   });
+            },
+            [this] {
+                tbb::parallel_sort(
+                    turn_edges.begin(), turn_edges.end(), [](const auto &lhs, const auto &rhs) {
+                        return std::tie(lhs.from, lhs.via, lhs.to, lhs.edge) <
+                               std::tie(rhs.from, rhs.via, rhs.to, rhs.edge);
+                    });
+            });
+    }
+
+    GeometrySegmentRange GetGeometrySegments(const OSMNodeID from, const OSMNodeID to) const
+    {
+        return std::equal_range(geometry_segments.begin(),
+                                geometry_segments.end(),
+                                lookup::GeometrySegment{from, to, 0, 0},
+                                [](const auto &lhs, const auto &rhs) {
+                                    return std::tie(lhs.from, lhs.to) < std::tie(rhs.from, rhs.to);
+                                });
+    }
+
+    SegmentEdgeRange GetSegmentEdges(const OSMNodeID from, const OSMNodeID to) const
+    {
+        return std::equal_range(segment_edges.begin(),
+                                segment_edges.end(),
+                                lookup::SegmentEdge{from, to, SPECIAL_EDGEID},
+                                [](const auto &lhs, const auto &rhs) {
+                                    return std::tie(lhs.from, lhs.to) < std::tie(rhs.from, rhs.to);
+                                });
+    }
+
+    TurnEdgeRange GetTurnEdges(const OSMNodeID from, const OSMNodeID via, const OSMNodeID to) const
+    {
+        return std::equal_range(turn_edges.begin(),
+                                turn_edges.end(),
+                                lookup::TurnEdge{from, via, to, SPECIAL_EDGEID},
+                                [](const auto &lhs, const auto &rhs) {
+                                    return std::tie(lhs.from, lhs.via, lhs.to) <
+                                           std::tie(rhs.from, rhs.via, rhs.to);
+                                });
+    }
+};
+
+// The index is stored as fingerprint, geometry segments, segment edges, turn edges and offsets
+inline void writeSegmentIndex(const std::string &path, const SegmentIndex &index)
+{
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream || !util::writeFingerprint(stream))
+    {
+        throw util::exception("Could not open " + path + " for writing.");
+    }
+    if (!util::serializeVector(stream, index.geometry_segments) ||
+        !util::serializeVector(stream, index.segment_edges) ||
+        !util::serializeVector(stream, index.turn_edges) ||
+        !util::serializeVector(stream, index.segment_offsets))
+    {
+        throw util::exception("Could not write " + path);
+    }
+}
+
+inline SegmentIndex readSegmentIndex(const std::string &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        throw util::exception("Could not open " + path +
+                              " for reading, rerun osrm-extract with --generate-edge-lookup");
+    }
+    if (!util::readAndCheckFingerprint(stream))
+    {
+        throw util::exception(path + " was prepared with a different build, rerun osrm-extract");
+    }
+
+    SegmentIndex index;
+    if (!util::deserializeVector(stream, index.geometry_segments) ||
+        !util::deserializeVector(stream, index.segment_edges) ||
+        !util::deserializeVector(stream, index.turn_edges) ||
+        !util::deserializeVector(stream, index.segment_offsets))
+    {
+        throw util::exception("Could not read " + path);
+    }
+    return index;
+}
+}
+}
+
+#endif // OSRM_EXTRACTOR_SEGMENT_INDEX_HPP
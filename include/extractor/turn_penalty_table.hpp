@@ -0,0 +1,66 @@
+#ifndef OSRM_EXTRACTOR_TURN_PENALTY_TABLE_HPP
+#define OSRM_EXTRACTOR_TURN_PENALTY_TABLE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * The turn function of a profile sampled at fixed angles between -180 and 180 degrees. A penalty
+ * is interpolated linearly between the two nearest samples and converted to an integer just like
+ * ScriptingEnvironment::GetTurnPenalty does. This replaces a call into the profile for every turn
+ * if the penalty only depends on the angle.
+ */
+class TurnPenaltyTable
+{
+  public:
+    static const constexpr double SAMPLES_PER_DEGREE = 20;
+
+    struct ValidationResult
+    {
+        std::size_t samples;
+        std::size_t mismatches;
+        std::int32_t max_difference;
+    };
+
+    // an empty table, the penalties have to be computed by the profile
+    TurnPenaltyTable() = default;
+
+    // turn_function returns the penalty in deci-seconds before it is converted to an integer
+    explicit TurnPenaltyTable(const std::function<double(double)> &turn_function);
+
+    bool Empty() const { return penalties.empty(); }
+
+    std::int32_t GetTurnPenalty(const double angle) const
+    {
+        BOOST_ASSERT(!Empty());
+        const double clamped_angle = std::min(std::max(angle, -180.), 180.);
+        const double position = (clamped_angle + 180.) * SAMPLES_PER_DEGREE;
+        const auto index = std::min(static_cast<std::size_t>(position), penalties.size() - 2);
+        const double fraction = position - index;
+        // exact at both samples
+        const double penalty = (1 - fraction) * penalties[index] + fraction * penalties[index + 1];
+        return boost::numeric_cast<std::int32_t>(penalty);
+    }
+
+    // Compares the table with turn_penalty on all samples and number_of_samples random angles
+    ValidationResult Validate(const std::function<std::int32_t(double)> &turn_penalty,
+                              const std::size_t number_of_samples) const;
+
+  private:
+    std::vector<double> penalties;
+};
+}
+}
+
+#endif // OSRM_EXTRACTOR_TURN_PENALTY_TABLE_HPP
@@ -57,6 +57,8 @@ using engine::api::TileParameters;
  *  - Match: snaps noisy coordinate traces to the road network
  *  - Tile: vector tiles with internal graph representation
  *
+ *  The memory used by the instance can be inspected with MemoryReport.
+ *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
  */
 class OSRM final
@@ -130,6 +132,17 @@ class OSRM final
      */
     Status Tile(const TileParameters &parameters, std::string &result) const;
 
+    /**
+     * MemoryReport: how much memory the dataset and the query heaps use
+     *
+     * Lists the size of every dataset block and how much of it is resident in RAM, as well as
+     * the bytes held by the query heaps of each thread that answered a request.
+     *
+     * \return Status indicating success for the query or failure
+     * \see Status and json::Object
+     */
+    Status MemoryReport(json::Object &result) const;
+
   private:
     std::unique_ptr<engine::Engine> engine_;
 };
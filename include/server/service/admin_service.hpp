@@ -0,0 +1,33 @@
+#ifndef SERVER_SERVICE_ADMIN_SERVICE_HPP
+#define SERVER_SERVICE_ADMIN_SERVICE_HPP
+
+#include "server/service/base_service.hpp"
+
+#include "engine/status.hpp"
+#include "osrm/osrm.hpp"
+
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+namespace service
+{
+
+// Operational reports about the running instance, e.g. /admin/v1/driving/memory
+class AdminService final : public BaseService
+{
+  public:
+    AdminService(OSRM &routing_machine) : BaseService(routing_machine) {}
+
+    engine::Status
+    RunQuery(std::size_t prefix_length, std::string &query, ResultT &result) final override;
+
+    unsigned GetVersion() final override { return 1; }
+};
+}
+}
+}
+
+#endif
@@ -34,7 +34,8 @@ class ServiceHandlerInterface
 class ServiceHandler final : public ServiceHandlerInterface
 {
   public:
-    ServiceHandler(osrm::EngineConfig &config);
+    // The admin service exposes internals of the running instance and is only added on request
+    ServiceHandler(osrm::EngineConfig &config, const bool enable_admin_service = false);
     using ResultT = service::BaseService::ResultT;
 
     virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
@@ -6,12 +6,16 @@
 #include "extractor/original_edge_data.hpp"
 #include "extractor/query_node.hpp"
 #include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
 #include "util/simple_logger.hpp"
+#include "util/split_static_graph.hpp"
 #include "util/static_graph.hpp"
 
 #include <boost/filesystem/fstream.hpp>
 
+#include <algorithm>
 #include <tuple>
+#include <vector>
 
 namespace osrm
 {
@@ -78,18 +82,40 @@ inline HSGRHeader readHSGRHeader(boost::filesystem::ifstream &input_stream)
 
 // Reads the graph data of a `.hsgr` file into memory
 // Needs to be called after readHSGRHeader() to get the correct offset in the stream
-using NodeT = typename util::StaticGraph<contractor::QueryEdge::EdgeData>::NodeArrayEntry;
-using EdgeT = typename util::StaticGraph<contractor::QueryEdge::EdgeData>::EdgeArrayEntry;
+// The edges are stored as StaticGraph entries in the file and are split into the search and
+// unpack arrays of a SplitStaticGraph while reading.
+using QueryGraphT = util::SplitStaticGraph<contractor::QueryEdge::EdgeData>;
+using NodeT = typename QueryGraphT::NodeArrayEntry;
+using SearchEdgeT = typename QueryGraphT::SearchEdgeArrayEntry;
+using UnpackEdgeT = typename QueryGraphT::UnpackEdgeArrayEntry;
 inline void readHSGR(boost::filesystem::ifstream &input_stream,
                      NodeT *node_buffer,
                      const std::uint64_t number_of_nodes,
-                     EdgeT *edge_buffer,
+                     SearchEdgeT *search_edge_buffer,
+                     UnpackEdgeT *unpack_edge_buffer,
                      const std::uint64_t number_of_edges)
 {
+    using EdgeT = typename util::StaticGraph<contractor::QueryEdge::EdgeData>::EdgeArrayEntry;
+    const constexpr std::uint64_t READ_BLOCK_SIZE = 1024;
+
     BOOST_ASSERT(node_buffer);
-    BOOST_ASSERT(edge_buffer);
+    BOOST_ASSERT(number_of_edges == 0 || (search_edge_buffer && unpack_edge_buffer));
     input_stream.read(reinterpret_cast<char *>(node_buffer), number_of_nodes * sizeof(NodeT));
-    input_stream.read(reinterpret_cast<char *>(edge_buffer), number_of_edges * sizeof(EdgeT));
+
+    std::vector<EdgeT> read_buffer(std::min(number_of_edges, READ_BLOCK_SIZE));
+    for (std::uint64_t first_edge = 0; first_edge < number_of_edges;
+         first_edge += read_buffer.size())
+    {
+        const auto block_size =
+            std::min<std::uint64_t>(read_buffer.size(), number_of_edges - first_edge);
+        input_stream.read(reinterpret_cast<char *>(read_buffer.data()), block_size * sizeof(EdgeT));
+        for (const auto index : util::irange<std::uint64_t>(0, block_size))
+        {
+            search_edge_buffer[first_edge + index].target = read_buffer[index].target;
+            search_edge_buffer[first_edge + index].data = read_buffer[index].data.GetSearchData();
+            unpack_edge_buffer[first_edge + index] = read_buffer[index].data.GetUnpackData();
+        }
+    }
 }
 
 // Loads properties from a `.properties` file into memory
@@ -125,6 +151,7 @@ inline void readDatasourceIndexes(boost::filesystem::ifstream &datasource_indexe
 // Loads edge data from .edge files into memory which includes its
 // geometry, name ID, turn instruction, lane data ID, travel mode, entry class ID
 // Needs to be called after readElementCount() to get the correct offset in the stream
+// Lists that are passed as nullptr are skipped.
 inline void readEdges(boost::filesystem::ifstream &edges_input_stream,
                       GeometryID *geometry_list,
                       NameID *name_id_list,
@@ -136,25 +163,27 @@ inline void readEdges(boost::filesystem::ifstream &edges_input_stream,
                       util::guidance::TurnBearing *post_turn_bearing_list,
                       const std::uint64_t number_of_edges)
 {
-    BOOST_ASSERT(geometry_list);
-    BOOST_ASSERT(name_id_list);
-    BOOST_ASSERT(turn_instruction_list);
-    BOOST_ASSERT(lane_data_id_list);
-    BOOST_ASSERT(travel_mode_list);
-    BOOST_ASSERT(entry_class_id_list);
     extractor::OriginalEdgeData current_edge_data;
     for (std::uint64_t i = 0; i < number_of_edges; ++i)
     {
         edges_input_stream.read((char *)&(current_edge_data), sizeof(extractor::OriginalEdgeData));
 
-        geometry_list[i] = current_edge_data.via_geometry;
-        name_id_list[i] = current_edge_data.name_id;
-        turn_instruction_list[i] = current_edge_data.turn_instruction;
-        lane_data_id_list[i] = current_edge_data.lane_data_id;
-        travel_mode_list[i] = current_edge_data.travel_mode;
-        entry_class_id_list[i] = current_edge_data.entry_classid;
-        pre_turn_bearing_list[i] = current_edge_data.pre_turn_bearing;
-        post_turn_bearing_list[i] = current_edge_data.post_turn_bearing;
+        if (geometry_list)
+            geometry_list[i] = current_edge_data.via_geometry;
+        if (name_id_list)
+            name_id_list[i] = current_edge_data.name_id;
+        if (turn_instruction_list)
+            turn_instruction_list[i] = current_edge_data.turn_instruction;
+        if (lane_data_id_list)
+            lane_data_id_list[i] = current_edge_data.lane_data_id;
+        if (travel_mode_list)
+            travel_mode_list[i] = current_edge_data.travel_mode;
+        if (entry_class_id_list)
+            entry_class_id_list[i] = current_edge_data.entry_classid;
+        if (pre_turn_bearing_list)
+            pre_turn_bearing_list[i] = current_edge_data.pre_turn_bearing;
+        if (post_turn_bearing_list)
+            post_turn_bearing_list[i] = current_edge_data.post_turn_bearing;
     }
 }
 
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <array>
 
 namespace osrm
@@ -23,6 +24,7 @@ const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "VIA_NODE_LIST",
                                             "GRAPH_NODE_LIST",
                                             "GRAPH_EDGE_LIST",
+                                            "GRAPH_EDGE_UNPACK_LIST",
                                             "COORDINATE_LIST",
                                             "OSM_NODE_ID_LIST",
                                             "TURN_INSTRUCTION",
@@ -52,7 +54,20 @@ const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "POST_TURN_BEARING",
                                             "TURN_LANE_DATA",
                                             "LANE_DESCRIPTION_OFFSETS",
-                                            "LANE_DESCRIPTION_MASKS"};
+                                            "LANE_DESCRIPTION_MASKS",
+                                            "MLD_PARTITION",
+                                            "MLD_LEVEL_SHIFTS",
+                                            "MLD_CELLS",
+                                            "MLD_CELL_BOUNDARY",
+                                            "MLD_CELL_WEIGHTS"};
+
+// Pinned blocks live in the shared memory region which is locked into RAM. Mapped blocks are
+// stored in a file mapping and can be evicted by the kernel under memory pressure.
+enum class BlockResidency : std::uint8_t
+{
+    Pinned = 0,
+    Mapped
+};
 
 struct SharedDataLayout
 {
@@ -65,6 +80,7 @@ struct SharedDataLayout
         VIA_NODE_LIST,
         GRAPH_NODE_LIST,
         GRAPH_EDGE_LIST,
+        GRAPH_EDGE_UNPACK_LIST,
         COORDINATE_LIST,
         OSM_NODE_ID_LIST,
         TURN_INSTRUCTION,
@@ -95,13 +111,22 @@ struct SharedDataLayout
         TURN_LANE_DATA,
         LANE_DESCRIPTION_OFFSETS,
         LANE_DESCRIPTION_MASKS,
+        MLD_PARTITION,
+        MLD_LEVEL_SHIFTS,
+        MLD_CELLS,
+        MLD_CELL_BOUNDARY,
+        MLD_CELL_WEIGHTS,
         NUM_BLOCKS
     };
 
     std::array<uint64_t, NUM_BLOCKS> num_entries;
     std::array<uint64_t, NUM_BLOCKS> entry_size;
+    std::array<BlockResidency, NUM_BLOCKS> residency;
+    // Blocks that are at least this large start on a boundary of this size so that they can be
+    // backed by huge pages. Zero disables the alignment.
+    uint64_t large_block_alignment;
 
-    SharedDataLayout() : num_entries(), entry_size() {}
+    SharedDataLayout() : num_entries(), entry_size(), residency(), large_block_alignment(0) {}
 
     template <typename T> inline void SetBlockSize(BlockID bid, uint64_t entries)
     {
@@ -125,19 +150,54 @@ struct SharedDataLayout
         return AlignBlockSize(num_entries[bid] * entry_size[bid]);
     }
 
-    inline uint64_t GetSizeOfLayout() const
+    inline uint64_t AlignBlockOffset(BlockID bid, uint64_t offset) const
     {
-        return GetBlockOffset(NUM_BLOCKS) + NUM_BLOCKS * 2 * sizeof(CANARY);
+        uint64_t alignment = 4;
+        if (large_block_alignment > 0 && bid < NUM_BLOCKS &&
+            GetBlockSize(bid) >= large_block_alignment)
+        {
+            alignment = large_block_alignment;
+        }
+        return (offset + (alignment - 1)) & ~(alignment - 1);
     }
 
+    // Size of the memory that holds all blocks of the given residency, zero if there are none
+    inline uint64_t GetSizeOfLayout(BlockResidency block_residency = BlockResidency::Pinned) const
+    {
+        if (std::find(residency.begin(), residency.end(), block_residency) == residency.end())
+        {
+            return 0;
+        }
+        return GetBlockOffset(NUM_BLOCKS, block_residency) + NUM_BLOCKS * 2 * sizeof(CANARY);
+    }
+
+    // Offset relative to the start of the memory that holds the blocks of the same residency
     inline uint64_t GetBlockOffset(BlockID bid) const
     {
-        uint64_t result = sizeof(CANARY);
+        return GetBlockOffset(bid, residency[bid]);
+    }
+
+    inline uint64_t GetBlockOffset(BlockID bid, BlockResidency block_residency) const
+    {
+        uint64_t result = 0;
         for (auto i = 0; i < bid; i++)
         {
-            result += GetBlockSize((BlockID)i) + 2 * sizeof(CANARY);
+            if (residency[i] != block_residency)
+            {
+                continue;
+            }
+            result = AlignBlockOffset((BlockID)i, result + sizeof(CANARY)) +
+                     GetBlockSize((BlockID)i) + sizeof(CANARY);
         }
-        return result;
+        return AlignBlockOffset(bid, result + sizeof(CANARY));
+    }
+
+    // Picks the memory for the block based on its residency
+    template <typename T, bool WRITE_CANARY = false>
+    inline T *GetBlockPtr(char *shared_memory, char *mapped_memory, BlockID bid)
+    {
+        return GetBlockPtr<T, WRITE_CANARY>(
+            residency[bid] == BlockResidency::Pinned ? shared_memory : mapped_memory, bid);
     }
 
     template <typename T, bool WRITE_CANARY = false>
@@ -173,6 +233,38 @@ struct SharedDataLayout
     }
 };
 
+// Only keeps the blocks needed to compute routes in RAM. Guidance, name and datasource data is
+// only accessed for annotations and steps and can be paged in from disk on demand.
+inline BlockResidency GetTieredBlockResidency(const SharedDataLayout::BlockID bid)
+{
+    switch (bid)
+    {
+    case SharedDataLayout::NAME_OFFSETS:
+    case SharedDataLayout::NAME_BLOCKS:
+    case SharedDataLayout::NAME_CHAR_LIST:
+    case SharedDataLayout::NAME_ID_LIST:
+    case SharedDataLayout::DATASOURCES_LIST:
+    case SharedDataLayout::DATASOURCE_NAME_DATA:
+    case SharedDataLayout::DATASOURCE_NAME_OFFSETS:
+    case SharedDataLayout::DATASOURCE_NAME_LENGTHS:
+    case SharedDataLayout::BEARING_CLASSID:
+    case SharedDataLayout::BEARING_OFFSETS:
+    case SharedDataLayout::BEARING_BLOCKS:
+    case SharedDataLayout::BEARING_VALUES:
+    case SharedDataLayout::ENTRY_CLASSID:
+    case SharedDataLayout::ENTRY_CLASS:
+    case SharedDataLayout::LANE_DATA_ID:
+    case SharedDataLayout::PRE_TURN_BEARING:
+    case SharedDataLayout::POST_TURN_BEARING:
+    case SharedDataLayout::TURN_LANE_DATA:
+    case SharedDataLayout::LANE_DESCRIPTION_OFFSETS:
+    case SharedDataLayout::LANE_DESCRIPTION_MASKS:
+        return BlockResidency::Mapped;
+    default:
+        return BlockResidency::Pinned;
+    }
+}
+
 enum SharedDataType
 {
     CURRENT_REGIONS,
@@ -2,6 +2,7 @@
 #define SHARED_MEMORY_HPP
 
 #include "util/exception.hpp"
+#include "util/huge_pages.hpp"
 #include "util/simple_logger.hpp"
 
 #include <boost/filesystem.hpp>
@@ -15,14 +16,28 @@
 
 #ifdef __linux__
 #include <sys/ipc.h>
+#include <sys/mman.h>
 #include <sys/shm.h>
+
+// glibc does not expose the huge page size flags of shmget, they are encoded like for mmap
+#ifndef SHM_HUGE_SHIFT
+#define SHM_HUGE_SHIFT 26
+#endif
+#ifndef SHM_HUGE_2MB
+#define SHM_HUGE_2MB (21 << SHM_HUGE_SHIFT)
+#endif
+#ifndef SHM_HUGE_1GB
+#define SHM_HUGE_1GB (30 << SHM_HUGE_SHIFT)
+#endif
 #endif
 
-// #include <cstring>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 
 #include <algorithm>
 #include <exception>
+#include <string>
 
 namespace osrm
 {
@@ -39,6 +54,14 @@ struct OSRMLockFile
     }
 };
 
+// File that holds the evictable (mapped) blocks of a data region, next to the lock file
+template <typename IdentifierT, typename LockFileT = OSRMLockFile>
+boost::filesystem::path mappedBlocksPath(const IdentifierT id)
+{
+    LockFileT lock_file;
+    return lock_file().parent_path() / ("osrm.blocks." + std::to_string(static_cast<int>(id)));
+}
+
 #ifndef _WIN32
 class SharedMemory
 {
@@ -48,11 +71,14 @@ class SharedMemory
     SharedMemory(const SharedMemory &) = delete;
     SharedMemory &operator=(const SharedMemory &) = delete;
 
+    // If huge_page_size is set, newly created regions are backed by explicit huge pages
+    // (SHM_HUGETLB) or, if none are reserved, by transparent huge pages where supported.
     template <typename IdentifierT>
     SharedMemory(const boost::filesystem::path &lock_file,
                  const IdentifierT id,
                  const uint64_t size = 0,
-                 bool read_write = false)
+                 bool read_write = false,
+                 const uint64_t huge_page_size = 0)
         : key(lock_file.string().c_str(), id)
     {
         const auto access =
@@ -65,11 +91,14 @@ class SharedMemory
             util::SimpleLogger().Write(logDEBUG) << "opening " << shm.get_shmid() << " from id "
                                                  << id;
 
-            region = boost::interprocess::mapped_region(shm, access);
+            // the region may be backed by transparent huge pages, keep its large blocks aligned
+            region = MapRegion(shm, access, util::HUGE_PAGE_SIZE);
         }
         // open or create
         else
         {
+            const bool uses_hugetlb =
+                huge_page_size > 0 && CreateHugeTLBRegion(size, huge_page_size);
             shm = boost::interprocess::xsi_shared_memory(
                 boost::interprocess::open_or_create, key, size);
             util::SimpleLogger().Write(logDEBUG) << "opening/creating " << shm.get_shmid()
@@ -83,7 +112,14 @@ class SharedMemory
                 }
             }
 #endif
-            region = boost::interprocess::mapped_region(shm, access);
+            // segments with explicit huge pages are always mapped at a huge page boundary
+            const bool uses_thp = huge_page_size > 0 && !uses_hugetlb;
+            region = MapRegion(shm, access, uses_thp ? util::HUGE_PAGE_SIZE : 0);
+            if (uses_thp && !util::adviseHugePages(region.get_address(), region.get_size()))
+            {
+                util::SimpleLogger().Write(logWARNING)
+                    << "could not advise transparent huge pages for shared memory";
+            }
         }
     }
 
@@ -111,6 +147,94 @@ class SharedMemory
     }
 
   private:
+    // Creates the segment with SHM_HUGETLB so that the following open_or_create picks it up.
+    // A stale segment with the same key is removed first, it could be backed by regular pages.
+    // The size needs to be a multiple of the huge page size.
+    bool CreateHugeTLBRegion(const uint64_t size, const uint64_t huge_page_size)
+    {
+#if defined(__linux__) && defined(SHM_HUGETLB)
+        int flags = IPC_CREAT | IPC_EXCL | SHM_HUGETLB | 0644;
+        if (huge_page_size == (uint64_t{1} << 21))
+        {
+            flags |= SHM_HUGE_2MB;
+        }
+        else if (huge_page_size == (uint64_t{1} << 30))
+        {
+            flags |= SHM_HUGE_1GB;
+        }
+
+        const uint64_t rounded_size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+        int shmid = shmget(key.get_key(), rounded_size, flags);
+        if (-1 == shmid && EEXIST == errno)
+        {
+            const int stale_shmid = shmget(key.get_key(), 0, 0);
+            if (-1 != stale_shmid && 0 == shmctl(stale_shmid, IPC_RMID, nullptr))
+            {
+                util::SimpleLogger().Write(logWARNING) << "removed stale shared memory segment "
+                                                       << stale_shmid;
+                shmid = shmget(key.get_key(), rounded_size, flags);
+            }
+        }
+        if (-1 == shmid)
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "could not allocate " << rounded_size << " bytes of huge pages ("
+                << std::strerror(errno) << "), falling back to regular pages";
+            return false;
+        }
+        util::SimpleLogger().Write(logDEBUG) << "allocated shared memory with huge pages of "
+                                             << huge_page_size << " bytes";
+        return true;
+#else
+        (void)size;
+        (void)huge_page_size;
+        return false;
+#endif
+    }
+
+    // Maps the segment at a multiple of alignment if it is at least that large. The blocks that
+    // the layout aligns relative to the start of the region are then aligned in memory as well,
+    // which transparent huge pages need. Zero maps the segment at any address.
+    static boost::interprocess::mapped_region
+    MapRegion(const boost::interprocess::xsi_shared_memory &shm,
+              const boost::interprocess::mode_t access,
+              const uint64_t alignment)
+    {
+#ifdef __linux__
+        shmid_ds segment;
+        if (alignment > 0 && 0 == shmctl(shm.get_shmid(), IPC_STAT, &segment) &&
+            segment.shm_segsz >= alignment)
+        {
+            // reserve a range that contains an aligned address and release it for shmat
+            const auto reserved_size = segment.shm_segsz + alignment;
+            void *reserved = mmap(nullptr,
+                                  reserved_size,
+                                  PROT_NONE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                                  -1,
+                                  0);
+            if (MAP_FAILED != reserved)
+            {
+                const auto address = reinterpret_cast<std::uintptr_t>(reserved);
+                const auto aligned_address = (address + alignment - 1) & ~(alignment - 1);
+                munmap(reserved, reserved_size);
+                try
+                {
+                    return boost::interprocess::mapped_region(
+                        shm, access, 0, 0, reinterpret_cast<void *>(aligned_address));
+                }
+                catch (const boost::interprocess::interprocess_exception &)
+                {
+                    // another thread mapped memory into the released range
+                }
+            }
+        }
+#else
+        (void)alignment;
+#endif
+        return boost::interprocess::mapped_region(shm, access);
+    }
+
     static bool RegionExists(const boost::interprocess::xsi_key &key)
     {
         bool result = true;
@@ -151,10 +275,12 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
+    // huge pages are not supported for shared memory on Windows
     SharedMemory(const boost::filesystem::path &lock_file,
                  const int id,
                  const uint64_t size = 0,
-                 bool read_write = false)
+                 bool read_write = false,
+                 const uint64_t /* huge_page_size */ = 0)
     {
         sprintf(key, "%s.%d", "osrm.lock", id);
         auto access = read_write ? boost::interprocess::read_write : boost::interprocess::read_only;
@@ -232,8 +358,10 @@ class SharedMemory
 #endif
 
 template <typename IdentifierT, typename LockFileT = OSRMLockFile>
-std::unique_ptr<SharedMemory>
-makeSharedMemory(const IdentifierT &id, const uint64_t size = 0, bool read_write = false)
+std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id,
+                                               const uint64_t size = 0,
+                                               bool read_write = false,
+                                               const uint64_t huge_page_size = 0)
 {
     try
     {
@@ -249,7 +377,7 @@ makeSharedMemory(const IdentifierT &id, const uint64_t size = 0, bool read_write
                 boost::filesystem::ofstream ofs(lock_file());
             }
         }
-        return std::make_unique<SharedMemory>(lock_file(), id, size, read_write);
+        return std::make_unique<SharedMemory>(lock_file(), id, size, read_write, huge_page_size);
     }
     catch (const boost::interprocess::interprocess_exception &e)
     {
@@ -32,6 +32,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <cstdint>
+
 #include <string>
 
 namespace osrm
@@ -41,7 +43,18 @@ namespace storage
 class Storage
 {
   public:
-    Storage(StorageConfig config);
+    enum class ResidencyPolicy
+    {
+        // all blocks are locked into RAM
+        Pinned,
+        // only the blocks needed for routing are locked, see GetTieredBlockResidency
+        Tiered
+    };
+
+    // A non-zero huge_page_size backs the dataset with huge pages of that size (if available)
+    Storage(StorageConfig config,
+            std::uint64_t huge_page_size = 0,
+            ResidencyPolicy residency_policy = ResidencyPolicy::Pinned);
 
     enum ReturnCode
     {
@@ -54,6 +67,8 @@ class Storage
 
   private:
     StorageConfig config;
+    std::uint64_t huge_page_size;
+    ResidencyPolicy residency_policy;
 };
 }
 }
@@ -52,6 +52,9 @@ struct StorageConfig final
     StorageConfig(const boost::filesystem::path &base);
     bool IsValid() const;
 
+    // The files of a dataset partitioned by osrm-contract --mld exist
+    bool IsMultiLevelValid() const;
+
     boost::filesystem::path ram_index_path;
     boost::filesystem::path file_index_path;
     boost::filesystem::path hsgr_data_path;
@@ -67,6 +70,9 @@ struct StorageConfig final
     boost::filesystem::path intersection_class_path;
     boost::filesystem::path turn_lane_data_path;
     boost::filesystem::path turn_lane_description_path;
+    boost::filesystem::path partition_path;
+    boost::filesystem::path cells_path;
+    boost::filesystem::path cell_metrics_path;
 };
 }
 }
@@ -28,6 +28,8 @@ template <typename NodeID, typename Key> class ArrayStorage
 
     void Clear() {}
 
+    std::size_t MemoryUsage() const { return positions.capacity() * sizeof(Key); }
+
   private:
     std::vector<Key> positions;
 };
@@ -41,6 +43,12 @@ template <typename NodeID, typename Key> class MapStorage
 
     void Clear() { nodes.clear(); }
 
+    // approximation: every tree node holds three pointers and a color next to the value
+    std::size_t MemoryUsage() const
+    {
+        return nodes.size() * (sizeof(typename decltype(nodes)::value_type) + 4 * sizeof(void *));
+    }
+
     Key peek_index(const NodeID node) const
     {
         const auto iter = nodes.find(node);
@@ -80,6 +88,13 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     void Clear() { nodes.clear(); }
 
+    // approximation: a bucket is a pointer, every element a singly linked node
+    std::size_t MemoryUsage() const
+    {
+        return nodes.bucket_count() * sizeof(void *) +
+               nodes.size() * (sizeof(typename decltype(nodes)::value_type) + sizeof(void *));
+    }
+
   private:
     std::unordered_map<NodeID, Key> nodes;
 };
@@ -111,6 +126,25 @@ class BinaryHeap
 
     std::size_t Size() const { return (heap.size() - 1); }
 
+    // Nodes inserted since the last Clear and nodes that fit without reallocation
+    std::size_t NumberOfInsertedNodes() const { return inserted_nodes.size(); }
+
+    std::size_t Capacity() const { return inserted_nodes.capacity(); }
+
+    // Node of the index-th insertion since the last Clear
+    NodeID GetInsertedNode(const std::size_t index) const
+    {
+        BOOST_ASSERT(index < inserted_nodes.size());
+        return inserted_nodes[index].node;
+    }
+
+    // Bytes allocated by the heap, which includes capacity kept from previous queries
+    std::size_t MemoryUsage() const
+    {
+        return inserted_nodes.capacity() * sizeof(HeapNode) +
+               heap.capacity() * sizeof(HeapElement) + node_index.MemoryUsage();
+    }
+
     bool Empty() const { return 0 == Size(); }
 
     void Insert(NodeID node, Weight weight, const Data &data)
@@ -0,0 +1,56 @@
+#ifndef OSRM_UTIL_HUGE_PAGES_HPP
+#define OSRM_UTIL_HUGE_PAGES_HPP
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Size of a transparent huge page on x86_64
+const constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Asks the kernel to back the huge page aligned part of [ptr, ptr + size) with transparent
+// huge pages. This is only a hint: returns false if the range is too small or it was rejected.
+inline bool adviseHugePages(const void *ptr, const std::size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto begin = (address + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    const auto end = (address + size) & ~(HUGE_PAGE_SIZE - 1);
+    if (begin >= end)
+    {
+        return false;
+    }
+    return 0 == madvise(reinterpret_cast<void *>(begin), end - begin, MADV_HUGEPAGE);
+#else
+    (void)ptr;
+    (void)size;
+    return false;
+#endif
+}
+
+// Resizes a vector so that its pages get faulted in as huge pages: the memory is advised
+// after allocation but before the elements are constructed and the pages are touched.
+template <typename T>
+void resizeWithHugePages(std::vector<T> &vector, const std::size_t size, const bool use_huge_pages)
+{
+    if (use_huge_pages && size * sizeof(T) >= HUGE_PAGE_SIZE)
+    {
+        vector.reserve(size);
+        adviseHugePages(vector.data(), vector.capacity() * sizeof(T));
+    }
+    vector.resize(size);
+}
+}
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
 #include <bitset>
 #include <fstream>
 #include <stxxl/vector>
@@ -148,6 +149,27 @@ bool serializeVector(std::ofstream &out_stream, const stxxl::vector<simple_type>
     return static_cast<bool>(out_stream);
 }
 
+template <typename simple_type, std::size_t READ_BLOCK_BUFFER_SIZE = 1024>
+bool deserializeVector(std::istream &in_stream, stxxl::vector<simple_type> &data)
+{
+    std::uint64_t size = 0;
+    in_stream.read(reinterpret_cast<char *>(&size), sizeof(size));
+
+    simple_type read_buffer[READ_BLOCK_BUFFER_SIZE];
+    while (in_stream && size > 0)
+    {
+        const auto buffer_len = std::min<std::uint64_t>(size, READ_BLOCK_BUFFER_SIZE);
+        in_stream.read(reinterpret_cast<char *>(read_buffer), buffer_len * sizeof(simple_type));
+        for (std::uint64_t index = 0; index < buffer_len; ++index)
+        {
+            data.push_back(read_buffer[index]);
+        }
+        size -= buffer_len;
+    }
+
+    return static_cast<bool>(in_stream);
+}
+
 template <typename simple_type>
 bool deserializeAdjacencyArray(const std::string &filename,
                                std::vector<std::uint32_t> &offsets,
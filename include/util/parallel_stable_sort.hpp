@@ -0,0 +1,100 @@
+#ifndef PARALLEL_STABLE_SORT_HPP
+#define PARALLEL_STABLE_SORT_HPP
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+// ranges below this size are sorted and merged by a single thread
+const constexpr std::ptrdiff_t PARALLEL_SORT_GRAIN_SIZE = 1 << 14;
+
+// Merges the sorted ranges [first1, last1) and [first2, last2) into output. Equal elements of the
+// first range are placed before those of the second range, like std::merge does.
+template <typename InputIterator, typename OutputIterator, typename Compare>
+void parallelMerge(InputIterator first1,
+                   InputIterator last1,
+                   InputIterator first2,
+                   InputIterator last2,
+                   OutputIterator output,
+                   Compare &compare)
+{
+    const auto size1 = std::distance(first1, last1);
+    const auto size2 = std::distance(first2, last2);
+    if (size1 + size2 <= PARALLEL_SORT_GRAIN_SIZE)
+    {
+        std::merge(first1, last1, first2, last2, output, compare);
+        return;
+    }
+
+    // split the larger range in the middle and the other one around its middle element
+    InputIterator middle1, middle2;
+    if (size1 >= size2)
+    {
+        middle1 = first1 + size1 / 2;
+        middle2 = std::lower_bound(first2, last2, *middle1, compare);
+    }
+    else
+    {
+        middle2 = first2 + size2 / 2;
+        middle1 = std::upper_bound(first1, last1, *middle2, compare);
+    }
+    const auto middle_output =
+        output + std::distance(first1, middle1) + std::distance(first2, middle2);
+
+    tbb::parallel_invoke(
+        [&] { parallelMerge(first1, middle1, first2, middle2, output, compare); },
+        [&] { parallelMerge(middle1, last1, middle2, last2, middle_output, compare); });
+}
+
+template <typename RandomAccessIterator, typename BufferIterator, typename Compare>
+void parallelStableSort(RandomAccessIterator first,
+                        RandomAccessIterator last,
+                        BufferIterator buffer,
+                        Compare &compare)
+{
+    const auto size = std::distance(first, last);
+    if (size <= PARALLEL_SORT_GRAIN_SIZE)
+    {
+        std::stable_sort(first, last, compare);
+        return;
+    }
+
+    const auto middle = first + size / 2;
+    const auto buffer_middle = buffer + size / 2;
+    tbb::parallel_invoke([&] { parallelStableSort(first, middle, buffer, compare); },
+                         [&] { parallelStableSort(middle, last, buffer_middle, compare); });
+
+    parallelMerge(first, middle, middle, last, buffer, compare);
+    tbb::parallel_for(
+        tbb::blocked_range<std::ptrdiff_t>(0, size, PARALLEL_SORT_GRAIN_SIZE),
+        [&](const tbb::blocked_range<std::ptrdiff_t> &range) {
+            std::move(buffer + range.begin(), buffer + range.end(), first + range.begin());
+        });
+}
+}
+
+// Sorts [first, last) on all cores. Unlike tbb::parallel_sort equal elements keep their order, so
+// the result is the same as the one of std::stable_sort and does not depend on the number of
+// threads. Needs a temporary copy of the range.
+template <typename RandomAccessIterator, typename Compare>
+void parallelStableSort(RandomAccessIterator first, RandomAccessIterator last, Compare compare)
+{
+    using ValueT = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    std::vector<ValueT> buffer(std::distance(first, last));
+    detail::parallelStableSort(first, last, buffer.begin(), compare);
+}
+}
+}
+
+#endif // PARALLEL_STABLE_SORT_HPP
@@ -0,0 +1,116 @@
+#ifndef OSRM_UTIL_RESIDENT_MEMORY_HPP
+#define OSRM_UTIL_RESIDENT_MEMORY_HPP
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Number of bytes of [ptr, ptr + size) that are currently backed by pages in RAM.
+// Where this can not be determined the whole range is reported as resident.
+inline std::size_t residentBytes(const void *ptr, const std::size_t size)
+{
+#ifdef __linux__
+    if (ptr == nullptr || size == 0)
+    {
+        return 0;
+    }
+
+    const auto page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(ptr);
+    const auto end = begin + size;
+    const auto aligned_begin = begin & ~(page_size - 1);
+    const auto number_of_pages = (end - aligned_begin + page_size - 1) / page_size;
+
+    std::vector<unsigned char> page_residency(number_of_pages);
+    if (-1 == mincore(reinterpret_cast<void *>(aligned_begin),
+                      end - aligned_begin,
+                      page_residency.data()))
+    {
+        return size;
+    }
+
+    std::size_t resident_bytes = 0;
+    for (std::size_t page = 0; page < number_of_pages; ++page)
+    {
+        if (page_residency[page] & 1)
+        {
+            // only count the part of the first and last page that belongs to the range
+            const auto page_begin = std::max(aligned_begin + page * page_size, begin);
+            const auto page_end = std::min(aligned_begin + (page + 1) * page_size, end);
+            resident_bytes += page_end - page_begin;
+        }
+    }
+    return resident_bytes;
+#else
+    (void)ptr;
+    return size;
+#endif
+}
+
+// Largest number of bytes the process had resident in RAM so far, 0 where this can not be
+// determined.
+inline std::size_t peakResidentBytes()
+{
+#ifdef __linux__
+    rusage usage;
+    if (-1 == getrusage(RUSAGE_SELF, &usage))
+    {
+        return 0;
+    }
+    // ru_maxrss is given in KiB
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
+
+// Number of bytes of RAM that can be allocated without swapping, 0 where this can not be
+// determined.
+inline std::size_t availableMemoryBytes()
+{
+#ifdef __linux__
+    // MemAvailable includes the page cache that the kernel can drop
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    std::size_t value;
+    while (meminfo >> key >> value)
+    {
+        if (key == "MemAvailable:")
+        {
+            // given in KiB
+            return value * 1024;
+        }
+        meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+
+    const auto available_pages = sysconf(_SC_AVPHYS_PAGES);
+    const auto page_size = sysconf(_SC_PAGESIZE);
+    if (available_pages < 0 || page_size < 0)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(available_pages) * static_cast<std::size_t>(page_size);
+#else
+    return 0;
+#endif
+}
+}
+}
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef SPLIT_STATIC_GRAPH_HPP
+#define SPLIT_STATIC_GRAPH_HPP
+
+#include "util/integer_range.hpp"
+#include "util/shared_memory_vector_wrapper.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * A version of StaticGraph that stores the edges as a structure of arrays:
+ *  - the search array holds the target and the EdgeDataT::SearchData of every edge, this is all
+ *    that a search reads while relaxing the edges of a node
+ *  - the unpack array holds the EdgeDataT::UnpackData of every edge (the middle node of a
+ *    shortcut), it is only read when a path is unpacked
+ * For the search graph of a contraction hierarchy an entry of the search array takes 8 bytes
+ * instead of 12, so more adjacency lists fit into a cache line.
+ *
+ * EdgeDataT needs the SearchData and UnpackData types of QueryEdge::EdgeData, a constructor that
+ * joins both and the GetSearchData() and GetUnpackData() accessors.
+ */
+template <typename EdgeDataT, bool UseSharedMemory = false> class SplitStaticGraph
+{
+  public:
+    using NodeIterator = NodeID;
+    using EdgeIterator = NodeID;
+    using EdgeData = EdgeDataT;
+    using SearchData = typename EdgeDataT::SearchData;
+    using UnpackData = typename EdgeDataT::UnpackData;
+    using EdgeRange = range<EdgeIterator>;
+    using InputEdge = typename StaticGraph<EdgeDataT>::InputEdge;
+    using NodeArrayEntry = typename StaticGraph<EdgeDataT>::NodeArrayEntry;
+
+    struct SearchEdgeArrayEntry
+    {
+        NodeID target;
+        SearchData data;
+    };
+
+    using UnpackEdgeArrayEntry = UnpackData;
+
+    EdgeRange GetAdjacentEdgeRange(const NodeID node) const
+    {
+        return irange(BeginEdges(node), EndEdges(node));
+    }
+
+    template <typename ContainerT> SplitStaticGraph(const int nodes, const ContainerT &graph)
+    {
+        BOOST_ASSERT(std::is_sorted(const_cast<ContainerT &>(graph).begin(),
+                                    const_cast<ContainerT &>(graph).end()));
+
+        number_of_nodes = nodes;
+        number_of_edges = static_cast<EdgeIterator>(graph.size());
+        node_array.resize(number_of_nodes + 1);
+        search_edge_array.resize(number_of_edges);
+        unpack_edge_array.resize(number_of_edges);
+
+        EdgeIterator edge = 0;
+        for (const auto node : irange(0u, number_of_nodes + 1))
+        {
+            node_array[node].first_edge = edge;
+            while (edge < number_of_edges && graph[edge].source == node)
+            {
+                search_edge_array[edge].target = graph[edge].target;
+                search_edge_array[edge].data = graph[edge].data.GetSearchData();
+                unpack_edge_array[edge] = graph[edge].data.GetUnpackData();
+                ++edge;
+            }
+        }
+    }
+
+    SplitStaticGraph(typename ShM<NodeArrayEntry, UseSharedMemory>::vector &nodes,
+                     typename ShM<SearchEdgeArrayEntry, UseSharedMemory>::vector &search_edges,
+                     typename ShM<UnpackEdgeArrayEntry, UseSharedMemory>::vector &unpack_edges)
+    {
+        BOOST_ASSERT(search_edges.size() == unpack_edges.size());
+        number_of_nodes = static_cast<decltype(number_of_nodes)>(nodes.size() - 1);
+        number_of_edges = static_cast<decltype(number_of_edges)>(search_edges.size());
+
+        using std::swap;
+        swap(node_array, nodes);
+        swap(search_edge_array, search_edges);
+        swap(unpack_edge_array, unpack_edges);
+    }
+
+    unsigned GetNumberOfNodes() const { return number_of_nodes; }
+
+    unsigned GetNumberOfEdges() const { return number_of_edges; }
+
+    // Address and size in bytes of the node, search edge and unpack edge arrays
+    std::pair<const void *, std::size_t> GetNodeArrayMemory() const
+    {
+        return std::make_pair(node_array.empty() ? nullptr : &node_array[0],
+                              node_array.size() * sizeof(NodeArrayEntry));
+    }
+
+    std::pair<const void *, std::size_t> GetEdgeArrayMemory() const
+    {
+        return std::make_pair(search_edge_array.empty() ? nullptr : &search_edge_array[0],
+                              search_edge_array.size() * sizeof(SearchEdgeArrayEntry));
+    }
+
+    std::pair<const void *, std::size_t> GetUnpackArrayMemory() const
+    {
+        return std::make_pair(unpack_edge_array.empty() ? nullptr : &unpack_edge_array[0],
+                              unpack_edge_array.size() * sizeof(UnpackEdgeArrayEntry));
+    }
+
+    unsigned GetOutDegree(const NodeIterator n) const { return EndEdges(n) - BeginEdges(n); }
+
+    inline NodeIterator GetTarget(const EdgeIterator e) const
+    {
+        return NodeIterator(search_edge_array[e].target);
+    }
+
+    const SearchData &GetEdgeSearchData(const EdgeIterator e) const
+    {
+        return search_edge_array[e].data;
+    }
+
+    const UnpackData &GetEdgeUnpackData(const EdgeIterator e) const
+    {
+        return unpack_edge_array[e];
+    }
+
+    EdgeDataT GetEdgeData(const EdgeIterator e) const
+    {
+        return EdgeDataT(search_edge_array[e].data, unpack_edge_array[e]);
+    }
+
+    EdgeIterator BeginEdges(const NodeIterator n) const
+    {
+        return EdgeIterator(node_array.at(n).first_edge);
+    }
+
+    EdgeIterator EndEdges(const NodeIterator n) const
+    {
+        return EdgeIterator(node_array.at(n + 1).first_edge);
+    }
+
+    // searches for a specific edge
+    EdgeIterator FindEdge(const NodeIterator from, const NodeIterator to) const
+    {
+        for (const auto i : irange(BeginEdges(from), EndEdges(from)))
+        {
+            if (to == search_edge_array[i].target)
+            {
+                return i;
+            }
+        }
+        return SPECIAL_EDGEID;
+    }
+
+    // see StaticGraph::FindSmallestEdge, the filter gets the joined EdgeDataT
+    template <typename FilterFunction>
+    EdgeIterator
+    FindSmallestEdge(const NodeIterator from, const NodeIterator to, FilterFunction &&filter) const
+    {
+        EdgeIterator smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (auto edge : GetAdjacentEdgeRange(from))
+        {
+            const auto &entry = search_edge_array[edge];
+            if (entry.target == to && entry.data.weight < smallest_weight &&
+                std::forward<FilterFunction>(filter)(GetEdgeData(edge)))
+            {
+                smallest_edge = edge;
+                smallest_weight = entry.data.weight;
+            }
+        }
+        return smallest_edge;
+    }
+
+    EdgeIterator FindEdgeInEitherDirection(const NodeIterator from, const NodeIterator to) const
+    {
+        EdgeIterator tmp = FindEdge(from, to);
+        return (SPECIAL_NODEID != tmp ? tmp : FindEdge(to, from));
+    }
+
+    EdgeIterator
+    FindEdgeIndicateIfReverse(const NodeIterator from, const NodeIterator to, bool &result) const
+    {
+        EdgeIterator current_iterator = FindEdge(from, to);
+        if (SPECIAL_NODEID == current_iterator)
+        {
+            current_iterator = FindEdge(to, from);
+            if (SPECIAL_NODEID != current_iterator)
+            {
+                result = true;
+            }
+        }
+        return current_iterator;
+    }
+
+  private:
+    NodeIterator number_of_nodes;
+    EdgeIterator number_of_edges;
+
+    typename ShM<NodeArrayEntry, UseSharedMemory>::vector node_array;
+    typename ShM<SearchEdgeArrayEntry, UseSharedMemory>::vector search_edge_array;
+    typename ShM<UnpackEdgeArrayEntry, UseSharedMemory>::vector unpack_edge_array;
+};
+}
+}
+
+#endif // SPLIT_STATIC_GRAPH_HPP
@@ -114,6 +114,19 @@ template <typename EdgeDataT, bool UseSharedMemory = false> class StaticGraph
 
     unsigned GetNumberOfEdges() const { return number_of_edges; }
 
+    // Address and size in bytes of the node and edge arrays
+    std::pair<const void *, std::size_t> GetNodeArrayMemory() const
+    {
+        return std::make_pair(node_array.empty() ? nullptr : &node_array[0],
+                              node_array.size() * sizeof(NodeArrayEntry));
+    }
+
+    std::pair<const void *, std::size_t> GetEdgeArrayMemory() const
+    {
+        return std::make_pair(edge_array.empty() ? nullptr : &edge_array[0],
+                              edge_array.size() * sizeof(EdgeArrayEntry));
+    }
+
     unsigned GetOutDegree(const NodeIterator n) const { return EndEdges(n) - BeginEdges(n); }
 
     inline NodeIterator GetTarget(const EdgeIterator e) const
@@ -30,6 +30,7 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 // An extended alignment is implementation-defined, so use compiler attributes
@@ -390,6 +391,20 @@ class StaticRTree
         }
     }
 
+    // Address and size in bytes of the search tree nodes
+    std::pair<const void *, std::size_t> GetSearchTreeMemory() const
+    {
+        return std::make_pair(m_search_tree.empty() ? nullptr : &m_search_tree[0],
+                              m_search_tree.size() * sizeof(TreeNode));
+    }
+
+    // Address and size in bytes of the leaves, which are mapped from the leaf file
+    std::pair<const void *, std::size_t> GetLeavesMemory() const
+    {
+        return std::make_pair(static_cast<const void *>(m_leaves_region.data()),
+                              m_leaves_region.size());
+    }
+
     /* Returns all features inside the bounding box.
        Rectangle needs to be projected!*/
     std::vector<EdgeDataT> SearchInBox(const Rectangle &search_rectangle) const
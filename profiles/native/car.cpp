@@ -0,0 +1,846 @@
+// Car profile, a port of profiles/car.lua to the C++ profile interface.
+//
+// Build it with -DENABLE_NATIVE_PROFILES=ON and pass the library to osrm-extract:
+//   osrm-extract -p libosrm-profile-car.so map.osm.pbf
+//
+// Like in the Lua profile a missing tag reads as an empty string.
+
+#include "extractor/extraction_helper_functions.hpp"
+#include "extractor/profile_plugin.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/optional.hpp>
+
+#include <osmium/osm.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+using namespace osrm::extractor;
+
+using StringSet = std::unordered_set<std::string>;
+using SpeedTable = std::unordered_map<std::string, double>;
+
+const StringSet barrier_whitelist{"cattle_grid",
+                                  "border_control",
+                                  "checkpoint",
+                                  "toll_booth",
+                                  "sally_port",
+                                  "gate",
+                                  "lift_gate",
+                                  "no",
+                                  "entrance"};
+const StringSet access_tag_whitelist{
+    "yes", "motorcar", "motor_vehicle", "vehicle", "permissive", "designated", "destination"};
+const StringSet access_tag_blacklist{
+    "no", "private", "agricultural", "forestry", "emergency", "psv", "delivery"};
+const StringSet access_tag_restricted{"destination", "delivery"};
+const std::vector<const char *> access_tags_hierarchy{
+    "motorcar", "motor_vehicle", "vehicle", "access"};
+const StringSet service_tag_restricted{"parking_aisle", "parking"};
+const StringSet service_tag_forbidden{"emergency_access"};
+const std::vector<std::string> restrictions{"motorcar", "motor_vehicle", "vehicle"};
+
+// A list of suffixes to suppress in name change instructions
+const std::vector<std::string> suffix_list{
+    "N", "NE", "E", "SE", "S", "SW", "W", "NW", "North", "South", "West", "East"};
+
+const SpeedTable speed_profile{{"motorway", 90},
+                               {"motorway_link", 45},
+                               {"trunk", 85},
+                               {"trunk_link", 40},
+                               {"primary", 65},
+                               {"primary_link", 30},
+                               {"secondary", 55},
+                               {"secondary_link", 25},
+                               {"tertiary", 40},
+                               {"tertiary_link", 20},
+                               {"unclassified", 25},
+                               {"residential", 25},
+                               {"living_street", 10},
+                               {"service", 15},
+                               {"ferry", 5},
+                               {"movable", 5},
+                               {"shuttle_train", 10},
+                               {"default", 10}};
+
+const SpeedTable service_speeds{
+    {"alley", 5}, {"parking", 5}, {"parking_aisle", 5}, {"driveway", 5}, {"drive-through", 5}};
+
+// max speed for surfaces, surfaces without a limit are not listed
+const SpeedTable surface_speeds{{"cement", 80},
+                                {"compacted", 80},
+                                {"fine_gravel", 80},
+                                {"paving_stones", 60},
+                                {"metal", 60},
+                                {"bricks", 60},
+                                {"grass", 40},
+                                {"wood", 40},
+                                {"sett", 40},
+                                {"grass_paver", 40},
+                                {"gravel", 40},
+                                {"unpaved", 40},
+                                {"ground", 40},
+                                {"dirt", 40},
+                                {"pebblestone", 40},
+                                {"tartan", 40},
+                                {"cobblestone", 30},
+                                {"clay", 30},
+                                {"earth", 20},
+                                {"stone", 20},
+                                {"rocky", 20},
+                                {"sand", 20},
+                                {"mud", 10}};
+
+const SpeedTable tracktype_speeds{
+    {"grade1", 60}, {"grade2", 40}, {"grade3", 30}, {"grade4", 25}, {"grade5", 20}};
+
+const SpeedTable smoothness_speeds{{"intermediate", 80},
+                                   {"bad", 40},
+                                   {"very_bad", 20},
+                                   {"horrible", 10},
+                                   {"very_horrible", 5},
+                                   {"impassable", 0}};
+
+// http://wiki.openstreetmap.org/wiki/Speed_limits
+const SpeedTable maxspeed_table_default{
+    {"urban", 50}, {"rural", 90}, {"trunk", 110}, {"motorway", 130}};
+
+// List only exceptions
+const SpeedTable maxspeed_table{{"ch:rural", 80},
+                                {"ch:trunk", 100},
+                                {"ch:motorway", 120},
+                                {"de:living_street", 7},
+                                {"ru:living_street", 20},
+                                {"ru:urban", 60},
+                                {"ua:urban", 60},
+                                {"at:rural", 100},
+                                {"de:rural", 100},
+                                {"at:trunk", 100},
+                                {"cz:trunk", 0},
+                                {"ro:trunk", 100},
+                                {"cz:motorway", 0},
+                                {"de:motorway", 0},
+                                {"ru:motorway", 110},
+                                {"gb:nsl_single", (60 * 1609) / 1000.},
+                                {"gb:nsl_dual", (70 * 1609) / 1000.},
+                                {"gb:motorway", (70 * 1609) / 1000.},
+                                {"uk:nsl_single", (60 * 1609) / 1000.},
+                                {"uk:nsl_dual", (70 * 1609) / 1000.},
+                                {"uk:motorway", (70 * 1609) / 1000.},
+                                {"nl:rural", 80},
+                                {"nl:trunk", 100},
+                                {"none", 140}};
+
+// Guidance: Default Mapping from roads to types/priorities
+const std::unordered_map<std::string, guidance::RoadPriorityClass::Enum> highway_classes{
+    {"motorway", guidance::RoadPriorityClass::MOTORWAY},
+    {"motorway_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"trunk", guidance::RoadPriorityClass::TRUNK},
+    {"trunk_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"primary", guidance::RoadPriorityClass::PRIMARY},
+    {"primary_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"secondary", guidance::RoadPriorityClass::SECONDARY},
+    {"secondary_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"tertiary", guidance::RoadPriorityClass::TERTIARY},
+    {"tertiary_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"unclassified", guidance::RoadPriorityClass::SIDE_RESIDENTIAL},
+    {"residential", guidance::RoadPriorityClass::SIDE_RESIDENTIAL},
+    {"service", guidance::RoadPriorityClass::CONNECTIVITY},
+    {"living_street", guidance::RoadPriorityClass::MAIN_RESIDENTIAL},
+    {"track", guidance::RoadPriorityClass::BIKE_PATH},
+    {"path", guidance::RoadPriorityClass::BIKE_PATH},
+    {"footway", guidance::RoadPriorityClass::FOOT_PATH},
+    {"pedestrian", guidance::RoadPriorityClass::FOOT_PATH},
+    {"steps", guidance::RoadPriorityClass::FOOT_PATH}};
+
+const StringSet motorway_types{"motorway", "motorway_link", "trunk", "trunk_link"};
+
+const StringSet road_types{"motorway",
+                           "motorway_link",
+                           "trunk",
+                           "trunk_link",
+                           "primary",
+                           "primary_link",
+                           "secondary",
+                           "secondary_link",
+                           "tertiary",
+                           "tertiary_link",
+                           "unclassified",
+                           "residential",
+                           "living_street"};
+
+const StringSet link_types{
+    "motorway_link", "trunk_link", "primary_link", "secondary_link", "tertiary_link"};
+
+const constexpr double side_road_speed_multiplier = 0.8;
+const constexpr double turn_penalty = 7.5;
+// Note: this biases right-side driving. Should be inverted for left-driving countries.
+const constexpr double turn_bias = 1.075;
+const constexpr double speed_reduction = 0.8;
+const constexpr double infinity = std::numeric_limits<double>::infinity();
+
+const constexpr bool obey_oneway = true;
+const constexpr bool ignore_areas = true;
+const constexpr bool ignore_hov_ways = true;
+const constexpr bool ignore_toll_ways = false;
+
+template <typename T> std::string getValue(const T &object, const char *key)
+{
+    return object.get_value_by_key(key, "");
+}
+
+const double *findSpeed(const SpeedTable &table, const std::string &key)
+{
+    const auto iter = table.find(key);
+    return iter == table.end() ? nullptr : &iter->second;
+}
+
+template <typename T> std::string findAccessTag(const T &object)
+{
+    for (const auto key : access_tags_hierarchy)
+    {
+        const char *tag = object.get_value_by_key(key);
+        if (tag != nullptr && *tag != '\0')
+        {
+            return tag;
+        }
+    }
+    return "";
+}
+
+// tonumber(value:match("%d*")), the number formed by the leading digits
+boost::optional<double> parseLeadingDigits(const std::string &value)
+{
+    const auto digits = std::find_if_not(value.begin(), value.end(), [](const unsigned char c) {
+        return std::isdigit(c);
+    });
+    if (digits == value.begin())
+    {
+        return boost::none;
+    }
+    return std::strtod(std::string(value.begin(), digits).c_str(), nullptr);
+}
+
+// tonumber(value)
+boost::optional<double> parseNumber(const std::string &value)
+{
+    const char *begin = value.c_str();
+    char *end = nullptr;
+    const double number = std::strtod(begin, &end);
+    if (end == begin || !std::isfinite(number))
+    {
+        return boost::none;
+    }
+    while (std::isspace(static_cast<unsigned char>(*end)))
+    {
+        ++end;
+    }
+    if (*end != '\0')
+    {
+        return boost::none;
+    }
+    return number;
+}
+
+double parseMaxspeed(const std::string &source)
+{
+    if (const auto number = parseLeadingDigits(source))
+    {
+        if (source.find("mph") != std::string::npos || source.find("mp/h") != std::string::npos)
+        {
+            return (*number * 1609) / 1000;
+        }
+        return *number;
+    }
+
+    // parse maxspeed like FR:urban
+    const auto lower = boost::algorithm::to_lower_copy(source);
+    if (const auto speed = findSpeed(maxspeed_table, lower))
+    {
+        return *speed;
+    }
+
+    // the first match of %a%a:(%a+)
+    const auto is_alpha = [](const unsigned char c) { return std::isalpha(c) != 0; };
+    for (std::size_t index = 0; index + 3 < lower.size(); ++index)
+    {
+        if (is_alpha(lower[index]) && is_alpha(lower[index + 1]) && lower[index + 2] == ':' &&
+            is_alpha(lower[index + 3]))
+        {
+            const auto type_begin = lower.begin() + index + 3;
+            const auto type_end = std::find_if_not(type_begin, lower.end(), is_alpha);
+            const auto speed = findSpeed(maxspeed_table_default, std::string(type_begin, type_end));
+            return speed ? *speed : 0;
+        }
+    }
+    return 0;
+}
+
+bool hasAllDesignatedHovLanes(const std::string &lanes)
+{
+    std::size_t begin = 0;
+    while (true)
+    {
+        const auto end = std::min(lanes.find('|', begin), lanes.size());
+        if (lanes.compare(begin, end - begin, "designated") != 0)
+        {
+            return false;
+        }
+        if (end == lanes.size())
+        {
+            return true;
+        }
+        begin = end + 1;
+    }
+}
+
+// Assemble destination as: "A59: Düsseldorf, Köln"
+//          destination:ref  ^    ^  destination
+std::string getDestination(const osmium::Way &way, const bool is_forward)
+{
+    auto destination = getValue(way, "destination");
+    auto destination_ref = getValue(way, "destination:ref");
+
+    if (is_forward && destination_ref.empty())
+    {
+        destination_ref = getValue(way, "destination:ref:forward");
+    }
+    else if (!is_forward)
+    {
+        destination_ref = getValue(way, "destination:ref:backward");
+    }
+    auto result = boost::algorithm::replace_all_copy(destination_ref, ";", ", ");
+
+    if (is_forward && destination.empty())
+    {
+        destination = getValue(way, "destination:forward");
+    }
+    else if (!is_forward)
+    {
+        destination = getValue(way, "destination:backward");
+    }
+    if (!destination.empty())
+    {
+        if (!result.empty())
+        {
+            result += ": ";
+        }
+        result += boost::algorithm::replace_all_copy(destination, ";", ", ");
+    }
+
+    return result;
+}
+
+void setClassification(const std::string &highway, const osmium::Way &way, ExtractionWay &result)
+{
+    auto &classification = result.road_classification;
+    if (motorway_types.count(highway) > 0)
+    {
+        classification.SetMotorwayFlag(true);
+    }
+    if (link_types.count(highway) > 0)
+    {
+        classification.SetLinkClass(true);
+    }
+    const auto highway_class = highway_classes.find(highway);
+    classification.SetClass(highway_class != highway_classes.end()
+                                ? highway_class->second
+                                : guidance::RoadPriorityClass::CONNECTIVITY);
+    classification.SetLowPriorityFlag(road_types.count(highway) == 0);
+
+    const auto lane_count = getValue(way, "lanes");
+    if (!lane_count.empty())
+    {
+        if (const auto lanes = parseNumber(lane_count))
+        {
+            classification.SetNumberOfLanes(static_cast<std::uint8_t>(*lanes));
+        }
+    }
+    else
+    {
+        double total_count = 0;
+        if (const auto forward_count = parseNumber(getValue(way, "lanes:forward")))
+        {
+            total_count = *forward_count;
+        }
+        if (const auto backward_count = parseNumber(getValue(way, "lanes:backward")))
+        {
+            total_count += *backward_count;
+        }
+        if (total_count != 0)
+        {
+            classification.SetNumberOfLanes(static_cast<std::uint8_t>(total_count));
+        }
+    }
+}
+
+// trims lane string with regard to supported lanes
+std::string processLanes(const std::string &turn_lanes,
+                         const std::string &vehicle_lanes,
+                         const double first_count,
+                         const double second_count)
+{
+    if (turn_lanes.empty())
+    {
+        return turn_lanes;
+    }
+    if (!vehicle_lanes.empty())
+    {
+        return applyAccessTokens(turn_lanes, vehicle_lanes);
+    }
+    if (first_count != 0 || second_count != 0)
+    {
+        return trimLaneString(turn_lanes,
+                              static_cast<std::int32_t>(first_count),
+                              static_cast<std::int32_t>(second_count));
+    }
+    return turn_lanes;
+}
+
+// this is broken for left-sided driving. It needs to switch left and right in case of left-sided
+// driving
+void setTurnLanes(const osmium::Way &way, ExtractionWay &result)
+{
+    // forward and backward psv lane counts
+    double psv_forward = parseNumber(getValue(way, "lanes:psv")).value_or(0);
+    const auto psv_forward_tag = getValue(way, "lanes:psv:forward");
+    if (!psv_forward_tag.empty())
+    {
+        psv_forward = parseNumber(psv_forward_tag).value_or(0);
+    }
+    const double psv_backward = parseNumber(getValue(way, "lanes:psv:backward")).value_or(0);
+
+    const auto turn_lanes = processLanes(getValue(way, "turn:lanes"),
+                                         getValue(way, "vehicle:lanes"),
+                                         psv_backward,
+                                         psv_forward);
+    const auto turn_lanes_forward = processLanes(getValue(way, "turn:lanes:forward"),
+                                                 getValue(way, "vehicle:lanes:forward"),
+                                                 psv_backward,
+                                                 psv_forward);
+    // backwards turn lanes need to treat the backward psv lanes as forward ones and vice versa
+    const auto turn_lanes_backward = processLanes(getValue(way, "turn:lanes:backward"),
+                                                  getValue(way, "vehicle:lanes:backward"),
+                                                  psv_forward,
+                                                  psv_backward);
+
+    if (!turn_lanes.empty())
+    {
+        result.turn_lanes_forward = turn_lanes;
+        result.turn_lanes_backward = turn_lanes;
+    }
+    else
+    {
+        result.turn_lanes_forward = turn_lanes_forward;
+        result.turn_lanes_backward = turn_lanes_backward;
+    }
+}
+
+double scaleSpeed(const double speed,
+                  const std::string &service,
+                  const double width,
+                  const double lanes,
+                  const bool is_bidirectional)
+{
+    const double scaled_speed = speed * speed_reduction;
+    double penalized_speed = infinity;
+    if (const auto service_speed = findSpeed(service_speeds, service))
+    {
+        penalized_speed = *service_speed;
+    }
+    else if (width <= 3 || (lanes <= 1 && is_bidirectional))
+    {
+        penalized_speed = speed / 2;
+    }
+    return std::min(penalized_speed, scaled_speed);
+}
+
+class CarProfile final : public ProfilePlugin
+{
+  public:
+    ProfileProperties GetProfileProperties() const override
+    {
+        ProfileProperties properties;
+        properties.SetUturnPenalty(20);
+        properties.SetTrafficSignalPenalty(2);
+        properties.SetMaxSpeedForMapMatching(180 / 3.6);
+        properties.use_turn_restrictions = true;
+        properties.continue_straight_at_waypoint = true;
+        properties.left_hand_driving = false;
+        return properties;
+    }
+
+    std::vector<std::string> GetNameSuffixList() const override { return suffix_list; }
+
+    std::vector<std::string> GetRestrictions() const override { return restrictions; }
+
+    void ProcessNode(const osmium::Node &node, ExtractionNode &result) const override
+    {
+        // parse access and barrier tags
+        const auto access = findAccessTag(node);
+        if (!access.empty())
+        {
+            if (access_tag_blacklist.count(access) > 0)
+            {
+                result.barrier = true;
+            }
+        }
+        else
+        {
+            const auto barrier = getValue(node, "barrier");
+            // make an exception for rising bollard barriers
+            const bool rising_bollard = getValue(node, "bollard") == "rising";
+            if (!barrier.empty() && barrier_whitelist.count(barrier) == 0 && !rising_bollard)
+            {
+                result.barrier = true;
+            }
+        }
+
+        // check if node is a traffic light
+        if (getValue(node, "highway") == "traffic_signals")
+        {
+            result.traffic_lights = true;
+        }
+    }
+
+    void ProcessWay(const osmium::Way &way, ExtractionWay &result) const override
+    {
+        auto highway = getValue(way, "highway");
+        const auto route = getValue(way, "route");
+        const auto bridge = getValue(way, "bridge");
+
+        if (highway.empty() && route.empty() && bridge.empty())
+        {
+            return;
+        }
+
+        // default to driving mode, may get overwritten below
+        result.forward_travel_mode = TRAVEL_MODE_DRIVING;
+        result.backward_travel_mode = TRAVEL_MODE_DRIVING;
+
+        // we dont route over areas
+        if (ignore_areas && getValue(way, "area") == "yes")
+        {
+            return;
+        }
+
+        const auto oneway = getValue(way, "oneway");
+
+        // respect user-preference for HOV-only ways
+        if (ignore_hov_ways)
+        {
+            if (getValue(way, "hov") == "designated")
+            {
+                return;
+            }
+
+            // also respect user-preference for HOV-only ways when all lanes are HOV-designated
+            const auto all_designated = [&way](const char *key) {
+                const auto lanes = getValue(way, key);
+                return !lanes.empty() && hasAllDesignatedHovLanes(lanes);
+            };
+
+            // forward/backward lane depend on a way's direction
+            const bool reverse = oneway == "-1";
+
+            if (all_designated("hov:lanes") || all_designated("hov:lanes:forward"))
+            {
+                (reverse ? result.backward_travel_mode : result.forward_travel_mode) =
+                    TRAVEL_MODE_INACCESSIBLE;
+            }
+            if (all_designated("hov:lanes:backward"))
+            {
+                (reverse ? result.forward_travel_mode : result.backward_travel_mode) =
+                    TRAVEL_MODE_INACCESSIBLE;
+            }
+        }
+
+        // respect user-preference for toll=yes ways
+        if (ignore_toll_ways && getValue(way, "toll") == "yes")
+        {
+            return;
+        }
+
+        // Reversible oneways change direction with low frequency (think twice a day):
+        // do not route over these at all at the moment because of time dependence.
+        // Note: alternating (high frequency) oneways are handled below with penalty.
+        if (oneway == "reversible")
+        {
+            return;
+        }
+
+        if (getValue(way, "impassable") == "yes" || getValue(way, "status") == "impassable")
+        {
+            return;
+        }
+
+        // Check if we are allowed to access the way
+        const auto access = findAccessTag(way);
+        if (access_tag_blacklist.count(access) > 0)
+        {
+            return;
+        }
+
+        // handling ferries and piers
+        const auto route_speed = findSpeed(speed_profile, route);
+        if (route_speed && *route_speed > 0)
+        {
+            highway = route;
+            setDuration(way, result);
+            result.forward_travel_mode = TRAVEL_MODE_FERRY;
+            result.backward_travel_mode = TRAVEL_MODE_FERRY;
+            result.forward_speed = *route_speed;
+            result.backward_speed = *route_speed;
+        }
+
+        // handling movable bridges, car.lua compares capacity:car to a number which is never equal
+        const auto bridge_speed = findSpeed(speed_profile, bridge);
+        if (bridge_speed && *bridge_speed > 0)
+        {
+            highway = bridge;
+            setDuration(way, result);
+            result.forward_speed = *bridge_speed;
+            result.backward_speed = *bridge_speed;
+        }
+
+        // leave early if this way is not accessible
+        if (highway.empty())
+        {
+            return;
+        }
+
+        if (result.forward_speed == -1)
+        {
+            const auto highway_speed = findSpeed(speed_profile, highway);
+            double max_speed = parseMaxspeed(getValue(way, "maxspeed"));
+            // Set the avg speed on the way if it is accessible by road class
+            if (highway_speed)
+            {
+                result.forward_speed = std::max(max_speed, *highway_speed);
+                result.backward_speed = result.forward_speed;
+            }
+            else if (access_tag_whitelist.count(access) > 0)
+            {
+                // Set the avg speed on ways that are marked accessible
+                result.forward_speed = speed_profile.at("default");
+                result.backward_speed = speed_profile.at("default");
+            }
+            if (max_speed == 0)
+            {
+                max_speed = infinity;
+            }
+            result.forward_speed = std::min(result.forward_speed, max_speed);
+            result.backward_speed = std::min(result.backward_speed, max_speed);
+        }
+
+        if (result.forward_speed == -1 && result.backward_speed == -1)
+        {
+            return;
+        }
+
+        // reduce speed on special side roads
+        const auto sideway = getValue(way, "side_road");
+        if (sideway == "yes" || sideway == "rotary")
+        {
+            result.forward_speed *= side_road_speed_multiplier;
+            result.backward_speed *= side_road_speed_multiplier;
+        }
+
+        // reduce speed on bad surfaces
+        const auto limit_speed = [&result](const SpeedTable &table, const std::string &value) {
+            if (const auto speed = findSpeed(table, value))
+            {
+                result.forward_speed = std::min(*speed, result.forward_speed);
+                result.backward_speed = std::min(*speed, result.backward_speed);
+            }
+        };
+        limit_speed(surface_speeds, getValue(way, "surface"));
+        limit_speed(tracktype_speeds, getValue(way, "tracktype"));
+        limit_speed(smoothness_speeds, getValue(way, "smoothness"));
+
+        // set the road classification based on guidance globals configuration
+        setClassification(highway, way, result);
+
+        // Set the name that will be used for instructions
+        result.name = getValue(way, "name");
+        result.ref = canonicalizeStringList(getValue(way, "ref"), ";");
+        result.pronunciation = getValue(way, "name:pronunciation");
+
+        setTurnLanes(way, result);
+
+        const auto junction = getValue(way, "junction");
+        if (junction == "roundabout")
+        {
+            result.roundabout = true;
+        }
+
+        // Set access restriction flag if access is allowed under certain restrictions only
+        if (access_tag_restricted.count(access) > 0)
+        {
+            result.is_access_restricted = true;
+        }
+
+        const auto service = getValue(way, "service");
+        // Set access restriction flag if service is allowed under certain restrictions only
+        if (service_tag_restricted.count(service) > 0)
+        {
+            result.is_access_restricted = true;
+        }
+        // Set don't allow access to certain service roads
+        if (service_tag_forbidden.count(service) > 0)
+        {
+            result.forward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+            result.backward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+            return;
+        }
+
+        // Set direction according to tags on way
+        if (obey_oneway)
+        {
+            if (oneway == "-1")
+            {
+                result.forward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                result.destinations = canonicalizeStringList(getDestination(way, false), ",");
+            }
+            else if (oneway == "yes" || oneway == "1" || oneway == "true" ||
+                     junction == "roundabout" || (highway == "motorway" && oneway != "no"))
+            {
+                result.backward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                result.destinations = canonicalizeStringList(getDestination(way, true), ",");
+            }
+        }
+
+        const auto is_inaccessible = [](const TravelMode mode) {
+            return mode == TRAVEL_MODE_INACCESSIBLE;
+        };
+
+        // Override speed settings if explicit forward/backward maxspeeds are given
+        const auto maxspeed_forward = parseMaxspeed(getValue(way, "maxspeed:forward"));
+        const auto maxspeed_backward = parseMaxspeed(getValue(way, "maxspeed:backward"));
+        if (maxspeed_forward > 0)
+        {
+            if (!is_inaccessible(result.forward_travel_mode) &&
+                !is_inaccessible(result.backward_travel_mode))
+            {
+                result.backward_speed = result.forward_speed;
+            }
+            result.forward_speed = maxspeed_forward;
+        }
+        if (maxspeed_backward > 0)
+        {
+            result.backward_speed = maxspeed_backward;
+        }
+
+        // Override speed settings if advisory forward/backward maxspeeds are given
+        const auto advisory_speed = parseMaxspeed(getValue(way, "maxspeed:advisory"));
+        const auto advisory_forward = parseMaxspeed(getValue(way, "maxspeed:advisory:forward"));
+        const auto advisory_backward = parseMaxspeed(getValue(way, "maxspeed:advisory:backward"));
+        // apply bi-directional advisory speed first
+        if (advisory_speed > 0)
+        {
+            if (!is_inaccessible(result.forward_travel_mode))
+            {
+                result.forward_speed = advisory_speed;
+            }
+            if (!is_inaccessible(result.backward_travel_mode))
+            {
+                result.backward_speed = advisory_speed;
+            }
+        }
+        if (advisory_forward > 0)
+        {
+            if (!is_inaccessible(result.forward_travel_mode) &&
+                !is_inaccessible(result.backward_travel_mode))
+            {
+                result.backward_speed = result.forward_speed;
+            }
+            result.forward_speed = advisory_forward;
+        }
+        if (advisory_backward > 0)
+        {
+            result.backward_speed = advisory_backward;
+        }
+
+        double width = infinity;
+        double lanes = infinity;
+        if (result.forward_speed > 0 || result.backward_speed > 0)
+        {
+            width = parseLeadingDigits(getValue(way, "width")).value_or(infinity);
+            lanes = parseLeadingDigits(getValue(way, "lanes")).value_or(infinity);
+        }
+
+        const bool is_bidirectional = !is_inaccessible(result.forward_travel_mode) &&
+                                      !is_inaccessible(result.backward_travel_mode);
+
+        // scale speeds to get better avg driving times
+        if (result.forward_speed > 0)
+        {
+            result.forward_speed =
+                scaleSpeed(result.forward_speed, service, width, lanes, is_bidirectional);
+        }
+        if (result.backward_speed > 0)
+        {
+            result.backward_speed =
+                scaleSpeed(result.backward_speed, service, width, lanes, is_bidirectional);
+        }
+
+        // Handle high frequency reversible oneways (think traffic signal controlled, changing
+        // direction every 15 minutes). Scaling speed to take average waiting time into account
+        // plus some more for start / stop.
+        if (oneway == "alternating")
+        {
+            const double scaling_factor = 0.4;
+            if (result.forward_speed != infinity)
+            {
+                result.forward_speed *= scaling_factor;
+            }
+            if (result.backward_speed != infinity)
+            {
+                result.backward_speed *= scaling_factor;
+            }
+        }
+
+        // only allow this road as start point if it not a ferry
+        result.is_startpoint = result.forward_travel_mode == TRAVEL_MODE_DRIVING ||
+                               result.backward_travel_mode == TRAVEL_MODE_DRIVING;
+    }
+
+    double GetTurnPenalty(const double angle) const override
+    {
+        // Use a sigmoid function to return a penalty that maxes out at turn_penalty
+        // over the space of 0-180 degrees.  Values here were chosen by fitting
+        // the function to some turn penalty samples from real driving.
+        // multiplying by 10 converts to deci-seconds see issue #1318
+        if (angle >= 0)
+        {
+            return 10 * turn_penalty /
+                   (1 + std::pow(2.718, -((13 / turn_bias) * angle / 180 - 6.5 * turn_bias)));
+        }
+        return 10 * turn_penalty /
+               (1 + std::pow(2.718, -((13 * turn_bias) * -angle / 180 - 6.5 / turn_bias)));
+    }
+
+  private:
+    static void setDuration(const osmium::Way &way, ExtractionWay &result)
+    {
+        const auto duration = getValue(way, "duration");
+        if (durationIsValid(duration))
+        {
+            result.duration = std::max(parseDuration(duration), 1u);
+        }
+    }
+};
+}
+
+OSRM_PROFILE_PLUGIN(CarProfile)
@@ -3,6 +3,8 @@
 
 require 'testbot'
 
+turn_function_is_pure = true
+
 function turn_function (angle)
     -- multiplying by 10 converts to deci-seconds see issue #1318
     return 10*20*math.abs(angle)/180
@@ -0,0 +1,196 @@
+#include "contractor/cell_customizer.hpp"
+
+#include "util/binary_heap.hpp"
+#include "util/exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+
+struct CustomizationHeapData
+{
+    // the node was reached by a weight of a cell of the level below
+    bool from_cell;
+};
+
+using CustomizationHeap = util::BinaryHeap<NodeID,
+                                           NodeID,
+                                           EdgeWeight,
+                                           CustomizationHeapData,
+                                           util::UnorderedMapStorage<NodeID, int>>;
+
+// Forward adjacency array of the edge-based graph
+struct DirectedGraph
+{
+    std::vector<EdgeID> first_edge;
+    std::vector<NodeID> targets;
+    std::vector<EdgeWeight> weights;
+};
+
+DirectedGraph
+buildDirectedGraph(const NodeID number_of_nodes,
+                   const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    DirectedGraph graph;
+    graph.first_edge.resize(number_of_nodes + 1, 0);
+
+    const auto for_each_arc = [&](const auto &function) {
+        for (const auto &edge : edge_based_edge_list)
+        {
+            if (edge.source >= number_of_nodes || edge.target >= number_of_nodes)
+            {
+                throw util::exception("Edge " + std::to_string(edge.source) + "," +
+                                      std::to_string(edge.target) +
+                                      " exceeds the number of nodes");
+            }
+            if (edge.forward)
+            {
+                function(edge.source, edge.target, edge.weight);
+            }
+            if (edge.backward)
+            {
+                function(edge.target, edge.source, edge.weight);
+            }
+        }
+    };
+
+    for_each_arc([&](const NodeID from, const NodeID, const EdgeWeight) {
+        ++graph.first_edge[from + 1];
+    });
+    std::partial_sum(graph.first_edge.begin(), graph.first_edge.end(), graph.first_edge.begin());
+
+    graph.targets.resize(graph.first_edge.back());
+    graph.weights.resize(graph.first_edge.back());
+    std::vector<EdgeID> next_edge(graph.first_edge.begin(), graph.first_edge.end() - 1);
+    for_each_arc([&](const NodeID from, const NodeID to, const EdgeWeight weight) {
+        const auto edge = next_edge[from]++;
+        graph.targets[edge] = to;
+        graph.weights[edge] = weight;
+    });
+
+    return graph;
+}
+}
+
+std::vector<EdgeWeight>
+customizeCells(const MultiLevelPartition<> &partition,
+               const CellStorage<> &cells,
+               const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    const auto number_of_nodes = static_cast<NodeID>(partition.GetNumberOfNodes());
+    const auto graph = buildDirectedGraph(number_of_nodes, edge_based_edge_list);
+
+    std::vector<EdgeWeight> weights(cells.GetNumberOfWeights(), INVALID_EDGE_WEIGHT);
+    const auto &boundary_nodes = cells.GetBoundaryNodes();
+    const auto get_cell = [&](const LevelID level, const CellID cell) {
+        return Cell{cells.GetCellData(level, cell), boundary_nodes.data(), weights.data()};
+    };
+
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        util::SimpleLogger().Write() << "Customizing " << partition.GetNumberOfCells(level)
+                                     << " cells of level " << static_cast<int>(level);
+
+        // the cells of a level only read the weights of the level below
+        tbb::parallel_for(
+            tbb::blocked_range<CellID>(0, partition.GetNumberOfCells(level)),
+            [&](const tbb::blocked_range<CellID> &range) {
+                CustomizationHeap heap(number_of_nodes);
+                for (auto id = range.begin(); id != range.end(); ++id)
+                {
+                    const auto cell = get_cell(level, id);
+                    auto *const cell_weights =
+                        weights.data() + cells.GetCellData(level, id).weight_offset;
+
+                    for (std::uint32_t source = 0; source < cell.GetNumberOfSources(); ++source)
+                    {
+                        heap.Clear();
+                        heap.Insert(cell.GetSource(source), 0, {false});
+                        const auto relax = [&heap](const NodeID to,
+                                                   const EdgeWeight to_weight,
+                                                   const bool from_cell) {
+                            if (!heap.WasInserted(to))
+                            {
+                                heap.Insert(to, to_weight, {from_cell});
+                            }
+                            else if (to_weight < heap.GetKey(to))
+                            {
+                                heap.GetData(to).from_cell = from_cell;
+                                heap.DecreaseKey(to, to_weight);
+                            }
+                        };
+
+                        while (!heap.Empty())
+                        {
+                            const NodeID node = heap.DeleteMin();
+                            const EdgeWeight weight = heap.GetKey(node);
+
+                            // inside of the cells of the level below only their weights are used
+                            if (level > 1 && !heap.GetData(node).from_cell)
+                            {
+                                const auto subcell =
+                                    get_cell(level - 1, partition.GetCell(level - 1, node));
+                                const auto index = subcell.FindSource(node);
+                                for (std::uint32_t destination = 0;
+                                     index < subcell.GetNumberOfSources() &&
+                                     destination < subcell.GetNumberOfDestinations();
+                                     ++destination)
+                                {
+                                    const auto subcell_weight =
+                                        subcell.GetWeight(index, destination);
+                                    if (subcell_weight != INVALID_EDGE_WEIGHT)
+                                    {
+                                        relax(subcell.GetDestination(destination),
+                                              weight + subcell_weight,
+                                              true);
+                                    }
+                                }
+                            }
+
+                            for (auto edge = graph.first_edge[node];
+                                 edge < graph.first_edge[node + 1];
+                                 ++edge)
+                            {
+                                const NodeID target = graph.targets[edge];
+                                if (partition.GetCell(level, target) != id ||
+                                    (level > 1 && partition.GetCell(level - 1, target) ==
+                                                      partition.GetCell(level - 1, node)))
+                                {
+                                    continue;
+                                }
+                                relax(target, weight + graph.weights[edge], false);
+                            }
+                        }
+
+                        for (std::uint32_t destination = 0;
+                             destination < cell.GetNumberOfDestinations();
+                             ++destination)
+                        {
+                            const NodeID node = cell.GetDestination(destination);
+                            cell_weights[source * cell.GetNumberOfDestinations() + destination] =
+                                heap.WasInserted(node) ? heap.GetKey(node) : INVALID_EDGE_WEIGHT;
+                        }
+                    }
+                }
+            });
+    }
+
+    return weights;
+}
+}
+}
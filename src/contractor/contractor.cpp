@@ -1,28 +1,35 @@
 #include "contractor/contractor.hpp"
+#include "contractor/cell_customizer.hpp"
 #include "contractor/crc32_processor.hpp"
+#include "contractor/customizable_contraction_hierarchy.hpp"
 #include "contractor/graph_contractor.hpp"
+#include "contractor/graph_partitioner.hpp"
+#include "contractor/multi_level_files.hpp"
+#include "contractor/traffic_files.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/node_based_edge.hpp"
+#include "extractor/segment_index.hpp"
 
+#include "util/coordinate_calculation.hpp"
 #include "util/exception.hpp"
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
 #include "util/io.hpp"
+#include "util/resident_memory.hpp"
 #include "util/simple_logger.hpp"
 #include "util/static_graph.hpp"
-#include "util/static_rtree.hpp"
 #include "util/string_util.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
-#include <boost/spirit/include/qi.hpp>
 
 #include <tbb/blocked_range.h>
 #include <tbb/concurrent_unordered_map.h>
@@ -35,6 +42,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iterator>
@@ -132,64 +140,94 @@ int Contractor::Run()
         throw util::exception("Core factor must be between 0.0 to 1.0 (inclusive)");
     }
 
+    if (config.use_cch && config.use_mld)
+    {
+        throw util::exception("The graph can either be contracted or partitioned, not both");
+    }
+
+    if ((config.use_cch || config.use_mld) &&
+        (config.core_factor < 1.0 || config.use_cached_priority))
+    {
+        throw util::exception("Customizable graphs have neither a core nor a level cache");
+    }
+
+    if ((config.use_cch || config.use_mld) && config.eager_compaction)
+    {
+        throw util::exception("Eager compaction is only available for contraction hierarchies");
+    }
+
+    if ((config.use_cch || config.use_mld) && config.resume)
+    {
+        throw util::exception("Only the contraction of contraction hierarchies can be resumed");
+    }
+
     TIMER_START(preparing);
 
     util::SimpleLogger().Write() << "Loading edge-expanded graph representation";
 
     util::DeallocatingVector<extractor::EdgeBasedEdge> edge_based_edge_list;
 
-    EdgeID max_edge_id = LoadEdgeExpandedGraph(config.edge_based_graph_path,
-                                               edge_based_edge_list,
-                                               config.edge_segment_lookup_path,
-                                               config.edge_penalty_path,
-                                               config.segment_speed_lookup_paths,
-                                               config.turn_penalty_lookup_paths,
-                                               config.node_based_graph_path,
-                                               config.geometry_path,
-                                               config.datasource_names_path,
-                                               config.datasource_indexes_path,
-                                               config.rtree_leaf_path,
-                                               config.log_edge_updates_factor);
+    EdgeID max_edge_id = LoadEdgeExpandedGraph(edge_based_edge_list);
 
     // Contracting the edge-expanded graph
 
     TIMER_START(contraction);
     std::vector<bool> is_core_node;
     std::vector<float> node_levels;
-    if (config.use_cached_priority)
+    util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    if (config.use_cch)
     {
-        ReadNodeLevels(node_levels);
+        ContractGraphCustomizable(max_edge_id, edge_based_edge_list, contracted_edge_list);
     }
-
-    util::SimpleLogger().Write() << "Reading node weights.";
-    std::vector<EdgeWeight> node_weights;
-    std::string node_file_name = config.osrm_input_path.string() + ".enw";
-    if (util::deserializeVector(node_file_name, node_weights))
+    else if (config.use_mld)
     {
-        util::SimpleLogger().Write() << "Done reading node weights.";
+        PartitionGraph(max_edge_id, edge_based_edge_list, contracted_edge_list);
     }
     else
     {
-        throw util::exception("Failed reading node weights.");
-    }
+        if (config.use_cached_priority)
+        {
+            ReadNodeLevels(node_levels);
+        }
 
-    util::DeallocatingVector<QueryEdge> contracted_edge_list;
-    ContractGraph(max_edge_id,
-                  edge_based_edge_list,
-                  contracted_edge_list,
-                  std::move(node_weights),
-                  is_core_node,
-                  node_levels);
+        std::vector<EdgeWeight> node_weights;
+        ReadNodeWeights(node_weights);
+
+        ContractGraph(max_edge_id,
+                      edge_based_edge_list,
+                      contracted_edge_list,
+                      std::move(node_weights),
+                      is_core_node,
+                      node_levels);
+    }
     TIMER_STOP(contraction);
 
     util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
     std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
     WriteCoreNodeMarker(std::move(is_core_node));
-    if (!config.use_cached_priority)
+    if (config.eager_compaction)
+    {
+        ReportPeakMemory();
+    }
+    if (!config.use_cached_priority && !config.use_cch && !config.use_mld)
     {
         WriteNodeLevels(std::move(node_levels));
     }
+    // the contraction is complete, nothing is left to resume
+    boost::filesystem::remove(config.checkpoint_path);
+
+    // osrm-customize and osrm-routed tell the kind of the graph by the files that exist
+    if (!config.use_cch)
+    {
+        boost::filesystem::remove(config.cch_path);
+    }
+    if (!config.use_mld)
+    {
+        boost::filesystem::remove(config.partition_path);
+        boost::filesystem::remove(config.cells_path);
+        boost::filesystem::remove(config.cell_metrics_path);
+    }
 
     TIMER_STOP(preparing);
 
@@ -295,37 +333,16 @@ parse_segment_lookup_from_csv_files(const std::vector<std::string> &segment_spee
         const auto file_id = idx + 1; // starts at one, zero means we assigned the weight
         const auto filename = segment_speed_filenames[idx];
 
-        std::ifstream segment_speed_file{filename, std::ios::binary};
-        if (!segment_speed_file)
-            throw util::exception{"Unable to open segment speed file " + filename};
+        // a single large file is parsed in parallel as well
+        const auto records = readSegmentSpeeds(filename);
 
         SegmentSpeedSourceFlatMap local;
-
-        std::uint64_t from_node_id{};
-        std::uint64_t to_node_id{};
-        unsigned speed{};
-
-        for (std::string line; std::getline(segment_speed_file, line);)
+        local.reserve(records.size());
+        for (const auto &record : records)
         {
-            using namespace boost::spirit::qi;
-
-            auto it = begin(line);
-            const auto last = end(line);
-
-            // The ulong_long -> uint64_t will likely break on 32bit platforms
-            const auto ok =
-                parse(it,
-                      last,                                                                  //
-                      (ulong_long >> ',' >> ulong_long >> ',' >> uint_ >> *(',' >> *char_)), //
-                      from_node_id,
-                      to_node_id,
-                      speed); //
-
-            if (!ok || it != last)
-                throw util::exception{"Segment speed file " + filename + " malformed"};
-
-            SegmentSpeedSource val{{OSMNodeID{from_node_id}, OSMNodeID{to_node_id}},
-                                   {speed, static_cast<std::uint8_t>(file_id)}};
+            SegmentSpeedSource val{{OSMNodeID{record.from}, OSMNodeID{record.to}},
+                                   {static_cast<unsigned>(record.speed),
+                                    static_cast<std::uint8_t>(file_id)}};
 
             local.push_back(std::move(val));
         }
@@ -383,40 +400,15 @@ parse_turn_penalty_lookup_from_csv_files(const std::vector<std::string> &turn_pe
         const auto file_id = idx + 1; // starts at one, zero means we assigned the weight
         const auto filename = turn_penalty_filenames[idx];
 
-        std::ifstream turn_penalty_file{filename, std::ios::binary};
-        if (!turn_penalty_file)
-            throw util::exception{"Unable to open turn penalty file " + filename};
+        const auto records = readTurnPenalties(filename);
 
         TurnPenaltySourceFlatMap local;
-
-        std::uint64_t from_node_id{};
-        std::uint64_t via_node_id{};
-        std::uint64_t to_node_id{};
-        double penalty{};
-
-        for (std::string line; std::getline(turn_penalty_file, line);)
+        local.reserve(records.size());
+        for (const auto &record : records)
         {
-            using namespace boost::spirit::qi;
-
-            auto it = begin(line);
-            const auto last = end(line);
-
-            // The ulong_long -> uint64_t will likely break on 32bit platforms
-            const auto ok = parse(it,
-                                  last, //
-                                  (ulong_long >> ',' >> ulong_long >> ',' >> ulong_long >> ',' >>
-                                   double_ >> *(',' >> *char_)), //
-                                  from_node_id,
-                                  via_node_id,
-                                  to_node_id,
-                                  penalty); //
-
-            if (!ok || it != last)
-                throw util::exception{"Turn penalty file " + filename + " malformed"};
-
             TurnPenaltySource val{
-                {OSMNodeID{from_node_id}, OSMNodeID{via_node_id}, OSMNodeID{to_node_id}},
-                {penalty, static_cast<std::uint8_t>(file_id)}};
+                {OSMNodeID{record.from}, OSMNodeID{record.via}, OSMNodeID{record.to}},
+                {record.penalty, static_cast<std::uint8_t>(file_id)}};
             local.push_back(std::move(val));
         }
 
@@ -461,8 +453,191 @@ parse_turn_penalty_lookup_from_csv_files(const std::vector<std::string> &turn_pe
 
     return map;
 }
+
+// Returns the weight of an edge-based edge from its segments in .edge_segment_lookup and its turn
+// in .edge_penalties, INVALID_EDGE_WEIGHT if one of its segments has zero speed
+EdgeWeight getNewEdgeWeight(const char *edge_segment_byte_ptr,
+                            const extractor::lookup::PenaltyBlock &penaltyblock,
+                            const SegmentSpeedSourceFlatMap &segment_speed_lookup,
+                            const TurnPenaltySourceFlatMap &turn_penalty_lookup)
+{
+    auto header =
+        reinterpret_cast<const extractor::lookup::SegmentHeaderBlock *>(edge_segment_byte_ptr);
+    edge_segment_byte_ptr += sizeof(extractor::lookup::SegmentHeaderBlock);
+
+    auto previous_osm_node_id = header->previous_osm_node_id;
+    EdgeWeight new_weight = 0;
+    int compressed_edge_nodes = static_cast<int>(header->num_osm_nodes);
+
+    auto segmentblocks =
+        reinterpret_cast<const extractor::lookup::SegmentBlock *>(edge_segment_byte_ptr);
+
+    const auto num_segments = header->num_osm_nodes - 1;
+    for (auto i : util::irange<std::size_t>(0, num_segments))
+    {
+        auto speed_iter = find(
+            segment_speed_lookup,
+            SegmentSpeedSource{previous_osm_node_id, segmentblocks[i].this_osm_node_id, {0, 0}});
+        if (speed_iter != segment_speed_lookup.end())
+        {
+            if (speed_iter->speed_source.speed > 0)
+            {
+                const auto new_segment_weight = distanceAndSpeedToWeight(
+                    segmentblocks[i].segment_length, speed_iter->speed_source.speed);
+                new_weight += new_segment_weight;
+            }
+            else
+            {
+                // If we hit a 0-speed edge, then it's effectively not traversible.
+                // We don't want to include it in the edge_based_edge_list.
+                return INVALID_EDGE_WEIGHT;
+            }
+        }
+        else
+        {
+            // If no lookup found, use the original weight value for this segment
+            new_weight += segmentblocks[i].segment_weight;
+        }
+
+        previous_osm_node_id = segmentblocks[i].this_osm_node_id;
+    }
+
+    auto turn_iter = find(
+        turn_penalty_lookup,
+        TurnPenaltySource{penaltyblock.from_id, penaltyblock.via_id, penaltyblock.to_id, {0, 0}});
+    if (turn_iter != turn_penalty_lookup.end())
+    {
+        int new_turn_weight = static_cast<int>(turn_iter->penalty_source.penalty * 10);
+
+        if (new_turn_weight + new_weight < compressed_edge_nodes)
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "turn penalty " << turn_iter->penalty_source.penalty << " for turn "
+                << penaltyblock.from_id << ", " << penaltyblock.via_id << ", "
+                << penaltyblock.to_id << " is too negative: clamping turn weight to "
+                << compressed_edge_nodes;
+        }
+
+        return std::max(new_turn_weight + new_weight, compressed_edge_nodes);
+    }
+
+    return penaltyblock.fixed_penalty + new_weight;
+}
+
+// Multi-Level Dijkstra searches the uncontracted graph: every edge is stored at its source for
+// the forward search and at its target for the backward search
+void buildBaseGraph(
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &base_edge_list)
+{
+    for (const auto &edge : edge_based_edge_list)
+    {
+        if (edge.source == edge.target)
+        {
+            continue;
+        }
+        const auto add_arc = [&](const NodeID from, const NodeID to) {
+            QueryEdge::EdgeData data;
+            data.id = edge.edge_id;
+            data.shortcut = false;
+            data.weight = edge.weight;
+            data.forward = true;
+            data.backward = false;
+            base_edge_list.push_back(QueryEdge(from, to, data));
+            data.forward = false;
+            data.backward = true;
+            base_edge_list.push_back(QueryEdge(to, from, data));
+        };
+        if (edge.forward)
+        {
+            add_arc(edge.source, edge.target);
+        }
+        if (edge.backward)
+        {
+            add_arc(edge.target, edge.source);
+        }
+    }
+}
 } // anon ns
 
+int Contractor::Customize()
+{
+    TIMER_START(preparing);
+
+    util::SimpleLogger().Write() << "Loading edge-expanded graph representation";
+
+    util::DeallocatingVector<extractor::EdgeBasedEdge> edge_based_edge_list;
+
+    EdgeID max_edge_id = LoadEdgeExpandedGraph(edge_based_edge_list);
+
+    TIMER_START(customization);
+    util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    if (boost::filesystem::exists(config.cch_path))
+    {
+        util::SimpleLogger().Write() << "Reading contraction hierarchy topology";
+        const CustomizableContractionHierarchy hierarchy(config.cch_path);
+        if (hierarchy.GetNumberOfNodes() != max_edge_id + 1)
+        {
+            throw util::exception(config.cch_path + " does not match " +
+                                  config.edge_based_graph_path +
+                                  ", rebuild it with osrm-contract --cch");
+        }
+        std::vector<EdgeWeight> node_weights;
+        ReadNodeWeights(node_weights);
+        hierarchy.Customize(edge_based_edge_list, node_weights, contracted_edge_list);
+    }
+    else if (boost::filesystem::exists(config.partition_path))
+    {
+        util::SimpleLogger().Write() << "Reading multi-level partition";
+        const auto partition = readPartition(config.partition_path);
+        if (partition.GetNumberOfNodes() != max_edge_id + 1)
+        {
+            throw util::exception(config.partition_path + " does not match " +
+                                  config.edge_based_graph_path +
+                                  ", rebuild it with osrm-contract --mld");
+        }
+        const auto cells = readCells(config.cells_path, partition);
+        writeCellMetrics(config.cell_metrics_path,
+                         customizeCells(partition, cells, edge_based_edge_list));
+        buildBaseGraph(edge_based_edge_list, contracted_edge_list);
+    }
+    else
+    {
+        throw util::exception("Neither " + config.cch_path + " nor " + config.partition_path +
+                              " exist, run osrm-contract with --cch or --mld first");
+    }
+    TIMER_STOP(customization);
+
+    util::SimpleLogger().Write() << "Customization took " << TIMER_SEC(customization) << " sec";
+
+    WriteContractedGraph(max_edge_id, contracted_edge_list);
+    WriteCoreNodeMarker({});
+
+    TIMER_STOP(preparing);
+
+    util::SimpleLogger().Write() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
+    util::SimpleLogger().Write() << "finished preprocessing";
+
+    return 0;
+}
+
+EdgeID Contractor::LoadEdgeExpandedGraph(
+    util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    return LoadEdgeExpandedGraph(config.edge_based_graph_path,
+                                 edge_based_edge_list,
+                                 config.edge_segment_lookup_path,
+                                 config.edge_penalty_path,
+                                 config.segment_speed_lookup_paths,
+                                 config.turn_penalty_lookup_paths,
+                                 config.node_based_graph_path,
+                                 config.geometry_path,
+                                 config.datasource_names_path,
+                                 config.datasource_indexes_path,
+                                 config.edge_segment_index_path,
+                                 config.log_edge_updates_factor);
+}
+
 EdgeID Contractor::LoadEdgeExpandedGraph(
     std::string const &edge_based_graph_filename,
     util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
@@ -474,7 +649,7 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
     const std::string &geometry_filename,
     const std::string &datasource_names_filename,
     const std::string &datasource_indexes_filename,
-    const std::string &rtree_leaf_filename,
+    const std::string &edge_segment_index_filename,
     const double log_edge_updates_factor)
 {
     if (segment_speed_filenames.size() > 255 || turn_penalty_filenames.size() > 255)
@@ -533,7 +708,8 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
     const util::FingerPrint fingerprint_valid = util::FingerPrint::GetValid();
     graph_header.fingerprint.TestContractor(fingerprint_valid);
 
-    edge_based_edge_list.resize(graph_header.number_of_edges);
+    // the edges are appended while streaming through the memory map below
+    edge_based_edge_list.reserve(graph_header.number_of_edges);
     util::SimpleLogger().Write() << "Reading " << graph_header.number_of_edges
                                  << " edges from the edge based graph";
 
@@ -559,6 +735,12 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
     std::vector<NodeID> m_geometry_node_list;
     std::vector<EdgeWeight> m_geometry_fwd_weight_list;
     std::vector<EdgeWeight> m_geometry_rev_weight_list;
+    extractor::SegmentIndex segment_index;
+
+    const auto maybe_load_segment_index = [&] {
+        if (update_edge_weights || update_turn_penalties)
+            segment_index = extractor::readSegmentIndex(edge_segment_index_filename);
+    };
 
     const auto maybe_load_internal_to_external_node_map = [&] {
         if (!(update_edge_weights || update_turn_penalties))
@@ -625,7 +807,8 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
     tbb::parallel_invoke(parse_segment_speeds,
                          parse_turn_penalties, //
                          maybe_load_internal_to_external_node_map,
-                         maybe_load_geometries);
+                         maybe_load_geometries,
+                         maybe_load_segment_index);
 
     if (update_edge_weights || update_turn_penalties)
     {
@@ -640,19 +823,15 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
         // vector tiles later on.
         m_geometry_datasource.resize(m_geometry_fwd_weight_list.size(), 0);
 
-        // Now, we iterate over all the segments stored in the StaticRTree, updating
-        // the packed geometry weights in the `.geometries` file (note: we do not
-        // update the RTree itself, we just use the leaf nodes to iterate over all segments)
-        using LeafNode = util::StaticRTree<extractor::EdgeBasedNode>::LeafNode;
-
-        using boost::interprocess::mapped_region;
-
-        auto region = mmap_file(rtree_leaf_filename.c_str());
-        region.advise(mapped_region::advice_willneed);
+        if (segment_index.segment_offsets.size() != graph_header.number_of_edges)
+        {
+            throw util::exception(edge_segment_index_filename +
+                                  " does not match the edge based graph, rerun osrm-extract");
+        }
 
-        const auto bytes = region.get_size();
-        const auto first = static_cast<const LeafNode *>(region.get_address());
-        const auto last = first + (bytes / sizeof(LeafNode));
+        // Now, we update the weights of the segments that are part of the update, the segment
+        // index points us to their positions in the packed geometries of the `.geometries` file
+        // (note: we do not update the RTree itself)
 
         // vector to count used speeds for logging
         // size offset by one since index 0 is used for speeds not from external file
@@ -662,80 +841,43 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
             counters_type(num_counters, 0));
         const constexpr auto LUA_SOURCE = 0;
 
-        tbb::parallel_for_each(first, last, [&](const LeafNode &current_node) {
-            auto &counters = segment_speeds_counters.local();
-            for (size_t i = 0; i < current_node.object_count; i++)
-            {
-                const auto &leaf_object = current_node.objects[i];
-                extractor::QueryNode *u;
-                extractor::QueryNode *v;
-
-                const unsigned forward_begin =
-                    m_geometry_indices.at(leaf_object.packed_geometry_id);
-                const auto current_fwd_weight =
-                    m_geometry_fwd_weight_list[forward_begin + leaf_object.fwd_segment_position];
-
-                u = &(internal_to_external_node_map
-                          [m_geometry_node_list[forward_begin + leaf_object.fwd_segment_position]]);
-                v = &(internal_to_external_node_map
-                          [m_geometry_node_list[forward_begin + leaf_object.fwd_segment_position +
-                                                1]]);
-
-                const double segment_length = util::coordinate_calculation::greatCircleDistance(
-                    util::Coordinate{u->lon, u->lat}, util::Coordinate{v->lon, v->lat});
-
-                auto forward_speed_iter = find(
-                    segment_speed_lookup, SegmentSpeedSource{{u->node_id, v->node_id}, {0, 0}});
-                if (forward_speed_iter != segment_speed_lookup.end())
-                {
-                    const auto new_segment_weight = getNewWeight(forward_speed_iter,
-                                                                 segment_length,
-                                                                 segment_speed_filenames,
-                                                                 current_fwd_weight,
-                                                                 log_edge_updates_factor);
-
-                    m_geometry_fwd_weight_list[forward_begin + 1 +
-                                               leaf_object.fwd_segment_position] =
-                        new_segment_weight;
-                    m_geometry_datasource[forward_begin + 1 + leaf_object.fwd_segment_position] =
-                        forward_speed_iter->speed_source.source;
-
-                    // count statistics for logging
-                    counters[forward_speed_iter->speed_source.source] += 1;
-                }
-                else
-                {
-                    // count statistics for logging
-                    counters[LUA_SOURCE] += 1;
-                }
-
-                const auto current_rev_weight =
-                    m_geometry_rev_weight_list[forward_begin + leaf_object.fwd_segment_position];
-
-                const auto reverse_speed_iter = find(
-                    segment_speed_lookup, SegmentSpeedSource{{v->node_id, u->node_id}, {0, 0}});
-
-                if (reverse_speed_iter != segment_speed_lookup.end())
-                {
-                    const auto new_segment_weight = getNewWeight(reverse_speed_iter,
-                                                                 segment_length,
-                                                                 segment_speed_filenames,
-                                                                 current_rev_weight,
-                                                                 log_edge_updates_factor);
-                    m_geometry_rev_weight_list[forward_begin + leaf_object.fwd_segment_position] =
-                        new_segment_weight;
-                    m_geometry_datasource[forward_begin + leaf_object.fwd_segment_position] =
-                        reverse_speed_iter->speed_source.source;
-
-                    // count statistics for logging
-                    counters[reverse_speed_iter->speed_source.source] += 1;
-                }
-                else
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, segment_speed_lookup.size()),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                auto &counters = segment_speeds_counters.local();
+                for (auto index = range.begin(); index != range.end(); ++index)
                 {
-                    counters[LUA_SOURCE] += 1;
+                    const auto speed_iter = segment_speed_lookup.begin() + index;
+                    const auto segments = segment_index.GetGeometrySegments(
+                        speed_iter->segment.from, speed_iter->segment.to);
+                    for (auto segment = segments.first; segment != segments.second; ++segment)
+                    {
+                        const auto &u = internal_to_external_node_map
+                            [m_geometry_node_list[segment->first_position]];
+                        const auto &v = internal_to_external_node_map
+                            [m_geometry_node_list[segment->first_position + 1]];
+
+                        const double segment_length =
+                            util::coordinate_calculation::greatCircleDistance(
+                                util::Coordinate{u.lon, u.lat}, util::Coordinate{v.lon, v.lat});
+
+                        auto &weights = segment->forward ? m_geometry_fwd_weight_list
+                                                         : m_geometry_rev_weight_list;
+                        const auto position = segment->forward ? segment->first_position + 1
+                                                               : segment->first_position;
+
+                        weights[position] = getNewWeight(speed_iter,
+                                                         segment_length,
+                                                         segment_speed_filenames,
+                                                         weights[position],
+                                                         log_edge_updates_factor);
+                        m_geometry_datasource[position] = speed_iter->speed_source.source;
+
+                        // count statistics for logging
+                        counters[speed_iter->speed_source.source] += 1;
+                    }
                 }
-            }
-        }); // parallel_for_each
+            });
 
         counters_type merged_counters(num_counters, 0);
         for (const auto &counters : segment_speeds_counters)
@@ -745,6 +887,12 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
                 merged_counters[i] += counters[i];
             }
         }
+        // all segments without update keep the weight of the profile
+        merged_counters[LUA_SOURCE] = segment_index.geometry_segments.size();
+        for (std::size_t i = 1; i < merged_counters.size(); i++)
+        {
+            merged_counters[LUA_SOURCE] -= merged_counters[i];
+        }
 
         for (std::size_t i = 0; i < merged_counters.size(); i++)
         {
@@ -823,9 +971,75 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
 
     tbb::parallel_invoke(maybe_save_geometries, save_datasource_indexes, save_datastore_names);
 
-    auto penaltyblock = reinterpret_cast<const extractor::lookup::PenaltyBlock *>(
-        edge_penalty_region.get_address());
-    auto edge_segment_byte_ptr = reinterpret_cast<const char *>(edge_segment_region.get_address());
+    // Only the edge-based edges that contain an updated segment or take a turn with an updated
+    // penalty change their weight, we find them with the segment index and compute their new
+    // weights up front
+    std::vector<EdgeID> updated_edges;
+    std::vector<EdgeWeight> updated_edge_weights;
+    if (update_edge_weights || update_turn_penalties)
+    {
+        tbb::enumerable_thread_specific<std::vector<EdgeID>> local_updated_edges;
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, segment_speed_lookup.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              auto &edges = local_updated_edges.local();
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  const auto &segment = segment_speed_lookup[index].segment;
+                                  const auto segment_edges =
+                                      segment_index.GetSegmentEdges(segment.from, segment.to);
+                                  for (auto it = segment_edges.first; it != segment_edges.second;
+                                       ++it)
+                                  {
+                                      edges.push_back(it->edge);
+                                  }
+                              }
+                          });
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, turn_penalty_lookup.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              auto &edges = local_updated_edges.local();
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  const auto &turn = turn_penalty_lookup[index].segment;
+                                  const auto turn_edges =
+                                      segment_index.GetTurnEdges(turn.from, turn.via, turn.to);
+                                  for (auto it = turn_edges.first; it != turn_edges.second; ++it)
+                                  {
+                                      edges.push_back(it->edge);
+                                  }
+                              }
+                          });
+
+        for (const auto &edges : local_updated_edges)
+        {
+            updated_edges.insert(updated_edges.end(), edges.begin(), edges.end());
+        }
+        tbb::parallel_sort(updated_edges.begin(), updated_edges.end());
+        updated_edges.erase(std::unique(updated_edges.begin(), updated_edges.end()),
+                            updated_edges.end());
+
+        const auto edge_segment_bytes =
+            reinterpret_cast<const char *>(edge_segment_region.get_address());
+        const auto penaltyblocks = reinterpret_cast<const extractor::lookup::PenaltyBlock *>(
+            edge_penalty_region.get_address());
+
+        updated_edge_weights.resize(updated_edges.size());
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, updated_edges.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  const auto edge = updated_edges[index];
+                                  updated_edge_weights[index] = getNewEdgeWeight(
+                                      edge_segment_bytes + segment_index.segment_offsets[edge],
+                                      penaltyblocks[edge],
+                                      segment_speed_lookup,
+                                      turn_penalty_lookup);
+                              }
+                          });
+
+        util::SimpleLogger().Write() << "Updated the weights of " << updated_edges.size()
+                                     << " edges";
+    }
+
     auto edge_based_edge_ptr = reinterpret_cast<extractor::EdgeBasedEdge *>(
         reinterpret_cast<char *>(edge_based_graph_region.get_address()) +
         sizeof(EdgeBasedGraphHeader));
@@ -835,96 +1049,26 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
         sizeof(EdgeBasedGraphHeader) +
         sizeof(extractor::EdgeBasedEdge) * graph_header.number_of_edges);
 
-    while (edge_based_edge_ptr != edge_based_edge_last)
+    std::size_t updated_edge_index = 0;
+    for (EdgeID edge_id = 0; edge_based_edge_ptr != edge_based_edge_last; ++edge_id)
     {
         // Make a copy of the data from the memory map
         extractor::EdgeBasedEdge inbuffer = *edge_based_edge_ptr;
         edge_based_edge_ptr++;
 
-        if (update_edge_weights || update_turn_penalties)
+        if (updated_edge_index < updated_edges.size() &&
+            updated_edges[updated_edge_index] == edge_id)
         {
-            bool skip_this_edge = false;
-            auto header = reinterpret_cast<const extractor::lookup::SegmentHeaderBlock *>(
-                edge_segment_byte_ptr);
-            edge_segment_byte_ptr += sizeof(extractor::lookup::SegmentHeaderBlock);
-
-            auto previous_osm_node_id = header->previous_osm_node_id;
-            EdgeWeight new_weight = 0;
-            int compressed_edge_nodes = static_cast<int>(header->num_osm_nodes);
-
-            auto segmentblocks =
-                reinterpret_cast<const extractor::lookup::SegmentBlock *>(edge_segment_byte_ptr);
-            edge_segment_byte_ptr +=
-                sizeof(extractor::lookup::SegmentBlock) * (header->num_osm_nodes - 1);
-
-            const auto num_segments = header->num_osm_nodes - 1;
-            for (auto i : util::irange<std::size_t>(0, num_segments))
-            {
-                auto speed_iter =
-                    find(segment_speed_lookup,
-                         SegmentSpeedSource{
-                             previous_osm_node_id, segmentblocks[i].this_osm_node_id, {0, 0}});
-                if (speed_iter != segment_speed_lookup.end())
-                {
-                    if (speed_iter->speed_source.speed > 0)
-                    {
-                        const auto new_segment_weight = distanceAndSpeedToWeight(
-                            segmentblocks[i].segment_length, speed_iter->speed_source.speed);
-                        new_weight += new_segment_weight;
-                    }
-                    else
-                    {
-                        // If we hit a 0-speed edge, then it's effectively not traversible.
-                        // We don't want to include it in the edge_based_edge_list, so
-                        // we set a flag and `continue` the parent loop as soon as we can.
-                        // This would be a perfect place to use `goto`, but Patrick vetoed it.
-                        skip_this_edge = true;
-                        break;
-                    }
-                }
-                else
-                {
-                    // If no lookup found, use the original weight value for this segment
-                    new_weight += segmentblocks[i].segment_weight;
-                }
-
-                previous_osm_node_id = segmentblocks[i].this_osm_node_id;
-            }
+            const auto new_weight = updated_edge_weights[updated_edge_index++];
 
             // We found a zero-speed edge, so we'll skip this whole edge-based-edge which
             // effectively removes it from the routing network.
-            if (skip_this_edge)
+            if (new_weight == INVALID_EDGE_WEIGHT)
             {
-                penaltyblock++;
                 continue;
             }
 
-            auto turn_iter =
-                find(turn_penalty_lookup,
-                     TurnPenaltySource{
-                         penaltyblock->from_id, penaltyblock->via_id, penaltyblock->to_id, {0, 0}});
-            if (turn_iter != turn_penalty_lookup.end())
-            {
-                int new_turn_weight = static_cast<int>(turn_iter->penalty_source.penalty * 10);
-
-                if (new_turn_weight + new_weight < compressed_edge_nodes)
-                {
-                    util::SimpleLogger().Write(logWARNING)
-                        << "turn penalty " << turn_iter->penalty_source.penalty << " for turn "
-                        << penaltyblock->from_id << ", " << penaltyblock->via_id << ", "
-                        << penaltyblock->to_id << " is too negative: clamping turn weight to "
-                        << compressed_edge_nodes;
-                }
-
-                inbuffer.weight = std::max(new_turn_weight + new_weight, compressed_edge_nodes);
-            }
-            else
-            {
-                inbuffer.weight = penaltyblock->fixed_penalty + new_weight;
-            }
-
-            // Increment the pointer
-            penaltyblock++;
+            inbuffer.weight = new_weight;
         }
 
         edge_based_edge_list.emplace_back(std::move(inbuffer));
@@ -934,6 +1078,20 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
     return graph_header.max_edge_id;
 }
 
+void Contractor::ReadNodeWeights(std::vector<EdgeWeight> &node_weights) const
+{
+    util::SimpleLogger().Write() << "Reading node weights.";
+    const std::string node_file_name = config.osrm_input_path.string() + ".enw";
+    if (util::deserializeVector(node_file_name, node_weights))
+    {
+        util::SimpleLogger().Write() << "Done reading node weights.";
+    }
+    else
+    {
+        throw util::exception("Failed reading node weights.");
+    }
+}
+
 void Contractor::ReadNodeLevels(std::vector<float> &node_levels) const
 {
     boost::filesystem::ifstream order_input_stream(config.level_output_path, std::ios::binary);
@@ -955,6 +1113,20 @@ void Contractor::WriteNodeLevels(std::vector<float> &&in_node_levels) const
     order_output_stream.write((char *)node_levels.data(), sizeof(float) * node_levels.size());
 }
 
+void Contractor::ReportPeakMemory() const
+{
+    const auto peak_bytes = util::peakResidentBytes();
+    const auto graph_bytes = boost::filesystem::file_size(config.graph_output_path);
+    if (peak_bytes == 0 || graph_bytes == 0)
+    {
+        return;
+    }
+
+    const auto ratio = static_cast<double>(peak_bytes) / graph_bytes;
+    util::SimpleLogger().Write() << "Peak memory usage: " << (peak_bytes >> 20) << " MiB, "
+                                 << ratio << " times the size of " << config.graph_output_path;
+}
+
 void Contractor::WriteCoreNodeMarker(std::vector<bool> &&in_is_core_node) const
 {
     std::vector<bool> is_core_node(std::move(in_is_core_node));
@@ -1090,6 +1262,41 @@ Contractor::WriteContractedGraph(unsigned max_node_id,
     return number_of_used_edges;
 }
 
+namespace
+{
+// Identifies the files the graph and its weights were loaded from by their paths, sizes and
+// modification times, reading the content of the edge-based graph again would cost as much as
+// loading it
+std::uint64_t inputFingerprint(const ContractorConfig &config)
+{
+    std::size_t seed = 0;
+    const auto hash_file = [&seed](const std::string &path) {
+        boost::hash_combine(seed, path);
+        boost::hash_combine(seed, static_cast<std::uint64_t>(boost::filesystem::file_size(path)));
+        boost::hash_combine(seed,
+                            static_cast<std::int64_t>(boost::filesystem::last_write_time(path)));
+    };
+
+    hash_file(config.edge_based_graph_path);
+    if (config.use_cached_priority)
+    {
+        hash_file(config.level_output_path);
+    }
+    // the separators keep the speed files apart from the penalty files
+    for (const auto &path : config.segment_speed_lookup_paths)
+    {
+        hash_file(path);
+    }
+    boost::hash_combine(seed, config.segment_speed_lookup_paths.size());
+    for (const auto &path : config.turn_penalty_lookup_paths)
+    {
+        hash_file(path);
+    }
+    boost::hash_combine(seed, config.turn_penalty_lookup_paths.size());
+    return seed;
+}
+}
+
 /**
  \brief Build contracted graph.
  */
@@ -1106,10 +1313,50 @@ void Contractor::ContractGraph(
 
     GraphContractor graph_contractor(
         max_edge_id + 1, edge_based_edge_list, std::move(node_levels), std::move(node_weights));
-    graph_contractor.Run(config.core_factor);
+    if (config.checkpoint_interval > 0 || config.resume)
+    {
+        graph_contractor.SetCheckpoint(config.checkpoint_path,
+                                       std::chrono::minutes(config.checkpoint_interval),
+                                       config.resume,
+                                       inputFingerprint(config));
+    }
+    graph_contractor.Run(config.core_factor, config.eager_compaction);
     graph_contractor.GetEdges(contracted_edge_list);
     graph_contractor.GetCoreMarker(is_core_node);
     graph_contractor.GetNodeLevels(inout_node_levels);
 }
+
+/**
+ \brief Build the metric-independent Customizable Contraction Hierarchy and customize it.
+ */
+void Contractor::ContractGraphCustomizable(
+    const EdgeID max_edge_id,
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &contracted_edge_list) const
+{
+    const CustomizableContractionHierarchy hierarchy(max_edge_id + 1, edge_based_edge_list);
+    hierarchy.Write(config.cch_path);
+    std::vector<EdgeWeight> node_weights;
+    ReadNodeWeights(node_weights);
+    hierarchy.Customize(edge_based_edge_list, node_weights, contracted_edge_list);
+}
+
+/**
+ \brief Partition the graph for Multi-Level Dijkstra and customize the cells of the partition.
+ */
+void Contractor::PartitionGraph(
+    const EdgeID max_edge_id,
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &base_edge_list) const
+{
+    const auto partition =
+        partitionGraph(max_edge_id + 1, edge_based_edge_list, config.max_cell_size);
+    const auto cells = buildCellStorage(partition, edge_based_edge_list);
+    writePartition(config.partition_path, partition);
+    writeCells(config.cells_path, cells);
+    writeCellMetrics(config.cell_metrics_path,
+                     customizeCells(partition, cells, edge_based_edge_list));
+    buildBaseGraph(edge_based_edge_list, base_edge_list);
+}
 }
 }
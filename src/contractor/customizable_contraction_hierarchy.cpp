@@ -0,0 +1,553 @@
+#include "contractor/customizable_contraction_hierarchy.hpp"
+#include "contractor/undirected_graph.hpp"
+
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+#include "util/io.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+
+// Cells with at most this many nodes are not dissected any further
+const constexpr std::size_t MIN_DISSECTION_SIZE = 16;
+
+const constexpr std::uint32_t INVALID_CELL = std::numeric_limits<std::uint32_t>::max();
+
+// Recursively bisects the graph by BFS level structures and ranks the separator of every cell
+// above the two halves, which yields a metric-independent contraction order: a shortest path
+// between the two halves has to pass the separator, so only few shortcuts span it.
+std::vector<NodeID> computeNestedDissectionOrder(const UndirectedGraph &graph)
+{
+    const NodeID number_of_nodes = graph.GetNumberOfNodes();
+    std::vector<NodeID> node_rank(number_of_nodes, SPECIAL_NODEID);
+
+    struct Cell
+    {
+        std::vector<NodeID> nodes;
+        NodeID first_rank;
+        std::uint32_t id;
+    };
+
+    // cell of each node that has not been ranked yet
+    std::vector<std::uint32_t> node_cell(number_of_nodes, 0);
+    std::vector<std::uint32_t> distance(number_of_nodes, 0);
+    std::vector<std::uint32_t> visited(number_of_nodes, 0);
+    std::uint32_t number_of_cells = 1;
+    std::uint32_t number_of_searches = 0;
+
+    std::vector<Cell> cells;
+    cells.push_back(Cell{{}, 0, 0});
+    cells.back().nodes.resize(number_of_nodes);
+    std::iota(cells.back().nodes.begin(), cells.back().nodes.end(), 0);
+
+    // breadth first search that does not leave the cell, the nodes are reached by increasing
+    // distance
+    std::vector<NodeID> queue;
+    const auto search = [&](const NodeID source, const std::uint32_t cell) {
+        queue.clear();
+        queue.push_back(source);
+        visited[source] = number_of_searches;
+        distance[source] = 0;
+        for (std::size_t index = 0; index < queue.size(); ++index)
+        {
+            const NodeID node = queue[index];
+            for (auto edge = graph.first_edge[node]; edge < graph.first_edge[node + 1]; ++edge)
+            {
+                const NodeID target = graph.targets[edge];
+                if (node_cell[target] == cell && visited[target] != number_of_searches)
+                {
+                    visited[target] = number_of_searches;
+                    distance[target] = distance[node] + 1;
+                    queue.push_back(target);
+                }
+            }
+        }
+    };
+
+    const auto assign_ranks = [&](const std::vector<NodeID> &nodes, NodeID first_rank) {
+        for (const auto node : nodes)
+        {
+            node_rank[node] = first_rank++;
+            node_cell[node] = INVALID_CELL;
+        }
+    };
+
+    const auto push_cell = [&](std::vector<NodeID> nodes, const NodeID first_rank) {
+        if (nodes.size() <= MIN_DISSECTION_SIZE)
+        {
+            assign_ranks(nodes, first_rank);
+            return;
+        }
+        const auto id = number_of_cells++;
+        for (const auto node : nodes)
+        {
+            node_cell[node] = id;
+        }
+        cells.push_back(Cell{std::move(nodes), first_rank, id});
+    };
+
+    while (!cells.empty())
+    {
+        const Cell cell = std::move(cells.back());
+        cells.pop_back();
+
+        if (cell.nodes.size() <= MIN_DISSECTION_SIZE)
+        {
+            assign_ranks(cell.nodes, cell.first_rank);
+            continue;
+        }
+
+        ++number_of_searches;
+        search(cell.nodes.front(), cell.id);
+
+        // the connected components are independent of each other and need no separator
+        if (queue.size() < cell.nodes.size())
+        {
+            NodeID first_rank = cell.first_rank;
+            const auto search_id = number_of_searches;
+            for (const auto node : cell.nodes)
+            {
+                if (node == cell.nodes.front() || visited[node] != search_id)
+                {
+                    if (node != cell.nodes.front())
+                    {
+                        search(node, cell.id);
+                    }
+                    const auto component_size = static_cast<NodeID>(queue.size());
+                    push_cell(queue, first_rank);
+                    first_rank += component_size;
+                }
+            }
+            BOOST_ASSERT(first_rank == cell.first_rank + cell.nodes.size());
+            continue;
+        }
+
+        // the last node that is reached is far away from the rest of the cell
+        ++number_of_searches;
+        search(queue.back(), cell.id);
+        const auto max_distance = distance[queue.back()];
+        if (max_distance < 2)
+        {
+            assign_ranks(cell.nodes, cell.first_rank);
+            continue;
+        }
+
+        // cut at the level that splits the cell into halves
+        const auto cut_distance =
+            std::min(std::max(distance[queue[queue.size() / 2]], 1u), max_distance - 1);
+
+        std::vector<NodeID> lower_nodes;
+        std::vector<NodeID> upper_nodes;
+        std::vector<NodeID> separator_nodes;
+        for (const auto node : queue)
+        {
+            if (distance[node] < cut_distance)
+            {
+                lower_nodes.push_back(node);
+            }
+            else if (distance[node] > cut_distance)
+            {
+                upper_nodes.push_back(node);
+            }
+            else
+            {
+                // only nodes on the cut level that are adjacent to the upper half separate
+                bool is_separator = false;
+                for (auto edge = graph.first_edge[node]; edge < graph.first_edge[node + 1]; ++edge)
+                {
+                    const NodeID target = graph.targets[edge];
+                    is_separator |=
+                        node_cell[target] == cell.id && distance[target] == cut_distance + 1;
+                }
+                (is_separator ? separator_nodes : lower_nodes).push_back(node);
+            }
+        }
+
+        const auto number_of_lower_nodes = static_cast<NodeID>(lower_nodes.size());
+        const auto number_of_upper_nodes = static_cast<NodeID>(upper_nodes.size());
+        assign_ranks(separator_nodes,
+                     cell.first_rank + number_of_lower_nodes + number_of_upper_nodes);
+        push_cell(std::move(lower_nodes), cell.first_rank);
+        push_cell(std::move(upper_nodes), cell.first_rank + number_of_lower_nodes);
+    }
+
+    return node_rank;
+}
+
+// Weight of one direction of an arc and how to unpack it
+struct ArcMetric
+{
+    EdgeWeight weight;
+    // original edge id or the middle node of a shortcut
+    NodeID id;
+    bool shortcut;
+};
+
+const ArcMetric INVALID_ARC_METRIC{INVALID_EDGE_WEIGHT, SPECIAL_NODEID, false};
+
+inline void relaxArcMetric(ArcMetric &metric,
+                           const ArcMetric &first,
+                           const ArcMetric &second,
+                           const NodeID middle_node)
+{
+    if (first.weight == INVALID_EDGE_WEIGHT || second.weight == INVALID_EDGE_WEIGHT)
+    {
+        return;
+    }
+    const EdgeWeight weight = first.weight + second.weight;
+    if (weight < metric.weight)
+    {
+        metric = ArcMetric{weight, middle_node, true};
+    }
+}
+}
+
+CustomizableContractionHierarchy::CustomizableContractionHierarchy(
+    const NodeID number_of_nodes,
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    util::SimpleLogger().Write() << "Computing nested dissection order of " << number_of_nodes
+                                 << " nodes";
+
+    std::vector<std::vector<NodeID>> upward_heads(number_of_nodes);
+    {
+        const auto graph = buildUndirectedGraph(number_of_nodes, edge_based_edge_list);
+        node_rank = computeNestedDissectionOrder(graph);
+
+        for (const auto node : util::irange(0u, number_of_nodes))
+        {
+            for (auto edge = graph.first_edge[node]; edge < graph.first_edge[node + 1]; ++edge)
+            {
+                const NodeID target = graph.targets[edge];
+                if (node_rank[node] < node_rank[target])
+                {
+                    upward_heads[node_rank[node]].push_back(node_rank[target]);
+                }
+            }
+        }
+    }
+
+    rank_node.resize(number_of_nodes);
+    for (const auto node : util::irange(0u, number_of_nodes))
+    {
+        rank_node[node_rank[node]] = node;
+    }
+
+    util::SimpleLogger().Write() << "Computing shortcut topology";
+
+    // Contracting a node connects all of its upper neighbours. It suffices to add them to the
+    // lowest of them, which passes them on when it is contracted itself.
+    first_arc.reserve(number_of_nodes + 1);
+    first_arc.push_back(0);
+    for (const auto rank : util::irange(0u, number_of_nodes))
+    {
+        auto &heads = upward_heads[rank];
+        std::sort(heads.begin(), heads.end());
+        heads.erase(std::unique(heads.begin(), heads.end()), heads.end());
+        if (!heads.empty())
+        {
+            auto &parent_heads = upward_heads[heads.front()];
+            parent_heads.insert(parent_heads.end(), std::next(heads.begin()), heads.end());
+        }
+        arc_head.insert(arc_head.end(), heads.begin(), heads.end());
+        first_arc.push_back(arc_head.size());
+        std::vector<NodeID>().swap(heads);
+    }
+
+    BuildCustomizationOrder();
+
+    util::SimpleLogger().Write() << "Contraction hierarchy topology has " << arc_head.size()
+                                 << " arcs on " << (first_level_rank.size() - 1) << " levels";
+}
+
+CustomizableContractionHierarchy::CustomizableContractionHierarchy(
+    const std::string &topology_path)
+{
+    std::ifstream topology_stream(topology_path, std::ios::binary);
+    if (!topology_stream)
+    {
+        throw util::exception("Could not open " + topology_path + " for reading.");
+    }
+    if (!util::readAndCheckFingerprint(topology_stream))
+    {
+        throw util::exception("Fingerprint of " + topology_path +
+                              " does not match or could not read from file");
+    }
+    if (!util::deserializeVector(topology_stream, node_rank) ||
+        !util::deserializeVector(topology_stream, first_arc) ||
+        !util::deserializeVector(topology_stream, arc_head) ||
+        first_arc.size() != node_rank.size() + 1 || first_arc.back() != arc_head.size())
+    {
+        throw util::exception("Failed to read the contraction hierarchy topology from " +
+                              topology_path);
+    }
+
+    rank_node.resize(node_rank.size());
+    for (const auto node : util::irange<NodeID>(0, node_rank.size()))
+    {
+        rank_node[node_rank[node]] = node;
+    }
+
+    BuildCustomizationOrder();
+}
+
+void CustomizableContractionHierarchy::Write(const std::string &topology_path) const
+{
+    std::ofstream topology_stream(topology_path, std::ios::binary);
+    if (!util::writeFingerprint(topology_stream) ||
+        !util::serializeVector(topology_stream, node_rank) ||
+        !util::serializeVector(topology_stream, first_arc) ||
+        !util::serializeVector(topology_stream, arc_head))
+    {
+        throw util::exception("Failed to write the contraction hierarchy topology to " +
+                              topology_path);
+    }
+}
+
+void CustomizableContractionHierarchy::BuildCustomizationOrder()
+{
+    const NodeID number_of_ranks = node_rank.size();
+
+    first_down_arc.assign(number_of_ranks + 1, 0);
+    for (const auto head : arc_head)
+    {
+        ++first_down_arc[head + 1];
+    }
+    std::partial_sum(first_down_arc.begin(), first_down_arc.end(), first_down_arc.begin());
+
+    // the level of a rank is one above the highest level of its lower neighbours
+    std::vector<std::uint32_t> level(number_of_ranks, 0);
+    std::vector<EdgeID> next_down_arc(first_down_arc.begin(), std::prev(first_down_arc.end()));
+    down_arc_tail.resize(arc_head.size());
+    down_arc.resize(arc_head.size());
+    for (const auto rank : util::irange(0u, number_of_ranks))
+    {
+        for (auto arc = first_arc[rank]; arc < first_arc[rank + 1]; ++arc)
+        {
+            const NodeID head = arc_head[arc];
+            const auto position = next_down_arc[head]++;
+            down_arc_tail[position] = rank;
+            down_arc[position] = arc;
+            level[head] = std::max(level[head], level[rank] + 1);
+        }
+    }
+
+    const auto number_of_levels =
+        number_of_ranks == 0 ? 0 : *std::max_element(level.begin(), level.end()) + 1;
+    first_level_rank.assign(number_of_levels + 1, 0);
+    for (const auto rank_level : level)
+    {
+        ++first_level_rank[rank_level + 1];
+    }
+    std::partial_sum(
+        first_level_rank.begin(), first_level_rank.end(), first_level_rank.begin());
+
+    std::vector<std::size_t> next_level_rank(first_level_rank.begin(),
+                                             std::prev(first_level_rank.end()));
+    level_ranks.resize(number_of_ranks);
+    for (const auto rank : util::irange(0u, number_of_ranks))
+    {
+        level_ranks[next_level_rank[level[rank]]++] = rank;
+    }
+}
+
+EdgeID CustomizableContractionHierarchy::FindArc(const NodeID lower_rank,
+                                                 const NodeID higher_rank) const
+{
+    const auto begin = arc_head.begin() + first_arc[lower_rank];
+    const auto end = arc_head.begin() + first_arc[lower_rank + 1];
+    const auto iter = std::lower_bound(begin, end, higher_rank);
+    if (iter == end || *iter != higher_rank)
+    {
+        return SPECIAL_EDGEID;
+    }
+    return static_cast<EdgeID>(iter - arc_head.begin());
+}
+
+void CustomizableContractionHierarchy::Customize(
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    const std::vector<EdgeWeight> &node_weights,
+    util::DeallocatingVector<QueryEdge> &contracted_edge_list) const
+{
+    const NodeID number_of_nodes = GetNumberOfNodes();
+    if (node_weights.size() != number_of_nodes)
+    {
+        throw util::exception("The node weights do not match the contraction hierarchy topology");
+    }
+
+    // metric of the direction from the lower to the higher rank and back
+    std::vector<ArcMetric> upward_metric(arc_head.size(), INVALID_ARC_METRIC);
+    std::vector<ArcMetric> downward_metric(arc_head.size(), INVALID_ARC_METRIC);
+
+    const auto add_original_edge = [&](const NodeID from,
+                                       const NodeID to,
+                                       const NodeID edge_id,
+                                       const EdgeWeight weight) {
+        const auto from_rank = node_rank[from];
+        const auto to_rank = node_rank[to];
+        const bool is_upward = from_rank < to_rank;
+        const auto arc = is_upward ? FindArc(from_rank, to_rank) : FindArc(to_rank, from_rank);
+        if (arc == SPECIAL_EDGEID)
+        {
+            throw util::exception("Edge " + std::to_string(from) + "," + std::to_string(to) +
+                                  " is not part of the contraction hierarchy topology, rebuild "
+                                  "it with osrm-contract");
+        }
+        auto &metric = is_upward ? upward_metric[arc] : downward_metric[arc];
+        if (weight < metric.weight)
+        {
+            metric = ArcMetric{weight, edge_id, false};
+        }
+    };
+
+    for (const auto &edge : edge_based_edge_list)
+    {
+        if (edge.source >= number_of_nodes || edge.target >= number_of_nodes)
+        {
+            throw util::exception("Edge " + std::to_string(edge.source) + "," +
+                                  std::to_string(edge.target) + " exceeds the number of nodes");
+        }
+        if (edge.source == edge.target)
+        {
+            continue;
+        }
+        const EdgeWeight weight = std::max<EdgeWeight>(edge.weight, 1);
+        if (edge.forward)
+        {
+            add_original_edge(edge.source, edge.target, edge.edge_id, weight);
+        }
+        if (edge.backward)
+        {
+            add_original_edge(edge.target, edge.source, edge.edge_id, weight);
+        }
+    }
+
+    // Every arc takes the shortest path over its lower triangles. The arcs of a rank only
+    // depend on the arcs of its lower neighbours, which are on lower levels.
+    for (const auto level : util::irange<std::size_t>(0, first_level_rank.size() - 1))
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(first_level_rank[level], first_level_rank[level + 1]),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                for (auto index = range.begin(); index != range.end(); ++index)
+                {
+                    const NodeID rank = level_ranks[index];
+                    for (auto down = first_down_arc[rank]; down < first_down_arc[rank + 1]; ++down)
+                    {
+                        const NodeID lower_rank = down_arc_tail[down];
+                        const NodeID middle_node = rank_node[lower_rank];
+                        const EdgeID lower_arc = down_arc[down];
+
+                        // the upper neighbours of the lower rank above this one are upper
+                        // neighbours of this rank as well, both are sorted by rank
+                        auto arc = first_arc[rank];
+                        for (auto other_arc = lower_arc + 1; other_arc < first_arc[lower_rank + 1];
+                             ++other_arc)
+                        {
+                            while (arc_head[arc] != arc_head[other_arc])
+                            {
+                                ++arc;
+                                BOOST_ASSERT(arc < first_arc[rank + 1]);
+                            }
+                            relaxArcMetric(upward_metric[arc],
+                                           downward_metric[lower_arc],
+                                           upward_metric[other_arc],
+                                           middle_node);
+                            relaxArcMetric(downward_metric[arc],
+                                           downward_metric[other_arc],
+                                           upward_metric[lower_arc],
+                                           middle_node);
+                        }
+                    }
+                }
+            });
+    }
+
+    // The query needs a self-loop at the source if the target lies behind it on the same segment.
+    // As in GraphContractor::ContractNode a loop through a lower neighbour is only kept if it is
+    // shorter than the weight of the neighbour, or than the loop at the neighbour if it has one.
+    // The lower neighbours come first, so their bounds are final.
+    std::vector<EdgeWeight> loop_bound(node_weights);
+    for (const auto rank : util::irange(0u, number_of_nodes))
+    {
+        const NodeID source = rank_node[rank];
+
+        ArcMetric loop = INVALID_ARC_METRIC;
+        for (auto down = first_down_arc[rank]; down < first_down_arc[rank + 1]; ++down)
+        {
+            // the loop leaves the node downwards and returns on the same arc
+            const EdgeID arc = down_arc[down];
+            const NodeID middle_node = rank_node[down_arc_tail[down]];
+            if (downward_metric[arc].weight != INVALID_EDGE_WEIGHT &&
+                upward_metric[arc].weight != INVALID_EDGE_WEIGHT &&
+                downward_metric[arc].weight + upward_metric[arc].weight < loop_bound[middle_node])
+            {
+                relaxArcMetric(loop, downward_metric[arc], upward_metric[arc], middle_node);
+            }
+        }
+        if (loop.weight != INVALID_EDGE_WEIGHT)
+        {
+            loop_bound[source] = loop.weight;
+            QueryEdge::EdgeData data;
+            data.id = loop.id;
+            data.shortcut = true;
+            data.weight = loop.weight;
+            data.forward = true;
+            data.backward = true;
+            contracted_edge_list.push_back(QueryEdge(source, source, data));
+        }
+
+        for (auto arc = first_arc[rank]; arc < first_arc[rank + 1]; ++arc)
+        {
+            const NodeID target = rank_node[arc_head[arc]];
+            const auto add_query_edge = [&](const ArcMetric &metric,
+                                            const bool forward,
+                                            const bool backward) {
+                QueryEdge::EdgeData data;
+                data.id = metric.id;
+                data.shortcut = metric.shortcut;
+                data.weight = metric.weight;
+                data.forward = forward;
+                data.backward = backward;
+                contracted_edge_list.push_back(QueryEdge(source, target, data));
+            };
+
+            const auto &upward = upward_metric[arc];
+            const auto &downward = downward_metric[arc];
+            if (upward.weight != INVALID_EDGE_WEIGHT && upward.weight == downward.weight &&
+                upward.id == downward.id && upward.shortcut == downward.shortcut)
+            {
+                add_query_edge(upward, true, true);
+                continue;
+            }
+            if (upward.weight != INVALID_EDGE_WEIGHT)
+            {
+                add_query_edge(upward, true, false);
+            }
+            if (downward.weight != INVALID_EDGE_WEIGHT)
+            {
+                add_query_edge(downward, false, true);
+            }
+        }
+    }
+}
+}
+}
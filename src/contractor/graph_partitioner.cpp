@@ -0,0 +1,241 @@
+#include "contractor/graph_partitioner.hpp"
+#include "contractor/undirected_graph.hpp"
+
+#include "util/exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+
+// The cells of a level are 2^BISECTIONS_PER_LEVEL times as large as the cells below
+const constexpr std::uint8_t BISECTIONS_PER_LEVEL = 4;
+
+// Partition ids have one bit per bisection
+const constexpr std::uint8_t MAX_BISECTION_DEPTH = 31;
+
+// Recursively bisects the graph into 2^depth cells. Every cell is cut at the middle of a
+// breadth first search order that starts at a node far away from the rest of the cell, which
+// keeps the cells connected and the cuts short on road networks. Connected components are
+// ordered one after the other and are not torn apart unless they are larger than a half.
+std::vector<std::uint32_t> bisectGraph(const UndirectedGraph &graph, const std::uint8_t depth)
+{
+    const NodeID number_of_nodes = graph.GetNumberOfNodes();
+    std::vector<std::uint32_t> partition_ids(number_of_nodes, 0);
+
+    struct Cell
+    {
+        std::vector<NodeID> nodes;
+        std::uint8_t depth;
+        std::uint32_t id;
+        // unique number of the cell to identify its nodes
+        std::uint32_t number;
+    };
+
+    std::vector<std::uint32_t> node_cell(number_of_nodes, 0);
+    std::vector<std::uint32_t> ordered(number_of_nodes, std::numeric_limits<std::uint32_t>::max());
+    std::vector<std::uint32_t> visited(number_of_nodes, 0);
+    std::uint32_t number_of_cells = 1;
+    std::uint32_t number_of_searches = 0;
+
+    std::vector<Cell> cells;
+    cells.push_back(Cell{{}, 0, 0, 0});
+    cells.back().nodes.resize(number_of_nodes);
+    std::iota(cells.back().nodes.begin(), cells.back().nodes.end(), 0);
+
+    // breadth first search that does not leave the cell
+    std::vector<NodeID> queue;
+    const auto search = [&](const NodeID source, const std::uint32_t cell) {
+        ++number_of_searches;
+        queue.clear();
+        queue.push_back(source);
+        visited[source] = number_of_searches;
+        for (std::size_t index = 0; index < queue.size(); ++index)
+        {
+            const NodeID node = queue[index];
+            for (auto edge = graph.first_edge[node]; edge < graph.first_edge[node + 1]; ++edge)
+            {
+                const NodeID target = graph.targets[edge];
+                if (node_cell[target] == cell && visited[target] != number_of_searches)
+                {
+                    visited[target] = number_of_searches;
+                    queue.push_back(target);
+                }
+            }
+        }
+    };
+
+    std::vector<NodeID> order;
+    while (!cells.empty())
+    {
+        Cell cell = std::move(cells.back());
+        cells.pop_back();
+
+        if (cell.depth == depth || cell.nodes.size() <= 1)
+        {
+            const auto id = cell.id << (depth - cell.depth);
+            for (const auto node : cell.nodes)
+            {
+                partition_ids[node] = id;
+            }
+            continue;
+        }
+
+        order.clear();
+        for (const auto start : cell.nodes)
+        {
+            if (ordered[start] == cell.number)
+            {
+                continue;
+            }
+            // the last node that is reached is far away from the rest of the component
+            search(start, cell.number);
+            search(queue.back(), cell.number);
+            for (const auto node : queue)
+            {
+                ordered[node] = cell.number;
+                order.push_back(node);
+            }
+        }
+        BOOST_ASSERT(order.size() == cell.nodes.size());
+
+        const auto middle = order.begin() + (order.size() + 1) / 2;
+        for (const auto half : {0u, 1u})
+        {
+            Cell child{{}, static_cast<std::uint8_t>(cell.depth + 1), (cell.id << 1) | half,
+                       number_of_cells++};
+            child.nodes.assign(half == 0 ? order.begin() : middle,
+                               half == 0 ? middle : order.end());
+            for (const auto node : child.nodes)
+            {
+                node_cell[node] = child.number;
+            }
+            cells.push_back(std::move(child));
+        }
+    }
+
+    return partition_ids;
+}
+}
+
+MultiLevelPartition<>
+partitionGraph(const NodeID number_of_nodes,
+               const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+               const std::size_t max_cell_size)
+{
+    if (max_cell_size == 0)
+    {
+        throw util::exception("The maximal cell size needs to be positive");
+    }
+
+    // after depth bisections no cell has more than ceil(n / 2^depth) nodes
+    std::uint8_t depth = 1;
+    while (depth < MAX_BISECTION_DEPTH &&
+           ((std::uint64_t{number_of_nodes} + (std::uint64_t{1} << depth) - 1) >> depth) >
+               max_cell_size)
+    {
+        ++depth;
+    }
+
+    util::SimpleLogger().Write() << "Bisecting " << number_of_nodes << " nodes into "
+                                 << (std::uint64_t{1} << depth) << " cells";
+
+    const auto graph = buildUndirectedGraph(number_of_nodes, edge_based_edge_list);
+    auto partition_ids = bisectGraph(graph, depth);
+
+    std::vector<std::uint8_t> level_shifts;
+    for (std::uint8_t shift = 0; shift < depth; shift += BISECTIONS_PER_LEVEL)
+    {
+        level_shifts.push_back(shift);
+    }
+    level_shifts.push_back(depth);
+
+    util::SimpleLogger().Write() << "Partition has " << (level_shifts.size() - 1) << " levels";
+
+    return MultiLevelPartition<>{std::move(partition_ids), std::move(level_shifts)};
+}
+
+CellStorage<>
+buildCellStorage(const MultiLevelPartition<> &partition,
+                 const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    std::vector<CellData> cells;
+    std::vector<NodeID> boundary_nodes;
+    std::uint64_t weight_offset = 0;
+
+    std::vector<std::pair<CellID, NodeID>> sources;
+    std::vector<std::pair<CellID, NodeID>> destinations;
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        sources.clear();
+        destinations.clear();
+        const auto add_arc = [&](const NodeID from, const NodeID to) {
+            const auto from_cell = partition.GetCell(level, from);
+            const auto to_cell = partition.GetCell(level, to);
+            if (from_cell != to_cell)
+            {
+                destinations.emplace_back(from_cell, from);
+                sources.emplace_back(to_cell, to);
+            }
+        };
+        for (const auto &edge : edge_based_edge_list)
+        {
+            if (edge.forward)
+            {
+                add_arc(edge.source, edge.target);
+            }
+            if (edge.backward)
+            {
+                add_arc(edge.target, edge.source);
+            }
+        }
+        for (auto *boundary : {&sources, &destinations})
+        {
+            tbb::parallel_sort(boundary->begin(), boundary->end());
+            boundary->erase(std::unique(boundary->begin(), boundary->end()), boundary->end());
+        }
+
+        auto source_iter = sources.begin();
+        auto destination_iter = destinations.begin();
+        for (CellID cell = 0; cell < partition.GetNumberOfCells(level); ++cell)
+        {
+            CellData data{weight_offset, static_cast<std::uint32_t>(boundary_nodes.size()), 0, 0};
+            for (; source_iter != sources.end() && source_iter->first == cell; ++source_iter)
+            {
+                boundary_nodes.push_back(source_iter->second);
+                ++data.number_of_sources;
+            }
+            for (; destination_iter != destinations.end() && destination_iter->first == cell;
+                 ++destination_iter)
+            {
+                boundary_nodes.push_back(destination_iter->second);
+                ++data.number_of_destinations;
+            }
+            weight_offset += std::uint64_t{data.number_of_sources} * data.number_of_destinations;
+            cells.push_back(data);
+        }
+        BOOST_ASSERT(source_iter == sources.end() && destination_iter == destinations.end());
+    }
+
+    util::SimpleLogger().Write() << "Cells have " << boundary_nodes.size()
+                                 << " boundary nodes and " << weight_offset << " weights";
+
+    return CellStorage<>{partition, std::move(cells), std::move(boundary_nodes), {}};
+}
+}
+}
@@ -0,0 +1,214 @@
+#include "contractor/traffic_files.hpp"
+
+#include "util/exception.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+
+const constexpr std::size_t MAGIC_SIZE = 8;
+const constexpr char SEGMENT_SPEED_MAGIC[MAGIC_SIZE] = {'O', 'S', 'R', 'M', 'S', 'P', 'D', '1'};
+const constexpr char TURN_PENALTY_MAGIC[MAGIC_SIZE] = {'O', 'S', 'R', 'M', 'T', 'R', 'N', '1'};
+const constexpr std::size_t HEADER_SIZE = MAGIC_SIZE + sizeof(std::uint64_t);
+
+// A single large CSV file is split into chunks of about this size that are parsed in parallel
+const constexpr std::size_t CSV_CHUNK_SIZE = 16 * 1024 * 1024;
+
+// Parses the lines of [first, last) in parallel, the records keep the order of the lines
+template <typename Record, typename ParseLine>
+std::vector<Record> parseCSV(const char *first, const char *last, const ParseLine &parse_line)
+{
+    // every chunk but the first starts behind a line break
+    std::vector<const char *> boundaries{first};
+    while (boundaries.back() != last)
+    {
+        const auto chunk_size =
+            std::min<std::size_t>(CSV_CHUNK_SIZE, std::distance(boundaries.back(), last));
+        auto boundary = std::find(boundaries.back() + chunk_size, last, '\n');
+        boundaries.push_back(boundary == last ? last : boundary + 1);
+    }
+
+    std::vector<std::vector<Record>> chunks(boundaries.size() - 1);
+    tbb::parallel_for(std::size_t{0}, chunks.size(), [&](const std::size_t chunk) {
+        const auto chunk_end = boundaries[chunk + 1];
+        for (auto line_begin = boundaries[chunk]; line_begin != chunk_end;)
+        {
+            const auto line_end = std::find(line_begin, chunk_end, '\n');
+            chunks[chunk].push_back(parse_line(line_begin, line_end));
+            line_begin = line_end == chunk_end ? chunk_end : line_end + 1;
+        }
+    });
+
+    std::vector<std::size_t> offsets(chunks.size() + 1, 0);
+    for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk)
+    {
+        offsets[chunk + 1] = offsets[chunk] + chunks[chunk].size();
+    }
+    std::vector<Record> records(offsets.back());
+    tbb::parallel_for(std::size_t{0}, chunks.size(), [&](const std::size_t chunk) {
+        std::copy(chunks[chunk].begin(), chunks[chunk].end(), records.begin() + offsets[chunk]);
+        std::vector<Record>().swap(chunks[chunk]);
+    });
+    return records;
+}
+
+template <typename Record, typename ParseLine>
+std::vector<Record> readTrafficFile(const std::string &path,
+                                    const char (&magic)[MAGIC_SIZE],
+                                    const std::string &description,
+                                    const ParseLine &parse_line)
+{
+    if (!boost::filesystem::exists(path))
+    {
+        throw util::exception{"Unable to open " + description + " file " + path};
+    }
+    const auto file_size = boost::filesystem::file_size(path);
+    if (file_size == 0)
+    {
+        return {};
+    }
+
+    const boost::interprocess::file_mapping mapping(path.c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+    region.advise(boost::interprocess::mapped_region::advice_sequential);
+    const auto *first = static_cast<const char *>(region.get_address());
+    const auto *last = first + region.get_size();
+
+    const auto has_magic = [&](const char(&expected)[MAGIC_SIZE]) {
+        return region.get_size() >= MAGIC_SIZE && std::memcmp(first, expected, MAGIC_SIZE) == 0;
+    };
+    if (has_magic(SEGMENT_SPEED_MAGIC) || has_magic(TURN_PENALTY_MAGIC))
+    {
+        if (!has_magic(magic))
+        {
+            throw util::exception{path + " is not a " + description + " file"};
+        }
+
+        std::uint64_t number_of_records = 0;
+        if (region.get_size() >= HEADER_SIZE)
+        {
+            std::memcpy(&number_of_records, first + MAGIC_SIZE, sizeof(number_of_records));
+        }
+        if (region.get_size() < HEADER_SIZE ||
+            (region.get_size() - HEADER_SIZE) / sizeof(Record) != number_of_records ||
+            (region.get_size() - HEADER_SIZE) % sizeof(Record) != 0)
+        {
+            throw util::exception{path + " is truncated"};
+        }
+
+        std::vector<Record> records(number_of_records);
+        std::memcpy(records.data(), first + HEADER_SIZE, number_of_records * sizeof(Record));
+        return records;
+    }
+
+    return parseCSV<Record>(first, last, parse_line);
+}
+
+template <typename Record>
+void writeTrafficFile(const std::string &path,
+                      const char (&magic)[MAGIC_SIZE],
+                      const std::vector<Record> &records)
+{
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        throw util::exception{"Could not open " + path + " for writing"};
+    }
+
+    const std::uint64_t number_of_records = records.size();
+    stream.write(magic, MAGIC_SIZE);
+    stream.write(reinterpret_cast<const char *>(&number_of_records), sizeof(number_of_records));
+    stream.write(reinterpret_cast<const char *>(records.data()),
+                 number_of_records * sizeof(Record));
+    if (!stream)
+    {
+        throw util::exception{"Could not write " + path};
+    }
+}
+}
+
+std::vector<SegmentSpeedRecord> readSegmentSpeeds(const std::string &path)
+{
+    return readTrafficFile<SegmentSpeedRecord>(
+        path, SEGMENT_SPEED_MAGIC, "segment speed", [&path](const char *first, const char *last) {
+            using namespace boost::spirit::qi;
+
+            std::uint64_t from_node_id{};
+            std::uint64_t to_node_id{};
+            unsigned speed{};
+
+            auto it = first;
+            // The ulong_long -> uint64_t will likely break on 32bit platforms
+            const auto ok =
+                parse(it,
+                      last,                                                                  //
+                      (ulong_long >> ',' >> ulong_long >> ',' >> uint_ >> *(',' >> *char_)), //
+                      from_node_id,
+                      to_node_id,
+                      speed); //
+
+            if (!ok || it != last)
+                throw util::exception{"Segment speed file " + path + " malformed: " +
+                                      std::string(first, last)};
+
+            return SegmentSpeedRecord{from_node_id, to_node_id, speed};
+        });
+}
+
+std::vector<TurnPenaltyRecord> readTurnPenalties(const std::string &path)
+{
+    return readTrafficFile<TurnPenaltyRecord>(
+        path, TURN_PENALTY_MAGIC, "turn penalty", [&path](const char *first, const char *last) {
+            using namespace boost::spirit::qi;
+
+            std::uint64_t from_node_id{};
+            std::uint64_t via_node_id{};
+            std::uint64_t to_node_id{};
+            double penalty{};
+
+            auto it = first;
+            // The ulong_long -> uint64_t will likely break on 32bit platforms
+            const auto ok = parse(it,
+                                  last, //
+                                  (ulong_long >> ',' >> ulong_long >> ',' >> ulong_long >> ',' >>
+                                   double_ >> *(',' >> *char_)), //
+                                  from_node_id,
+                                  via_node_id,
+                                  to_node_id,
+                                  penalty); //
+
+            if (!ok || it != last)
+                throw util::exception{"Turn penalty file " + path + " malformed: " +
+                                      std::string(first, last)};
+
+            return TurnPenaltyRecord{from_node_id, via_node_id, to_node_id, penalty};
+        });
+}
+
+void writeSegmentSpeeds(const std::string &path, const std::vector<SegmentSpeedRecord> &records)
+{
+    writeTrafficFile(path, SEGMENT_SPEED_MAGIC, records);
+}
+
+void writeTurnPenalties(const std::string &path, const std::vector<TurnPenaltyRecord> &records)
+{
+    writeTrafficFile(path, TURN_PENALTY_MAGIC, records);
+}
+}
+}
@@ -0,0 +1,52 @@
+#include "contractor/undirected_graph.hpp"
+
+#include "util/exception.hpp"
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+
+UndirectedGraph
+buildUndirectedGraph(const NodeID number_of_nodes,
+                     const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list)
+{
+    std::vector<std::pair<NodeID, NodeID>> node_pairs;
+    node_pairs.reserve(2 * edge_based_edge_list.size());
+    for (const auto &edge : edge_based_edge_list)
+    {
+        if (edge.source >= number_of_nodes || edge.target >= number_of_nodes)
+        {
+            throw util::exception("Edge " + std::to_string(edge.source) + "," +
+                                  std::to_string(edge.target) + " exceeds the number of nodes");
+        }
+        if (edge.source != edge.target)
+        {
+            node_pairs.emplace_back(edge.source, edge.target);
+            node_pairs.emplace_back(edge.target, edge.source);
+        }
+    }
+    tbb::parallel_sort(node_pairs.begin(), node_pairs.end());
+    node_pairs.erase(std::unique(node_pairs.begin(), node_pairs.end()), node_pairs.end());
+
+    UndirectedGraph graph;
+    graph.first_edge.resize(number_of_nodes + 1, 0);
+    graph.targets.reserve(node_pairs.size());
+    for (const auto &node_pair : node_pairs)
+    {
+        ++graph.first_edge[node_pair.first + 1];
+        graph.targets.push_back(node_pair.second);
+    }
+    std::partial_sum(graph.first_edge.begin(), graph.first_edge.end(), graph.first_edge.begin());
+
+    return graph;
+}
+}
+}
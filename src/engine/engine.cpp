@@ -7,6 +7,7 @@
 #include "engine/datafacade/shared_datafacade.hpp"
 
 #include "storage/shared_barriers.hpp"
+#include "util/resident_memory.hpp"
 #include "util/simple_logger.hpp"
 
 #include <boost/assert.hpp>
@@ -17,6 +18,7 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -45,6 +47,82 @@ RunQuery(const std::unique_ptr<osrm::engine::DataWatchdog> &watchdog,
     return plugin.HandleRequest(facade, parameters, result);
 }
 
+// Data needed by the given services, all data if no service is given
+osrm::engine::datafacade::DataFamily::Mask
+RequiredDataFamilies(const std::vector<std::string> &services)
+{
+    using namespace osrm::engine;
+    if (services.empty())
+    {
+        return datafacade::DataFamily::all;
+    }
+
+    datafacade::DataFamily::Mask families = datafacade::DataFamily::none;
+    for (const auto &name : services)
+    {
+        const auto service = ParseServiceName(name);
+        if (!service)
+        {
+            throw osrm::util::exception("Unknown service " + name);
+        }
+
+        switch (*service)
+        {
+        case ServiceName::Route:
+            families |= plugins::ViaRoutePlugin::REQUIRED_DATA;
+            break;
+        case ServiceName::Table:
+            families |= plugins::TablePlugin::REQUIRED_DATA;
+            break;
+        case ServiceName::Nearest:
+            families |= plugins::NearestPlugin::REQUIRED_DATA;
+            break;
+        case ServiceName::Trip:
+            families |= plugins::TripPlugin::REQUIRED_DATA;
+            break;
+        case ServiceName::Match:
+            families |= plugins::MatchPlugin::REQUIRED_DATA;
+            break;
+        case ServiceName::Tile:
+            families |= plugins::TilePlugin::REQUIRED_DATA;
+            break;
+        }
+    }
+    return families;
+}
+
+std::string LocationToString(const osrm::engine::datafacade::MemoryBlock::Location location)
+{
+    using Location = osrm::engine::datafacade::MemoryBlock::Location;
+    switch (location)
+    {
+    case Location::Process:
+        return "process";
+    case Location::SharedMemory:
+        return "shared_memory";
+    case Location::MappedFile:
+        return "mapped_file";
+    }
+    return "unknown";
+}
+
+// The graph of a partitioned dataset is not contracted and vice versa
+void CheckAlgorithm(const osrm::engine::datafacade::BaseDataFacade &facade,
+                    const osrm::engine::EngineConfig::Algorithm algorithm)
+{
+    using Algorithm = osrm::engine::EngineConfig::Algorithm;
+    const bool is_partitioned = facade.GetNumberOfLevels() > 0;
+    if (algorithm == Algorithm::MLD && !is_partitioned)
+    {
+        throw osrm::util::exception(
+            "The dataset has no multi-level partition, prepare it with osrm-contract --mld");
+    }
+    if (algorithm == Algorithm::CH && is_partitioned)
+    {
+        throw osrm::util::exception(
+            "The dataset was partitioned by osrm-contract --mld and needs the MLD algorithm");
+    }
+}
 } // anon. ns
 
 namespace osrm
@@ -63,6 +141,10 @@ Engine::Engine(const EngineConfig &config)
       tile_plugin()                                      //
 
 {
+    const std::size_t max_heap_size =
+        config.max_heap_size < 0 ? 0 : static_cast<std::size_t>(config.max_heap_size);
+    SearchEngineData::SetMaxHeapSize(max_heap_size * 1024 * 1024);
+
     if (config.use_shared_memory)
     {
         if (!DataWatchdog::TryConnect())
@@ -71,8 +153,9 @@ Engine::Engine(const EngineConfig &config)
                 "No shared memory blocks found, have you forgotten to run osrm-datastore?");
         }
 
-        watchdog = std::make_unique<DataWatchdog>();
+        watchdog = std::make_unique<DataWatchdog>(config.lock_memory);
         BOOST_ASSERT(watchdog);
+        CheckAlgorithm(*watchdog->GetDataFacade().second, config.algorithm);
     }
     else
     {
@@ -80,8 +163,9 @@ Engine::Engine(const EngineConfig &config)
         {
             throw util::exception("Invalid file paths given!");
         }
-        immutable_data_facade =
-            std::make_shared<datafacade::InternalDataFacade>(config.storage_config);
+        immutable_data_facade = std::make_shared<datafacade::InternalDataFacade>(
+            config.storage_config, config.use_huge_pages, RequiredDataFamilies(config.services));
+        CheckAlgorithm(*immutable_data_facade, config.algorithm);
     }
 }
 
@@ -115,5 +199,73 @@ Status Engine::Tile(const api::TileParameters &params, std::string &result) cons
     return RunQuery(watchdog, immutable_data_facade, params, tile_plugin, result);
 }
 
+Status Engine::MemoryReport(util::json::Object &result) const
+{
+    std::vector<datafacade::MemoryBlock> blocks;
+    if (watchdog)
+    {
+        BOOST_ASSERT(!immutable_data_facade);
+        // keeps the dataset from being unmapped while we look at it
+        auto lock_and_facade = watchdog->GetDataFacade();
+        blocks = lock_and_facade.second->GetMemoryBlocks();
+    }
+    else
+    {
+        BOOST_ASSERT(immutable_data_facade);
+        blocks = immutable_data_facade->GetMemoryBlocks();
+    }
+
+    util::json::Array json_blocks;
+    std::size_t dataset_bytes = 0;
+    std::size_t dataset_resident_bytes = 0;
+    for (const auto &block : blocks)
+    {
+        const auto resident_bytes = util::residentBytes(block.address, block.bytes);
+        dataset_bytes += block.bytes;
+        dataset_resident_bytes += resident_bytes;
+
+        util::json::Object json_block;
+        json_block.values["name"] = block.name;
+        json_block.values["location"] = LocationToString(block.location);
+        json_block.values["bytes"] = block.bytes;
+        json_block.values["resident_bytes"] = resident_bytes;
+        json_blocks.values.push_back(std::move(json_block));
+    }
+
+    util::json::Object dataset;
+    dataset.values["bytes"] = dataset_bytes;
+    dataset.values["resident_bytes"] = dataset_resident_bytes;
+    dataset.values["blocks"] = std::move(json_blocks);
+
+    util::json::Array json_threads;
+    std::size_t heap_bytes = 0;
+    for (const auto &thread_usage : SearchEngineData::GetHeapMemoryUsage())
+    {
+        util::json::Array json_heaps;
+        std::size_t thread_bytes = 0;
+        for (const auto bytes : thread_usage)
+        {
+            json_heaps.values.push_back(bytes);
+            thread_bytes += bytes;
+        }
+        heap_bytes += thread_bytes;
+
+        util::json::Object json_thread;
+        json_thread.values["bytes"] = thread_bytes;
+        json_thread.values["heaps"] = std::move(json_heaps);
+        json_threads.values.push_back(std::move(json_thread));
+    }
+
+    util::json::Object heaps;
+    heaps.values["bytes"] = heap_bytes;
+    heaps.values["released"] = SearchEngineData::GetNumberOfReleasedHeaps();
+    heaps.values["threads"] = std::move(json_threads);
+
+    result.values["code"] = "Ok";
+    result.values["dataset"] = std::move(dataset);
+    result.values["heaps"] = std::move(heaps);
+    return Status::Ok;
+}
+
 } // engine ns
 } // osrm ns
@@ -1,10 +1,42 @@
 #include "engine/engine_config.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 namespace osrm
 {
 namespace engine
 {
 
+namespace
+{
+struct NamedService
+{
+    const char *name;
+    ServiceName service;
+};
+
+const constexpr NamedService SERVICE_NAMES[] = {{"route", ServiceName::Route},
+                                                {"table", ServiceName::Table},
+                                                {"nearest", ServiceName::Nearest},
+                                                {"trip", ServiceName::Trip},
+                                                {"match", ServiceName::Match},
+                                                {"tile", ServiceName::Tile}};
+}
+
+boost::optional<ServiceName> ParseServiceName(const std::string &name)
+{
+    const auto named_service = std::find_if(
+        std::begin(SERVICE_NAMES), std::end(SERVICE_NAMES), [&](const NamedService &named) {
+            return name == named.name;
+        });
+    if (named_service == std::end(SERVICE_NAMES))
+    {
+        return boost::none;
+    }
+    return named_service->service;
+}
+
 bool EngineConfig::IsValid() const
 {
     const bool all_path_are_empty =
@@ -23,9 +55,20 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_map_matching, 2) &&
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
-                              unlimited_or_more_than(max_results_nearest, 0);
+                              unlimited_or_more_than(max_results_nearest, 0) &&
+                              unlimited_or_more_than(max_heap_size, 0);
+
+    const bool services_valid =
+        std::all_of(services.begin(), services.end(), [](const std::string &service) {
+            return static_cast<bool>(ParseServiceName(service));
+        });
+
+    // the partition is only loaded from files, shared memory has it if osrm-datastore found it
+    const bool algorithm_valid = algorithm == Algorithm::CH || use_shared_memory ||
+                                 storage_config.IsMultiLevelValid();
 
-    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
+    return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) &&
+           limits_valid && services_valid && algorithm_valid;
 }
 }
 }
@@ -86,7 +86,9 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
 
     if (1 == raw_route.segment_end_coordinates.size())
     {
-        if (route_parameters.alternatives && facade->GetCoreSize() == 0)
+        // alternatives are taken from the search spaces of a plain contraction hierarchy
+        if (route_parameters.alternatives && facade->GetCoreSize() == 0 &&
+            facade->GetNumberOfLevels() == 0)
         {
             alternative_path(*facade, raw_route.segment_end_coordinates.front(), raw_route);
         }
@@ -2,6 +2,11 @@
 
 #include "util/binary_heap.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
 namespace osrm
 {
 namespace engine
@@ -14,67 +19,133 @@ SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
 
-void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+namespace
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+// Memory held by the heaps of one thread. Written by the owning thread, read by reports.
+struct ThreadHeapUsage;
+
+std::mutex heap_usage_mutex;
+std::unordered_set<const ThreadHeapUsage *> heap_usages;
+
+std::atomic<std::size_t> max_heap_size{0};
+std::atomic<std::size_t> number_of_released_heaps{0};
 
-    if (reverse_heap_1.get())
+// A heap is released if it can hold this many times the nodes recent queries inserted
+const constexpr std::size_t SHRINK_FACTOR = 8;
+// Smaller heaps are never released, growing them again costs more than they hold
+const constexpr std::size_t MIN_SHRINK_SIZE = 4 * 1024 * 1024;
+
+struct ThreadHeapUsage
+{
+    ThreadHeapUsage()
     {
-        reverse_heap_1->Clear();
+        for (auto &heap_bytes : bytes)
+        {
+            heap_bytes.store(0, std::memory_order_relaxed);
+        }
+        recent_inserted_nodes.fill(0);
+        std::lock_guard<std::mutex> lock(heap_usage_mutex);
+        heap_usages.insert(this);
     }
-    else
+
+    ~ThreadHeapUsage()
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        std::lock_guard<std::mutex> lock(heap_usage_mutex);
+        heap_usages.erase(this);
     }
-}
 
-void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
+    std::array<std::atomic<std::size_t>, SearchEngineData::NUMBER_OF_HEAPS> bytes;
+    // only used by the owning thread
+    std::array<std::size_t, SearchEngineData::NUMBER_OF_HEAPS> recent_inserted_nodes;
+};
+
+boost::thread_specific_ptr<ThreadHeapUsage> thread_heap_usage;
+
+void InitializeOrClearHeap(SearchEngineData::SearchEngineHeapPtr &heap,
+                           const std::size_t heap_index,
+                           const unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
+    if (!thread_heap_usage.get())
     {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
+        thread_heap_usage.reset(new ThreadHeapUsage());
     }
+    auto &usage = *thread_heap_usage;
 
-    if (reverse_heap_2.get())
+    if (heap.get())
     {
-        reverse_heap_2->Clear();
+        // peak of the recent queries, decays by 1/16 with every query
+        auto &recent_nodes = usage.recent_inserted_nodes[heap_index];
+        recent_nodes = std::max(heap->NumberOfInsertedNodes(), recent_nodes - recent_nodes / 16);
+
+        const auto heap_size = heap->MemoryUsage();
+        const auto max_size = max_heap_size.load(std::memory_order_relaxed);
+        const bool exceeds_limit = max_size > 0 && heap_size > max_size;
+        const bool exceeds_usage =
+            heap_size > MIN_SHRINK_SIZE && heap->Capacity() > SHRINK_FACTOR * recent_nodes;
+        if (exceeds_limit || exceeds_usage)
+        {
+            heap.reset(new SearchEngineData::QueryHeap(number_of_nodes));
+            number_of_released_heaps.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            heap->Clear();
+        }
     }
     else
     {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
+        heap.reset(new SearchEngineData::QueryHeap(number_of_nodes));
     }
+
+    usage.bytes[heap_index].store(heap->MemoryUsage(), std::memory_order_relaxed);
+}
+}
+
+void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeap(forward_heap_1, 0, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_1, 1, number_of_nodes);
+}
+
+void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeap(forward_heap_2, 2, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_2, 3, number_of_nodes);
 }
 
 void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(forward_heap_3, 4, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_3, 5, number_of_nodes);
+}
 
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
+std::vector<SearchEngineData::HeapMemoryUsage> SearchEngineData::GetHeapMemoryUsage()
+{
+    std::lock_guard<std::mutex> lock(heap_usage_mutex);
+
+    std::vector<HeapMemoryUsage> usage;
+    usage.reserve(heap_usages.size());
+    for (const auto *thread_usage : heap_usages)
     {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
+        HeapMemoryUsage thread_bytes;
+        for (std::size_t heap_index = 0; heap_index < NUMBER_OF_HEAPS; ++heap_index)
+        {
+            thread_bytes[heap_index] =
+                thread_usage->bytes[heap_index].load(std::memory_order_relaxed);
+        }
+        usage.push_back(thread_bytes);
     }
+    return usage;
+}
+
+void SearchEngineData::SetMaxHeapSize(const std::size_t bytes)
+{
+    max_heap_size.store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t SearchEngineData::GetNumberOfReleasedHeaps()
+{
+    return number_of_released_heaps.load(std::memory_order_relaxed);
 }
 }
 }
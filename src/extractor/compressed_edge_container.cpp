@@ -1,80 +1,84 @@
 #include "extractor/compressed_edge_container.hpp"
 #include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <limits>
 #include <string>
 
-#include <iostream>
-
 namespace osrm
 {
 namespace extractor
 {
 
-CompressedEdgeContainer::CompressedEdgeContainer()
+namespace
 {
-    m_free_list.reserve(100);
-    IncreaseFreeList();
+const constexpr unsigned INVALID_POSITION = std::numeric_limits<unsigned>::max();
+
+template <typename T> std::size_t allocatedBytes(const std::vector<T> &vector)
+{
+    return vector.capacity() * sizeof(T);
+}
 }
 
-void CompressedEdgeContainer::IncreaseFreeList()
+std::size_t CompressedEdgeContainer::GetNumberOfEdges() const
 {
-    m_compressed_oneway_geometries.resize(m_compressed_oneway_geometries.size() + 100);
-    for (unsigned i = 100; i > 0; --i)
+    return m_is_compacted ? m_compressed_geometry_offsets.size() - 1 : m_edge_chains.size();
+}
+
+unsigned CompressedEdgeContainer::GetLength(const EdgeID edge_id) const
+{
+    if (edge_id >= GetNumberOfEdges())
+    {
+        return 0;
+    }
+    if (m_is_compacted)
     {
-        m_free_list.emplace_back(free_list_maximum);
-        ++free_list_maximum;
+        return m_compressed_geometry_offsets[edge_id + 1] - m_compressed_geometry_offsets[edge_id];
     }
+    return m_edge_chains[edge_id].length;
 }
 
 bool CompressedEdgeContainer::HasEntryForID(const EdgeID edge_id) const
 {
-    auto iter = m_edge_id_to_list_index_map.find(edge_id);
-    return iter != m_edge_id_to_list_index_map.end();
+    return GetLength(edge_id) > 0;
 }
 
 bool CompressedEdgeContainer::HasZippedEntryForForwardID(const EdgeID edge_id) const
 {
-    auto iter = m_forward_edge_id_to_zipped_index_map.find(edge_id);
-    return iter != m_forward_edge_id_to_zipped_index_map.end();
+    return edge_id < m_forward_edge_id_to_zipped_index.size() &&
+           m_forward_edge_id_to_zipped_index[edge_id] != INVALID_POSITION;
 }
 
 bool CompressedEdgeContainer::HasZippedEntryForReverseID(const EdgeID edge_id) const
 {
-    auto iter = m_reverse_edge_id_to_zipped_index_map.find(edge_id);
-    return iter != m_reverse_edge_id_to_zipped_index_map.end();
-}
-
-unsigned CompressedEdgeContainer::GetPositionForID(const EdgeID edge_id) const
-{
-    auto map_iterator = m_edge_id_to_list_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_edge_id_to_list_index_map.end());
-    BOOST_ASSERT(map_iterator->second < m_compressed_oneway_geometries.size());
-    return map_iterator->second;
+    return edge_id < m_reverse_edge_id_to_zipped_index.size() &&
+           m_reverse_edge_id_to_zipped_index[edge_id] != INVALID_POSITION;
 }
 
 unsigned CompressedEdgeContainer::GetZippedPositionForForwardID(const EdgeID edge_id) const
 {
-    auto map_iterator = m_forward_edge_id_to_zipped_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_forward_edge_id_to_zipped_index_map.end());
-    BOOST_ASSERT(map_iterator->second < m_compressed_geometry_nodes.size());
-    return map_iterator->second;
+    BOOST_ASSERT(HasZippedEntryForForwardID(edge_id));
+    return m_forward_edge_id_to_zipped_index[edge_id];
 }
 
 unsigned CompressedEdgeContainer::GetZippedPositionForReverseID(const EdgeID edge_id) const
 {
-    auto map_iterator = m_reverse_edge_id_to_zipped_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_reverse_edge_id_to_zipped_index_map.end());
-    BOOST_ASSERT(map_iterator->second < m_compressed_geometry_nodes.size());
-    return map_iterator->second;
+    BOOST_ASSERT(HasZippedEntryForReverseID(edge_id));
+    return m_reverse_edge_id_to_zipped_index[edge_id];
 }
 
 void CompressedEdgeContainer::SerializeInternalVector(const std::string &path) const
 {
+    BOOST_ASSERT(m_is_zipped);
+
     boost::filesystem::fstream geometry_out_stream(path, std::ios::binary | std::ios::out);
     const unsigned compressed_geometry_indices = m_compressed_geometry_index.size() + 1;
     const unsigned compressed_geometries = m_compressed_geometry_nodes.size();
@@ -103,6 +107,36 @@ void CompressedEdgeContainer::SerializeInternalVector(const std::string &path) c
                               sizeof(EdgeWeight) * m_compressed_geometry_rev_weights.size());
 }
 
+// Appends a record to the chain of edge_id, creating the chain if it does not exist
+void CompressedEdgeContainer::Append(const EdgeID edge_id,
+                                     const OnewayCompressedEdge &compressed_edge)
+{
+    BOOST_ASSERT(!m_is_compacted);
+
+    if (edge_id >= m_edge_chains.size())
+    {
+        m_edge_chains.resize(edge_id + 1,
+                             EdgeChain{INVALID_POSITION, INVALID_POSITION, INVALID_POSITION, 0});
+    }
+
+    const unsigned position = m_chained_edges.size();
+    BOOST_ASSERT(position != INVALID_POSITION);
+    m_chained_edges.push_back(ChainedCompressedEdge{compressed_edge, INVALID_POSITION});
+
+    auto &chain = m_edge_chains[edge_id];
+    if (chain.length == 0)
+    {
+        chain.first = position;
+    }
+    else
+    {
+        m_chained_edges[chain.last].next = position;
+    }
+    chain.second_to_last = chain.last;
+    chain.last = position;
+    ++chain.length;
+}
+
 // Adds info for a compressed edge to the container.   edge_id_2
 // has been removed from the graph, so we have to save These edges/nodes
 // have already been trimmed from the graph, this function just stores
@@ -131,68 +165,34 @@ void CompressedEdgeContainer::CompressEdge(const EdgeID edge_id_1,
     //
     // General scheme:
     // 1. append via node id to list of edge_id_1
-    // 2. find list for edge_id_2, if yes add all elements and delete it
-
-    // Add via node id. List is created if it does not exist
-    if (!HasEntryForID(edge_id_1))
-    {
-        // create a new entry in the map
-        if (0 == m_free_list.size())
-        {
-            // make sure there is a place to put the entries
-            IncreaseFreeList();
-        }
-        BOOST_ASSERT(!m_free_list.empty());
-        m_edge_id_to_list_index_map[edge_id_1] = m_free_list.back();
-        m_free_list.pop_back();
-    }
-
-    // find bucket index
-    const auto iter = m_edge_id_to_list_index_map.find(edge_id_1);
-    BOOST_ASSERT(iter != m_edge_id_to_list_index_map.end());
-    const unsigned edge_bucket_id1 = iter->second;
-    BOOST_ASSERT(edge_bucket_id1 == GetPositionForID(edge_id_1));
-    BOOST_ASSERT(edge_bucket_id1 < m_compressed_oneway_geometries.size());
-
-    std::vector<OnewayCompressedEdge> &edge_bucket_list1 =
-        m_compressed_oneway_geometries[edge_bucket_id1];
+    // 2. find list for edge_id_2, if yes link it to the list of edge_id_1 and delete it
 
     // note we don't save the start coordinate: it is implicitly given by edge 1
     // weight1 is the distance to the (currently) last coordinate in the bucket
-    if (edge_bucket_list1.empty())
+    if (!HasEntryForID(edge_id_1))
     {
-        edge_bucket_list1.emplace_back(OnewayCompressedEdge{via_node_id, weight1});
+        Append(edge_id_1, OnewayCompressedEdge{via_node_id, weight1});
     }
 
-    BOOST_ASSERT(0 < edge_bucket_list1.size());
-    BOOST_ASSERT(!edge_bucket_list1.empty());
-
     if (HasEntryForID(edge_id_2))
     {
-        // second edge is not atomic anymore
-        const unsigned list_to_remove_index = GetPositionForID(edge_id_2);
-        BOOST_ASSERT(list_to_remove_index < m_compressed_oneway_geometries.size());
-
-        std::vector<OnewayCompressedEdge> &edge_bucket_list2 =
-            m_compressed_oneway_geometries[list_to_remove_index];
-
-        // found an existing list, append it to the list of edge_id_1
-        edge_bucket_list1.insert(
-            edge_bucket_list1.end(), edge_bucket_list2.begin(), edge_bucket_list2.end());
-
-        // remove the list of edge_id_2
-        m_edge_id_to_list_index_map.erase(edge_id_2);
-        BOOST_ASSERT(m_edge_id_to_list_index_map.end() ==
-                     m_edge_id_to_list_index_map.find(edge_id_2));
-        edge_bucket_list2.clear();
-        BOOST_ASSERT(0 == edge_bucket_list2.size());
-        m_free_list.emplace_back(list_to_remove_index);
-        BOOST_ASSERT(list_to_remove_index == m_free_list.back());
+        // second edge is not atomic anymore, move its chain to the end of the one of edge_id_1
+        auto &chain1 = m_edge_chains[edge_id_1];
+        auto &chain2 = m_edge_chains[edge_id_2];
+        BOOST_ASSERT(chain1.length > 0);
+
+        m_chained_edges[chain1.last].next = chain2.first;
+        chain1.second_to_last = chain2.length > 1 ? chain2.second_to_last : chain1.last;
+        chain1.last = chain2.last;
+        chain1.length += chain2.length;
+
+        chain2 = EdgeChain{INVALID_POSITION, INVALID_POSITION, INVALID_POSITION, 0};
+        BOOST_ASSERT(!HasEntryForID(edge_id_2));
     }
     else
     {
         // we are certain that the second edge is atomic.
-        edge_bucket_list1.emplace_back(OnewayCompressedEdge{target_node_id, weight2});
+        Append(edge_id_1, OnewayCompressedEdge{target_node_id, weight2});
     }
 }
 
@@ -205,100 +205,162 @@ void CompressedEdgeContainer::AddUncompressedEdge(const EdgeID edge_id,
     BOOST_ASSERT(SPECIAL_NODEID != target_node_id);
     BOOST_ASSERT(INVALID_EDGE_WEIGHT != weight);
 
-    // Add via node id. List is created if it does not exist
-    if (!HasEntryForID(edge_id))
-    {
-        // create a new entry in the map
-        if (0 == m_free_list.size())
-        {
-            // make sure there is a place to put the entries
-            IncreaseFreeList();
-        }
-        BOOST_ASSERT(!m_free_list.empty());
-        m_edge_id_to_list_index_map[edge_id] = m_free_list.back();
-        m_free_list.pop_back();
-    }
-
-    // find bucket index
-    const auto iter = m_edge_id_to_list_index_map.find(edge_id);
-    BOOST_ASSERT(iter != m_edge_id_to_list_index_map.end());
-    const unsigned edge_bucket_id = iter->second;
-    BOOST_ASSERT(edge_bucket_id == GetPositionForID(edge_id));
-    BOOST_ASSERT(edge_bucket_id < m_compressed_oneway_geometries.size());
-
-    std::vector<OnewayCompressedEdge> &edge_bucket_list =
-        m_compressed_oneway_geometries[edge_bucket_id];
-
     // note we don't save the start coordinate: it is implicitly given by edge_id
     // weight is the distance to the (currently) last coordinate in the bucket
     // Don't re-add this if it's already in there.
-    if (edge_bucket_list.empty())
+    if (!HasEntryForID(edge_id))
     {
-        edge_bucket_list.emplace_back(OnewayCompressedEdge{target_node_id, weight});
+        Append(edge_id, OnewayCompressedEdge{target_node_id, weight});
     }
 }
 
 void CompressedEdgeContainer::InitializeBothwayVector()
 {
-    m_compressed_geometry_index.reserve(m_compressed_oneway_geometries.size());
-    m_compressed_geometry_nodes.reserve(m_compressed_oneway_geometries.size());
-    m_compressed_geometry_fwd_weights.reserve(m_compressed_oneway_geometries.size());
-    m_compressed_geometry_rev_weights.reserve(m_compressed_oneway_geometries.size());
+    BOOST_ASSERT(!m_is_compacted);
+    TIMER_START(compact);
+
+    const std::size_t number_of_edges = m_edge_chains.size();
+    m_compressed_geometry_offsets.resize(number_of_edges + 1);
+    unsigned offset = 0;
+    for (std::size_t edge_id = 0; edge_id < number_of_edges; ++edge_id)
+    {
+        m_compressed_geometry_offsets[edge_id] = offset;
+        offset += m_edge_chains[edge_id].length;
+    }
+    m_compressed_geometry_offsets.back() = offset;
+
+    // unlink the chains of the edges into consecutive ranges of the compacted geometries
+    m_compressed_oneway_geometries.resize(offset);
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, number_of_edges),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto edge_id = range.begin(); edge_id != range.end(); ++edge_id)
+            {
+                const auto &chain = m_edge_chains[edge_id];
+                auto position = chain.first;
+                auto output = m_compressed_oneway_geometries.begin() +
+                              m_compressed_geometry_offsets[edge_id];
+                for (unsigned index = 0; index < chain.length; ++index)
+                {
+                    BOOST_ASSERT(position != INVALID_POSITION);
+                    *output++ = m_chained_edges[position].edge;
+                    position = m_chained_edges[position].next;
+                }
+            }
+        });
+
+    const auto chained_bytes = allocatedBytes(m_chained_edges) + allocatedBytes(m_edge_chains);
+    std::vector<ChainedCompressedEdge>().swap(m_chained_edges);
+    std::vector<EdgeChain>().swap(m_edge_chains);
+    m_is_compacted = true;
+
+    m_forward_edge_id_to_zipped_index.resize(number_of_edges, INVALID_POSITION);
+    m_reverse_edge_id_to_zipped_index.resize(number_of_edges, INVALID_POSITION);
+    m_compressed_geometry_index.reserve(number_of_edges / 2);
+
+    TIMER_STOP(compact);
+    const auto compacted_bytes = allocatedBytes(m_compressed_geometry_offsets) +
+                                 allocatedBytes(m_compressed_oneway_geometries);
+    util::SimpleLogger().Write() << "Compacted the geometries of " << number_of_edges
+                                 << " edges in " << TIMER_SEC(compact) << "s: "
+                                 << (chained_bytes >> 20) << " MiB while compressing, "
+                                 << (compacted_bytes >> 20) << " MiB compacted";
 }
 
 unsigned CompressedEdgeContainer::ZipEdges(const EdgeID f_edge_id, const EdgeID r_edge_id)
 {
-    const auto &forward_bucket = GetBucketReference(f_edge_id);
-    const auto &reverse_bucket = GetBucketReference(r_edge_id);
-
-    BOOST_ASSERT(forward_bucket.size() == reverse_bucket.size());
+    BOOST_ASSERT(m_is_compacted && !m_is_zipped);
+    BOOST_ASSERT(HasEntryForID(f_edge_id));
+    BOOST_ASSERT(GetLength(f_edge_id) == GetLength(r_edge_id));
+    BOOST_ASSERT(!HasZippedEntryForForwardID(f_edge_id));
+    BOOST_ASSERT(!HasZippedEntryForReverseID(r_edge_id));
 
     const unsigned zipped_geometry_id = m_compressed_geometry_index.size();
-    m_forward_edge_id_to_zipped_index_map[f_edge_id] = zipped_geometry_id;
-    m_reverse_edge_id_to_zipped_index_map[r_edge_id] = zipped_geometry_id;
-
-    m_compressed_geometry_index.emplace_back(m_compressed_geometry_nodes.size());
-
-    const auto &first_node = reverse_bucket.back();
-
-    m_compressed_geometry_nodes.emplace_back(first_node.node_id);
-    m_compressed_geometry_fwd_weights.emplace_back(INVALID_EDGE_WEIGHT);
-    m_compressed_geometry_rev_weights.emplace_back(first_node.weight);
-
-    for (std::size_t i = 0; i < forward_bucket.size() - 1; ++i)
-    {
-        const auto &fwd_node = forward_bucket.at(i);
-        const auto &rev_node = reverse_bucket.at(reverse_bucket.size() - 2 - i);
-
-        BOOST_ASSERT(fwd_node.node_id == rev_node.node_id);
-
-        m_compressed_geometry_nodes.emplace_back(fwd_node.node_id);
-        m_compressed_geometry_fwd_weights.emplace_back(fwd_node.weight);
-        m_compressed_geometry_rev_weights.emplace_back(rev_node.weight);
-    }
+    m_forward_edge_id_to_zipped_index[f_edge_id] = zipped_geometry_id;
+    m_reverse_edge_id_to_zipped_index[r_edge_id] = zipped_geometry_id;
 
-    const auto &last_node = forward_bucket.back();
-
-    m_compressed_geometry_nodes.emplace_back(last_node.node_id);
-    m_compressed_geometry_fwd_weights.emplace_back(last_node.weight);
-    m_compressed_geometry_rev_weights.emplace_back(INVALID_EDGE_WEIGHT);
+    // the zipped geometry holds the start node followed by the nodes of the forward geometry
+    const auto zipped_geometry_begin = m_compressed_geometry_nodes.size();
+    const auto zipped_geometry_end = zipped_geometry_begin + GetLength(f_edge_id) + 1;
+    m_compressed_geometry_index.emplace_back(zipped_geometry_begin);
+    m_compressed_geometry_nodes.resize(zipped_geometry_end);
+    m_compressed_geometry_fwd_weights.resize(zipped_geometry_end);
+    m_compressed_geometry_rev_weights.resize(zipped_geometry_end);
 
     return zipped_geometry_id;
 }
 
+void CompressedEdgeContainer::ZipAllEdges()
+{
+    BOOST_ASSERT(m_is_compacted && !m_is_zipped);
+    TIMER_START(zip);
+
+    // every edge is zipped at most once in each direction, so the edges write disjoint ranges
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, GetNumberOfEdges()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto edge_id = range.begin(); edge_id != range.end(); ++edge_id)
+            {
+                if (HasZippedEntryForForwardID(edge_id))
+                {
+                    const auto &forward_bucket = GetBucketReference(edge_id);
+                    const auto begin =
+                        m_compressed_geometry_index[GetZippedPositionForForwardID(edge_id)];
+
+                    m_compressed_geometry_fwd_weights[begin] = INVALID_EDGE_WEIGHT;
+                    for (std::size_t i = 0; i < forward_bucket.size(); ++i)
+                    {
+                        m_compressed_geometry_nodes[begin + 1 + i] = forward_bucket[i].node_id;
+                        m_compressed_geometry_fwd_weights[begin + 1 + i] = forward_bucket[i].weight;
+                    }
+                }
+
+                if (HasZippedEntryForReverseID(edge_id))
+                {
+                    const auto &reverse_bucket = GetBucketReference(edge_id);
+                    const auto begin =
+                        m_compressed_geometry_index[GetZippedPositionForReverseID(edge_id)];
+                    const auto size = reverse_bucket.size();
+
+                    // the reverse geometry ends at the start node of the forward geometry
+                    m_compressed_geometry_nodes[begin] = reverse_bucket.back().node_id;
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        m_compressed_geometry_rev_weights[begin + i] =
+                            reverse_bucket[size - 1 - i].weight;
+                    }
+                    m_compressed_geometry_rev_weights[begin + size] = INVALID_EDGE_WEIGHT;
+                }
+            }
+        });
+    m_is_zipped = true;
+
+    TIMER_STOP(zip);
+    const auto zipped_bytes =
+        allocatedBytes(m_compressed_geometry_index) + allocatedBytes(m_compressed_geometry_nodes) +
+        allocatedBytes(m_compressed_geometry_fwd_weights) +
+        allocatedBytes(m_compressed_geometry_rev_weights) +
+        allocatedBytes(m_forward_edge_id_to_zipped_index) +
+        allocatedBytes(m_reverse_edge_id_to_zipped_index);
+    util::SimpleLogger().Write() << "Zipped " << m_compressed_geometry_index.size()
+                                 << " geometries in " << TIMER_SEC(zip) << "s: "
+                                 << (zipped_bytes >> 20) << " MiB";
+}
+
 void CompressedEdgeContainer::PrintStatistics() const
 {
-    const uint64_t compressed_edges = m_compressed_oneway_geometries.size();
-    BOOST_ASSERT(0 == compressed_edges % 2);
-    BOOST_ASSERT(m_compressed_oneway_geometries.size() + m_free_list.size() > 0);
+    BOOST_ASSERT(m_is_compacted);
 
-    uint64_t compressed_geometries = 0;
+    uint64_t compressed_edges = 0;
     uint64_t longest_chain_length = 0;
-    for (const std::vector<OnewayCompressedEdge> &current_vector : m_compressed_oneway_geometries)
+    for (std::size_t edge_id = 0; edge_id < GetNumberOfEdges(); ++edge_id)
     {
-        compressed_geometries += current_vector.size();
-        longest_chain_length = std::max(longest_chain_length, (uint64_t)current_vector.size());
+        const uint64_t length = GetLength(edge_id);
+        compressed_edges += length > 0 ? 1 : 0;
+        longest_chain_length = std::max(longest_chain_length, length);
     }
+    const uint64_t compressed_geometries = m_compressed_oneway_geometries.size();
+    BOOST_ASSERT(0 == compressed_edges % 2);
 
     util::SimpleLogger().Write()
         << "Geometry successfully removed:"
@@ -310,11 +372,14 @@ void CompressedEdgeContainer::PrintStatistics() const
         << (float)compressed_geometries / std::max((uint64_t)1, compressed_edges);
 }
 
-const CompressedEdgeContainer::OnewayEdgeBucket &
+CompressedEdgeContainer::OnewayEdgeBucket
 CompressedEdgeContainer::GetBucketReference(const EdgeID edge_id) const
 {
-    const unsigned index = m_edge_id_to_list_index_map.at(edge_id);
-    return m_compressed_oneway_geometries.at(index);
+    BOOST_ASSERT(m_is_compacted);
+    BOOST_ASSERT(edge_id < GetNumberOfEdges());
+    const auto begin = m_compressed_oneway_geometries.begin();
+    return OnewayEdgeBucket(begin + m_compressed_geometry_offsets[edge_id],
+                            begin + m_compressed_geometry_offsets[edge_id + 1]);
 }
 
 // Since all edges are technically in the compressed geometry container,
@@ -323,27 +388,48 @@ CompressedEdgeContainer::GetBucketReference(const EdgeID edge_id) const
 // that only contain one original segment
 bool CompressedEdgeContainer::IsTrivial(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    return bucket.size() == 1;
+    return GetLength(edge_id) == 1;
 }
 
 NodeID CompressedEdgeContainer::GetFirstEdgeTargetID(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    BOOST_ASSERT(bucket.size() >= 1);
-    return bucket.front().node_id;
+    BOOST_ASSERT(GetLength(edge_id) >= 1);
+    if (m_is_compacted)
+    {
+        return GetBucketReference(edge_id).front().node_id;
+    }
+    return m_chained_edges[m_edge_chains[edge_id].first].edge.node_id;
 }
 NodeID CompressedEdgeContainer::GetLastEdgeTargetID(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    BOOST_ASSERT(bucket.size() >= 1);
-    return bucket.back().node_id;
+    BOOST_ASSERT(GetLength(edge_id) >= 1);
+    if (m_is_compacted)
+    {
+        return GetBucketReference(edge_id).back().node_id;
+    }
+    return m_chained_edges[m_edge_chains[edge_id].last].edge.node_id;
 }
 NodeID CompressedEdgeContainer::GetLastEdgeSourceID(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    BOOST_ASSERT(bucket.size() >= 2);
-    return bucket[bucket.size() - 2].node_id;
+    BOOST_ASSERT(GetLength(edge_id) >= 2);
+    if (m_is_compacted)
+    {
+        const auto &bucket = GetBucketReference(edge_id);
+        return bucket[bucket.size() - 2].node_id;
+    }
+    return m_chained_edges[m_edge_chains[edge_id].second_to_last].edge.node_id;
+}
+
+const std::vector<unsigned> &CompressedEdgeContainer::GetZippedGeometryIndices() const
+{
+    BOOST_ASSERT(m_is_zipped);
+    return m_compressed_geometry_index;
+}
+
+const std::vector<NodeID> &CompressedEdgeContainer::GetZippedGeometryNodes() const
+{
+    BOOST_ASSERT(m_is_zipped);
+    return m_compressed_geometry_nodes;
 }
 }
 }
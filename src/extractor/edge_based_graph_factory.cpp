@@ -19,6 +19,9 @@
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
 #include <cmath>
 #include <fstream>
@@ -27,6 +30,8 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -188,10 +193,12 @@ void EdgeBasedGraphFactory::FlushVectorToStream(
 }
 
 void EdgeBasedGraphFactory::Run(ScriptingEnvironment &scripting_environment,
+                                const TurnPenaltyTable &turn_penalty_table,
                                 const std::string &original_edge_data_filename,
                                 const std::string &turn_lane_data_filename,
                                 const std::string &edge_segment_lookup_filename,
                                 const std::string &edge_penalty_filename,
+                                const std::string &edge_segment_index_filename,
                                 const bool generate_edge_lookup)
 {
     TIMER_START(renumber);
@@ -205,10 +212,12 @@ void EdgeBasedGraphFactory::Run(ScriptingEnvironment &scripting_environment,
 
     TIMER_START(generate_edges);
     GenerateEdgeExpandedEdges(scripting_environment,
+                              turn_penalty_table,
                               original_edge_data_filename,
                               turn_lane_data_filename,
                               edge_segment_lookup_filename,
                               edge_penalty_filename,
+                              edge_segment_index_filename,
                               generate_edge_lookup);
 
     TIMER_STOP(generate_edges);
@@ -296,6 +305,8 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedNodes()
         }
     }
 
+    m_compressed_edge_container.ZipAllEdges();
+
     BOOST_ASSERT(m_edge_based_node_list.size() == m_edge_based_node_is_startpoint.size());
     BOOST_ASSERT(m_max_edge_id + 1 == m_edge_based_node_weights.size());
 
@@ -303,13 +314,84 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedNodes()
                                  << " nodes in edge-expanded graph";
 }
 
+namespace
+{
+// The turns of this many node-based nodes are generated by one task
+const constexpr std::size_t EXPANSION_CHUNK_SIZE = 1024;
+// Number of chunks that are generated in parallel before they are merged, this bounds the memory
+// of the buffered turns
+const constexpr std::size_t EXPANSION_CHUNKS_PER_BATCH = 256;
+
+// Returns the id of value in map, a value that is not in the map yet gets the next free id
+template <typename MapT>
+typename MapT::mapped_type
+internValue(MapT &map, const typename MapT::key_type &value, const std::size_t first_id = 0)
+{
+    const auto itr = map.find(value);
+    if (itr != map.end())
+    {
+        return itr->second;
+    }
+
+    const auto id = static_cast<typename MapT::mapped_type>(first_id + map.size());
+    map.emplace(value, id);
+    return id;
+}
+
+// Classes of a chunk, numbered in the order they are first seen
+template <typename ClassT, typename ClassIDT> struct LocalClassTable
+{
+    ClassIDT Insert(const ClassT &value)
+    {
+        const auto size = ids.size();
+        const auto id = internValue(ids, value);
+        if (ids.size() != size)
+        {
+            values.push_back(value);
+        }
+        return id;
+    }
+
+    std::unordered_map<ClassT, ClassIDT> ids;
+    std::vector<ClassT> values;
+};
+
+// Everything the turns of a chunk of nodes add to the edge-expanded graph. The entry class,
+// bearing class, lane description and lane data ids are local to the chunk, they are replaced by
+// the global ids when the chunk is merged.
+struct EdgeExpansionChunk
+{
+    std::size_t node_based_edges = 0;
+    std::size_t lanes_called = 0;
+    std::size_t lanes_handled = 0;
+
+    // the edge ids are assigned during the merge
+    std::vector<EdgeBasedEdge> edges;
+    std::vector<OriginalEdgeData> original_edge_data;
+    // node-based node and the bearing class of the intersection at it
+    std::vector<std::pair<NodeID, BearingClassID>> node_bearing_classes;
+
+    LocalClassTable<util::guidance::EntryClass, EntryClassID> entry_classes;
+    LocalClassTable<util::guidance::BearingClass, BearingClassID> bearing_classes;
+    guidance::LaneDescriptionMap new_lane_descriptions;
+    guidance::LaneDataIdMap lane_data_map;
+
+    // one header and one penalty block per edge, num_osm_nodes - 1 segment blocks per header
+    std::vector<lookup::SegmentHeaderBlock> segment_headers;
+    std::vector<lookup::SegmentBlock> segment_blocks;
+    std::vector<lookup::PenaltyBlock> penalty_blocks;
+};
+}
+
 /// Actually it also generates OriginalEdgeData and serializes them...
 void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     ScriptingEnvironment &scripting_environment,
+    const TurnPenaltyTable &turn_penalty_table,
     const std::string &original_edge_data_filename,
     const std::string &turn_lane_data_filename,
     const std::string &edge_segment_lookup_filename,
     const std::string &edge_fixed_penalties_filename,
+    const std::string &edge_segment_index_filename,
     const bool generate_edge_lookup)
 {
     util::SimpleLogger().Write() << "generating edge-expanded edges";
@@ -323,6 +405,9 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     std::ofstream edge_data_file(original_edge_data_filename.c_str(), std::ios::binary);
     std::ofstream edge_segment_file;
     std::ofstream edge_penalty_file;
+    // reverse index of the lookup files, lets osrm-contract update only the affected edges
+    SegmentIndex segment_index;
+    std::uint64_t edge_segment_file_offset = 0;
 
     if (generate_edge_lookup)
     {
@@ -338,9 +423,6 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     std::vector<OriginalEdgeData> original_edge_data_vector;
     original_edge_data_vector.reserve(1024 * 1024);
 
-    // Loop over all turns and generate new set of edges.
-    // Three nested loop look super-linear, but we are dealing with a (kind of)
-    // linear number of turns only.
     util::Percent progress(m_node_based_graph->GetNumberOfNodes());
     SuffixTable street_name_suffix_table(scripting_environment);
     guidance::TurnAnalysis turn_analysis(*m_node_based_graph,
@@ -352,226 +434,392 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                                          street_name_suffix_table,
                                          profile_properties);
 
+    // The turns are generated for chunks of nodes in parallel. The analysis of an intersection
+    // only reads shared data, every chunk collects its turns and classes in its own buffers. The
+    // chunks are merged in node order, which assigns the same ids as generating the turns of one
+    // node after the other. The output does not depend on the number of threads.
+    const auto number_of_lane_descriptions = lane_description_map.size();
+    // descriptions that are combined for sliproads, they are added to lane_description_map at
+    // the end since it is read by all chunks
+    guidance::LaneDescriptionMap new_lane_descriptions;
     guidance::LaneDataIdMap lane_data_map;
-    guidance::lanes::TurnLaneHandler turn_lane_handler(*m_node_based_graph,
-                                                       turn_lane_offsets,
-                                                       turn_lane_masks,
-                                                       lane_description_map,
-                                                       turn_analysis,
-                                                       lane_data_map);
+    std::size_t lanes_called = 0;
+    std::size_t lanes_handled = 0;
 
     bearing_class_by_node_based_node.resize(m_node_based_graph->GetNumberOfNodes(),
                                             std::numeric_limits<std::uint32_t>::max());
 
-    for (const auto node_u : util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
-    {
-        progress.PrintStatus(node_u);
-        for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
+    // Loop over all turns and generate new set of edges.
+    // Three nested loop look super-linear, but we are dealing with a (kind of)
+    // linear number of turns only.
+    const auto expand_chunk = [&](const NodeID begin, const NodeID end, EdgeExpansionChunk &chunk) {
+        guidance::lanes::TurnLaneHandler turn_lane_handler(*m_node_based_graph,
+                                                           turn_lane_offsets,
+                                                           turn_lane_masks,
+                                                           lane_description_map,
+                                                           chunk.new_lane_descriptions,
+                                                           turn_analysis,
+                                                           chunk.lane_data_map);
+
+        for (const auto node_u : util::irange(begin, end))
         {
-            if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
+            for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
             {
-                continue;
-            }
+                if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
+                {
+                    continue;
+                }
 
-            const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
-            ++node_based_edge_counter;
-            auto intersection = turn_analysis.getIntersection(node_u, edge_from_u);
-            BOOST_ASSERT(intersection.valid());
-            intersection =
-                turn_analysis.assignTurnTypes(node_u, edge_from_u, std::move(intersection));
-            intersection =
-                turn_lane_handler.assignTurnLanes(node_u, edge_from_u, std::move(intersection));
+                const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
+                ++chunk.node_based_edges;
+                auto intersection = turn_analysis.getIntersection(node_u, edge_from_u);
+                BOOST_ASSERT(intersection.valid());
+                intersection =
+                    turn_analysis.assignTurnTypes(node_u, edge_from_u, std::move(intersection));
+                intersection =
+                    turn_lane_handler.assignTurnLanes(node_u, edge_from_u, std::move(intersection));
 
-            const auto possible_turns = turn_analysis.transformIntersectionIntoTurns(intersection);
+                const auto possible_turns =
+                    turn_analysis.transformIntersectionIntoTurns(intersection);
 
-            // the entry class depends on the turn, so we have to classify the interesction for
-            // every edge
-            const auto turn_classification = classifyIntersection(intersection);
+                // the entry class depends on the turn, so we have to classify the interesction for
+                // every edge
+                const auto turn_classification = classifyIntersection(intersection);
 
-            const auto entry_class_id = [&](const util::guidance::EntryClass entry_class) {
-                if (0 == entry_class_hash.count(entry_class))
-                {
-                    const auto id = static_cast<std::uint16_t>(entry_class_hash.size());
-                    entry_class_hash[entry_class] = id;
-                    return id;
-                }
-                else
-                {
-                    return entry_class_hash.find(entry_class)->second;
-                }
-            }(turn_classification.first);
+                const auto entry_class_id = chunk.entry_classes.Insert(turn_classification.first);
+                chunk.node_bearing_classes.emplace_back(
+                    node_v, chunk.bearing_classes.Insert(turn_classification.second));
 
-            const auto bearing_class_id = [&](const util::guidance::BearingClass bearing_class) {
-                if (0 == bearing_class_hash.count(bearing_class))
-                {
-                    const auto id = static_cast<std::uint32_t>(bearing_class_hash.size());
-                    bearing_class_hash[bearing_class] = id;
-                    return id;
-                }
-                else
+                for (const auto turn : possible_turns)
                 {
-                    return bearing_class_hash.find(bearing_class)->second;
-                }
-            }(turn_classification.second);
-            bearing_class_by_node_based_node[node_v] = bearing_class_id;
+                    // only add an edge if turn is not prohibited
+                    const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
+                    const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
 
-            for (const auto turn : possible_turns)
-            {
-                // only add an edge if turn is not prohibited
-                const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
-                const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
+                    BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
+                    BOOST_ASSERT(!edge_data1.reversed);
+                    BOOST_ASSERT(!edge_data2.reversed);
 
-                BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
-                BOOST_ASSERT(!edge_data1.reversed);
-                BOOST_ASSERT(!edge_data2.reversed);
+                    // the following is the core of the loop.
+                    unsigned distance = edge_data1.distance;
+                    if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
+                    {
+                        distance += profile_properties.traffic_signal_penalty;
+                    }
 
-                // the following is the core of the loop.
-                unsigned distance = edge_data1.distance;
-                if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
-                {
-                    distance += profile_properties.traffic_signal_penalty;
-                }
+                    const double turn_angle = 180. - turn.angle;
+                    const int32_t turn_penalty =
+                        turn_penalty_table.Empty()
+                            ? scripting_environment.GetTurnPenalty(turn_angle)
+                            : turn_penalty_table.GetTurnPenalty(turn_angle);
 
-                const int32_t turn_penalty =
-                    scripting_environment.GetTurnPenalty(180. - turn.angle);
+                    const auto turn_instruction = turn.instruction;
 
-                const auto turn_instruction = turn.instruction;
+                    if (turn_instruction.direction_modifier == guidance::DirectionModifier::UTurn)
+                    {
+                        distance += profile_properties.u_turn_penalty;
+                    }
 
-                if (turn_instruction.direction_modifier == guidance::DirectionModifier::UTurn)
-                {
-                    distance += profile_properties.u_turn_penalty;
-                }
+                    // don't add turn penalty if it is not an actual turn. This heuristic is
+                    // necessary since OSRM cannot handle looping roads/parallel roads
+                    if (turn_instruction.type != guidance::TurnType::NoTurn)
+                        distance += turn_penalty;
+
+                    const bool is_encoded_forwards =
+                        m_compressed_edge_container.HasZippedEntryForForwardID(edge_from_u);
+                    const bool is_encoded_backwards =
+                        m_compressed_edge_container.HasZippedEntryForReverseID(edge_from_u);
+                    BOOST_ASSERT(is_encoded_forwards || is_encoded_backwards);
+                    if (is_encoded_forwards)
+                    {
+                        chunk.original_edge_data.emplace_back(
+                            GeometryID{m_compressed_edge_container.GetZippedPositionForForwardID(
+                                           edge_from_u),
+                                       true},
+                            edge_data1.name_id,
+                            turn.lane_data_id,
+                            turn_instruction,
+                            entry_class_id,
+                            edge_data1.travel_mode,
+                            util::guidance::TurnBearing(intersection[0].bearing),
+                            util::guidance::TurnBearing(turn.bearing));
+                    }
+                    else if (is_encoded_backwards)
+                    {
+                        chunk.original_edge_data.emplace_back(
+                            GeometryID{m_compressed_edge_container.GetZippedPositionForReverseID(
+                                           edge_from_u),
+                                       false},
+                            edge_data1.name_id,
+                            turn.lane_data_id,
+                            turn_instruction,
+                            entry_class_id,
+                            edge_data1.travel_mode,
+                            util::guidance::TurnBearing(intersection[0].bearing),
+                            util::guidance::TurnBearing(turn.bearing));
+                    }
 
-                // don't add turn penalty if it is not an actual turn. This heuristic is necessary
-                // since OSRM cannot handle looping roads/parallel roads
-                if (turn_instruction.type != guidance::TurnType::NoTurn)
-                    distance += turn_penalty;
-
-                const bool is_encoded_forwards =
-                    m_compressed_edge_container.HasZippedEntryForForwardID(edge_from_u);
-                const bool is_encoded_backwards =
-                    m_compressed_edge_container.HasZippedEntryForReverseID(edge_from_u);
-                BOOST_ASSERT(is_encoded_forwards || is_encoded_backwards);
-                if (is_encoded_forwards)
-                {
-                    original_edge_data_vector.emplace_back(
-                        GeometryID{
-                            m_compressed_edge_container.GetZippedPositionForForwardID(edge_from_u),
-                            true},
-                        edge_data1.name_id,
-                        turn.lane_data_id,
-                        turn_instruction,
-                        entry_class_id,
-                        edge_data1.travel_mode,
-                        util::guidance::TurnBearing(intersection[0].bearing),
-                        util::guidance::TurnBearing(turn.bearing));
-                }
-                else if (is_encoded_backwards)
-                {
-                    original_edge_data_vector.emplace_back(
-                        GeometryID{
-                            m_compressed_edge_container.GetZippedPositionForReverseID(edge_from_u),
-                            false},
-                        edge_data1.name_id,
-                        turn.lane_data_id,
-                        turn_instruction,
-                        entry_class_id,
-                        edge_data1.travel_mode,
-                        util::guidance::TurnBearing(intersection[0].bearing),
-                        util::guidance::TurnBearing(turn.bearing));
+                    BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
+                    BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+
+                    chunk.edges.emplace_back(edge_data1.edge_id,
+                                             edge_data2.edge_id,
+                                             SPECIAL_EDGEID,
+                                             distance,
+                                             true,
+                                             false);
+
+                    // Here is where we collect the mapping between the edge-expanded edges, and
+                    // the node-based edges that are originally used to calculate the `distance`
+                    // for the edge-expanded edges.  About 60 lines back, there is:
+                    //
+                    //                 unsigned distance = edge_data1.distance;
+                    //
+                    // This tells us that the weight for an edge-expanded-edge is based on the
+                    // weight of the *source* node-based edge.  Therefore, we will look up the
+                    // individual segments of the source node-based edge, and write out a mapping
+                    // between those and the edge-based-edge ID.
+                    // External programs can then use this mapping to quickly perform
+                    // updates to the edge-expanded-edge based directly on its ID.
+                    if (generate_edge_lookup)
+                    {
+                        const auto node_based_edges =
+                            m_compressed_edge_container.GetBucketReference(edge_from_u);
+                        NodeID previous = node_u;
+
+                        const unsigned node_count = node_based_edges.size() + 1;
+                        const QueryNode &first_node = m_node_info_list[previous];
+
+                        chunk.segment_headers.push_back({node_count, first_node.node_id});
+
+                        for (auto target_node : node_based_edges)
+                        {
+                            const QueryNode &from = m_node_info_list[previous];
+                            const QueryNode &to = m_node_info_list[target_node.node_id];
+                            const double segment_length =
+                                util::coordinate_calculation::greatCircleDistance(from, to);
+
+                            chunk.segment_blocks.push_back(
+                                {to.node_id, segment_length, target_node.weight});
+                            previous = target_node.node_id;
+                        }
+
+                        // We also now write out the mapping between the edge-expanded edges and
+                        // the original nodes. Since each edge represents a possible maneuver,
+                        // external programs can use this to quickly perform updates to edge
+                        // weights in order to penalize certain turns.
+
+                        // If this edge is 'trivial' -- where the compressed edge corresponds
+                        // exactly to an original OSM segment -- we can pull the turn's preceding
+                        // node ID directly with `node_u`; otherwise, we need to look up the node
+                        // immediately preceding the turn from the compressed edge container.
+                        const bool isTrivial = m_compressed_edge_container.IsTrivial(edge_from_u);
+
+                        const auto &from_node =
+                            isTrivial
+                                ? m_node_info_list[node_u]
+                                : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
+                                      edge_from_u)];
+                        const auto &via_node =
+                            m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
+                                edge_from_u)];
+                        const auto &to_node =
+                            m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
+                                turn.eid)];
+
+                        const unsigned fixed_penalty = distance - edge_data1.distance;
+                        chunk.penalty_blocks.push_back(
+                            {fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id});
+                    }
                 }
+            }
+        }
 
-                ++original_edges_counter;
+        chunk.lanes_called = turn_lane_handler.countCalled();
+        chunk.lanes_handled = turn_lane_handler.countHandled();
+    };
 
-                if (original_edge_data_vector.size() > 1024 * 1024 * 10)
-                {
-                    FlushVectorToStream(edge_data_file, original_edge_data_vector);
-                }
+    // Replaces the chunk-local ids by global ids, which are assigned in the order of the chunks,
+    // numbers the edges and writes them out
+    const auto merge_chunk = [&](const EdgeExpansionChunk &chunk) {
+        node_based_edge_counter += chunk.node_based_edges;
+        lanes_called += chunk.lanes_called;
+        lanes_handled += chunk.lanes_handled;
 
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
-
-                // NOTE: potential overflow here if we hit 2^32 routable edges
-                BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
-                m_edge_based_edge_list.emplace_back(edge_data1.edge_id,
-                                                    edge_data2.edge_id,
-                                                    m_edge_based_edge_list.size(),
-                                                    distance,
-                                                    true,
-                                                    false);
-
-                // Here is where we write out the mapping between the edge-expanded edges, and
-                // the node-based edges that are originally used to calculate the `distance`
-                // for the edge-expanded edges.  About 40 lines back, there is:
-                //
-                //                 unsigned distance = edge_data1.distance;
-                //
-                // This tells us that the weight for an edge-expanded-edge is based on the weight
-                // of the *source* node-based edge.  Therefore, we will look up the individual
-                // segments of the source node-based edge, and write out a mapping between
-                // those and the edge-based-edge ID.
-                // External programs can then use this mapping to quickly perform
-                // updates to the edge-expanded-edge based directly on its ID.
-                if (generate_edge_lookup)
-                {
-                    const auto node_based_edges =
-                        m_compressed_edge_container.GetBucketReference(edge_from_u);
-                    NodeID previous = node_u;
+        std::vector<EntryClassID> entry_class_ids;
+        entry_class_ids.reserve(chunk.entry_classes.values.size());
+        for (const auto &entry_class : chunk.entry_classes.values)
+        {
+            entry_class_ids.push_back(internValue(entry_class_hash, entry_class));
+        }
 
-                    const unsigned node_count = node_based_edges.size() + 1;
-                    const QueryNode &first_node = m_node_info_list[previous];
+        std::vector<BearingClassID> bearing_class_ids;
+        bearing_class_ids.reserve(chunk.bearing_classes.values.size());
+        for (const auto &bearing_class : chunk.bearing_classes.values)
+        {
+            bearing_class_ids.push_back(internValue(bearing_class_hash, bearing_class));
+        }
+        for (const auto &node_and_class : chunk.node_bearing_classes)
+        {
+            bearing_class_by_node_based_node[node_and_class.first] =
+                bearing_class_ids[node_and_class.second];
+        }
 
-                    lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
+        // the local ids of new lane descriptions continue the ids of lane_description_map
+        std::vector<const guidance::LaneDescriptionMap::key_type *> chunk_lane_descriptions(
+            chunk.new_lane_descriptions.size());
+        for (const auto &description_and_id : chunk.new_lane_descriptions)
+        {
+            chunk_lane_descriptions[description_and_id.second - number_of_lane_descriptions] =
+                &description_and_id.first;
+        }
+        std::vector<LaneDescriptionID> lane_description_ids;
+        lane_description_ids.reserve(chunk_lane_descriptions.size());
+        for (const auto description : chunk_lane_descriptions)
+        {
+            lane_description_ids.push_back(
+                internValue(new_lane_descriptions, *description, number_of_lane_descriptions));
+        }
 
-                    edge_segment_file.write(reinterpret_cast<const char *>(&header),
-                                            sizeof(header));
+        std::vector<const util::guidance::LaneTupleIdPair *> chunk_lane_data(
+            chunk.lane_data_map.size());
+        for (const auto &lane_data_and_id : chunk.lane_data_map)
+        {
+            chunk_lane_data[lane_data_and_id.second] = &lane_data_and_id.first;
+        }
+        std::vector<LaneDataID> lane_data_ids;
+        lane_data_ids.reserve(chunk_lane_data.size());
+        for (const auto lane_data : chunk_lane_data)
+        {
+            auto key = *lane_data;
+            if (key.second >= number_of_lane_descriptions)
+            {
+                key.second = lane_description_ids[key.second - number_of_lane_descriptions];
+            }
+            lane_data_ids.push_back(internValue(lane_data_map, key));
+        }
 
-                    for (auto target_node : node_based_edges)
-                    {
-                        const QueryNode &from = m_node_info_list[previous];
-                        const QueryNode &to = m_node_info_list[target_node.node_id];
-                        const double segment_length =
-                            util::coordinate_calculation::greatCircleDistance(from, to);
+        for (auto original_edge_data : chunk.original_edge_data)
+        {
+            original_edge_data.entry_classid = entry_class_ids[original_edge_data.entry_classid];
+            if (original_edge_data.lane_data_id != INVALID_LANE_DATAID)
+            {
+                original_edge_data.lane_data_id = lane_data_ids[original_edge_data.lane_data_id];
+            }
+            original_edge_data_vector.push_back(original_edge_data);
+        }
+        original_edges_counter += chunk.edges.size();
 
-                        lookup::SegmentBlock nodeblock = {
-                            to.node_id, segment_length, target_node.weight};
+        if (original_edge_data_vector.size() > 1024 * 1024 * 10)
+        {
+            FlushVectorToStream(edge_data_file, original_edge_data_vector);
+        }
 
-                        edge_segment_file.write(reinterpret_cast<const char *>(&nodeblock),
-                                                sizeof(nodeblock));
-                        previous = target_node.node_id;
-                    }
+        BOOST_ASSERT(!generate_edge_lookup || chunk.segment_headers.size() == chunk.edges.size());
+        auto segment_block = chunk.segment_blocks.begin();
+        for (const auto index : util::irange<std::size_t>(0, chunk.edges.size()))
+        {
+            // NOTE: potential overflow here if we hit 2^32 routable edges
+            BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
+            const EdgeID edge_based_edge_id = m_edge_based_edge_list.size();
+            EdgeBasedEdge edge = chunk.edges[index];
+            edge.edge_id = edge_based_edge_id;
+            m_edge_based_edge_list.push_back(edge);
+
+            if (generate_edge_lookup)
+            {
+                const auto &header = chunk.segment_headers[index];
+                const auto number_of_segments = header.num_osm_nodes - 1;
+
+                segment_index.segment_offsets.push_back(edge_segment_file_offset);
+                edge_segment_file_offset += sizeof(lookup::SegmentHeaderBlock) +
+                                            number_of_segments * sizeof(lookup::SegmentBlock);
+
+                edge_segment_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+                OSMNodeID from = header.previous_osm_node_id;
+                for (const auto end = segment_block + number_of_segments; segment_block != end;
+                     ++segment_block)
+                {
+                    edge_segment_file.write(reinterpret_cast<const char *>(&*segment_block),
+                                            sizeof(lookup::SegmentBlock));
+                    const OSMNodeID to = segment_block->this_osm_node_id;
+                    segment_index.segment_edges.push_back({from, to, edge_based_edge_id});
+                    from = to;
+                }
+
+                const auto &penalty_block = chunk.penalty_blocks[index];
+                edge_penalty_file.write(reinterpret_cast<const char *>(&penalty_block),
+                                        sizeof(penalty_block));
+                segment_index.turn_edges.push_back({penalty_block.from_id,
+                                                    penalty_block.via_id,
+                                                    penalty_block.to_id,
+                                                    edge_based_edge_id});
+            }
+        }
+    };
 
-                    // We also now write out the mapping between the edge-expanded edges and the
-                    // original nodes. Since each edge represents a possible maneuver, external
-                    // programs can use this to quickly perform updates to edge weights in order
-                    // to penalize certain turns.
-
-                    // If this edge is 'trivial' -- where the compressed edge corresponds
-                    // exactly to an original OSM segment -- we can pull the turn's preceding
-                    // node ID directly with `node_u`; otherwise, we need to look up the node
-                    // immediately preceding the turn from the compressed edge container.
-                    const bool isTrivial = m_compressed_edge_container.IsTrivial(edge_from_u);
-
-                    const auto &from_node =
-                        isTrivial
-                            ? m_node_info_list[node_u]
-                            : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
-                                  edge_from_u)];
-                    const auto &via_node =
-                        m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
-                            edge_from_u)];
-                    const auto &to_node =
-                        m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
-                            turn.eid)];
-
-                    const unsigned fixed_penalty = distance - edge_data1.distance;
-                    lookup::PenaltyBlock penaltyblock = {
-                        fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id};
-                    edge_penalty_file.write(reinterpret_cast<const char *>(&penaltyblock),
-                                            sizeof(penaltyblock));
+    const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+    const NodeID batch_size = EXPANSION_CHUNK_SIZE * EXPANSION_CHUNKS_PER_BATCH;
+    std::vector<EdgeExpansionChunk> chunks;
+    for (NodeID batch_begin = 0; batch_begin < number_of_nodes; batch_begin += batch_size)
+    {
+        const NodeID batch_end = std::min(number_of_nodes, batch_begin + batch_size);
+        const std::size_t number_of_chunks =
+            (batch_end - batch_begin + EXPANSION_CHUNK_SIZE - 1) / EXPANSION_CHUNK_SIZE;
+
+        chunks.clear();
+        chunks.resize(number_of_chunks);
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_chunks, 1),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                for (const auto chunk_index : util::irange(range.begin(), range.end()))
+                {
+                    const NodeID begin = batch_begin + chunk_index * EXPANSION_CHUNK_SIZE;
+                    const NodeID end = std::min<NodeID>(batch_end, begin + EXPANSION_CHUNK_SIZE);
+                    expand_chunk(begin, end, chunks[chunk_index]);
                 }
+            });
+
+        for (const auto &chunk : chunks)
+        {
+            merge_chunk(chunk);
+        }
+        progress.PrintStatus(batch_end);
+    }
+    chunks.clear();
+
+    // the lane data of the new descriptions refers to their ids
+    lane_description_map.insert(new_lane_descriptions.begin(), new_lane_descriptions.end());
+    util::SimpleLogger().Write() << "Assigned turn lanes at " << lanes_handled << " of "
+                                 << lanes_called << " intersections with turn lanes";
+
+    if (generate_edge_lookup)
+    {
+        // Both directions of every segment of the zipped geometries, these are exactly the
+        // segments of the edge-based nodes
+        const auto &geometry_indices = m_compressed_edge_container.GetZippedGeometryIndices();
+        const auto &geometry_nodes = m_compressed_edge_container.GetZippedGeometryNodes();
+        segment_index.geometry_segments.reserve(2 * geometry_nodes.size());
+        for (const auto geometry_id : util::irange<std::size_t>(0, geometry_indices.size()))
+        {
+            const auto begin = geometry_indices[geometry_id];
+            const auto end = geometry_id + 1 < geometry_indices.size()
+                                 ? geometry_indices[geometry_id + 1]
+                                 : geometry_nodes.size();
+            for (auto position = begin; position + 1 < end; ++position)
+            {
+                const auto from = m_node_info_list[geometry_nodes[position]].node_id;
+                const auto to = m_node_info_list[geometry_nodes[position + 1]].node_id;
+                segment_index.geometry_segments.push_back({from, to, position, true});
+                segment_index.geometry_segments.push_back({to, from, position, false});
             }
         }
+
+        util::SimpleLogger().Write() << "Writing edge segment index to "
+                                     << edge_segment_index_filename;
+        segment_index.Sort();
+        writeSegmentIndex(edge_segment_index_filename, segment_index);
     }
 
     util::SimpleLogger().Write() << "Created " << entry_class_hash.size() << " entry classes and "
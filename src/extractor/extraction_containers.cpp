@@ -6,7 +6,10 @@
 
 #include "util/exception.hpp"
 #include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
 #include "util/io.hpp"
+#include "util/parallel_stable_sort.hpp"
+#include "util/resident_memory.hpp"
 #include "util/simple_logger.hpp"
 #include "util/timing_util.hpp"
 
@@ -16,11 +19,20 @@
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/ref.hpp>
 
+#include <osmium/osm/node.hpp>
+
 #include <stxxl/sort>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <vector>
 
 namespace
 {
@@ -60,6 +72,7 @@ struct CmpEdgeByOSMTargetID
     value_type min_value() { return value_type::min_osm_value(); }
 };
 
+template <typename NameCharDataT, typename NameOffsetsT>
 struct CmpEdgeByInternalSourceTargetAndName
 {
     using value_type = oe::InternalExtractorEdge;
@@ -86,9 +99,14 @@ struct CmpEdgeByInternalSourceTargetAndName
         if (rhs.result.name_id == EMPTY_NAMEID)
             return true;
 
-        std::lock_guard<std::mutex> lock(mutex);
+        // the stxxl vectors can not be read concurrently
+        std::unique_lock<std::mutex> lock;
+        if (mutex != nullptr)
+        {
+            lock = std::unique_lock<std::mutex>(*mutex);
+        }
         BOOST_ASSERT(!name_offsets.empty() && name_offsets.back() == name_data.size());
-        const oe::ExtractionContainers::STXXLNameCharData::const_iterator data = name_data.begin();
+        const auto data = name_data.begin();
         return std::lexicographical_compare(data + name_offsets[lhs.result.name_id],
                                             data + name_offsets[lhs.result.name_id + 1],
                                             data + name_offsets[rhs.result.name_id],
@@ -98,10 +116,97 @@ struct CmpEdgeByInternalSourceTargetAndName
     value_type max_value() { return value_type::max_internal_value(); }
     value_type min_value() { return value_type::min_internal_value(); }
 
-    std::mutex &mutex;
-    const oe::ExtractionContainers::STXXLNameCharData &name_data;
-    const oe::ExtractionContainers::STXXLNameOffsets &name_offsets;
+    std::mutex *mutex;
+    const NameCharDataT &name_data;
+    const NameOffsetsT &name_offsets;
+};
+
+#ifndef _MSC_VER
+constexpr static unsigned stxxl_memory =
+    ((sizeof(std::size_t) == 4) ? std::numeric_limits<int>::max()
+                                : std::numeric_limits<unsigned>::max());
+#else
+const static unsigned stxxl_memory = ((sizeof(std::size_t) == 4) ? INT_MAX : UINT_MAX);
+#endif
+
+struct ExternalMemorySort
+{
+    template <typename VectorT, typename CompareT>
+    void operator()(VectorT &vector, CompareT compare) const
+    {
+        stxxl::sort(vector.begin(), vector.end(), compare, stxxl_memory);
+    }
+};
+
+// stable, so the order of the edges does not depend on the number of threads
+struct InternalMemorySort
+{
+    template <typename VectorT, typename CompareT>
+    void operator()(VectorT &vector, CompareT compare) const
+    {
+        osrm::util::parallelStableSort(vector.begin(), vector.end(), compare);
+    }
+};
+
+// Copies a stxxl vector into RAM and frees its blocks
+template <typename T> std::vector<T> copyToInternalMemory(stxxl::vector<T> &external)
+{
+    std::vector<T> internal;
+    internal.reserve(external.size());
+    std::copy(external.cbegin(), external.cend(), std::back_inserter(internal));
+    external.clear();
+    return internal;
+}
+
+// number of segments that are joined with their target node before they are weighted in parallel
+const constexpr std::size_t SEGMENT_BATCH_SIZE = 1 << 16;
+
+struct WeightedSegment
+{
+    osrm::util::Coordinate source;
+    osrm::util::Coordinate target;
+    oe::InternalExtractorEdge::WeightData weight_data;
+    EdgeWeight weight;
 };
+
+// Calls the segment function of the profile and computes the weights of the segments in parallel
+void weighSegments(oe::ScriptingEnvironment &scripting_environment,
+                   std::vector<WeightedSegment> &segments)
+{
+    using oe::InternalExtractorEdge;
+
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, segments.size()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto index = range.begin(); index != range.end(); ++index)
+            {
+                auto &segment = segments[index];
+                const double distance = osrm::util::coordinate_calculation::greatCircleDistance(
+                    segment.source, segment.target);
+
+                scripting_environment.ProcessSegment(
+                    segment.source, segment.target, distance, segment.weight_data);
+
+                const double weight = [distance](const InternalExtractorEdge::WeightData &data) {
+                    switch (data.type)
+                    {
+                    case InternalExtractorEdge::WeightType::EDGE_DURATION:
+                    case InternalExtractorEdge::WeightType::WAY_DURATION:
+                        return data.duration * 10.;
+                        break;
+                    case InternalExtractorEdge::WeightType::SPEED:
+                        return (distance * 10.) / (data.speed / 3.6);
+                        break;
+                    case InternalExtractorEdge::WeightType::INVALID:
+                        osrm::util::exception("invalid weight type");
+                    }
+                    return -1.0;
+                }(segment.weight_data);
+
+                segment.weight = std::max(1, static_cast<int>(std::floor(weight + .5)));
+            }
+        });
+}
 }
 
 namespace osrm
@@ -111,7 +216,47 @@ namespace extractor
 
 static const int WRITE_BLOCK_BUFFER_SIZE = 8000;
 
-ExtractionContainers::ExtractionContainers()
+std::uint64_t SharedNodeStore::AddNode(const osmium::Node &node)
+{
+    BOOST_ASSERT(!is_sorted);
+    external_nodes.push_back({util::toFixed(util::FloatLongitude{node.location().lon()}),
+                              util::toFixed(util::FloatLatitude{node.location().lat()}),
+                              OSMNodeID{static_cast<std::uint64_t>(node.id())},
+                              number_of_nodes});
+    return number_of_nodes++;
+}
+
+void SharedNodeStore::Sort(const bool use_external_memory)
+{
+    if (is_sorted)
+    {
+        return;
+    }
+    is_sorted = true;
+
+    // the sort buffer holds another copy of the nodes
+    const std::size_t internal_memory_bytes = 2 * external_nodes.size() * sizeof(SharedNode);
+    const std::size_t available_memory_bytes = util::availableMemoryBytes();
+
+    std::cout << "[extractor] Sorting all nodes         ... " << std::flush;
+    TIMER_START(sorting_nodes);
+    // leave half of the RAM for the containers of the profiles
+    if (!use_external_memory && internal_memory_bytes < available_memory_bytes / 2)
+    {
+        internal_nodes = copyToInternalMemory(external_nodes);
+        in_internal_memory = true;
+        InternalMemorySort()(internal_nodes, SharedNodeSTXXLCompare());
+    }
+    else
+    {
+        ExternalMemorySort()(external_nodes, SharedNodeSTXXLCompare());
+    }
+    TIMER_STOP(sorting_nodes);
+    std::cout << "ok, after " << TIMER_SEC(sorting_nodes) << "s" << std::endl;
+}
+
+ExtractionContainers::ExtractionContainers(std::shared_ptr<SharedNodeStore> node_store_)
+    : node_store(std::move(node_store_))
 {
     // Check if stxxl can be instantiated
     stxxl::vector<unsigned> dummy_vector;
@@ -125,6 +270,29 @@ ExtractionContainers::ExtractionContainers()
     name_offsets.push_back(0);
 }
 
+void ExtractionContainers::SetNodeFlags(const std::uint64_t input_index,
+                                        const bool barrier,
+                                        const bool traffic_lights)
+{
+    // most nodes have no flags, the bitmaps only grow up to the last node that has one
+    if (barrier)
+    {
+        if (input_index >= barrier_nodes.size())
+        {
+            barrier_nodes.resize(input_index + 1);
+        }
+        barrier_nodes[input_index] = true;
+    }
+    if (traffic_lights)
+    {
+        if (input_index >= traffic_light_nodes.size())
+        {
+            traffic_light_nodes.resize(input_index + 1);
+        }
+        traffic_light_nodes[input_index] = true;
+    }
+}
+
 /**
  * Processes the collected data and serializes it.
  * At this point nodes are still referenced by their OSM id.
@@ -138,23 +306,126 @@ ExtractionContainers::ExtractionContainers()
 void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environment,
                                        const std::string &output_file_name,
                                        const std::string &restrictions_file_name,
-                                       const std::string &name_file_name)
+                                       const std::string &name_file_name,
+                                       const bool use_external_memory)
 {
     std::ofstream file_out_stream;
     file_out_stream.open(output_file_name.c_str(), std::ios::binary);
     const util::FingerPrint fingerprint = util::FingerPrint::GetValid();
     file_out_stream.write((char *)&fingerprint, sizeof(util::FingerPrint));
 
-    PrepareNodes();
-    WriteNodes(file_out_stream);
-    PrepareEdges(scripting_environment);
-    WriteEdges(file_out_stream);
+    // the sort buffer holds another copy of the edges, the shared nodes are already sorted
+    node_store->Sort(use_external_memory);
+    const std::size_t internal_memory_bytes =
+        used_node_id_list.size() * sizeof(OSMNodeID) +
+        2 * all_edges_list.size() * sizeof(InternalExtractorEdge) +
+        restrictions_list.size() * sizeof(InputRestrictionContainer) +
+        way_start_end_id_list.size() * sizeof(FirstAndLastSegmentOfWay) + name_char_data.size() +
+        name_offsets.size() * sizeof(unsigned);
+    const std::size_t available_memory_bytes = util::availableMemoryBytes();
+
+    // leave a quarter of the RAM for the node id map and the rest of the process
+    if (!use_external_memory && internal_memory_bytes < available_memory_bytes / 4 * 3)
+    {
+        util::SimpleLogger().Write() << "Sorting in RAM, needs " << (internal_memory_bytes >> 20)
+                                     << " MiB of " << (available_memory_bytes >> 20)
+                                     << " MiB available";
+        if (node_store->IsInInternalMemory())
+        {
+            PrepareDataInInternalMemory(scripting_environment,
+                                        node_store->GetInternalNodes(),
+                                        file_out_stream,
+                                        restrictions_file_name);
+        }
+        else
+        {
+            PrepareDataInInternalMemory(scripting_environment,
+                                        node_store->GetExternalNodes(),
+                                        file_out_stream,
+                                        restrictions_file_name);
+        }
+    }
+    else
+    {
+        util::SimpleLogger().Write() << "Sorting with stxxl, needs "
+                                     << (internal_memory_bytes >> 20) << " MiB of "
+                                     << (available_memory_bytes >> 20) << " MiB available";
+        if (node_store->IsInInternalMemory())
+        {
+            PrepareDataInExternalMemory(scripting_environment,
+                                        node_store->GetInternalNodes(),
+                                        file_out_stream,
+                                        restrictions_file_name);
+        }
+        else
+        {
+            PrepareDataInExternalMemory(scripting_environment,
+                                        node_store->GetExternalNodes(),
+                                        file_out_stream,
+                                        restrictions_file_name);
+        }
+    }
 
-    PrepareRestrictions();
-    WriteRestrictions(restrictions_file_name);
     WriteCharData(name_file_name);
 }
 
+template <typename NodeVectorT>
+void ExtractionContainers::PrepareDataInInternalMemory(ScriptingEnvironment &scripting_environment,
+                                                       const NodeVectorT &all_nodes,
+                                                       std::ofstream &file_out_stream,
+                                                       const std::string &restrictions_file_name)
+{
+    std::cout << "[extractor] Copying data into RAM    ... " << std::flush;
+    TIMER_START(copy_data);
+    auto used_node_ids = copyToInternalMemory(used_node_id_list);
+    auto all_edges = copyToInternalMemory(all_edges_list);
+    // WriteCharData still needs the names in the stxxl vectors
+    const std::vector<unsigned char> name_data(name_char_data.cbegin(), name_char_data.cend());
+    const std::vector<unsigned> name_data_offsets(name_offsets.cbegin(), name_offsets.cend());
+    TIMER_STOP(copy_data);
+    std::cout << "ok, after " << TIMER_SEC(copy_data) << "s" << std::endl;
+
+    PrepareNodes(used_node_ids, all_nodes, InternalMemorySort());
+    WriteNodes(file_out_stream, used_node_ids, all_nodes);
+    PrepareEdges(scripting_environment,
+                 all_nodes,
+                 all_edges,
+                 name_data,
+                 name_data_offsets,
+                 nullptr,
+                 InternalMemorySort());
+    WriteEdges(file_out_stream, all_edges);
+
+    // free the edges before the restrictions are copied
+    std::vector<InternalExtractorEdge>().swap(all_edges);
+    auto restrictions = copyToInternalMemory(restrictions_list);
+    auto way_start_end_ids = copyToInternalMemory(way_start_end_id_list);
+    PrepareRestrictions(restrictions, way_start_end_ids, InternalMemorySort());
+    WriteRestrictions(restrictions_file_name, restrictions);
+}
+
+template <typename NodeVectorT>
+void ExtractionContainers::PrepareDataInExternalMemory(ScriptingEnvironment &scripting_environment,
+                                                       const NodeVectorT &all_nodes,
+                                                       std::ofstream &file_out_stream,
+                                                       const std::string &restrictions_file_name)
+{
+    PrepareNodes(used_node_id_list, all_nodes, ExternalMemorySort());
+    WriteNodes(file_out_stream, used_node_id_list, all_nodes);
+    std::mutex name_data_mutex;
+    PrepareEdges(scripting_environment,
+                 all_nodes,
+                 all_edges_list,
+                 name_char_data,
+                 name_offsets,
+                 &name_data_mutex,
+                 ExternalMemorySort());
+    WriteEdges(file_out_stream, all_edges_list);
+
+    PrepareRestrictions(restrictions_list, way_start_end_id_list, ExternalMemorySort());
+    WriteRestrictions(restrictions_file_name, restrictions_list);
+}
+
 void ExtractionContainers::WriteCharData(const std::string &file_name)
 {
     std::cout << "[extractor] writing street name index ... " << std::flush;
@@ -201,38 +472,31 @@ void ExtractionContainers::WriteCharData(const std::string &file_name)
     std::cout << "ok, after " << TIMER_SEC(write_index) << "s" << std::endl;
 }
 
-void ExtractionContainers::PrepareNodes()
+template <typename NodeIDVectorT, typename NodeVectorT, typename SortT>
+void ExtractionContainers::PrepareNodes(NodeIDVectorT &used_node_ids,
+                                        const NodeVectorT &all_nodes,
+                                        const SortT &sort)
 {
     std::cout << "[extractor] Sorting used nodes        ... " << std::flush;
     TIMER_START(sorting_used_nodes);
-    stxxl::sort(
-        used_node_id_list.begin(), used_node_id_list.end(), OSMNodeIDSTXXLLess(), stxxl_memory);
+    sort(used_node_ids, OSMNodeIDSTXXLLess());
     TIMER_STOP(sorting_used_nodes);
     std::cout << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s" << std::endl;
 
     std::cout << "[extractor] Erasing duplicate nodes   ... " << std::flush;
     TIMER_START(erasing_dups);
-    auto new_end = std::unique(used_node_id_list.begin(), used_node_id_list.end());
-    used_node_id_list.resize(new_end - used_node_id_list.begin());
+    auto new_end = std::unique(used_node_ids.begin(), used_node_ids.end());
+    used_node_ids.resize(new_end - used_node_ids.begin());
     TIMER_STOP(erasing_dups);
     std::cout << "ok, after " << TIMER_SEC(erasing_dups) << "s" << std::endl;
 
-    std::cout << "[extractor] Sorting all nodes         ... " << std::flush;
-    TIMER_START(sorting_nodes);
-    stxxl::sort(all_nodes_list.begin(),
-                all_nodes_list.end(),
-                ExternalMemoryNodeSTXXLCompare(),
-                stxxl_memory);
-    TIMER_STOP(sorting_nodes);
-    std::cout << "ok, after " << TIMER_SEC(sorting_nodes) << "s" << std::endl;
-
     std::cout << "[extractor] Building node id map      ... " << std::flush;
     TIMER_START(id_map);
-    external_to_internal_node_id_map.reserve(used_node_id_list.size());
-    auto node_iter = all_nodes_list.begin();
-    auto ref_iter = used_node_id_list.begin();
-    const auto all_nodes_list_end = all_nodes_list.end();
-    const auto used_node_id_list_end = used_node_id_list.end();
+    external_to_internal_node_id_map.reserve(used_node_ids.size());
+    auto node_iter = all_nodes.begin();
+    auto ref_iter = used_node_ids.begin();
+    const auto all_nodes_end = all_nodes.end();
+    const auto used_node_ids_end = used_node_ids.end();
     // Note: despite being able to handle 64 bit OSM node ids, we can't
     // handle > uint32_t actual usable nodes.  This should be OK for a while
     // because we usually route on a *lot* less than 2^32 of the OSM
@@ -240,7 +504,7 @@ void ExtractionContainers::PrepareNodes()
     std::uint64_t internal_id = 0;
 
     // compute the intersection of nodes that were referenced and nodes we actually have
-    while (node_iter != all_nodes_list_end && ref_iter != used_node_id_list_end)
+    while (node_iter != all_nodes_end && ref_iter != used_node_ids_end)
     {
         if (node_iter->node_id < *ref_iter)
         {
@@ -267,25 +531,36 @@ void ExtractionContainers::PrepareNodes()
     std::cout << "ok, after " << TIMER_SEC(id_map) << "s" << std::endl;
 }
 
-void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environment)
+template <typename NodeVectorT,
+          typename EdgeVectorT,
+          typename NameCharDataT,
+          typename NameOffsetsT,
+          typename SortT>
+void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environment,
+                                        const NodeVectorT &all_nodes,
+                                        EdgeVectorT &all_edges,
+                                        const NameCharDataT &name_data,
+                                        const NameOffsetsT &name_data_offsets,
+                                        std::mutex *name_data_mutex,
+                                        const SortT &sort)
 {
     // Sort edges by start.
     std::cout << "[extractor] Sorting edges by start    ... " << std::flush;
     TIMER_START(sort_edges_by_start);
-    stxxl::sort(all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMStartID(), stxxl_memory);
+    sort(all_edges, CmpEdgeByOSMStartID());
     TIMER_STOP(sort_edges_by_start);
     std::cout << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s" << std::endl;
 
     std::cout << "[extractor] Setting start coords      ... " << std::flush;
     TIMER_START(set_start_coords);
     // Traverse list of edges and nodes in parallel and set start coord
-    auto node_iterator = all_nodes_list.begin();
-    auto edge_iterator = all_edges_list.begin();
+    auto node_iterator = all_nodes.begin();
+    auto edge_iterator = all_edges.begin();
 
-    const auto all_edges_list_end = all_edges_list.end();
-    const auto all_nodes_list_end = all_nodes_list.end();
+    const auto all_edges_end = all_edges.end();
+    const auto all_nodes_end = all_nodes.end();
 
-    while (edge_iterator != all_edges_list_end && node_iterator != all_nodes_list_end)
+    while (edge_iterator != all_edges_end && node_iterator != all_nodes_end)
     {
         if (edge_iterator->result.osm_source_id < node_iterator->node_id)
         {
@@ -330,26 +605,42 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         edge.result.source = SPECIAL_NODEID;
         edge.result.osm_source_id = SPECIAL_OSM_NODEID;
     };
-    std::for_each(edge_iterator, all_edges_list_end, markSourcesInvalid);
+    std::for_each(edge_iterator, all_edges_end, markSourcesInvalid);
     TIMER_STOP(set_start_coords);
     std::cout << "ok, after " << TIMER_SEC(set_start_coords) << "s" << std::endl;
 
     // Sort Edges by target
     std::cout << "[extractor] Sorting edges by target   ... " << std::flush;
     TIMER_START(sort_edges_by_target);
-    stxxl::sort(all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMTargetID(), stxxl_memory);
+    sort(all_edges, CmpEdgeByOSMTargetID());
     TIMER_STOP(sort_edges_by_target);
     std::cout << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s" << std::endl;
 
     // Compute edge weights
     std::cout << "[extractor] Computing edge weights    ... " << std::flush;
     TIMER_START(compute_weights);
-    node_iterator = all_nodes_list.begin();
-    edge_iterator = all_edges_list.begin();
-    const auto all_edges_list_end_ = all_edges_list.end();
-    const auto all_nodes_list_end_ = all_nodes_list.end();
+    // The edges are joined with their target nodes sequentially, the segment function is called
+    // in parallel on batches of joined segments.
+    std::vector<WeightedSegment> segments;
+    std::vector<decltype(all_edges.begin())> segment_edges;
+    segments.reserve(SEGMENT_BATCH_SIZE);
+    segment_edges.reserve(SEGMENT_BATCH_SIZE);
+    const auto weighBatch = [&] {
+        weighSegments(scripting_environment, segments);
+        for (const auto index : util::irange<std::size_t>(0, segments.size()))
+        {
+            segment_edges[index]->result.weight = segments[index].weight;
+        }
+        segments.clear();
+        segment_edges.clear();
+    };
+
+    node_iterator = all_nodes.begin();
+    edge_iterator = all_edges.begin();
+    const auto all_edges_end_ = all_edges.end();
+    const auto all_nodes_end_ = all_nodes.end();
 
-    while (edge_iterator != all_edges_list_end_ && node_iterator != all_nodes_list_end_)
+    while (edge_iterator != all_edges_end_ && node_iterator != all_nodes_end_)
     {
         // skip all invalid edges
         if (edge_iterator->result.source == SPECIAL_NODEID)
@@ -380,31 +671,13 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         BOOST_ASSERT(edge_iterator->source_coordinate.lon !=
                      util::FixedLongitude{std::numeric_limits<std::int32_t>::min()});
 
-        const double distance = util::coordinate_calculation::greatCircleDistance(
-            edge_iterator->source_coordinate,
-            util::Coordinate(node_iterator->lon, node_iterator->lat));
-
-        scripting_environment.ProcessSegment(
-            edge_iterator->source_coordinate, *node_iterator, distance, edge_iterator->weight_data);
-
-        const double weight = [distance](const InternalExtractorEdge::WeightData &data) {
-            switch (data.type)
-            {
-            case InternalExtractorEdge::WeightType::EDGE_DURATION:
-            case InternalExtractorEdge::WeightType::WAY_DURATION:
-                return data.duration * 10.;
-                break;
-            case InternalExtractorEdge::WeightType::SPEED:
-                return (distance * 10.) / (data.speed / 3.6);
-                break;
-            case InternalExtractorEdge::WeightType::INVALID:
-                util::exception("invalid weight type");
-            }
-            return -1.0;
-        }(edge_iterator->weight_data);
+        segments.push_back({edge_iterator->source_coordinate,
+                            util::Coordinate(node_iterator->lon, node_iterator->lat),
+                            edge_iterator->weight_data,
+                            INVALID_EDGE_WEIGHT});
+        segment_edges.push_back(edge_iterator);
 
         auto &edge = edge_iterator->result;
-        edge.weight = std::max(1, static_cast<int>(std::floor(weight + .5)));
 
         // assign new node id
         auto id_iter = external_to_internal_node_id_map.find(node_iterator->node_id);
@@ -423,7 +696,13 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
             edge.backward = temp;
         }
         ++edge_iterator;
+
+        if (segments.size() == SEGMENT_BATCH_SIZE)
+        {
+            weighBatch();
+        }
     }
+    weighBatch();
 
     // Remove all remaining edges. They are invalid because there are no corresponding nodes for
     // them. This happens when using osmosis with bbox or polygon to extract smaller areas.
@@ -432,39 +711,37 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
                                                        << edge.result.target;
         edge.result.target = SPECIAL_NODEID;
     };
-    std::for_each(edge_iterator, all_edges_list_end_, markTargetsInvalid);
+    std::for_each(edge_iterator, all_edges_end_, markTargetsInvalid);
     TIMER_STOP(compute_weights);
     std::cout << "ok, after " << TIMER_SEC(compute_weights) << "s" << std::endl;
 
     // Sort edges by start.
     std::cout << "[extractor] Sorting edges by renumbered start ... " << std::flush;
     TIMER_START(sort_edges_by_renumbered_start);
-    std::mutex name_data_mutex;
-    stxxl::sort(all_edges_list.begin(),
-                all_edges_list.end(),
-                CmpEdgeByInternalSourceTargetAndName{name_data_mutex, name_char_data, name_offsets},
-                stxxl_memory);
+    sort(all_edges,
+         CmpEdgeByInternalSourceTargetAndName<NameCharDataT, NameOffsetsT>{
+             name_data_mutex, name_data, name_data_offsets});
     TIMER_STOP(sort_edges_by_renumbered_start);
     std::cout << "ok, after " << TIMER_SEC(sort_edges_by_renumbered_start) << "s" << std::endl;
 
-    BOOST_ASSERT(all_edges_list.size() > 0);
-    for (unsigned i = 0; i < all_edges_list.size();)
+    BOOST_ASSERT(all_edges.size() > 0);
+    for (unsigned i = 0; i < all_edges.size();)
     {
         // only invalid edges left
-        if (all_edges_list[i].result.source == SPECIAL_NODEID)
+        if (all_edges[i].result.source == SPECIAL_NODEID)
         {
             break;
         }
         // skip invalid edges
-        if (all_edges_list[i].result.target == SPECIAL_NODEID)
+        if (all_edges[i].result.target == SPECIAL_NODEID)
         {
             ++i;
             continue;
         }
 
         unsigned start_idx = i;
-        NodeID source = all_edges_list[i].result.source;
-        NodeID target = all_edges_list[i].result.target;
+        NodeID source = all_edges[i].result.source;
+        NodeID target = all_edges[i].result.target;
 
         int min_forward_weight = std::numeric_limits<int>::max();
         int min_backward_weight = std::numeric_limits<int>::max();
@@ -472,20 +749,20 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         unsigned min_backward_idx = std::numeric_limits<unsigned>::max();
 
         // find minimal edge in both directions
-        while (all_edges_list[i].result.source == source &&
-               all_edges_list[i].result.target == target)
+        while (all_edges[i].result.source == source &&
+               all_edges[i].result.target == target)
         {
-            if (all_edges_list[i].result.forward &&
-                all_edges_list[i].result.weight < min_forward_weight)
+            if (all_edges[i].result.forward &&
+                all_edges[i].result.weight < min_forward_weight)
             {
                 min_forward_idx = i;
-                min_forward_weight = all_edges_list[i].result.weight;
+                min_forward_weight = all_edges[i].result.weight;
             }
-            if (all_edges_list[i].result.backward &&
-                all_edges_list[i].result.weight < min_backward_weight)
+            if (all_edges[i].result.backward &&
+                all_edges[i].result.weight < min_backward_weight)
             {
                 min_backward_idx = i;
-                min_backward_weight = all_edges_list[i].result.weight;
+                min_backward_weight = all_edges[i].result.weight;
             }
 
             // this also increments the outer loop counter!
@@ -501,9 +778,9 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
 
         if (min_backward_idx == min_forward_idx)
         {
-            all_edges_list[min_forward_idx].result.is_split = false;
-            all_edges_list[min_forward_idx].result.forward = true;
-            all_edges_list[min_forward_idx].result.backward = true;
+            all_edges[min_forward_idx].result.is_split = false;
+            all_edges[min_forward_idx].result.forward = true;
+            all_edges[min_forward_idx].result.backward = true;
         }
         else
         {
@@ -511,17 +788,17 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
             bool has_backward = min_backward_idx != std::numeric_limits<unsigned>::max();
             if (has_forward)
             {
-                all_edges_list[min_forward_idx].result.forward = true;
-                all_edges_list[min_forward_idx].result.backward = false;
-                all_edges_list[min_forward_idx].result.is_split = has_backward;
+                all_edges[min_forward_idx].result.forward = true;
+                all_edges[min_forward_idx].result.backward = false;
+                all_edges[min_forward_idx].result.is_split = has_backward;
             }
             if (has_backward)
             {
-                std::swap(all_edges_list[min_backward_idx].result.source,
-                          all_edges_list[min_backward_idx].result.target);
-                all_edges_list[min_backward_idx].result.forward = true;
-                all_edges_list[min_backward_idx].result.backward = false;
-                all_edges_list[min_backward_idx].result.is_split = has_forward;
+                std::swap(all_edges[min_backward_idx].result.source,
+                          all_edges[min_backward_idx].result.target);
+                all_edges[min_backward_idx].result.forward = true;
+                all_edges[min_backward_idx].result.backward = false;
+                all_edges[min_backward_idx].result.is_split = has_forward;
             }
         }
 
@@ -532,13 +809,15 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
             {
                 continue;
             }
-            all_edges_list[j].result.source = SPECIAL_NODEID;
-            all_edges_list[j].result.target = SPECIAL_NODEID;
+            all_edges[j].result.source = SPECIAL_NODEID;
+            all_edges[j].result.target = SPECIAL_NODEID;
         }
     }
 }
 
-void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream) const
+template <typename EdgeVectorT>
+void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream,
+                                      const EdgeVectorT &all_edges) const
 {
     std::cout << "[extractor] Writing used edges       ... " << std::flush;
     TIMER_START(write_edges);
@@ -549,7 +828,7 @@ void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream) const
     auto start_position = file_out_stream.tellp();
     file_out_stream.write((char *)&used_edges_counter_buffer, sizeof(used_edges_counter_buffer));
 
-    for (const auto &edge : all_edges_list)
+    for (const auto &edge : all_edges)
     {
         if (edge.result.source == SPECIAL_NODEID || edge.result.target == SPECIAL_NODEID)
         {
@@ -581,7 +860,10 @@ void ExtractionContainers::WriteEdges(std::ofstream &file_out_stream) const
     util::SimpleLogger().Write() << "Processed " << used_edges_counter << " edges";
 }
 
-void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
+template <typename NodeIDVectorT, typename NodeVectorT>
+void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream,
+                                      const NodeIDVectorT &used_node_ids,
+                                      const NodeVectorT &all_nodes) const
 {
     // write dummy value, will be overwritten later
     std::cout << "[extractor] setting number of nodes   ... " << std::flush;
@@ -591,12 +873,12 @@ void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
     std::cout << "[extractor] Confirming/Writing used nodes     ... " << std::flush;
     TIMER_START(write_nodes);
     // identify all used nodes by a merging step of two sorted lists
-    auto node_iterator = all_nodes_list.begin();
-    auto node_id_iterator = used_node_id_list.begin();
-    const auto used_node_id_list_end = used_node_id_list.end();
-    const auto all_nodes_list_end = all_nodes_list.end();
+    auto node_iterator = all_nodes.begin();
+    auto node_id_iterator = used_node_ids.begin();
+    const auto used_node_ids_end = used_node_ids.end();
+    const auto all_nodes_end = all_nodes.end();
 
-    while (node_id_iterator != used_node_id_list_end && node_iterator != all_nodes_list_end)
+    while (node_id_iterator != used_node_ids_end && node_iterator != all_nodes_end)
     {
         if (*node_id_iterator < node_iterator->node_id)
         {
@@ -610,7 +892,12 @@ void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
         }
         BOOST_ASSERT(*node_id_iterator == node_iterator->node_id);
 
-        file_out_stream.write((char *)&(*node_iterator), sizeof(ExternalMemoryNode));
+        const ExternalMemoryNode node(node_iterator->lon,
+                                      node_iterator->lat,
+                                      node_iterator->node_id,
+                                      IsBarrier(node_iterator->input_index),
+                                      IsTrafficLight(node_iterator->input_index));
+        file_out_stream.write((char *)&node, sizeof(ExternalMemoryNode));
 
         ++node_id_iterator;
         ++node_iterator;
@@ -621,7 +908,9 @@ void ExtractionContainers::WriteNodes(std::ofstream &file_out_stream) const
     util::SimpleLogger().Write() << "Processed " << max_internal_node_id << " nodes";
 }
 
-void ExtractionContainers::WriteRestrictions(const std::string &path) const
+template <typename RestrictionsVectorT>
+void ExtractionContainers::WriteRestrictions(const std::string &path,
+                                             const RestrictionsVectorT &restrictions) const
 {
     // serialize restrictions
     std::ofstream restrictions_out_stream;
@@ -632,7 +921,7 @@ void ExtractionContainers::WriteRestrictions(const std::string &path) const
     const auto count_position = restrictions_out_stream.tellp();
     restrictions_out_stream.write((char *)&written_restriction_count, sizeof(unsigned));
 
-    for (const auto &restriction_container : restrictions_list)
+    for (const auto &restriction_container : restrictions)
     {
         if (SPECIAL_NODEID != restriction_container.restriction.from.node &&
             SPECIAL_NODEID != restriction_container.restriction.via.node &&
@@ -648,36 +937,33 @@ void ExtractionContainers::WriteRestrictions(const std::string &path) const
     util::SimpleLogger().Write() << "usable restrictions: " << written_restriction_count;
 }
 
-void ExtractionContainers::PrepareRestrictions()
+template <typename RestrictionsVectorT, typename WayIDStartEndVectorT, typename SortT>
+void ExtractionContainers::PrepareRestrictions(RestrictionsVectorT &restrictions,
+                                               WayIDStartEndVectorT &way_start_end_ids,
+                                               const SortT &sort)
 {
     std::cout << "[extractor] Sorting used ways         ... " << std::flush;
     TIMER_START(sort_ways);
-    stxxl::sort(way_start_end_id_list.begin(),
-                way_start_end_id_list.end(),
-                FirstAndLastSegmentOfWayStxxlCompare(),
-                stxxl_memory);
+    sort(way_start_end_ids, FirstAndLastSegmentOfWayStxxlCompare());
     TIMER_STOP(sort_ways);
     std::cout << "ok, after " << TIMER_SEC(sort_ways) << "s" << std::endl;
 
-    std::cout << "[extractor] Sorting " << restrictions_list.size() << " restriction. by from... "
+    std::cout << "[extractor] Sorting " << restrictions.size() << " restriction. by from... "
               << std::flush;
     TIMER_START(sort_restrictions);
-    stxxl::sort(restrictions_list.begin(),
-                restrictions_list.end(),
-                CmpRestrictionContainerByFrom(),
-                stxxl_memory);
+    sort(restrictions, CmpRestrictionContainerByFrom());
     TIMER_STOP(sort_restrictions);
     std::cout << "ok, after " << TIMER_SEC(sort_restrictions) << "s" << std::endl;
 
     std::cout << "[extractor] Fixing restriction starts ... " << std::flush;
     TIMER_START(fix_restriction_starts);
-    auto restrictions_iterator = restrictions_list.begin();
-    auto way_start_and_end_iterator = way_start_end_id_list.cbegin();
-    const auto restrictions_list_end = restrictions_list.end();
-    const auto way_start_end_id_list_end = way_start_end_id_list.cend();
+    auto restrictions_iterator = restrictions.begin();
+    auto way_start_and_end_iterator = way_start_end_ids.cbegin();
+    const auto restrictions_end = restrictions.end();
+    const auto way_start_end_ids_end = way_start_end_ids.cend();
 
-    while (way_start_and_end_iterator != way_start_end_id_list_end &&
-           restrictions_iterator != restrictions_list_end)
+    while (way_start_and_end_iterator != way_start_end_ids_end &&
+           restrictions_iterator != restrictions_end)
     {
         if (way_start_and_end_iterator->way_id <
             OSMWayID{static_cast<std::uint32_t>(restrictions_iterator->restriction.from.way)})
@@ -757,22 +1043,19 @@ void ExtractionContainers::PrepareRestrictions()
 
     std::cout << "[extractor] Sorting restrictions. by to  ... " << std::flush;
     TIMER_START(sort_restrictions_to);
-    stxxl::sort(restrictions_list.begin(),
-                restrictions_list.end(),
-                CmpRestrictionContainerByTo(),
-                stxxl_memory);
+    sort(restrictions, CmpRestrictionContainerByTo());
     TIMER_STOP(sort_restrictions_to);
     std::cout << "ok, after " << TIMER_SEC(sort_restrictions_to) << "s" << std::endl;
 
     std::cout << "[extractor] Fixing restriction ends   ... " << std::flush;
     TIMER_START(fix_restriction_ends);
-    restrictions_iterator = restrictions_list.begin();
-    way_start_and_end_iterator = way_start_end_id_list.cbegin();
-    const auto way_start_end_id_list_end_ = way_start_end_id_list.cend();
-    const auto restrictions_list_end_ = restrictions_list.end();
+    restrictions_iterator = restrictions.begin();
+    way_start_and_end_iterator = way_start_end_ids.cbegin();
+    const auto way_start_end_ids_end_ = way_start_end_ids.cend();
+    const auto restrictions_end_ = restrictions.end();
 
-    while (way_start_and_end_iterator != way_start_end_id_list_end_ &&
-           restrictions_iterator != restrictions_list_end_)
+    while (way_start_and_end_iterator != way_start_end_ids_end_ &&
+           restrictions_iterator != restrictions_end_)
     {
         if (way_start_and_end_iterator->way_id <
             OSMWayID{static_cast<std::uint32_t>(restrictions_iterator->restriction.to.way)})
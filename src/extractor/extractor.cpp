@@ -10,6 +10,7 @@
 
 #include "extractor/raster_source.hpp"
 #include "util/graph_loader.hpp"
+#include "util/integer_range.hpp"
 #include "util/io.hpp"
 #include "util/name_table.hpp"
 #include "util/range_table.hpp"
@@ -33,6 +34,8 @@
 #include <osmium/io/any_input.hpp>
 
 #include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+#include <tbb/pipeline.h>
 #include <tbb/task_scheduler_init.h>
 
 #include <cstdlib>
@@ -108,37 +111,71 @@ transformTurnLaneMapIntoArrays(const guidance::LaneDescriptionMap &turn_lane_map
  */
 int Extractor::run(ScriptingEnvironment &scripting_environment)
 {
+    return run({this}, {&scripting_environment});
+}
+
+/**
+ * Reads and decodes the input once and drives every buffer through the scripting environments of
+ * all profiles. Each profile collects its results in its own ExtractionContainers. The nodes are
+ * stored once in a SharedNodeStore, the containers only keep bitmaps of the barrier and traffic
+ * signal flags that their profile set. The datasets are then written and expanded one after the
+ * other to bound the memory use.
+ */
+int Extractor::run(const std::vector<Extractor *> &extractors,
+                   const std::vector<ScriptingEnvironment *> &scripting_environments)
+{
+    BOOST_ASSERT(!extractors.empty());
+    BOOST_ASSERT(extractors.size() == scripting_environments.size());
+    const auto &config = extractors.front()->config;
+    const auto number_of_profiles = extractors.size();
+
     util::LogPolicy::GetInstance().Unmute();
-    TIMER_START(extracting);
+    TIMER_START(parsing);
 
     const unsigned recommended_num_threads = tbb::task_scheduler_init::default_num_threads();
     const auto number_of_threads = std::min(recommended_num_threads, config.requested_num_threads);
     tbb::task_scheduler_init init(number_of_threads);
 
+    const auto node_store = std::make_shared<SharedNodeStore>();
+    std::vector<std::unique_ptr<ExtractionContainers>> extraction_containers;
     {
         util::SimpleLogger().Write() << "Input file: " << config.input_path.filename().string();
-        if (!config.profile_path.empty())
+        for (const auto extractor : extractors)
         {
-            util::SimpleLogger().Write() << "Profile: " << config.profile_path.filename().string();
+            if (!extractor->config.profile_path.empty())
+            {
+                util::SimpleLogger().Write()
+                    << "Profile: " << extractor->config.profile_path.filename().string();
+            }
         }
         util::SimpleLogger().Write() << "Threads: " << number_of_threads;
 
-        ExtractionContainers extraction_containers;
-        auto extractor_callbacks = std::make_unique<ExtractorCallbacks>(extraction_containers);
+        std::vector<std::unique_ptr<ExtractorCallbacks>> extractor_callbacks;
+        for (std::size_t profile = 0; profile < number_of_profiles; ++profile)
+        {
+            extraction_containers.push_back(std::make_unique<ExtractionContainers>(node_store));
+            extractor_callbacks.push_back(
+                std::make_unique<ExtractorCallbacks>(*extraction_containers.back()));
+        }
 
         const osmium::io::File input_file(config.input_path.string());
         osmium::io::Reader reader(input_file);
         const osmium::io::Header header = reader.header();
 
-        unsigned number_of_nodes = 0;
-        unsigned number_of_ways = 0;
-        unsigned number_of_relations = 0;
+        std::vector<unsigned> number_of_nodes(number_of_profiles, 0);
+        std::vector<unsigned> number_of_ways(number_of_profiles, 0);
+        std::vector<unsigned> number_of_relations(number_of_profiles, 0);
 
         util::SimpleLogger().Write() << "Parsing in progress..";
-        TIMER_START(parsing);
 
-        // setup raster sources
-        scripting_environment.SetupSources();
+        // setup raster sources and restriction parsers
+        std::vector<RestrictionParser> restriction_parsers;
+        restriction_parsers.reserve(number_of_profiles);
+        for (const auto scripting_environment : scripting_environments)
+        {
+            scripting_environment->SetupSources();
+            restriction_parsers.emplace_back(*scripting_environment);
+        }
 
         std::string generator = header.get("generator");
         if (generator.empty())
@@ -155,69 +192,165 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
         }
         util::SimpleLogger().Write() << "timestamp: " << timestamp;
 
-        boost::filesystem::ofstream timestamp_out(config.timestamp_file_name);
-        timestamp_out.write(timestamp.c_str(), timestamp.length());
-
-        // initialize vectors holding parsed objects
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
-        tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
-
-        // setup restriction parser
-        const RestrictionParser restriction_parser(scripting_environment);
+        for (const auto extractor : extractors)
+        {
+            boost::filesystem::ofstream timestamp_out(extractor->config.timestamp_file_name);
+            timestamp_out.write(timestamp.c_str(), timestamp.length());
+        }
 
-        while (const osmium::memory::Buffer buffer = reader.read())
+        // The results of one profile for the elements of a buffer
+        struct ProfileResults
         {
-            // create a vector of iterators into the buffer
+            tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
+            tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
+            tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
+                resulting_restrictions;
+        };
+
+        // A buffer of the input file and the results of the profiles for its elements
+        struct ParsedBuffer
+        {
+            osmium::memory::Buffer buffer;
             std::vector<osmium::memory::Buffer::const_iterator> osm_elements;
-            for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
+            std::vector<ProfileResults> profile_results;
+        };
+        using ParsedBufferPtr = std::shared_ptr<ParsedBuffer>;
+
+        // Reading and decoding the input, processing the elements with the profiles and adding
+        // the results to the containers overlap. The number of buffers in flight is bounded and
+        // the buffers are added to the containers in the order of the input file.
+        const auto read_buffer = [&](tbb::flow_control &control) {
+            auto parsed = std::make_shared<ParsedBuffer>();
+            parsed->buffer = reader.read();
+            if (!parsed->buffer)
             {
-                osm_elements.push_back(iter);
+                control.stop();
+                return ParsedBufferPtr{};
             }
 
-            // clear resulting vectors
-            resulting_nodes.clear();
-            resulting_ways.clear();
-            resulting_restrictions.clear();
-
-            scripting_environment.ProcessElements(osm_elements,
-                                                  restriction_parser,
-                                                  resulting_nodes,
-                                                  resulting_ways,
-                                                  resulting_restrictions);
-
-            number_of_nodes += resulting_nodes.size();
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : resulting_nodes)
-            {
-                extractor_callbacks->ProcessNode(
-                    static_cast<const osmium::Node &>(*(osm_elements[result.first])),
-                    result.second);
-            }
-            number_of_ways += resulting_ways.size();
-            for (const auto &result : resulting_ways)
+            // create a vector of iterators into the buffer
+            const auto &buffer = parsed->buffer;
+            for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
             {
-                extractor_callbacks->ProcessWay(
-                    static_cast<const osmium::Way &>(*(osm_elements[result.first])), result.second);
+                parsed->osm_elements.push_back(iter);
             }
-            number_of_relations += resulting_restrictions.size();
-            for (const auto &result : resulting_restrictions)
+            return parsed;
+        };
+
+        const auto process_buffer = [&](ParsedBufferPtr parsed) {
+            // the profiles process the buffer concurrently
+            parsed->profile_results.resize(number_of_profiles);
+            tbb::parallel_for(std::size_t{0}, number_of_profiles, [&](const std::size_t profile) {
+                auto &results = parsed->profile_results[profile];
+                scripting_environments[profile]->ProcessElements(parsed->osm_elements,
+                                                                 restriction_parsers[profile],
+                                                                 results.resulting_nodes,
+                                                                 results.resulting_ways,
+                                                                 results.resulting_restrictions);
+            });
+            return parsed;
+        };
+
+        const auto ingest_buffer = [&](ParsedBufferPtr parsed) {
+            // the nodes are stored once for all profiles
+            std::vector<std::uint64_t> input_indexes(parsed->osm_elements.size());
+            for (const auto element : util::irange<std::size_t>(0, parsed->osm_elements.size()))
             {
-                extractor_callbacks->ProcessRestriction(result);
+                const auto &entity = *parsed->osm_elements[element];
+                if (entity.type() == osmium::item_type::node)
+                {
+                    input_indexes[element] =
+                        node_store->AddNode(static_cast<const osmium::Node &>(entity));
+                }
             }
-        }
+
+            // every profile has its own containers
+            tbb::parallel_for(std::size_t{0}, number_of_profiles, [&](const std::size_t profile) {
+                auto &results = parsed->profile_results[profile];
+                auto &callbacks = *extractor_callbacks[profile];
+
+                const auto by_element = [](const auto &lhs, const auto &rhs) {
+                    return lhs.first < rhs.first;
+                };
+                // the profile results arrive in any order, keep the order of the input file
+                auto &nodes = results.resulting_nodes;
+                auto &ways = results.resulting_ways;
+                std::sort(nodes.begin(), nodes.end(), by_element);
+                std::sort(ways.begin(), ways.end(), by_element);
+
+                number_of_nodes[profile] += results.resulting_nodes.size();
+                // put parsed objects thru extractor callbacks
+                for (const auto &result : results.resulting_nodes)
+                {
+                    callbacks.ProcessNode(input_indexes[result.first], result.second);
+                }
+                number_of_ways[profile] += results.resulting_ways.size();
+                for (const auto &result : results.resulting_ways)
+                {
+                    callbacks.ProcessWay(
+                        static_cast<const osmium::Way &>(*(parsed->osm_elements[result.first])),
+                        result.second);
+                }
+                number_of_relations[profile] += results.resulting_restrictions.size();
+                for (const auto &result : results.resulting_restrictions)
+                {
+                    callbacks.ProcessRestriction(result);
+                }
+            });
+        };
+
+        const auto max_buffers_in_flight = 2 * number_of_threads;
+        tbb::parallel_pipeline(
+            max_buffers_in_flight,
+            tbb::make_filter<void, ParsedBufferPtr>(tbb::filter::serial_in_order, read_buffer) &
+                tbb::make_filter<ParsedBufferPtr, ParsedBufferPtr>(tbb::filter::parallel,
+                                                                   process_buffer) &
+                tbb::make_filter<ParsedBufferPtr, void>(tbb::filter::serial_in_order,
+                                                        ingest_buffer));
         TIMER_STOP(parsing);
         util::SimpleLogger().Write() << "Parsing finished after " << TIMER_SEC(parsing)
                                      << " seconds";
 
-        util::SimpleLogger().Write() << "Raw input contains " << number_of_nodes << " nodes, "
-                                     << number_of_ways << " ways, and " << number_of_relations
-                                     << " relations";
+        // sorted once for the datasets of all profiles
+        node_store->Sort(config.use_external_memory);
+
+        for (const auto profile : util::irange<std::size_t>(0, number_of_profiles))
+        {
+            util::SimpleLogger().Write() << "Raw input contains " << number_of_nodes[profile]
+                                         << " nodes, " << number_of_ways[profile]
+                                         << " ways, and " << number_of_relations[profile]
+                                         << " relations";
+            scripting_environments[profile]->LogStatistics();
+
+            // take control over the turn lane map
+            extractors[profile]->turn_lane_map =
+                extractor_callbacks[profile]->moveOutLaneDescriptionMap();
+        }
+    }
 
-        // take control over the turn lane map
-        turn_lane_map = extractor_callbacks->moveOutLaneDescriptionMap();
+    int result = 0;
+    for (const auto profile : util::irange<std::size_t>(0, number_of_profiles))
+    {
+        if (number_of_profiles > 1)
+        {
+            util::SimpleLogger().Write()
+                << "Writing the dataset of "
+                << extractors[profile]->config.profile_path.filename().string();
+        }
+        // the containers of a profile are freed once its dataset is written
+        const auto containers = std::move(extraction_containers[profile]);
+        const auto profile_result =
+            extractors[profile]->BuildDataset(*scripting_environments[profile], *containers);
+        result = std::max(result, profile_result);
+    }
+    return result;
+}
 
-        extractor_callbacks.reset();
+int Extractor::BuildDataset(ScriptingEnvironment &scripting_environment,
+                            ExtractionContainers &extraction_containers)
+{
+    {
+        TIMER_START(extracting);
 
         if (extraction_containers.all_edges_list.empty())
         {
@@ -228,7 +361,8 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
         extraction_containers.PrepareData(scripting_environment,
                                           config.output_file_name,
                                           config.restriction_file_name,
-                                          config.names_file_name);
+                                          config.names_file_name,
+                                          config.use_external_memory);
 
         WriteProfileProperties(config.profile_properties_output_path,
                                scripting_environment.GetProfileProperties());
@@ -446,6 +580,58 @@ Extractor::LoadNodeBasedGraph(std::unordered_set<NodeID> &barrier_nodes,
     return util::NodeBasedDynamicGraphFromEdges(number_of_node_based_nodes, edge_list);
 }
 
+/**
+ \brief Samples the turn function into a table if the penalty only depends on the angle
+
+ Validating the table does not make the extraction use it, the table is only returned if the
+ profile is pure or --turn-penalty-table is set.
+*/
+TurnPenaltyTable Extractor::BuildTurnPenaltyTable(ScriptingEnvironment &scripting_environment)
+{
+    const bool use_table =
+        scripting_environment.HasPureTurnFunction() || config.use_turn_penalty_table;
+    const bool validate = config.turn_penalty_validation_samples > 0;
+    if (!use_table && !validate)
+    {
+        return TurnPenaltyTable();
+    }
+
+    TIMER_START(sample_turn_function);
+    TurnPenaltyTable turn_penalty_table([&scripting_environment](const double angle) {
+        return scripting_environment.GetTurnFunctionValue(angle);
+    });
+    TIMER_STOP(sample_turn_function);
+    util::SimpleLogger().Write() << "Sampled the turn function into a table in "
+                                 << TIMER_SEC(sample_turn_function) << "s";
+
+    if (validate)
+    {
+        const auto result = turn_penalty_table.Validate(
+            [&scripting_environment](const double angle) {
+                return scripting_environment.GetTurnPenalty(angle);
+            },
+            config.turn_penalty_validation_samples);
+        if (result.mismatches > 0)
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "Turn penalty table differs from the profile for " << result.mismatches
+                << " of " << result.samples << " angles, by up to " << result.max_difference
+                << " deci-seconds";
+        }
+        else
+        {
+            util::SimpleLogger().Write() << "Turn penalty table matches the profile for all "
+                                         << result.samples << " angles";
+        }
+    }
+
+    if (!use_table)
+    {
+        return TurnPenaltyTable();
+    }
+    return turn_penalty_table;
+}
+
 /**
  \brief Building an edge-expanded graph from node-based input and turn restrictions
 */
@@ -494,11 +680,15 @@ Extractor::BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
         turn_lane_masks,
         turn_lane_map);
 
+    const auto turn_penalty_table = BuildTurnPenaltyTable(scripting_environment);
+
     edge_based_graph_factory.Run(scripting_environment,
+                                 turn_penalty_table,
                                  config.edge_output_path,
                                  config.turn_lane_data_file_name,
                                  config.edge_segment_lookup_path,
                                  config.edge_penalty_path,
+                                 config.edge_segment_index_path,
                                  config.generate_edge_lookup);
 
     WriteTurnLaneData(config.turn_lane_descriptions_file_name);
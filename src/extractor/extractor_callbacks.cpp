@@ -40,20 +40,16 @@ ExtractorCallbacks::ExtractorCallbacks(ExtractionContainers &extraction_containe
 }
 
 /**
- * Takes the node position from osmium and the filtered properties from the lua
- * profile and saves them to external memory.
+ * Takes the filtered properties from the lua profile and saves them for the node of the shared
+ * node store with the given input index. The position of the node is stored once for all
+ * profiles.
  *
  * warning: caller needs to take care of synchronization!
  */
-void ExtractorCallbacks::ProcessNode(const osmium::Node &input_node,
+void ExtractorCallbacks::ProcessNode(const std::uint64_t input_index,
                                      const ExtractionNode &result_node)
 {
-    external_memory.all_nodes_list.push_back(
-        {util::toFixed(util::FloatLongitude{input_node.location().lon()}),
-         util::toFixed(util::FloatLatitude{input_node.location().lat()}),
-         OSMNodeID{static_cast<std::uint64_t>(input_node.id())},
-         result_node.barrier,
-         result_node.traffic_lights});
+    external_memory.SetNodeFlags(input_index, result_node.barrier, result_node.traffic_lights);
 }
 
 void ExtractorCallbacks::ProcessRestriction(
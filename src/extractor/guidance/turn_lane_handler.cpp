@@ -32,22 +32,17 @@ std::size_t getNumberOfTurns(const Intersection &intersection)
 } // namespace
 
 TurnLaneHandler::TurnLaneHandler(const util::NodeBasedDynamicGraph &node_based_graph,
-                                 std::vector<std::uint32_t> &turn_lane_offsets,
-                                 std::vector<TurnLaneType::Mask> &turn_lane_masks,
-                                 LaneDescriptionMap &lane_description_map,
+                                 const std::vector<std::uint32_t> &turn_lane_offsets,
+                                 const std::vector<TurnLaneType::Mask> &turn_lane_masks,
+                                 const LaneDescriptionMap &lane_description_map,
+                                 LaneDescriptionMap &new_lane_descriptions,
                                  const TurnAnalysis &turn_analysis,
                                  LaneDataIdMap &id_map)
-    : node_based_graph(node_based_graph), turn_lane_offsets(turn_lane_offsets),
-      turn_lane_masks(turn_lane_masks), lane_description_map(lane_description_map),
+    : count_handled(0), count_called(0), node_based_graph(node_based_graph),
+      turn_lane_offsets(turn_lane_offsets), turn_lane_masks(turn_lane_masks),
+      lane_description_map(lane_description_map), new_lane_descriptions(new_lane_descriptions),
       turn_analysis(turn_analysis), id_map(id_map)
 {
-    count_handled = count_called = 0;
-}
-
-TurnLaneHandler::~TurnLaneHandler()
-{
-    std::cout << "Handled: " << count_handled << " of " << count_called
-              << " lanes: " << (double)(count_handled * 100) / (count_called) << " %." << std::endl;
 }
 
 /*
@@ -765,16 +760,23 @@ Intersection TurnLaneHandler::handleSliproadTurn(Intersection intersection,
     }
 
     const auto combined_id = [&]() {
-        auto itr = lane_description_map.find(combined_description);
-        if (lane_description_map.find(combined_description) == lane_description_map.end())
+        const auto itr = lane_description_map.find(combined_description);
+        if (itr != lane_description_map.end())
+        {
+            return itr->second;
+        }
+
+        const auto new_itr = new_lane_descriptions.find(combined_description);
+        if (new_itr == new_lane_descriptions.end())
         {
-            const auto new_id = boost::numeric_cast<LaneDescriptionID>(lane_description_map.size());
-            lane_description_map[combined_description] = new_id;
+            const auto new_id = boost::numeric_cast<LaneDescriptionID>(
+                lane_description_map.size() + new_lane_descriptions.size());
+            new_lane_descriptions[combined_description] = new_id;
             return new_id;
         }
         else
         {
-            return itr->second;
+            return new_itr->second;
         }
     }();
     return simpleMatchTuplesToTurns(std::move(intersection), lane_data, combined_id);
@@ -30,6 +30,9 @@ namespace extractor
 {
 namespace
 {
+// Number of way function results each thread keeps for ways with the same tags
+const constexpr std::size_t MAX_WAY_CACHE_SIZE = 1 << 16;
+
 // wrapper method as luabind doesn't automatically overload funcs w/ default parameters
 template <class T>
 auto get_value_by_key(T const &object, const char *key) -> decltype(object.get_value_by_key(key))
@@ -62,7 +65,7 @@ int luaErrorCallback(lua_State *state)
 }
 
 LuaScriptingEnvironment::LuaScriptingEnvironment(const std::string &file_name)
-    : file_name(file_name)
+    : file_name(file_name), has_sources(false)
 {
     util::SimpleLogger().Write() << "Using script " << file_name;
 }
@@ -226,7 +229,7 @@ void LuaScriptingEnvironment::InitContext(LuaScriptingContext &context)
              .def("invalid_data", &RasterDatum::get_invalid)];
 
     luabind::globals(context.state)["properties"] = &context.properties;
-    luabind::globals(context.state)["sources"] = &context.sources;
+    luabind::globals(context.state)["sources"] = &sources;
 
     if (0 != luaL_dofile(context.state, file_name.c_str()))
     {
@@ -237,9 +240,26 @@ void LuaScriptingEnvironment::InitContext(LuaScriptingContext &context)
     }
 
     context.has_turn_penalty_function = util::luaFunctionExists(context.state, "turn_function");
+    const luabind::object pure_turn_function =
+        luabind::globals(context.state)["turn_function_is_pure"];
+    context.has_pure_turn_function = luabind::type(pure_turn_function) == LUA_TBOOLEAN &&
+                                     luabind::object_cast<bool>(pure_turn_function);
     context.has_node_function = util::luaFunctionExists(context.state, "node_function");
     context.has_way_function = util::luaFunctionExists(context.state, "way_function");
     context.has_segment_function = util::luaFunctionExists(context.state, "segment_function");
+
+    if (context.has_way_function && util::luaFunctionExists(context.state, "get_way_cache_keys"))
+    {
+        luabind::call_function<void>(
+            context.state, "get_way_cache_keys", boost::ref(context.way_cache_keys));
+    }
+
+    // Sets the globals that refer to the sources in this state as well, the sources themselves
+    // are only loaded once.
+    if (has_sources)
+    {
+        luabind::call_function<void>(context.state, "source_function");
+    }
 }
 
 const ProfileProperties &LuaScriptingEnvironment::GetProfileProperties()
@@ -249,15 +269,16 @@ const ProfileProperties &LuaScriptingEnvironment::GetProfileProperties()
 
 LuaScriptingContext &LuaScriptingEnvironment::GetLuaContext()
 {
-    std::lock_guard<std::mutex> lock(init_mutex);
+    // called for every segment, only lock when the context of the thread is created
     bool initialized = false;
     auto &ref = script_contexts.local(initialized);
     if (!initialized)
     {
+        std::lock_guard<std::mutex> lock(init_mutex);
         ref = std::make_unique<LuaScriptingContext>();
         InitContext(*ref);
+        luabind::set_pcall_callback(&luaErrorCallback);
     }
-    luabind::set_pcall_callback(&luaErrorCallback);
 
     return *ref;
 }
@@ -296,8 +317,15 @@ void LuaScriptingEnvironment::ProcessElements(
                     result_way.clear();
                     if (local_context.has_way_function)
                     {
-                        local_context.processWay(static_cast<const osmium::Way &>(*entity),
-                                                 result_way);
+                        const auto &way = static_cast<const osmium::Way &>(*entity);
+                        if (local_context.way_cache_keys.empty())
+                        {
+                            local_context.processWay(way, result_way);
+                        }
+                        else
+                        {
+                            local_context.processCachedWay(way, result_way);
+                        }
                     }
                     resulting_ways.push_back(std::make_pair(x, std::move(result_way)));
                     break;
@@ -354,10 +382,38 @@ void LuaScriptingEnvironment::SetupSources()
     if (util::luaFunctionExists(context.state, "source_function"))
     {
         luabind::call_function<void>(context.state, "source_function");
+        std::lock_guard<std::mutex> lock(init_mutex);
+        has_sources = true;
     }
 }
 
-int32_t LuaScriptingEnvironment::GetTurnPenalty(const double angle)
+void LuaScriptingEnvironment::LogStatistics()
+{
+    std::size_t way_cache_hits = 0;
+    std::size_t way_cache_misses = 0;
+    for (const auto &context : script_contexts)
+    {
+        way_cache_hits += context->way_cache_hits;
+        way_cache_misses += context->way_cache_misses;
+    }
+
+    const auto processed_ways = way_cache_hits + way_cache_misses;
+    if (processed_ways > 0)
+    {
+        util::SimpleLogger().Write() << "Way cache: " << way_cache_hits << " hits, "
+                                     << way_cache_misses << " misses ("
+                                     << (100. * way_cache_hits) / processed_ways << "% hit rate)";
+    }
+}
+
+bool LuaScriptingEnvironment::HasPureTurnFunction()
+{
+    // without a turn function every penalty is 0
+    auto &context = GetLuaContext();
+    return !context.has_turn_penalty_function || context.has_pure_turn_function;
+}
+
+double LuaScriptingEnvironment::GetTurnFunctionValue(const double angle)
 {
     auto &context = GetLuaContext();
     if (context.has_turn_penalty_function)
@@ -366,11 +422,7 @@ int32_t LuaScriptingEnvironment::GetTurnPenalty(const double angle)
         try
         {
             // call lua profile to compute turn penalty
-            const double penalty =
-                luabind::call_function<double>(context.state, "turn_function", angle);
-            BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
-            BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
-            return boost::numeric_cast<int32_t>(penalty);
+            return luabind::call_function<double>(context.state, "turn_function", angle);
         }
         catch (const luabind::error &er)
         {
@@ -380,6 +432,14 @@ int32_t LuaScriptingEnvironment::GetTurnPenalty(const double angle)
     return 0;
 }
 
+int32_t LuaScriptingEnvironment::GetTurnPenalty(const double angle)
+{
+    const double penalty = GetTurnFunctionValue(angle);
+    BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
+    BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
+    return boost::numeric_cast<int32_t>(penalty);
+}
+
 void LuaScriptingEnvironment::ProcessSegment(const osrm::util::Coordinate &source,
                                              const osrm::util::Coordinate &target,
                                              double distance,
@@ -409,5 +469,39 @@ void LuaScriptingContext::processWay(const osmium::Way &way, ExtractionWay &resu
     BOOST_ASSERT(state != nullptr);
     luabind::call_function<void>(state, "way_function", boost::cref(way), boost::ref(result));
 }
+
+void LuaScriptingContext::processCachedWay(const osmium::Way &way, ExtractionWay &result)
+{
+    // the values of the declared tags, a missing tag differs from an empty value
+    way_cache_key.clear();
+    for (const auto &key : way_cache_keys)
+    {
+        const char *value = way.get_value_by_key(key.c_str());
+        if (value != nullptr)
+        {
+            way_cache_key.push_back('=');
+            way_cache_key.append(value);
+        }
+        way_cache_key.push_back('\0');
+    }
+
+    const auto itr = way_cache.find(way_cache_key);
+    if (itr != way_cache.end())
+    {
+        ++way_cache_hits;
+        // The keys cover every tag the way function reads except the name, so the result of
+        // the other way is that of this way (see docs/profiles.md)
+        result = itr->second;
+        result.name = way.get_value_by_key("name", "");
+        return;
+    }
+
+    ++way_cache_misses;
+    processWay(way, result);
+    if (way_cache.size() < MAX_WAY_CACHE_SIZE)
+    {
+        way_cache.emplace(way_cache_key, result);
+    }
+}
 }
 }
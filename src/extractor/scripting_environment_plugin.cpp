@@ -0,0 +1,197 @@
+#include "extractor/scripting_environment_plugin.hpp"
+
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/restriction_parser.hpp"
+#include "util/exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <osmium/osm.hpp>
+
+#include <tbb/parallel_for.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <cstdint>
+#include <limits>
+
+namespace osrm
+{
+namespace extractor
+{
+namespace
+{
+using ApiVersionFunction = std::uint32_t (*)();
+using LayoutFunction = std::uint64_t (*)();
+using CreateFunction = ProfilePlugin *(*)();
+
+#ifdef _WIN32
+void *openLibrary(const std::string &file_name) { return LoadLibraryA(file_name.c_str()); }
+void *findSymbol(void *library, const char *name)
+{
+    return reinterpret_cast<void *>(GetProcAddress(static_cast<HMODULE>(library), name));
+}
+void closeLibrary(void *library) { FreeLibrary(static_cast<HMODULE>(library)); }
+std::string lastError() { return "error " + std::to_string(GetLastError()); }
+#else
+void *openLibrary(const std::string &file_name) { return dlopen(file_name.c_str(), RTLD_NOW); }
+void *findSymbol(void *library, const char *name) { return dlsym(library, name); }
+void closeLibrary(void *library) { dlclose(library); }
+std::string lastError()
+{
+    const char *error = dlerror();
+    return error != nullptr ? error : "unknown error";
+}
+#endif
+}
+
+PluginScriptingEnvironment::PluginScriptingEnvironment(const std::string &file_name)
+    : library(openLibrary(file_name))
+{
+    if (library == nullptr)
+    {
+        throw util::exception("Could not load profile " + file_name + ": " + lastError());
+    }
+
+    const auto api_version = reinterpret_cast<ApiVersionFunction>(
+        findSymbol(library, "osrm_profile_plugin_api_version"));
+    const auto create =
+        reinterpret_cast<CreateFunction>(findSymbol(library, "osrm_create_profile_plugin"));
+    if (api_version == nullptr || create == nullptr)
+    {
+        closeLibrary(library);
+        throw util::exception(file_name + " is not a profile, it does not use OSRM_PROFILE_PLUGIN");
+    }
+    if (api_version() != PROFILE_PLUGIN_API_VERSION)
+    {
+        closeLibrary(library);
+        throw util::exception(file_name + " was built for version " +
+                              std::to_string(api_version()) + " of the profile interface, " +
+                              "this version of osrm-extract needs version " +
+                              std::to_string(PROFILE_PLUGIN_API_VERSION));
+    }
+    const auto layout =
+        reinterpret_cast<LayoutFunction>(findSymbol(library, "osrm_profile_plugin_layout"));
+    if (layout == nullptr || layout() != PROFILE_PLUGIN_LAYOUT)
+    {
+        closeLibrary(library);
+        throw util::exception(file_name + " was built with other definitions of ExtractionWay, " +
+                              "ExtractionNode or ProfileProperties than this osrm-extract, " +
+                              "rebuild it against the headers of this version");
+    }
+
+    plugin.reset(create());
+    properties = plugin->GetProfileProperties();
+    util::SimpleLogger().Write() << "Using compiled profile " << file_name;
+}
+
+PluginScriptingEnvironment::~PluginScriptingEnvironment()
+{
+    // the code of the plugin is part of the library
+    plugin.reset();
+    closeLibrary(library);
+}
+
+bool PluginScriptingEnvironment::IsPlugin(const std::string &file_name)
+{
+#if defined(_WIN32)
+    return boost::algorithm::iends_with(file_name, ".dll");
+#elif defined(__APPLE__)
+    return boost::algorithm::ends_with(file_name, ".dylib") ||
+           boost::algorithm::ends_with(file_name, ".so");
+#else
+    return boost::algorithm::ends_with(file_name, ".so");
+#endif
+}
+
+const ProfileProperties &PluginScriptingEnvironment::GetProfileProperties() { return properties; }
+
+std::vector<std::string> PluginScriptingEnvironment::GetNameSuffixList()
+{
+    return plugin->GetNameSuffixList();
+}
+
+std::vector<std::string> PluginScriptingEnvironment::GetRestrictions()
+{
+    return plugin->GetRestrictions();
+}
+
+// raster sources are only available to Lua profiles
+void PluginScriptingEnvironment::SetupSources() {}
+
+void PluginScriptingEnvironment::LogStatistics() {}
+
+// The table is opt-in with --turn-penalty-table, so a plugin gets the same penalties as the Lua
+// profile it ports
+bool PluginScriptingEnvironment::HasPureTurnFunction() { return false; }
+
+double PluginScriptingEnvironment::GetTurnFunctionValue(const double angle)
+{
+    return plugin->GetTurnPenalty(angle);
+}
+
+int32_t PluginScriptingEnvironment::GetTurnPenalty(const double angle)
+{
+    const double penalty = GetTurnFunctionValue(angle);
+    BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
+    BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
+    return boost::numeric_cast<int32_t>(penalty);
+}
+
+void PluginScriptingEnvironment::ProcessSegment(const osrm::util::Coordinate &source,
+                                                const osrm::util::Coordinate &target,
+                                                double distance,
+                                                InternalExtractorEdge::WeightData &weight)
+{
+    plugin->ProcessSegment(source, target, distance, weight);
+}
+
+void PluginScriptingEnvironment::ProcessElements(
+    const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
+    const RestrictionParser &restriction_parser,
+    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
+    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
+    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> &resulting_restrictions)
+{
+    // parse OSM entities in parallel, store in resulting vectors
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, osm_elements.size()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            ExtractionNode result_node;
+            ExtractionWay result_way;
+
+            for (auto x = range.begin(), end = range.end(); x != end; ++x)
+            {
+                const auto entity = osm_elements[x];
+
+                switch (entity->type())
+                {
+                case osmium::item_type::node:
+                    result_node.clear();
+                    plugin->ProcessNode(static_cast<const osmium::Node &>(*entity), result_node);
+                    resulting_nodes.push_back(std::make_pair(x, std::move(result_node)));
+                    break;
+                case osmium::item_type::way:
+                    result_way.clear();
+                    plugin->ProcessWay(static_cast<const osmium::Way &>(*entity), result_way);
+                    resulting_ways.push_back(std::make_pair(x, std::move(result_way)));
+                    break;
+                case osmium::item_type::relation:
+                    resulting_restrictions.push_back(restriction_parser.TryParse(
+                        static_cast<const osmium::Relation &>(*entity)));
+                    break;
+                default:
+                    break;
+                }
+            }
+        });
+}
+}
+}
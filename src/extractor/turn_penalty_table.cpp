@@ -0,0 +1,57 @@
+#include "extractor/turn_penalty_table.hpp"
+
+#include <cstdlib>
+#include <random>
+
+namespace osrm
+{
+namespace extractor
+{
+
+namespace
+{
+// the samples are compared with the profile in the same order on every run
+const constexpr unsigned VALIDATION_SEED = 1337;
+}
+
+TurnPenaltyTable::TurnPenaltyTable(const std::function<double(double)> &turn_function)
+{
+    const auto number_of_penalties = static_cast<std::size_t>(360 * SAMPLES_PER_DEGREE) + 1;
+    penalties.reserve(number_of_penalties);
+    for (std::size_t index = 0; index < number_of_penalties; ++index)
+    {
+        penalties.push_back(turn_function(index / SAMPLES_PER_DEGREE - 180.));
+    }
+}
+
+TurnPenaltyTable::ValidationResult
+TurnPenaltyTable::Validate(const std::function<std::int32_t(double)> &turn_penalty,
+                           const std::size_t number_of_samples) const
+{
+    ValidationResult result{0, 0, 0};
+    const auto compare = [&](const double angle) {
+        const auto difference = std::abs(GetTurnPenalty(angle) - turn_penalty(angle));
+        ++result.samples;
+        if (difference != 0)
+        {
+            ++result.mismatches;
+            result.max_difference = std::max(result.max_difference, difference);
+        }
+    };
+
+    for (std::size_t index = 0; index < penalties.size(); ++index)
+    {
+        compare(index / SAMPLES_PER_DEGREE - 180.);
+    }
+
+    std::mt19937 generator(VALIDATION_SEED);
+    std::uniform_real_distribution<double> angle_distribution(-180., 180.);
+    for (std::size_t sample = 0; sample < number_of_samples; ++sample)
+    {
+        compare(angle_distribution(generator));
+    }
+
+    return result;
+}
+}
+}
@@ -54,4 +54,9 @@ engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string
     return engine_->Tile(params, result);
 }
 
+engine::Status OSRM::MemoryReport(json::Object &result) const
+{
+    return engine_->MemoryReport(result);
+}
+
 } // ns osrm
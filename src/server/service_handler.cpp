@@ -1,5 +1,6 @@
 #include "server/service_handler.hpp"
 
+#include "server/service/admin_service.hpp"
 #include "server/service/match_service.hpp"
 #include "server/service/nearest_service.hpp"
 #include "server/service/route_service.hpp"
@@ -16,7 +17,8 @@ namespace osrm
 {
 namespace server
 {
-ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(config)
+ServiceHandler::ServiceHandler(osrm::EngineConfig &config, const bool enable_admin_service)
+    : routing_machine(config)
 {
     service_map["route"] = std::make_unique<service::RouteService>(routing_machine);
     service_map["table"] = std::make_unique<service::TableService>(routing_machine);
@@ -24,6 +26,10 @@ ServiceHandler::ServiceHandler(osrm::EngineConfig &config) : routing_machine(con
     service_map["trip"] = std::make_unique<service::TripService>(routing_machine);
     service_map["match"] = std::make_unique<service::MatchService>(routing_machine);
     service_map["tile"] = std::make_unique<service::TileService>(routing_machine);
+    if (enable_admin_service)
+    {
+        service_map["admin"] = std::make_unique<service::AdminService>(routing_machine);
+    }
 }
 
 engine::Status ServiceHandler::RunQuery(api::ParsedURL parsed_url,
@@ -1,4 +1,5 @@
 #include "storage/storage.hpp"
+#include "contractor/multi_level_files.hpp"
 #include "contractor/query_edge.hpp"
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
@@ -19,7 +20,7 @@
 #include "util/range_table.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
 #include "util/simple_logger.hpp"
-#include "util/static_graph.hpp"
+#include "util/split_static_graph.hpp"
 #include "util/static_rtree.hpp"
 #include "util/typedefs.hpp"
 
@@ -29,7 +30,10 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/named_sharable_mutex.hpp>
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
@@ -38,11 +42,13 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <new>
 #include <string>
+#include <type_traits>
 
 namespace osrm
 {
@@ -52,9 +58,15 @@ namespace storage
 using RTreeLeaf = engine::datafacade::BaseDataFacade::RTreeLeaf;
 using RTreeNode =
     util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, true>::vector, true>::TreeNode;
-using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
+using QueryGraph = util::SplitStaticGraph<contractor::QueryEdge::EdgeData>;
 
-Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
+Storage::Storage(StorageConfig config_,
+                 std::uint64_t huge_page_size_,
+                 ResidencyPolicy residency_policy_)
+    : config(std::move(config_)), huge_page_size(huge_page_size_),
+      residency_policy(residency_policy_)
+{
+}
 
 struct RegionsLayout
 {
@@ -119,9 +131,10 @@ Storage::ReturnCode Storage::Run(int max_wait)
     }
 
 #ifdef __linux__
-    // try to disable swapping on Linux
+    // try to disable swapping on Linux. With a tiered residency the mapped blocks need to stay
+    // evictable, the shared memory region is locked on its own.
     const bool lock_flags = MCL_CURRENT | MCL_FUTURE;
-    if (-1 == mlockall(lock_flags))
+    if (residency_policy == ResidencyPolicy::Pinned && -1 == mlockall(lock_flags))
     {
         util::SimpleLogger().Write(logWARNING) << "Could not request RAM lock";
     }
@@ -186,6 +199,15 @@ Storage::ReturnCode Storage::Run(int max_wait)
     // Allocate a memory layout in shared memory
     auto layout_memory = makeSharedMemory(layout_region, sizeof(SharedDataLayout), true);
     auto shared_layout_ptr = new (layout_memory->Ptr()) SharedDataLayout();
+    shared_layout_ptr->large_block_alignment = huge_page_size;
+    if (residency_policy == ResidencyPolicy::Tiered)
+    {
+        for (auto bid = 0; bid < SharedDataLayout::NUM_BLOCKS; ++bid)
+        {
+            shared_layout_ptr->residency[bid] =
+                GetTieredBlockResidency(static_cast<SharedDataLayout::BlockID>(bid));
+        }
+    }
     auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
 
     shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::FILE_INDEX_PATH,
@@ -260,8 +282,10 @@ Storage::ReturnCode Storage::Run(int max_wait)
     shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::HSGR_CHECKSUM, 1);
     shared_layout_ptr->SetBlockSize<QueryGraph::NodeArrayEntry>(SharedDataLayout::GRAPH_NODE_LIST,
                                                                 hsgr_header.number_of_nodes);
-    shared_layout_ptr->SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
-                                                                hsgr_header.number_of_edges);
+    shared_layout_ptr->SetBlockSize<QueryGraph::SearchEdgeArrayEntry>(
+        SharedDataLayout::GRAPH_EDGE_LIST, hsgr_header.number_of_edges);
+    shared_layout_ptr->SetBlockSize<QueryGraph::UnpackEdgeArrayEntry>(
+        SharedDataLayout::GRAPH_EDGE_UNPACK_LIST, hsgr_header.number_of_edges);
 
     // load rsearch tree size
     boost::filesystem::ifstream tree_node_file(config.ram_index_path, std::ios::binary);
@@ -295,6 +319,26 @@ Storage::ReturnCode Storage::Run(int max_wait)
     shared_layout_ptr->SetBlockSize<unsigned>(SharedDataLayout::CORE_MARKER,
                                               number_of_core_markers);
 
+    // load the multi-level partition of datasets prepared by osrm-contract --mld
+    contractor::MultiLevelPartition<> partition;
+    contractor::CellStorage<> cells;
+    if (boost::filesystem::exists(config.partition_path))
+    {
+        partition = contractor::readPartition(config.partition_path.string());
+        cells = contractor::readCells(config.cells_path.string(), partition);
+        cells.SetWeights(contractor::readCellMetrics(config.cell_metrics_path.string(), cells));
+    }
+    shared_layout_ptr->SetBlockSize<std::uint32_t>(SharedDataLayout::MLD_PARTITION,
+                                                   partition.GetPartitionIDs().size());
+    shared_layout_ptr->SetBlockSize<std::uint8_t>(SharedDataLayout::MLD_LEVEL_SHIFTS,
+                                                  partition.GetLevelShifts().size());
+    shared_layout_ptr->SetBlockSize<contractor::CellData>(SharedDataLayout::MLD_CELLS,
+                                                          cells.GetCells().size());
+    shared_layout_ptr->SetBlockSize<NodeID>(SharedDataLayout::MLD_CELL_BOUNDARY,
+                                            cells.GetBoundaryNodes().size());
+    shared_layout_ptr->SetBlockSize<EdgeWeight>(SharedDataLayout::MLD_CELL_WEIGHTS,
+                                                cells.GetWeights().size());
+
     // load coordinate size
     boost::filesystem::ifstream nodes_input_stream(config.nodes_data_path, std::ios::binary);
     if (!nodes_input_stream)
@@ -439,19 +483,45 @@ Storage::ReturnCode Storage::Run(int max_wait)
     // allocate shared memory block
     util::SimpleLogger().Write() << "allocating shared memory of "
                                  << shared_layout_ptr->GetSizeOfLayout() << " bytes";
-    auto shared_memory = makeSharedMemory(data_region, shared_layout_ptr->GetSizeOfLayout(), true);
+    if (huge_page_size > 0)
+    {
+        util::SimpleLogger().Write() << "using huge pages of " << huge_page_size << " bytes";
+    }
+    auto shared_memory = makeSharedMemory(
+        data_region, shared_layout_ptr->GetSizeOfLayout(), true, huge_page_size);
     char *shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
 
+    // blocks that may be evicted are written to a file that clients map
+    const auto mapped_blocks_path = mappedBlocksPath(data_region);
+    boost::filesystem::remove(mapped_blocks_path);
+    const auto mapped_blocks_size = shared_layout_ptr->GetSizeOfLayout(BlockResidency::Mapped);
+    boost::interprocess::mapped_region mapped_blocks;
+    char *mapped_memory_ptr = nullptr;
+    if (mapped_blocks_size > 0)
+    {
+        util::SimpleLogger().Write() << "mapping " << mapped_blocks_size
+                                     << " bytes of evictable data from " << mapped_blocks_path;
+        {
+            boost::filesystem::ofstream mapped_blocks_stream(mapped_blocks_path, std::ios::binary);
+        }
+        boost::filesystem::resize_file(mapped_blocks_path, mapped_blocks_size);
+        const boost::interprocess::file_mapping mapped_blocks_file(
+            mapped_blocks_path.string().c_str(), boost::interprocess::read_write);
+        mapped_blocks =
+            boost::interprocess::mapped_region(mapped_blocks_file, boost::interprocess::read_write);
+        mapped_memory_ptr = static_cast<char *>(mapped_blocks.get_address());
+    }
+
     // read actual data into shared memory object //
 
     // hsgr checksum
     unsigned *checksum_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::HSGR_CHECKSUM);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::HSGR_CHECKSUM);
     *checksum_ptr = hsgr_header.checksum;
 
     // ram index file name
     char *file_index_path_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::FILE_INDEX_PATH);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::FILE_INDEX_PATH);
     // make sure we have 0 ending
     std::fill(file_index_path_ptr,
               file_index_path_ptr +
@@ -463,7 +533,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
 
     // Loading street names
     unsigned *name_offsets_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_OFFSETS);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::NAME_OFFSETS);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_OFFSETS) > 0)
     {
         name_stream.read((char *)name_offsets_ptr,
@@ -471,7 +541,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     }
 
     unsigned *name_blocks_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_BLOCKS);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::NAME_BLOCKS);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::NAME_BLOCKS) > 0)
     {
         name_stream.read((char *)name_blocks_ptr,
@@ -479,7 +549,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     }
 
     char *name_char_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_CHAR_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::NAME_CHAR_LIST);
     unsigned temp_length = 0;
     name_stream.read((char *)&temp_length, sizeof(unsigned));
 
@@ -497,7 +567,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     // make sure do write canary...
     auto *turn_lane_data_ptr =
         shared_layout_ptr->GetBlockPtr<util::guidance::LaneTupleIdPair, true>(
-            shared_memory_ptr, SharedDataLayout::TURN_LANE_DATA);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::TURN_LANE_DATA);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::TURN_LANE_DATA) > 0)
     {
         lane_data_stream.read(reinterpret_cast<char *>(turn_lane_data_ptr),
@@ -506,7 +576,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     lane_data_stream.close();
 
     auto *turn_lane_offset_ptr = shared_layout_ptr->GetBlockPtr<std::uint32_t, true>(
-        shared_memory_ptr, SharedDataLayout::LANE_DESCRIPTION_OFFSETS);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::LANE_DESCRIPTION_OFFSETS);
     if (!lane_description_offsets.empty())
     {
         BOOST_ASSERT(shared_layout_ptr->GetBlockSize(SharedDataLayout::LANE_DESCRIPTION_OFFSETS) >=
@@ -519,7 +589,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
 
     auto *turn_lane_mask_ptr =
         shared_layout_ptr->GetBlockPtr<extractor::guidance::TurnLaneType::Mask, true>(
-            shared_memory_ptr, SharedDataLayout::LANE_DESCRIPTION_MASKS);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::LANE_DESCRIPTION_MASKS);
     if (!lane_description_masks.empty())
     {
         BOOST_ASSERT(shared_layout_ptr->GetBlockSize(SharedDataLayout::LANE_DESCRIPTION_MASKS) >=
@@ -531,30 +601,31 @@ Storage::ReturnCode Storage::Run(int max_wait)
 
     // load original edge information
     GeometryID *via_geometry_ptr = shared_layout_ptr->GetBlockPtr<GeometryID, true>(
-        shared_memory_ptr, SharedDataLayout::VIA_NODE_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::VIA_NODE_LIST);
 
     unsigned *name_id_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::NAME_ID_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::NAME_ID_LIST);
 
     extractor::TravelMode *travel_mode_ptr =
         shared_layout_ptr->GetBlockPtr<extractor::TravelMode, true>(shared_memory_ptr,
+                                                                    mapped_memory_ptr,
                                                                     SharedDataLayout::TRAVEL_MODE);
     util::guidance::TurnBearing *pre_turn_bearing_ptr =
         shared_layout_ptr->GetBlockPtr<util::guidance::TurnBearing, true>(
-            shared_memory_ptr, SharedDataLayout::PRE_TURN_BEARING);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::PRE_TURN_BEARING);
     util::guidance::TurnBearing *post_turn_bearing_ptr =
         shared_layout_ptr->GetBlockPtr<util::guidance::TurnBearing, true>(
-            shared_memory_ptr, SharedDataLayout::POST_TURN_BEARING);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::POST_TURN_BEARING);
 
     LaneDataID *lane_data_id_ptr = shared_layout_ptr->GetBlockPtr<LaneDataID, true>(
-        shared_memory_ptr, SharedDataLayout::LANE_DATA_ID);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::LANE_DATA_ID);
 
     extractor::guidance::TurnInstruction *turn_instructions_ptr =
         shared_layout_ptr->GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-            shared_memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::TURN_INSTRUCTION);
 
     EntryClassID *entry_class_id_ptr = shared_layout_ptr->GetBlockPtr<EntryClassID, true>(
-        shared_memory_ptr, SharedDataLayout::ENTRY_CLASSID);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::ENTRY_CLASSID);
 
     io::readEdges(edges_input_stream,
                   via_geometry_ptr,
@@ -571,7 +642,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     // load compressed geometry
     unsigned temporary_value;
     unsigned *geometries_index_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::GEOMETRIES_INDEX);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GEOMETRIES_INDEX);
     geometry_input_stream.seekg(0, geometry_input_stream.beg);
     geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
     BOOST_ASSERT(temporary_value ==
@@ -584,7 +655,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
             shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_INDEX));
     }
     NodeID *geometries_node_id_list_ptr = shared_layout_ptr->GetBlockPtr<NodeID, true>(
-        shared_memory_ptr, SharedDataLayout::GEOMETRIES_NODE_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GEOMETRIES_NODE_LIST);
 
     geometry_input_stream.read((char *)&temporary_value, sizeof(unsigned));
     BOOST_ASSERT(temporary_value ==
@@ -597,7 +668,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
             shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_NODE_LIST));
     }
     EdgeWeight *geometries_fwd_weight_list_ptr = shared_layout_ptr->GetBlockPtr<EdgeWeight, true>(
-        shared_memory_ptr, SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
 
     BOOST_ASSERT(temporary_value ==
                  shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST]);
@@ -609,7 +680,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
             shared_layout_ptr->GetBlockSize(SharedDataLayout::GEOMETRIES_FWD_WEIGHT_LIST));
     }
     EdgeWeight *geometries_rev_weight_list_ptr = shared_layout_ptr->GetBlockPtr<EdgeWeight, true>(
-        shared_memory_ptr, SharedDataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GEOMETRIES_REV_WEIGHT_LIST);
 
     BOOST_ASSERT(temporary_value ==
                  shared_layout_ptr->num_entries[SharedDataLayout::GEOMETRIES_REV_WEIGHT_LIST]);
@@ -623,7 +694,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
 
     // load datasource information (if it exists)
     uint8_t *datasources_list_ptr = shared_layout_ptr->GetBlockPtr<uint8_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCES_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::DATASOURCES_LIST);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCES_LIST) > 0)
     {
         io::readDatasourceIndexes(geometry_datasource_input_stream,
@@ -634,7 +705,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     // load datasource name information (if it exists)
 
     char *datasource_name_data_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_DATA);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::DATASOURCE_NAME_DATA);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCE_NAME_DATA) > 0)
     {
         std::copy(datasource_names_data.names.begin(),
@@ -643,7 +714,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     }
 
     auto datasource_name_offsets_ptr = shared_layout_ptr->GetBlockPtr<std::uint32_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_OFFSETS);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::DATASOURCE_NAME_OFFSETS);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCE_NAME_OFFSETS) > 0)
     {
         std::copy(datasource_names_data.offsets.begin(),
@@ -652,7 +723,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
     }
 
     auto datasource_name_lengths_ptr = shared_layout_ptr->GetBlockPtr<std::uint32_t, true>(
-        shared_memory_ptr, SharedDataLayout::DATASOURCE_NAME_LENGTHS);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::DATASOURCE_NAME_LENGTHS);
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::DATASOURCE_NAME_LENGTHS) > 0)
     {
         std::copy(datasource_names_data.lengths.begin(),
@@ -662,9 +733,9 @@ Storage::ReturnCode Storage::Run(int max_wait)
 
     // Loading list of coordinates
     util::Coordinate *coordinates_ptr = shared_layout_ptr->GetBlockPtr<util::Coordinate, true>(
-        shared_memory_ptr, SharedDataLayout::COORDINATE_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::COORDINATE_LIST);
     std::uint64_t *osmnodeid_ptr = shared_layout_ptr->GetBlockPtr<std::uint64_t, true>(
-        shared_memory_ptr, SharedDataLayout::OSM_NODE_ID_LIST);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::OSM_NODE_ID_LIST);
     util::PackedVector<OSMNodeID, true> osmnodeid_list;
     osmnodeid_list.reset(osmnodeid_ptr,
                          shared_layout_ptr->num_entries[SharedDataLayout::OSM_NODE_ID_LIST]);
@@ -672,13 +743,13 @@ Storage::ReturnCode Storage::Run(int max_wait)
     nodes_input_stream.close();
 
     // store timestamp
-    char *timestamp_ptr =
-        shared_layout_ptr->GetBlockPtr<char, true>(shared_memory_ptr, SharedDataLayout::TIMESTAMP);
+    char *timestamp_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::TIMESTAMP);
     io::readTimestamp(timestamp_stream, timestamp_ptr, timestamp_size);
 
     // store search tree portion of rtree
     RTreeNode *rtree_ptrtest = shared_layout_ptr->GetBlockPtr<RTreeNode, true>(
-        shared_memory_ptr, SharedDataLayout::R_SEARCH_TREE);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::R_SEARCH_TREE);
     io::readRamIndex(tree_node_file, rtree_ptrtest, tree_size);
 
     // load core markers
@@ -687,7 +758,7 @@ Storage::ReturnCode Storage::Run(int max_wait)
                           sizeof(char) * number_of_core_markers);
 
     unsigned *core_marker_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-        shared_memory_ptr, SharedDataLayout::CORE_MARKER);
+        shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::CORE_MARKER);
 
     for (auto i = 0u; i < number_of_core_markers; ++i)
     {
@@ -710,27 +781,45 @@ Storage::ReturnCode Storage::Run(int max_wait)
         }
     }
 
+    // store the multi-level partition, the blocks are empty for contracted datasets
+    const auto copy_into_block = [&](const auto &data, const SharedDataLayout::BlockID block_id) {
+        using DataT = typename std::decay_t<decltype(data)>::value_type;
+        auto *block_ptr = shared_layout_ptr->GetBlockPtr<DataT, true>(
+            shared_memory_ptr, mapped_memory_ptr, block_id);
+        std::copy(data.begin(), data.end(), block_ptr);
+    };
+    copy_into_block(partition.GetPartitionIDs(), SharedDataLayout::MLD_PARTITION);
+    copy_into_block(partition.GetLevelShifts(), SharedDataLayout::MLD_LEVEL_SHIFTS);
+    copy_into_block(cells.GetCells(), SharedDataLayout::MLD_CELLS);
+    copy_into_block(cells.GetBoundaryNodes(), SharedDataLayout::MLD_CELL_BOUNDARY);
+    copy_into_block(cells.GetWeights(), SharedDataLayout::MLD_CELL_WEIGHTS);
+
     // load the nodes of the search graph
     QueryGraph::NodeArrayEntry *graph_node_list_ptr =
         shared_layout_ptr->GetBlockPtr<QueryGraph::NodeArrayEntry, true>(
-            shared_memory_ptr, SharedDataLayout::GRAPH_NODE_LIST);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GRAPH_NODE_LIST);
 
-    // load the edges of the search graph
-    QueryGraph::EdgeArrayEntry *graph_edge_list_ptr =
-        shared_layout_ptr->GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(
-            shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
+    // load the edges of the search graph, split into the data read by the searches and the data
+    // read by the unpacking
+    QueryGraph::SearchEdgeArrayEntry *graph_edge_list_ptr =
+        shared_layout_ptr->GetBlockPtr<QueryGraph::SearchEdgeArrayEntry, true>(
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
+    QueryGraph::UnpackEdgeArrayEntry *graph_edge_unpack_list_ptr =
+        shared_layout_ptr->GetBlockPtr<QueryGraph::UnpackEdgeArrayEntry, true>(
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::GRAPH_EDGE_UNPACK_LIST);
 
     io::readHSGR(hsgr_input_stream,
                  graph_node_list_ptr,
                  hsgr_header.number_of_nodes,
                  graph_edge_list_ptr,
+                 graph_edge_unpack_list_ptr,
                  hsgr_header.number_of_edges);
     hsgr_input_stream.close();
 
     // load profile properties
     extractor::ProfileProperties *profile_properties_ptr =
         shared_layout_ptr->GetBlockPtr<extractor::ProfileProperties, true>(
-            shared_memory_ptr, SharedDataLayout::PROPERTIES);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::PROPERTIES);
     boost::filesystem::ifstream profile_properties_stream(config.properties_path);
     if (!profile_properties_stream)
     {
@@ -743,14 +832,14 @@ Storage::ReturnCode Storage::Run(int max_wait)
     if (!bearing_class_id_table.empty())
     {
         auto bearing_id_ptr = shared_layout_ptr->GetBlockPtr<BearingClassID, true>(
-            shared_memory_ptr, SharedDataLayout::BEARING_CLASSID);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::BEARING_CLASSID);
         std::copy(bearing_class_id_table.begin(), bearing_class_id_table.end(), bearing_id_ptr);
     }
 
     if (shared_layout_ptr->GetBlockSize(SharedDataLayout::BEARING_OFFSETS) > 0)
     {
         auto *bearing_offsets_ptr = shared_layout_ptr->GetBlockPtr<unsigned, true>(
-            shared_memory_ptr, SharedDataLayout::BEARING_OFFSETS);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::BEARING_OFFSETS);
         std::copy(bearing_offsets_data.begin(), bearing_offsets_data.end(), bearing_offsets_ptr);
     }
 
@@ -758,21 +847,21 @@ Storage::ReturnCode Storage::Run(int max_wait)
     {
         auto *bearing_blocks_ptr =
             shared_layout_ptr->GetBlockPtr<typename util::RangeTable<16, true>::BlockT, true>(
-                shared_memory_ptr, SharedDataLayout::BEARING_BLOCKS);
+                shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::BEARING_BLOCKS);
         std::copy(bearing_blocks_data.begin(), bearing_blocks_data.end(), bearing_blocks_ptr);
     }
 
     if (!bearing_class_table.empty())
     {
         auto bearing_class_ptr = shared_layout_ptr->GetBlockPtr<DiscreteBearing, true>(
-            shared_memory_ptr, SharedDataLayout::BEARING_VALUES);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::BEARING_VALUES);
         std::copy(bearing_class_table.begin(), bearing_class_table.end(), bearing_class_ptr);
     }
 
     if (!entry_class_table.empty())
     {
         auto entry_class_ptr = shared_layout_ptr->GetBlockPtr<util::guidance::EntryClass, true>(
-            shared_memory_ptr, SharedDataLayout::ENTRY_CLASS);
+            shared_memory_ptr, mapped_memory_ptr, SharedDataLayout::ENTRY_CLASS);
         std::copy(entry_class_table.begin(), entry_class_table.end(), entry_class_ptr);
     }
 
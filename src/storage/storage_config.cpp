@@ -17,7 +17,9 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
       datasource_indexes_path{base.string() + ".datasource_indexes"},
       names_data_path{base.string() + ".names"}, properties_path{base.string() + ".properties"},
       intersection_class_path{base.string() + ".icd"}, turn_lane_data_path{base.string() + ".tld"},
-      turn_lane_description_path{base.string() + ".tls"}
+      turn_lane_description_path{base.string() + ".tls"},
+      partition_path{base.string() + ".partition"}, cells_path{base.string() + ".cells"},
+      cell_metrics_path{base.string() + ".cell_metrics"}
 {
 }
 
@@ -50,5 +52,20 @@ bool StorageConfig::IsValid() const
 
     return success;
 }
+
+bool StorageConfig::IsMultiLevelValid() const
+{
+    bool success = true;
+    for (const auto &path : {partition_path, cells_path, cell_metrics_path})
+    {
+        if (!boost::filesystem::is_regular_file(path))
+        {
+            util::SimpleLogger().Write(logWARNING) << "Missing/Broken File: " << path.string();
+            success = false;
+        }
+    }
+
+    return success;
+}
 }
 }
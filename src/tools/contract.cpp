@@ -43,16 +43,50 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         boost::program_options::value<std::vector<std::string>>(
             &contractor_config.segment_speed_lookup_paths)
             ->composing(),
-        "Lookup files containing nodeA, nodeB, speed data to adjust edge weights")(
+        "Lookup files containing nodeA, nodeB, speed data to adjust edge weights, as CSV or as "
+        "written by osrm-convert-traffic")(
         "turn-penalty-file",
         boost::program_options::value<std::vector<std::string>>(
             &contractor_config.turn_penalty_lookup_paths)
             ->composing(),
-        "Lookup files containing from_, to_, via_nodes, and turn penalties to adjust turn weights")(
+        "Lookup files containing from_, to_, via_nodes, and turn penalties to adjust turn weights, "
+        "as CSV or as written by osrm-convert-traffic --turn-penalties")(
         "level-cache,o",
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
         "Use .level file to retain the contaction level for each node from the last run.")(
+        "cch",
+        boost::program_options::value<bool>(&contractor_config.use_cch)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Build a metric-independent Customizable Contraction Hierarchy (.cch), which "
+        "osrm-customize can re-weight without contracting again")(
+        "mld",
+        boost::program_options::value<bool>(&contractor_config.use_mld)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Partition the graph for Multi-Level Dijkstra queries (.partition, .cells, .cell_metrics) "
+        "instead of contracting it, osrm-customize re-weights the cells")(
+        "max-cell-size",
+        boost::program_options::value<unsigned>(&contractor_config.max_cell_size)
+            ->default_value(128),
+        "Use with `--mld`. Maximal number of nodes in the cells of the lowest level")(
+        "eager-compaction",
+        boost::program_options::value<bool>(&contractor_config.eager_compaction)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Compact the contracted nodes out of the graph whenever half of its nodes are "
+        "contracted and log the peak resident memory. The input is still read as a whole, the "
+        "memory use is not bounded")(
+        "checkpoint-interval",
+        boost::program_options::value<unsigned>(&contractor_config.checkpoint_interval)
+            ->default_value(0),
+        "Minutes between checkpoints of the contraction (.checkpoint), 0 disables them")(
+        "resume",
+        boost::program_options::value<bool>(&contractor_config.resume)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Continue the contraction from the last checkpoint of an interrupted run")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(&contractor_config.log_edge_updates_factor)
             ->default_value(0.0),
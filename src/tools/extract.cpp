@@ -1,6 +1,7 @@
 #include "extractor/extractor.hpp"
 #include "extractor/extractor_config.hpp"
 #include "extractor/scripting_environment_lua.hpp"
+#include "extractor/scripting_environment_plugin.hpp"
 #include "util/simple_logger.hpp"
 #include "util/version.hpp"
 
@@ -11,7 +12,11 @@
 
 #include <cstdlib>
 #include <exception>
+#include <memory>
 #include <new>
+#include <set>
+#include <string>
+#include <vector>
 
 using namespace osrm;
 
@@ -22,7 +27,10 @@ enum class return_code : unsigned
     exit
 };
 
-return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &extractor_config)
+return_code parseArguments(int argc,
+                           char *argv[],
+                           extractor::ExtractorConfig &extractor_config,
+                           std::vector<boost::filesystem::path> &profile_paths)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -32,9 +40,12 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
     boost::program_options::options_description config_options("Configuration");
     config_options.add_options()(
         "profile,p",
-        boost::program_options::value<boost::filesystem::path>(&extractor_config.profile_path)
-            ->default_value("profile.lua"),
-        "Path to LUA routing profile")(
+        boost::program_options::value<std::vector<boost::filesystem::path>>(&profile_paths)
+            ->composing()
+            ->default_value({"profile.lua"}, "profile.lua"),
+        "Path to LUA routing profile or compiled profile library. Given several times, the "
+        "datasets of all profiles are extracted with one pass over the input and named "
+        "<input>.<profile>.osrm")(
         "threads,t",
         boost::program_options::value<unsigned int>(&extractor_config.requested_num_threads)
             ->default_value(tbb::task_scheduler_init::default_num_threads()),
@@ -43,12 +54,32 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         boost::program_options::value<bool>(&extractor_config.generate_edge_lookup)
             ->implicit_value(true)
             ->default_value(false),
-        "Generate a lookup table for internal edge-expanded-edge IDs to OSM node pairs")(
+        "Generate a lookup table for internal edge-expanded-edge IDs to OSM node pairs and the "
+        "index osrm-contract uses for traffic updates")(
         "small-component-size",
         boost::program_options::value<unsigned int>(&extractor_config.small_component_size)
             ->default_value(1000),
         "Number of nodes required before a strongly-connected-componennt is considered big "
-        "(affects nearest neighbor snapping)");
+        "(affects nearest neighbor snapping)")(
+        "turn-penalty-table",
+        boost::program_options::value<bool>(&extractor_config.use_turn_penalty_table)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Sample the turn function into a table even if the profile does not set "
+        "turn_function_is_pure")(
+        "validate-turn-penalty-table",
+        boost::program_options::value<unsigned int>(
+            &extractor_config.turn_penalty_validation_samples)
+            ->implicit_value(100000)
+            ->default_value(0),
+        "Compare the turn penalty table with the turn function on every sample and this many "
+        "random angles, only logs the differences")(
+        "external-memory",
+        boost::program_options::value<bool>(&extractor_config.use_external_memory)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Always sort the extracted nodes, edges and restrictions on disk with stxxl, by default "
+        "they are sorted in RAM if they fit");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
@@ -115,8 +146,9 @@ int main(int argc, char *argv[]) try
 {
     util::LogPolicy::GetInstance().Unmute();
     extractor::ExtractorConfig extractor_config;
+    std::vector<boost::filesystem::path> profile_paths;
 
-    const auto result = parseArguments(argc, argv, extractor_config);
+    const auto result = parseArguments(argc, argv, extractor_config, profile_paths);
 
     if (return_code::fail == result)
     {
@@ -128,8 +160,6 @@ int main(int argc, char *argv[]) try
         return EXIT_SUCCESS;
     }
 
-    extractor_config.UseDefaultOutputNames();
-
     if (1 > extractor_config.requested_num_threads)
     {
         util::SimpleLogger().Write(logWARNING) << "Number of threads must be 1 or larger";
@@ -143,17 +173,59 @@ int main(int argc, char *argv[]) try
         return EXIT_FAILURE;
     }
 
-    if (!boost::filesystem::is_regular_file(extractor_config.profile_path))
+    std::vector<extractor::Extractor> extractors;
+    std::vector<std::unique_ptr<extractor::ScriptingEnvironment>> scripting_environments;
+    std::set<std::string> dataset_names;
+    for (const auto &path : profile_paths)
     {
-        util::SimpleLogger().Write(logWARNING)
-            << "Profile " << extractor_config.profile_path.string() << " not found!";
-        return EXIT_FAILURE;
+        if (!boost::filesystem::is_regular_file(path))
+        {
+            util::SimpleLogger().Write(logWARNING) << "Profile " << path.string()
+                                                   << " not found!";
+            return EXIT_FAILURE;
+        }
+
+        // with several profiles the outputs are named after the profile, e.g. map.car.osrm
+        const auto dataset_name = profile_paths.size() > 1 ? path.stem().string() : "";
+        if (!dataset_names.insert(dataset_name).second)
+        {
+            util::SimpleLogger().Write(logWARNING) << "Profile names must be unique, "
+                                                   << path.string() << " is given twice";
+            return EXIT_FAILURE;
+        }
+
+        auto profile_config = extractor_config;
+        profile_config.profile_path = path;
+        profile_config.UseDefaultOutputNames(dataset_name);
+        extractors.emplace_back(std::move(profile_config));
+
+        // setup scripting environment, profiles are either Lua scripts or compiled libraries
+        const auto profile_path = path.string();
+        if (extractor::PluginScriptingEnvironment::IsPlugin(profile_path))
+        {
+            scripting_environments.emplace_back(
+                new extractor::PluginScriptingEnvironment(profile_path));
+        }
+        else
+        {
+            scripting_environments.emplace_back(
+                new extractor::LuaScriptingEnvironment(profile_path.c_str()));
+        }
+    }
+
+    if (extractors.size() == 1)
+    {
+        return extractors.front().run(*scripting_environments.front());
     }
 
-    // setup scripting environment
-    extractor::LuaScriptingEnvironment scripting_environment(
-        extractor_config.profile_path.string().c_str());
-    return extractor::Extractor(extractor_config).run(scripting_environment);
+    std::vector<extractor::Extractor *> extractor_pointers;
+    std::vector<extractor::ScriptingEnvironment *> scripting_environment_pointers;
+    for (std::size_t profile = 0; profile < extractors.size(); ++profile)
+    {
+        extractor_pointers.push_back(&extractors[profile]);
+        scripting_environment_pointers.push_back(scripting_environments[profile].get());
+    }
+    return extractor::Extractor::run(extractor_pointers, scripting_environment_pointers);
 }
 catch (const std::bad_alloc &e)
 {
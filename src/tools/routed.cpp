@@ -25,6 +25,7 @@
 #include <new>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -59,12 +60,17 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              int &ip_port,
                                              int &requested_num_threads,
                                              bool &use_shared_memory,
+                                             bool &use_huge_pages,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
-                                             int &max_results_nearest)
+                                             int &max_results_nearest,
+                                             int &max_heap_size,
+                                             std::vector<std::string> &services,
+                                             std::string &algorithm,
+                                             bool &enable_admin_service)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -90,6 +96,9 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("use-huge-pages",
+         value<bool>(&use_huge_pages)->implicit_value(true)->default_value(false),
+         "Back data loaded into process memory with transparent huge pages") //
         ("max-viaroute-size",
          value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
@@ -104,7 +113,21 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&max_results_nearest)->default_value(100),
-         "Max. results supported in nearest query");
+         "Max. results supported in nearest query") //
+        ("max-heap-size",
+         value<int>(&max_heap_size)->default_value(-1),
+         "Max. MiB a query heap keeps between queries, larger heaps are released") //
+        ("services",
+         value<std::vector<std::string>>(&services)->multitoken(),
+         "Services that are expected to be queried (route, table, nearest, trip, match, tile). "
+         "Data only needed by other services is loaded on first use") //
+        ("algorithm,a",
+         value<std::string>(&algorithm)->default_value("CH"),
+         "Algorithm the dataset was prepared for: CH (osrm-contract) or MLD (osrm-contract "
+         "--mld)") //
+        ("admin",
+         value<bool>(&enable_admin_service)->implicit_value(true)->default_value(false),
+         "Serve reports about the running instance, e.g. /admin/v1/driving/memory");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -154,6 +177,21 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    for (const auto &service : services)
+    {
+        if (!engine::ParseServiceName(service))
+        {
+            util::SimpleLogger().Write(logWARNING) << "[error] unknown service " << service;
+            return INIT_FAILED;
+        }
+    }
+
+    if (algorithm != "CH" && algorithm != "MLD")
+    {
+        util::SimpleLogger().Write(logWARNING) << "[error] unknown algorithm " << algorithm;
+        return INIT_FAILED;
+    }
+
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -177,7 +215,9 @@ int main(int argc, const char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
 
     bool trial_run = false;
+    bool enable_admin_service = false;
     std::string ip_address;
+    std::string algorithm;
     int ip_port, requested_thread_num;
 
     EngineConfig config;
@@ -189,12 +229,17 @@ int main(int argc, const char *argv[]) try
                                                               ip_port,
                                                               requested_thread_num,
                                                               config.use_shared_memory,
+                                                              config.use_huge_pages,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
-                                                              config.max_results_nearest);
+                                                              config.max_results_nearest,
+                                                              config.max_heap_size,
+                                                              config.services,
+                                                              algorithm,
+                                                              enable_admin_service);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -207,6 +252,8 @@ int main(int argc, const char *argv[]) try
     {
         config.storage_config = storage::StorageConfig(base_path);
     }
+    config.algorithm =
+        algorithm == "MLD" ? EngineConfig::Algorithm::MLD : EngineConfig::Algorithm::CH;
     if (!config.IsValid())
     {
         if (base_path.empty() != config.use_shared_memory)
@@ -284,7 +331,10 @@ int main(int argc, const char *argv[]) try
     {
         explicit MemoryLocker(bool should_lock) : should_lock(should_lock)
         {
-            if (should_lock && -1 == mlockall(MCL_CURRENT | MCL_FUTURE))
+            // The shared data facade locks the pinned blocks of each dataset it loads if this
+            // succeeds. Locking future mappings would pin the evictable blocks of a tiered
+            // dataset as well.
+            if (should_lock && -1 == mlockall(MCL_CURRENT))
             {
                 could_lock = false;
                 util::SimpleLogger().Write(logWARNING) << "memory could not be locked to RAM";
@@ -297,6 +347,8 @@ int main(int argc, const char *argv[]) try
         }
         bool should_lock = false, could_lock = true;
     } memory_locker(config.use_shared_memory);
+    // the datasets in shared memory are only locked if the memory of osrm-routed could be locked
+    config.lock_memory = memory_locker.should_lock && memory_locker.could_lock;
 #endif
     util::SimpleLogger().Write() << "starting up engines, " << OSRM_VERSION;
 
@@ -318,7 +370,8 @@ int main(int argc, const char *argv[]) try
 #endif
 
     auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
-    auto service_handler = std::make_unique<server::ServiceHandler>(config);
+    auto service_handler =
+        std::make_unique<server::ServiceHandler>(config, enable_admin_service);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
 
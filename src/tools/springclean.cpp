@@ -4,6 +4,8 @@
 #include "storage/shared_memory.hpp"
 #include "util/simple_logger.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 namespace osrm
 {
 namespace tools
@@ -38,6 +40,12 @@ void deleteRegion(const SharedDataType region)
 
         util::SimpleLogger().Write(logWARNING) << "could not delete shared memory region " << name;
     }
+
+    if (region == DATA_1 || region == DATA_2)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(mappedBlocksPath(region), ec);
+    }
 }
 
 // find all existing shmem regions and remove them.
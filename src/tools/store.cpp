@@ -7,13 +7,19 @@
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <cstdint>
+#include <string>
+
 using namespace osrm;
 
 // generate boost::program_options object for the routing part
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &use_huge_pages,
+                              unsigned &huge_page_size_mib,
+                              std::string &residency)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -25,7 +31,19 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()(
         "max-wait",
         boost::program_options::value<int>(&max_wait)->default_value(-1),
-        "Maximum number of seconds to wait on requests that use the old dataset.");
+        "Maximum number of seconds to wait on requests that use the old dataset.")(
+        "use-huge-pages",
+        boost::program_options::value<bool>(&use_huge_pages)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Back the dataset with huge pages, falls back to regular pages if none are available")(
+        "huge-page-size",
+        boost::program_options::value<unsigned>(&huge_page_size_mib)->default_value(2),
+        "Size of the huge pages in MiB: 2 or 1024")(
+        "residency",
+        boost::program_options::value<std::string>(&residency)->default_value("pinned"),
+        "Memory residency of the dataset: pinned (all in RAM) or tiered (names, bearings and "
+        "lane data are file backed and may be evicted)");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -84,6 +102,18 @@ bool generateDataStoreOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if (use_huge_pages && huge_page_size_mib != 2 && huge_page_size_mib != 1024)
+    {
+        util::SimpleLogger().Write(logWARNING) << "[error] huge page size needs to be 2 or 1024";
+        return false;
+    }
+
+    if (residency != "pinned" && residency != "tiered")
+    {
+        util::SimpleLogger().Write(logWARNING) << "[error] residency needs to be pinned or tiered";
+        return false;
+    }
+
     return true;
 }
 
@@ -93,7 +123,11 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    bool use_huge_pages = false;
+    unsigned huge_page_size_mib = 2;
+    std::string residency;
+    if (!generateDataStoreOptions(
+            argc, argv, base_path, max_wait, use_huge_pages, huge_page_size_mib, residency))
     {
         return EXIT_SUCCESS;
     }
@@ -103,7 +137,12 @@ int main(const int argc, const char *argv[]) try
         util::SimpleLogger().Write(logWARNING) << "Config contains invalid file paths. Exiting!";
         return EXIT_FAILURE;
     }
-    storage::Storage storage(std::move(config));
+    const std::uint64_t huge_page_size =
+        use_huge_pages ? std::uint64_t{huge_page_size_mib} * 1024 * 1024 : 0;
+    const auto residency_policy = residency == "tiered"
+                                      ? storage::Storage::ResidencyPolicy::Tiered
+                                      : storage::Storage::ResidencyPolicy::Pinned;
+    storage::Storage storage(std::move(config), huge_page_size, residency_policy);
 
     // We will attempt to load this dataset to memory several times if we encounter
     // an error we can recover from. This is needed when we need to clear mutexes
@@ -0,0 +1,126 @@
+#include "contractor/customizable_contraction_hierarchy.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/exception.hpp"
+#include "util/typedefs.hpp"
+
+#include "graph_helper.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(customizable_contraction_hierarchy)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+BOOST_AUTO_TEST_CASE(order_test)
+{
+    const NodeID width = 8;
+    const auto edges = makeGrid(width, [](NodeID, NodeID) { return 1; });
+    const CustomizableContractionHierarchy hierarchy(width * width + 2, edges);
+
+    BOOST_CHECK_EQUAL(hierarchy.GetNumberOfNodes(), width * width + 2);
+    std::vector<NodeID> ranks;
+    for (NodeID node = 0; node < hierarchy.GetNumberOfNodes(); ++node)
+    {
+        ranks.push_back(hierarchy.GetRank(node));
+    }
+    std::sort(ranks.begin(), ranks.end());
+    for (NodeID rank = 0; rank < ranks.size(); ++rank)
+    {
+        BOOST_CHECK_EQUAL(ranks[rank], rank);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(customization_test)
+{
+    const NodeID width = 8;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges =
+        makeGrid(width, [](NodeID source, NodeID target) { return 1 + (source * 7 + target) % 5; });
+    const CustomizableContractionHierarchy hierarchy(number_of_nodes, edges);
+
+    util::DeallocatingVector<QueryEdge> contracted_edges;
+    hierarchy.Customize(edges, std::vector<EdgeWeight>(number_of_nodes, 100), contracted_edges);
+    checkDistances(number_of_nodes, edges, contracted_edges);
+}
+
+BOOST_AUTO_TEST_CASE(recustomization_test)
+{
+    const NodeID width = 8;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges = makeGrid(width, [](NodeID, NodeID) { return 10; });
+    const CustomizableContractionHierarchy hierarchy(number_of_nodes, edges);
+
+    const auto topology_path = boost::filesystem::unique_path().string();
+    hierarchy.Write(topology_path);
+    const CustomizableContractionHierarchy read_hierarchy(topology_path);
+    boost::filesystem::remove(topology_path);
+    BOOST_CHECK_EQUAL(read_hierarchy.GetNumberOfArcs(), hierarchy.GetNumberOfArcs());
+
+    // a traffic jam on the middle rows
+    const auto updated_edges = makeGrid(width, [width](NodeID source, NodeID) {
+        return source / width == width / 2 ? 100 : 10;
+    });
+    util::DeallocatingVector<QueryEdge> contracted_edges;
+    read_hierarchy.Customize(
+        updated_edges, std::vector<EdgeWeight>(number_of_nodes, 10), contracted_edges);
+    checkDistances(number_of_nodes, updated_edges, contracted_edges);
+}
+
+BOOST_AUTO_TEST_CASE(unknown_edge_test)
+{
+    const NodeID width = 4;
+    const auto edges = makeGrid(width, [](NodeID, NodeID) { return 1; });
+    const CustomizableContractionHierarchy hierarchy(width * width + 2, edges);
+    const std::vector<EdgeWeight> node_weights(width * width + 2, 1);
+
+    EdgeList changed_edges = makeGrid(width, [](NodeID, NodeID) { return 1; });
+    changed_edges.push_back({0, width * width + 1, 0, 1, true, false});
+    util::DeallocatingVector<QueryEdge> contracted_edges;
+    BOOST_CHECK_THROW(hierarchy.Customize(changed_edges, node_weights, contracted_edges),
+                      util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(loop_test)
+{
+    // 0 <-> 1, the higher node can turn around at the lower one
+    EdgeList edges;
+    edges.push_back({0, 1, 0, 3, true, false});
+    edges.push_back({1, 0, 1, 4, true, false});
+    const CustomizableContractionHierarchy hierarchy(2, edges);
+    const NodeID lower_node = hierarchy.GetRank(0) < hierarchy.GetRank(1) ? 0 : 1;
+    const NodeID higher_node = 1 - lower_node;
+
+    const auto is_loop = [](const QueryEdge &edge) { return edge.source == edge.target; };
+    const auto count_loops = [&](const util::DeallocatingVector<QueryEdge> &contracted_edges) {
+        return std::count_if(contracted_edges.begin(), contracted_edges.end(), is_loop);
+    };
+
+    // the loop is shorter than the segment of the lower node
+    util::DeallocatingVector<QueryEdge> contracted_edges;
+    hierarchy.Customize(edges, {100, 100}, contracted_edges);
+    BOOST_REQUIRE_EQUAL(count_loops(contracted_edges), 1);
+    const auto loop = std::find_if(contracted_edges.begin(), contracted_edges.end(), is_loop);
+    BOOST_CHECK_EQUAL(loop->source, higher_node);
+    BOOST_CHECK_EQUAL(loop->data.weight, 7);
+    BOOST_CHECK_EQUAL(loop->data.id, lower_node);
+    BOOST_CHECK(loop->data.shortcut);
+    BOOST_CHECK(loop->data.forward && loop->data.backward);
+    checkDistances(2, edges, contracted_edges);
+
+    // like the contractor, longer loops are not kept
+    util::DeallocatingVector<QueryEdge> short_segment_edges;
+    hierarchy.Customize(edges, {5, 5}, short_segment_edges);
+    BOOST_CHECK_EQUAL(count_loops(short_segment_edges), 0);
+    checkDistances(2, edges, short_segment_edges);
+
+    BOOST_CHECK_THROW(hierarchy.Customize(edges, {100}, contracted_edges), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,222 @@
+#include "contractor/graph_contractor.hpp"
+#include "contractor/query_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include "graph_helper.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(graph_contractor)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+const static std::string CHECKPOINT_TMP_FILE = "test_graph_contractor.checkpoint";
+const static std::string INTERRUPTED_CHECKPOINT_TMP_FILE =
+    "test_graph_contractor_interrupted.checkpoint";
+
+util::DeallocatingVector<QueryEdge>
+contract(const NodeID number_of_nodes,
+         const EdgeList &edges,
+         const bool eager_compaction,
+         const bool checkpoint = false,
+         const bool resume = false,
+         const std::uint64_t input_fingerprint = 0,
+         const std::function<void(unsigned)> &checkpoint_handler = nullptr)
+{
+    // the contractor frees the blocks of its input, a copy of the list would share them
+    EdgeList input_edges;
+    for (const auto &edge : edges)
+    {
+        input_edges.push_back(edge);
+    }
+    GraphContractor contractor(number_of_nodes,
+                               input_edges,
+                               std::vector<float>{},
+                               std::vector<EdgeWeight>(number_of_nodes, 1));
+    if (checkpoint || resume)
+    {
+        // a checkpoint at every level
+        contractor.SetCheckpoint(
+            CHECKPOINT_TMP_FILE, std::chrono::nanoseconds(1), resume, input_fingerprint);
+        contractor.SetCheckpointHandler(checkpoint_handler);
+    }
+    contractor.Run(1.0, eager_compaction);
+
+    util::DeallocatingVector<QueryEdge> contracted_edges;
+    contractor.GetEdges(contracted_edges);
+    return contracted_edges;
+}
+}
+
+BOOST_AUTO_TEST_CASE(contraction_test)
+{
+    const NodeID width = 8;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges =
+        makeGrid(width, [](NodeID source, NodeID target) { return 1 + (source * 7 + target) % 5; });
+
+    checkDistances(number_of_nodes, edges, contract(number_of_nodes, edges, false));
+}
+
+BOOST_AUTO_TEST_CASE(eager_compaction_test)
+{
+    // the graph is renumbered several times
+    const NodeID width = 16;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges =
+        makeGrid(width, [](NodeID source, NodeID target) { return 1 + (source * 3 + target) % 7; });
+
+    const auto contracted_edges = contract(number_of_nodes, edges, true);
+    checkDistances(number_of_nodes, edges, contracted_edges);
+
+    // The middle nodes of the shortcuts are translated across the renumberings. The renumberings
+    // change the ties of the node order, so the shortcuts differ from those of a normal
+    // contraction, but the unpacked paths between all nodes have the same weights.
+    const auto weights = unpackPaths(number_of_nodes, edges, contracted_edges);
+    const auto expected_weights =
+        unpackPaths(number_of_nodes, edges, contract(number_of_nodes, edges, false));
+    BOOST_CHECK(weights == expected_weights);
+}
+
+BOOST_AUTO_TEST_CASE(resume_contraction_test)
+{
+    const NodeID width = 12;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges =
+        makeGrid(width, [](NodeID source, NodeID target) { return 1 + (source * 5 + target) % 3; });
+
+    // the last checkpoint of a complete run is left behind, resuming continues from there
+    for (const bool eager : {false, true})
+    {
+        boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+        contract(number_of_nodes, edges, eager, true, false);
+        BOOST_REQUIRE(boost::filesystem::exists(CHECKPOINT_TMP_FILE));
+
+        checkDistances(
+            number_of_nodes, edges, contract(number_of_nodes, edges, eager, false, true));
+    }
+    boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+
+    // without a checkpoint the contraction starts from scratch
+    checkDistances(number_of_nodes, edges, contract(number_of_nodes, edges, false, false, true));
+    boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+}
+
+BOOST_AUTO_TEST_CASE(resume_interrupted_contraction_test)
+{
+    const NodeID width = 12;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges =
+        makeGrid(width, [](NodeID source, NodeID target) { return 1 + (source * 5 + target) % 3; });
+
+    for (const bool eager : {false, true})
+    {
+        for (const unsigned interrupted_level : {1u, 4u, 8u})
+        {
+            // keep the checkpoint of the level as if the contraction was interrupted after it
+            boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+            boost::filesystem::remove(INTERRUPTED_CHECKPOINT_TMP_FILE);
+            const auto uninterrupted_edges =
+                contract(number_of_nodes, edges, eager, true, false, 0, [&](unsigned level) {
+                    if (level == interrupted_level)
+                    {
+                        boost::filesystem::copy_file(CHECKPOINT_TMP_FILE,
+                                                     INTERRUPTED_CHECKPOINT_TMP_FILE);
+                    }
+                });
+            BOOST_REQUIRE(boost::filesystem::exists(INTERRUPTED_CHECKPOINT_TMP_FILE));
+            boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+            boost::filesystem::copy_file(INTERRUPTED_CHECKPOINT_TMP_FILE, CHECKPOINT_TMP_FILE);
+
+            // the first checkpoint after resuming is the one of the interrupted level
+            unsigned first_resumed_level = 0;
+            bool resumed = false;
+            const auto resumed_edges =
+                contract(number_of_nodes, edges, eager, false, true, 0, [&](unsigned level) {
+                    if (!resumed)
+                    {
+                        first_resumed_level = level;
+                        resumed = true;
+                    }
+                });
+            BOOST_CHECK_EQUAL(first_resumed_level, interrupted_level);
+            checkDistances(number_of_nodes, edges, resumed_edges);
+            // the order of the edges in the graph differs after resuming, so the shortcuts are
+            // not the same but they unpack to paths of the same weights
+            BOOST_CHECK(unpackPaths(number_of_nodes, edges, resumed_edges) ==
+                        unpackPaths(number_of_nodes, edges, uninterrupted_edges));
+        }
+    }
+
+    // the checkpoint of other input files or options is rejected
+    boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+    boost::filesystem::copy_file(INTERRUPTED_CHECKPOINT_TMP_FILE, CHECKPOINT_TMP_FILE);
+    BOOST_CHECK_THROW(contract(number_of_nodes, edges, true, false, true, 42), util::exception);
+    BOOST_CHECK_THROW(contract(number_of_nodes, edges, false, false, true), util::exception);
+
+    boost::filesystem::remove(CHECKPOINT_TMP_FILE);
+    boost::filesystem::remove(INTERRUPTED_CHECKPOINT_TMP_FILE);
+}
+
+// The witness of the shortcut over v is a chain of chain_length edges, the witness search only
+// finds it within its hop limit of 5 edges. Otherwise the contractor adds the shortcut, which
+// is not needed but keeps the distances correct.
+BOOST_AUTO_TEST_CASE(hop_limited_witness_search_test)
+{
+    const NodeID u = 0, v = 1, w = 2;
+    for (const NodeID chain_length : {3u, 12u})
+    {
+        const NodeID number_of_nodes = 3 + chain_length - 1;
+        const auto make_edges = [&] {
+            EdgeList edges;
+            NodeID edge_id = 0;
+            edges.push_back({u, v, edge_id++, 10, true, false});
+            edges.push_back({v, w, edge_id++, 10, true, false});
+            for (NodeID node = 3; node <= number_of_nodes; ++node)
+            {
+                const NodeID source = node == 3 ? u : node - 1;
+                const NodeID target = node == number_of_nodes ? w : node;
+                edges.push_back({source, target, edge_id++, 1, true, false});
+            }
+            return edges;
+        };
+        const EdgeList edges = make_edges();
+        // the contractor frees the blocks of its input
+        EdgeList input_edges = make_edges();
+
+        // v is contracted first, the other nodes keep the order of their ids
+        std::vector<float> node_levels(number_of_nodes);
+        for (NodeID node = 0; node < number_of_nodes; ++node)
+        {
+            node_levels[node] = node == v ? 0 : node + 1;
+        }
+        GraphContractor contractor(number_of_nodes,
+                                   input_edges,
+                                   std::move(node_levels),
+                                   std::vector<EdgeWeight>(number_of_nodes, 1));
+        contractor.Run();
+        util::DeallocatingVector<QueryEdge> contracted_edges;
+        contractor.GetEdges(contracted_edges);
+
+        const auto shortcut_over_v = std::find_if(
+            contracted_edges.begin(), contracted_edges.end(), [v](const QueryEdge &edge) {
+                return edge.data.shortcut && edge.data.id == v;
+            });
+        BOOST_CHECK_EQUAL(shortcut_over_v != contracted_edges.end(), chain_length > 5);
+        checkDistances(number_of_nodes, edges, contracted_edges);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,287 @@
+#ifndef OSRM_UNIT_TEST_CONTRACTOR_GRAPH_HELPER
+#define OSRM_UNIT_TEST_CONTRACTOR_GRAPH_HELPER
+
+// Test graphs and a brute force check of contracted graphs for the contractor tests
+
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using EdgeList = osrm::util::DeallocatingVector<osrm::extractor::EdgeBasedEdge>;
+using Adjacency = std::vector<std::vector<std::pair<NodeID, EdgeWeight>>>;
+
+// A grid of width * width nodes with one-way streets in every third row and a separate
+// component of two nodes
+inline EdgeList makeGrid(const NodeID width,
+                         const std::function<EdgeWeight(NodeID, NodeID)> &weight)
+{
+    EdgeList edges;
+    NodeID edge_id = 0;
+    const auto add_edge = [&](const NodeID source, const NodeID target, const bool oneway) {
+        edges.push_back({source, target, edge_id++, weight(source, target), true, false});
+        if (!oneway)
+        {
+            edges.push_back({target, source, edge_id++, weight(target, source), true, false});
+        }
+    };
+    for (NodeID row = 0; row < width; ++row)
+    {
+        for (NodeID column = 0; column < width; ++column)
+        {
+            const NodeID node = row * width + column;
+            if (column + 1 < width)
+            {
+                add_edge(node, node + 1, row % 3 == 1);
+            }
+            if (row + 1 < width)
+            {
+                add_edge(node, node + width, false);
+            }
+        }
+    }
+    add_edge(width * width, width * width + 1, false);
+    return edges;
+}
+
+// Distances from the source, parents receives the node before every node on its shortest path
+inline std::vector<EdgeWeight> dijkstra(const Adjacency &adjacency,
+                                        const NodeID source,
+                                        std::vector<NodeID> *parents = nullptr)
+{
+    std::vector<EdgeWeight> distance(adjacency.size(), INVALID_EDGE_WEIGHT);
+    if (parents)
+    {
+        parents->assign(adjacency.size(), SPECIAL_NODEID);
+    }
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distance[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto entry = queue.top();
+        queue.pop();
+        if (entry.first > distance[entry.second])
+        {
+            continue;
+        }
+        for (const auto &edge : adjacency[entry.second])
+        {
+            if (entry.first + edge.second < distance[edge.first])
+            {
+                distance[edge.first] = entry.first + edge.second;
+                queue.emplace(distance[edge.first], edge.first);
+                if (parents)
+                {
+                    (*parents)[edge.first] = entry.second;
+                }
+            }
+        }
+    }
+    return distance;
+}
+
+// Compares all distances of the contraction hierarchy to the ones in the original graph
+inline void
+checkDistances(const NodeID number_of_nodes,
+               const EdgeList &edges,
+               const osrm::util::DeallocatingVector<osrm::contractor::QueryEdge> &contracted_edges)
+{
+    Adjacency original(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        original[edge.source].emplace_back(edge.target, edge.weight);
+    }
+
+    // all edges point upwards, so searching from both ends on the stored edges finds all
+    // up-down paths
+    Adjacency forward_upward(number_of_nodes);
+    Adjacency backward_upward(number_of_nodes);
+    for (const auto &edge : contracted_edges)
+    {
+        BOOST_CHECK_GT(edge.data.weight, 0);
+        if (edge.data.forward)
+        {
+            forward_upward[edge.source].emplace_back(edge.target, edge.data.weight);
+        }
+        if (edge.data.backward)
+        {
+            backward_upward[edge.source].emplace_back(edge.target, edge.data.weight);
+        }
+    }
+
+    std::vector<std::vector<EdgeWeight>> backward_distances;
+    for (NodeID target = 0; target < number_of_nodes; ++target)
+    {
+        backward_distances.push_back(dijkstra(backward_upward, target));
+    }
+
+    for (NodeID source = 0; source < number_of_nodes; ++source)
+    {
+        const auto expected = dijkstra(original, source);
+        const auto forward = dijkstra(forward_upward, source);
+        for (NodeID target = 0; target < number_of_nodes; ++target)
+        {
+            EdgeWeight distance = INVALID_EDGE_WEIGHT;
+            for (NodeID middle = 0; middle < number_of_nodes; ++middle)
+            {
+                if (forward[middle] != INVALID_EDGE_WEIGHT &&
+                    backward_distances[target][middle] != INVALID_EDGE_WEIGHT)
+                {
+                    distance =
+                        std::min(distance, forward[middle] + backward_distances[target][middle]);
+                }
+            }
+            BOOST_CHECK_EQUAL(distance, expected[target]);
+        }
+    }
+}
+
+// Unpacks every shortcut through its middle nodes down to the edges of the original graph and
+// checks that they form a path of the weight of the shortcut. Then unpacks the shortest path of
+// the contracted graph between every pair of nodes the same way and returns the weights of the
+// unpacked paths, INVALID_EDGE_WEIGHT if there is none.
+inline std::vector<std::vector<EdgeWeight>>
+unpackPaths(const NodeID number_of_nodes,
+            const EdgeList &edges,
+            const osrm::util::DeallocatingVector<osrm::contractor::QueryEdge> &contracted_edges)
+{
+    using EdgeData = osrm::contractor::QueryEdge::EdgeData;
+
+    // the lightest edge from a node to another one, like the unpacking of the queries
+    std::map<std::pair<NodeID, NodeID>, EdgeData> lightest_edges;
+    const auto add_edge = [&](const NodeID from, const NodeID to, const EdgeData &data) {
+        const auto inserted = lightest_edges.insert({{from, to}, data});
+        if (!inserted.second && data.weight < inserted.first->second.weight)
+        {
+            inserted.first->second = data;
+        }
+    };
+    Adjacency forward_upward(number_of_nodes);
+    Adjacency backward_upward(number_of_nodes);
+    for (const auto &edge : contracted_edges)
+    {
+        if (edge.data.forward)
+        {
+            add_edge(edge.source, edge.target, edge.data);
+            forward_upward[edge.source].emplace_back(edge.target, edge.data.weight);
+        }
+        if (edge.data.backward)
+        {
+            add_edge(edge.target, edge.source, edge.data);
+            backward_upward[edge.source].emplace_back(edge.target, edge.data.weight);
+        }
+    }
+
+    // the ids of the original edges are not compared, the contractor keeps one id for merged
+    // parallel edges
+    std::map<std::pair<NodeID, NodeID>, EdgeWeight> original_weights;
+    for (const auto &edge : edges)
+    {
+        const auto inserted = original_weights.insert({{edge.source, edge.target}, edge.weight});
+        inserted.first->second = std::min<EdgeWeight>(inserted.first->second, edge.weight);
+    }
+
+    std::function<void(NodeID, NodeID, std::vector<NodeID> &)> unpack =
+        [&](const NodeID from, const NodeID to, std::vector<NodeID> &path) {
+            const auto edge = lightest_edges.find({from, to});
+            BOOST_REQUIRE(edge != lightest_edges.end());
+            if (edge->second.shortcut)
+            {
+                const NodeID middle = edge->second.id;
+                BOOST_REQUIRE(middle != from && middle != to);
+                unpack(from, middle, path);
+                unpack(middle, to, path);
+            }
+            else
+            {
+                path.push_back(to);
+            }
+        };
+    const auto path_weight = [&](const std::vector<NodeID> &path) {
+        EdgeWeight weight = 0;
+        for (std::size_t index = 1; index < path.size(); ++index)
+        {
+            const auto original = original_weights.find({path[index - 1], path[index]});
+            BOOST_REQUIRE(original != original_weights.end());
+            weight += original->second;
+        }
+        return weight;
+    };
+
+    for (const auto &edge : lightest_edges)
+    {
+        if (edge.second.shortcut)
+        {
+            std::vector<NodeID> path{edge.first.first};
+            unpack(edge.first.first, edge.first.second, path);
+            BOOST_CHECK_EQUAL(path_weight(path), edge.second.weight);
+        }
+    }
+
+    std::vector<std::vector<NodeID>> backward_parents(number_of_nodes);
+    std::vector<std::vector<EdgeWeight>> backward_distances;
+    for (NodeID target = 0; target < number_of_nodes; ++target)
+    {
+        backward_distances.push_back(dijkstra(backward_upward, target, &backward_parents[target]));
+    }
+
+    std::vector<std::vector<EdgeWeight>> weights(number_of_nodes);
+    std::vector<NodeID> forward_parents;
+    for (NodeID source = 0; source < number_of_nodes; ++source)
+    {
+        const auto forward = dijkstra(forward_upward, source, &forward_parents);
+        for (NodeID target = 0; target < number_of_nodes; ++target)
+        {
+            EdgeWeight distance = INVALID_EDGE_WEIGHT;
+            NodeID middle = SPECIAL_NODEID;
+            for (NodeID node = 0; node < number_of_nodes; ++node)
+            {
+                if (forward[node] != INVALID_EDGE_WEIGHT &&
+                    backward_distances[target][node] != INVALID_EDGE_WEIGHT &&
+                    forward[node] + backward_distances[target][node] < distance)
+                {
+                    distance = forward[node] + backward_distances[target][node];
+                    middle = node;
+                }
+            }
+            if (middle == SPECIAL_NODEID)
+            {
+                weights[source].push_back(INVALID_EDGE_WEIGHT);
+                continue;
+            }
+
+            std::vector<NodeID> packed_path{middle};
+            for (NodeID node = middle; node != source; node = forward_parents[node])
+            {
+                packed_path.push_back(forward_parents[node]);
+            }
+            std::reverse(packed_path.begin(), packed_path.end());
+            for (NodeID node = middle; node != target; node = backward_parents[target][node])
+            {
+                packed_path.push_back(backward_parents[target][node]);
+            }
+
+            std::vector<NodeID> path{source};
+            for (std::size_t index = 1; index < packed_path.size(); ++index)
+            {
+                unpack(packed_path[index - 1], packed_path[index], path);
+            }
+            BOOST_CHECK_EQUAL(path.back(), target);
+            weights[source].push_back(path_weight(path));
+        }
+    }
+    return weights;
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "contractor/cell_customizer.hpp"
+#include "contractor/cell_storage.hpp"
+#include "contractor/graph_partitioner.hpp"
+#include "contractor/multi_level_partition.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(multi_level_partition)
+
+using namespace osrm;
+using namespace osrm::contractor;
+using EdgeList = util::DeallocatingVector<extractor::EdgeBasedEdge>;
+
+namespace
+{
+
+// A grid of width * width nodes with one-way streets in every third row and a separate
+// component of two nodes
+EdgeList makeGrid(const NodeID width, const std::function<EdgeWeight(NodeID, NodeID)> &weight)
+{
+    EdgeList edges;
+    NodeID edge_id = 0;
+    const auto add_edge = [&](const NodeID source, const NodeID target, const bool oneway) {
+        edges.push_back({source, target, edge_id++, weight(source, target), true, false});
+        if (!oneway)
+        {
+            edges.push_back({target, source, edge_id++, weight(target, source), true, false});
+        }
+    };
+    for (NodeID row = 0; row < width; ++row)
+    {
+        for (NodeID column = 0; column < width; ++column)
+        {
+            const NodeID node = row * width + column;
+            if (column + 1 < width)
+            {
+                add_edge(node, node + 1, row % 3 == 1);
+            }
+            if (row + 1 < width)
+            {
+                add_edge(node, node + width, false);
+            }
+        }
+    }
+    add_edge(width * width, width * width + 1, false);
+    return edges;
+}
+
+// Dijkstra on the edges that stay inside of the given cell
+std::vector<EdgeWeight> cellDijkstra(const NodeID number_of_nodes,
+                                     const EdgeList &edges,
+                                     const MultiLevelPartition<> &partition,
+                                     const LevelID level,
+                                     const NodeID source)
+{
+    const auto cell = partition.GetCell(level, source);
+    std::vector<std::vector<std::pair<NodeID, EdgeWeight>>> adjacency(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        if (partition.GetCell(level, edge.source) == cell &&
+            partition.GetCell(level, edge.target) == cell)
+        {
+            adjacency[edge.source].emplace_back(edge.target, edge.weight);
+        }
+    }
+
+    std::vector<EdgeWeight> distance(number_of_nodes, INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distance[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto entry = queue.top();
+        queue.pop();
+        if (entry.first > distance[entry.second])
+        {
+            continue;
+        }
+        for (const auto &edge : adjacency[entry.second])
+        {
+            if (entry.first + edge.second < distance[edge.first])
+            {
+                distance[edge.first] = entry.first + edge.second;
+                queue.emplace(distance[edge.first], edge.first);
+            }
+        }
+    }
+    return distance;
+}
+}
+
+BOOST_AUTO_TEST_CASE(partition_test)
+{
+    const NodeID width = 16;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges = makeGrid(width, [](NodeID, NodeID) { return 1; });
+    const auto partition = partitionGraph(number_of_nodes, edges, 4);
+
+    BOOST_CHECK_EQUAL(partition.GetNumberOfNodes(), number_of_nodes);
+    BOOST_CHECK_EQUAL(partition.GetNumberOfLevels(), 2);
+    BOOST_CHECK_EQUAL(partition.GetNumberOfCells(1), 128);
+    BOOST_CHECK_EQUAL(partition.GetNumberOfCells(2), 8);
+
+    std::vector<std::size_t> cell_sizes(partition.GetNumberOfCells(1), 0);
+    for (NodeID node = 0; node < number_of_nodes; ++node)
+    {
+        BOOST_REQUIRE_LT(partition.GetCell(1, node), cell_sizes.size());
+        ++cell_sizes[partition.GetCell(1, node)];
+        // the cells of a level are unions of the cells below
+        BOOST_CHECK_EQUAL(partition.GetCell(2, node), partition.GetCell(1, node) >> 4);
+    }
+    for (const auto size : cell_sizes)
+    {
+        BOOST_CHECK_LE(size, 4);
+    }
+
+    for (NodeID first = 0; first < number_of_nodes; ++first)
+    {
+        for (NodeID second = 0; second < number_of_nodes; second += 7)
+        {
+            const auto level = partition.GetHighestDifferentLevel(first, second);
+            BOOST_CHECK_EQUAL(level, partition.GetHighestDifferentLevel(second, first));
+            if (level < partition.GetNumberOfLevels())
+            {
+                BOOST_CHECK_EQUAL(partition.GetCell(level + 1, first),
+                                  partition.GetCell(level + 1, second));
+            }
+            if (level > 0)
+            {
+                BOOST_CHECK_NE(partition.GetCell(level, first), partition.GetCell(level, second));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cell_storage_test)
+{
+    const NodeID width = 8;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges = makeGrid(width, [](NodeID, NodeID) { return 1; });
+    const auto partition = partitionGraph(number_of_nodes, edges, 4);
+    const auto cells = buildCellStorage(partition, edges);
+
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        std::vector<bool> is_source(number_of_nodes, false);
+        std::vector<bool> is_destination(number_of_nodes, false);
+        for (const auto &edge : edges)
+        {
+            if (partition.GetCell(level, edge.source) != partition.GetCell(level, edge.target))
+            {
+                is_destination[edge.source] = true;
+                is_source[edge.target] = true;
+            }
+        }
+
+        for (NodeID node = 0; node < number_of_nodes; ++node)
+        {
+            const auto cell = cells.GetCell(level, partition.GetCell(level, node));
+            BOOST_CHECK_EQUAL(cell.FindSource(node) < cell.GetNumberOfSources(), is_source[node]);
+            BOOST_CHECK_EQUAL(cell.FindDestination(node) < cell.GetNumberOfDestinations(),
+                              is_destination[node]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(customization_test)
+{
+    const NodeID width = 16;
+    const NodeID number_of_nodes = width * width + 2;
+    const auto edges =
+        makeGrid(width, [](NodeID source, NodeID target) { return 1 + (source * 7 + target) % 5; });
+    const auto partition = partitionGraph(number_of_nodes, edges, 4);
+    auto cells = buildCellStorage(partition, edges);
+    cells.SetWeights(customizeCells(partition, cells, edges));
+
+    for (LevelID level = 1; level <= partition.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = cells.GetCell(level, id);
+            for (std::uint32_t source = 0; source < cell.GetNumberOfSources(); ++source)
+            {
+                const auto distance = cellDijkstra(
+                    number_of_nodes, edges, partition, level, cell.GetSource(source));
+                for (std::uint32_t destination = 0; destination < cell.GetNumberOfDestinations();
+                     ++destination)
+                {
+                    BOOST_CHECK_EQUAL(cell.GetWeight(source, destination),
+                                      distance[cell.GetDestination(destination)]);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
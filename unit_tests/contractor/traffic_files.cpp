@@ -0,0 +1,103 @@
+#include "contractor/traffic_files.hpp"
+#include "util/exception.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(traffic_files)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+const static std::string CSV_TMP_FILE = "test_traffic.csv";
+const static std::string BINARY_TMP_FILE = "test_traffic.bin";
+}
+
+BOOST_AUTO_TEST_CASE(segment_speed_csv_test)
+{
+    // more than a single chunk of lines
+    const std::uint64_t number_of_lines = 1500000;
+    {
+        std::ofstream csv(CSV_TMP_FILE);
+        for (std::uint64_t line = 0; line < number_of_lines; ++line)
+        {
+            csv << line << "," << (line + 1) << "," << (line % 130);
+            if (line % 3 == 0)
+            {
+                csv << ",source,2017";
+            }
+            csv << "\n";
+        }
+    }
+
+    const auto records = readSegmentSpeeds(CSV_TMP_FILE);
+    BOOST_REQUIRE_EQUAL(records.size(), number_of_lines);
+    for (std::uint64_t line = 0; line < number_of_lines; ++line)
+    {
+        BOOST_REQUIRE_EQUAL(records[line].from, line);
+        BOOST_REQUIRE_EQUAL(records[line].to, line + 1);
+        BOOST_REQUIRE_EQUAL(records[line].speed, line % 130);
+    }
+
+    writeSegmentSpeeds(BINARY_TMP_FILE, records);
+    const auto binary_records = readSegmentSpeeds(BINARY_TMP_FILE);
+    BOOST_REQUIRE_EQUAL(binary_records.size(), number_of_lines);
+    for (std::uint64_t line = 0; line < number_of_lines; line += 997)
+    {
+        BOOST_CHECK_EQUAL(binary_records[line].from, records[line].from);
+        BOOST_CHECK_EQUAL(binary_records[line].to, records[line].to);
+        BOOST_CHECK_EQUAL(binary_records[line].speed, records[line].speed);
+    }
+
+    // a binary speed file is no turn penalty file
+    BOOST_CHECK_THROW(readTurnPenalties(BINARY_TMP_FILE), util::exception);
+
+    boost::filesystem::remove(CSV_TMP_FILE);
+    boost::filesystem::remove(BINARY_TMP_FILE);
+}
+
+BOOST_AUTO_TEST_CASE(turn_penalty_csv_test)
+{
+    {
+        std::ofstream csv(CSV_TMP_FILE);
+        csv << "1,2,3,10.5\n4,5,6,-1,comment\n7,8,9,0";
+    }
+
+    const auto records = readTurnPenalties(CSV_TMP_FILE);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_CHECK_EQUAL(records[0].from, 1);
+    BOOST_CHECK_EQUAL(records[0].via, 2);
+    BOOST_CHECK_EQUAL(records[0].to, 3);
+    BOOST_CHECK_EQUAL(records[0].penalty, 10.5);
+    BOOST_CHECK_EQUAL(records[1].penalty, -1);
+    BOOST_CHECK_EQUAL(records[2].to, 9);
+
+    writeTurnPenalties(BINARY_TMP_FILE, records);
+    const auto binary_records = readTurnPenalties(BINARY_TMP_FILE);
+    BOOST_REQUIRE_EQUAL(binary_records.size(), 3);
+    BOOST_CHECK_EQUAL(binary_records[1].from, 4);
+    BOOST_CHECK_EQUAL(binary_records[1].penalty, -1);
+
+    boost::filesystem::remove(CSV_TMP_FILE);
+    boost::filesystem::remove(BINARY_TMP_FILE);
+}
+
+BOOST_AUTO_TEST_CASE(malformed_csv_test)
+{
+    {
+        std::ofstream csv(CSV_TMP_FILE);
+        csv << "1,2,30\n3,x,40\n";
+    }
+    BOOST_CHECK_THROW(readSegmentSpeeds(CSV_TMP_FILE), util::exception);
+    boost::filesystem::remove(CSV_TMP_FILE);
+
+    BOOST_CHECK_THROW(readSegmentSpeeds(CSV_TMP_FILE), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+const constexpr unsigned NUMBER_OF_NODES = 1000000;
+const constexpr std::size_t MIB = 1024 * 1024;
+
+void runQuery(SearchEngineData &engine_working_data, const unsigned inserted_nodes)
+{
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(NUMBER_OF_NODES);
+    auto &heap = *engine_working_data.forward_heap_1;
+    for (unsigned node = 0; node < inserted_nodes; ++node)
+    {
+        heap.Insert(node, node, node);
+    }
+}
+
+// Bytes of forward_heap_1 of this thread as of the last time it was cleared
+std::size_t reportedHeapBytes()
+{
+    std::size_t bytes = 0;
+    for (const auto &thread_usage : SearchEngineData::GetHeapMemoryUsage())
+    {
+        bytes = std::max(bytes, thread_usage[0]);
+    }
+    return bytes;
+}
+}
+
+BOOST_AUTO_TEST_CASE(release_after_recent_queries_got_smaller)
+{
+    SearchEngineData engine_working_data;
+    SearchEngineData::SetMaxHeapSize(0);
+
+    runQuery(engine_working_data, 200000);
+    const auto released_heaps = SearchEngineData::GetNumberOfReleasedHeaps();
+
+    // the next query keeps the memory of the large one
+    runQuery(engine_working_data, 10);
+    const auto large_heap_bytes = reportedHeapBytes();
+    BOOST_CHECK_GT(large_heap_bytes, 4 * MIB);
+    BOOST_CHECK_EQUAL(SearchEngineData::GetNumberOfReleasedHeaps(), released_heaps);
+
+    // the recent usage decays slowly, a few small queries do not release the heap
+    for (int query = 0; query < 10; ++query)
+    {
+        runQuery(engine_working_data, 10);
+    }
+    BOOST_CHECK_EQUAL(SearchEngineData::GetNumberOfReleasedHeaps(), released_heaps);
+    BOOST_CHECK_EQUAL(reportedHeapBytes(), large_heap_bytes);
+
+    // but enough of them do, exactly once
+    for (int query = 0; query < 30; ++query)
+    {
+        runQuery(engine_working_data, 10);
+    }
+    BOOST_CHECK_EQUAL(SearchEngineData::GetNumberOfReleasedHeaps(), released_heaps + 1);
+    BOOST_CHECK_LT(reportedHeapBytes(), MIB);
+}
+
+BOOST_AUTO_TEST_CASE(release_heaps_over_max_heap_size)
+{
+    SearchEngineData engine_working_data;
+    SearchEngineData::SetMaxHeapSize(MIB);
+
+    runQuery(engine_working_data, 100);
+    runQuery(engine_working_data, 100);
+    const auto released_heaps = SearchEngineData::GetNumberOfReleasedHeaps();
+    const auto small_heap_bytes = reportedHeapBytes();
+    BOOST_CHECK_LT(small_heap_bytes, MIB);
+
+    // a heap over the limit is released by the next query, even if it is the same size
+    runQuery(engine_working_data, 100000);
+    runQuery(engine_working_data, 100000);
+    BOOST_CHECK_EQUAL(SearchEngineData::GetNumberOfReleasedHeaps(), released_heaps + 1);
+    BOOST_CHECK_LT(reportedHeapBytes(), MIB);
+
+    runQuery(engine_working_data, 100000);
+    BOOST_CHECK_EQUAL(SearchEngineData::GetNumberOfReleasedHeaps(), released_heaps + 2);
+
+    // without the limit the heap is kept
+    SearchEngineData::SetMaxHeapSize(0);
+    runQuery(engine_working_data, 100000);
+    BOOST_CHECK_EQUAL(SearchEngineData::GetNumberOfReleasedHeaps(), released_heaps + 2);
+    BOOST_CHECK_GT(reportedHeapBytes(), MIB);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
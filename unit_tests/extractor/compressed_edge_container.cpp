@@ -1,9 +1,13 @@
 #include "extractor/compressed_edge_container.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(compressed_edge_container)
 
 using namespace osrm;
@@ -87,4 +91,96 @@ BOOST_AUTO_TEST_CASE(t_crossing)
     BOOST_CHECK_EQUAL(container.GetLastEdgeSourceID(2), 3);
 }
 
+BOOST_AUTO_TEST_CASE(compact_and_zip)
+{
+    //     0   1
+    //   --> --->
+    // 0---1----2
+    //   <-- <---
+    //     3   2
+    CompressedEdgeContainer container;
+
+    // compress 0---1---2 to 0---2 in both directions
+    container.CompressEdge(0, 1, 1, 2, 1, 2);
+    container.CompressEdge(2, 3, 1, 0, 2, 1);
+    container.InitializeBothwayVector();
+    BOOST_CHECK(container.HasEntryForID(0));
+    BOOST_CHECK(!container.HasEntryForID(1));
+    BOOST_CHECK(container.HasEntryForID(2));
+    BOOST_CHECK(!container.HasEntryForID(3));
+    BOOST_CHECK(!container.HasEntryForID(4));
+    BOOST_CHECK_EQUAL(container.GetFirstEdgeTargetID(0), 1);
+    BOOST_CHECK_EQUAL(container.GetLastEdgeSourceID(0), 1);
+    BOOST_CHECK_EQUAL(container.GetLastEdgeTargetID(0), 2);
+
+    const auto forward_bucket = container.GetBucketReference(0);
+    BOOST_REQUIRE_EQUAL(forward_bucket.size(), 2);
+    BOOST_CHECK_EQUAL(forward_bucket[0].node_id, 1);
+    BOOST_CHECK_EQUAL(forward_bucket[0].weight, 1);
+    BOOST_CHECK_EQUAL(forward_bucket[1].node_id, 2);
+    BOOST_CHECK_EQUAL(forward_bucket[1].weight, 2);
+
+    const auto reverse_bucket = container.GetBucketReference(2);
+    BOOST_REQUIRE_EQUAL(reverse_bucket.size(), 2);
+    BOOST_CHECK_EQUAL(reverse_bucket.front().node_id, 1);
+    BOOST_CHECK_EQUAL(reverse_bucket.back().node_id, 0);
+
+    BOOST_CHECK_EQUAL(container.ZipEdges(0, 2), 0);
+    container.ZipAllEdges();
+    BOOST_CHECK(container.HasZippedEntryForForwardID(0));
+    BOOST_CHECK(!container.HasZippedEntryForReverseID(0));
+    BOOST_CHECK(container.HasZippedEntryForReverseID(2));
+    BOOST_CHECK_EQUAL(container.GetZippedPositionForForwardID(0), 0);
+    BOOST_CHECK_EQUAL(container.GetZippedPositionForReverseID(2), 0);
+
+    const std::vector<unsigned> reference_indices = {0};
+    const std::vector<NodeID> reference_nodes = {0, 1, 2};
+    const auto &indices = container.GetZippedGeometryIndices();
+    const auto &nodes = container.GetZippedGeometryNodes();
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        indices.begin(), indices.end(), reference_indices.begin(), reference_indices.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        nodes.begin(), nodes.end(), reference_nodes.begin(), reference_nodes.end());
+
+    // the forward weight at i is the weight of the segment that ends at node i, the reverse weight
+    // at i the one of the segment that starts at node i, in reverse direction
+    const std::vector<EdgeWeight> reference_fwd_weights = {INVALID_EDGE_WEIGHT, 1, 2};
+    const std::vector<EdgeWeight> reference_rev_weights = {1, 2, INVALID_EDGE_WEIGHT};
+
+    const auto geometry_path = boost::filesystem::unique_path().string();
+    container.SerializeInternalVector(geometry_path);
+    boost::filesystem::ifstream geometry_stream(geometry_path, std::ios::binary);
+
+    unsigned number_of_indices = 0;
+    geometry_stream.read((char *)&number_of_indices, sizeof(unsigned));
+    BOOST_REQUIRE_EQUAL(number_of_indices, reference_indices.size() + 1);
+    std::vector<unsigned> read_indices(number_of_indices);
+    geometry_stream.read((char *)read_indices.data(), sizeof(unsigned) * number_of_indices);
+    BOOST_CHECK_EQUAL(read_indices.back(), reference_nodes.size());
+
+    unsigned number_of_nodes = 0;
+    geometry_stream.read((char *)&number_of_nodes, sizeof(unsigned));
+    BOOST_REQUIRE_EQUAL(number_of_nodes, reference_nodes.size());
+    std::vector<NodeID> read_nodes(number_of_nodes);
+    std::vector<EdgeWeight> read_fwd_weights(number_of_nodes);
+    std::vector<EdgeWeight> read_rev_weights(number_of_nodes);
+    geometry_stream.read((char *)read_nodes.data(), sizeof(NodeID) * number_of_nodes);
+    geometry_stream.read((char *)read_fwd_weights.data(), sizeof(EdgeWeight) * number_of_nodes);
+    geometry_stream.read((char *)read_rev_weights.data(), sizeof(EdgeWeight) * number_of_nodes);
+    BOOST_CHECK(geometry_stream);
+    geometry_stream.close();
+    boost::filesystem::remove(geometry_path);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        read_nodes.begin(), read_nodes.end(), reference_nodes.begin(), reference_nodes.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(read_fwd_weights.begin(),
+                                  read_fwd_weights.end(),
+                                  reference_fwd_weights.begin(),
+                                  reference_fwd_weights.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(read_rev_weights.begin(),
+                                  read_rev_weights.end(),
+                                  reference_rev_weights.begin(),
+                                  reference_rev_weights.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#include "extractor/scripting_environment_plugin.hpp"
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/restriction_parser.hpp"
+#include "util/exception.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+
+#include <tbb/concurrent_vector.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The paths of the mock profile libraries (see unit_tests/mocks/mock_profile_plugin.cpp) are
+// set by CMake
+#ifndef OSRM_MOCK_PROFILE_PLUGIN
+#error "OSRM_MOCK_PROFILE_PLUGIN has to be the path of the mock profile library"
+#endif
+
+BOOST_AUTO_TEST_SUITE(scripting_environment_plugin)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+BOOST_AUTO_TEST_CASE(load_plugin)
+{
+    PluginScriptingEnvironment scripting_environment(OSRM_MOCK_PROFILE_PLUGIN);
+
+    const auto &properties = scripting_environment.GetProfileProperties();
+    BOOST_CHECK_EQUAL(properties.GetTrafficSignalPenalty(), 2);
+    BOOST_CHECK_EQUAL(properties.GetUturnPenalty(), 20);
+    BOOST_CHECK(properties.use_turn_restrictions);
+
+    BOOST_CHECK(scripting_environment.GetNameSuffixList() ==
+                (std::vector<std::string>{"north", "south"}));
+    BOOST_CHECK(scripting_environment.GetRestrictions() == std::vector<std::string>{"motorcar"});
+    BOOST_CHECK(scripting_environment.HasPureTurnFunction());
+    BOOST_CHECK_EQUAL(scripting_environment.GetTurnPenalty(-90), 90);
+    BOOST_CHECK_EQUAL(scripting_environment.GetTurnPenalty(45), 45);
+}
+
+BOOST_AUTO_TEST_CASE(process_elements)
+{
+    PluginScriptingEnvironment scripting_environment(OSRM_MOCK_PROFILE_PLUGIN);
+    RestrictionParser restriction_parser(scripting_environment);
+
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer(1024, osmium::memory::Buffer::auto_grow::yes);
+    osmium::builder::add_node(buffer, _id(1), _tag("barrier", "gate"));
+    osmium::builder::add_node(buffer, _id(2));
+    osmium::builder::add_way(buffer,
+                             _id(10),
+                             _nodes({1, 2}),
+                             _tag("highway", "primary"),
+                             _tag("oneway", "yes"),
+                             _tag("name", "Main Street"),
+                             _tag("ref", "B 1"));
+    osmium::builder::add_way(buffer, _id(11), _nodes({1, 2}), _tag("building", "yes"));
+
+    std::vector<osmium::memory::Buffer::const_iterator> osm_elements;
+    for (auto iter = buffer.cbegin(); iter != buffer.cend(); ++iter)
+    {
+        osm_elements.push_back(iter);
+    }
+
+    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
+    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
+    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+    scripting_environment.ProcessElements(osm_elements,
+                                          restriction_parser,
+                                          resulting_nodes,
+                                          resulting_ways,
+                                          resulting_restrictions);
+
+    // the elements are processed in parallel, the first member is the index of the element
+    std::sort(resulting_nodes.begin(), resulting_nodes.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+    std::sort(resulting_ways.begin(), resulting_ways.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    BOOST_REQUIRE_EQUAL(resulting_nodes.size(), 2);
+    BOOST_CHECK(resulting_nodes[0].second.barrier);
+    BOOST_CHECK(!resulting_nodes[1].second.barrier);
+
+    BOOST_REQUIRE_EQUAL(resulting_ways.size(), 2);
+    const auto &way = resulting_ways[0].second;
+    BOOST_CHECK_EQUAL(way.forward_speed, 36);
+    BOOST_CHECK_EQUAL(way.backward_speed, 0);
+    BOOST_CHECK_EQUAL(way.name, "Main Street");
+    BOOST_CHECK_EQUAL(way.ref, "B 1");
+
+    // the way without a highway tag keeps the cleared result
+    const auto &building = resulting_ways[1].second;
+    BOOST_CHECK_EQUAL(building.forward_speed, -1);
+    BOOST_CHECK_EQUAL(building.backward_speed, -1);
+    BOOST_CHECK(building.name.empty());
+
+    BOOST_CHECK(resulting_restrictions.empty());
+}
+
+BOOST_AUTO_TEST_CASE(reject_other_layout)
+{
+    BOOST_CHECK_THROW(PluginScriptingEnvironment(OSRM_MOCK_PROFILE_PLUGIN_WRONG_LAYOUT),
+                      util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(reject_missing_library)
+{
+    BOOST_CHECK_THROW(PluginScriptingEnvironment("over-the-rainbow.so"), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
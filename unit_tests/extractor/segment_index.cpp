@@ -0,0 +1,74 @@
+#include "extractor/segment_index.hpp"
+#include "util/exception.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <iterator>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(segment_index)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+const static std::string TMP_FILE = "test_segment_index.osrm.edge_segment_index";
+}
+
+BOOST_AUTO_TEST_CASE(lookup_test)
+{
+    //   0     1     2
+    // 10----11----12
+    SegmentIndex index;
+    index.geometry_segments = {{OSMNodeID{11}, OSMNodeID{12}, 1, 1},
+                               {OSMNodeID{12}, OSMNodeID{11}, 1, 0},
+                               {OSMNodeID{10}, OSMNodeID{11}, 0, 1},
+                               {OSMNodeID{11}, OSMNodeID{10}, 0, 0},
+                               {OSMNodeID{10}, OSMNodeID{11}, 5, 1}};
+    index.segment_edges = {{OSMNodeID{11}, OSMNodeID{12}, 3},
+                           {OSMNodeID{10}, OSMNodeID{11}, 2},
+                           {OSMNodeID{11}, OSMNodeID{12}, 2}};
+    index.turn_edges = {{OSMNodeID{10}, OSMNodeID{11}, OSMNodeID{12}, 7},
+                        {OSMNodeID{12}, OSMNodeID{11}, OSMNodeID{10}, 4}};
+    index.segment_offsets = {0, 32, 64};
+    index.Sort();
+
+    const auto segments = index.GetGeometrySegments(OSMNodeID{10}, OSMNodeID{11});
+    BOOST_REQUIRE_EQUAL(std::distance(segments.first, segments.second), 2);
+    BOOST_CHECK_EQUAL(segments.first->first_position, 0);
+    BOOST_CHECK_EQUAL(std::next(segments.first)->first_position, 5);
+
+    const auto reverse = index.GetGeometrySegments(OSMNodeID{12}, OSMNodeID{11});
+    BOOST_REQUIRE_EQUAL(std::distance(reverse.first, reverse.second), 1);
+    BOOST_CHECK_EQUAL(reverse.first->forward, 0);
+
+    const auto missing = index.GetGeometrySegments(OSMNodeID{10}, OSMNodeID{12});
+    BOOST_CHECK(missing.first == missing.second);
+
+    const auto edges = index.GetSegmentEdges(OSMNodeID{11}, OSMNodeID{12});
+    BOOST_REQUIRE_EQUAL(std::distance(edges.first, edges.second), 2);
+    BOOST_CHECK_EQUAL(edges.first->edge, 2);
+    BOOST_CHECK_EQUAL(std::next(edges.first)->edge, 3);
+
+    const auto turns = index.GetTurnEdges(OSMNodeID{12}, OSMNodeID{11}, OSMNodeID{10});
+    BOOST_REQUIRE_EQUAL(std::distance(turns.first, turns.second), 1);
+    BOOST_CHECK_EQUAL(turns.first->edge, 4);
+
+    writeSegmentIndex(TMP_FILE, index);
+    const auto read_index = readSegmentIndex(TMP_FILE);
+    BOOST_CHECK_EQUAL(read_index.geometry_segments.size(), 5);
+    BOOST_CHECK_EQUAL(read_index.segment_edges.size(), 3);
+    BOOST_CHECK_EQUAL(read_index.turn_edges.size(), 2);
+    BOOST_CHECK_EQUAL(read_index.segment_offsets.back(), 64);
+    const auto read_edges = read_index.GetSegmentEdges(OSMNodeID{10}, OSMNodeID{11});
+    BOOST_REQUIRE_EQUAL(std::distance(read_edges.first, read_edges.second), 1);
+    BOOST_CHECK_EQUAL(read_edges.first->edge, 2);
+
+    boost::filesystem::remove(TMP_FILE);
+    BOOST_CHECK_THROW(readSegmentIndex(TMP_FILE), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#include "extractor/turn_penalty_table.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(turn_penalty_table)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+// turn_function of turnbot.lua and car.lua
+double linearTurnFunction(const double angle) { return 10 * 20 * std::abs(angle) / 180; }
+
+double sigmoidTurnFunction(const double angle)
+{
+    const double turn_penalty = 7.5;
+    const double turn_bias = 1.075;
+    if (angle >= 0)
+    {
+        return 10 * turn_penalty /
+               (1 + std::pow(2.718, -((13 / turn_bias) * angle / 180 - 6.5 * turn_bias)));
+    }
+    return 10 * turn_penalty /
+           (1 + std::pow(2.718, -((13 * turn_bias) * -angle / 180 - 6.5 / turn_bias)));
+}
+
+std::int32_t toPenalty(const double penalty) { return static_cast<std::int32_t>(penalty); }
+}
+
+BOOST_AUTO_TEST_CASE(empty_test)
+{
+    const TurnPenaltyTable table;
+    BOOST_CHECK(table.Empty());
+}
+
+BOOST_AUTO_TEST_CASE(linear_test)
+{
+    const TurnPenaltyTable table(linearTurnFunction);
+    BOOST_REQUIRE(!table.Empty());
+
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(0), 0);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(90), 100);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(-90), 100);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(180), 200);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(-180), 200);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(45.5), 50);
+
+    const auto result =
+        table.Validate([](const double angle) { return toPenalty(linearTurnFunction(angle)); },
+                       10000);
+    BOOST_CHECK_EQUAL(result.samples, 7201 + 10000);
+    BOOST_CHECK_EQUAL(result.mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(sigmoid_test)
+{
+    const TurnPenaltyTable table(sigmoidTurnFunction);
+
+    const auto result =
+        table.Validate([](const double angle) { return toPenalty(sigmoidTurnFunction(angle)); },
+                       10000);
+    BOOST_CHECK_LE(result.max_difference, 1);
+    BOOST_CHECK_LE(result.mismatches, result.samples / 1000);
+}
+
+BOOST_AUTO_TEST_CASE(validation_test)
+{
+    // a step between two samples is missed by the interpolation
+    const auto step_function = [](const double angle) { return angle > 45.01 ? 100. : 0.; };
+    const TurnPenaltyTable table(step_function);
+
+    const auto result =
+        table.Validate([&](const double angle) { return toPenalty(step_function(angle)); }, 10000);
+    BOOST_CHECK_GT(result.mismatches, 0);
+    BOOST_CHECK_GT(result.max_difference, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
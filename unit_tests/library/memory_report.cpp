@@ -0,0 +1,59 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "args.hpp"
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(memory_report)
+
+BOOST_AUTO_TEST_CASE(test_memory_report)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    // run a query so the heaps of this thread show up in the report
+    const auto locations = get_locations_in_big_component();
+    RouteParameters params;
+    params.coordinates.push_back(locations.at(0));
+    params.coordinates.push_back(locations.at(1));
+    json::Object route_result;
+    BOOST_CHECK(osrm.Route(params, route_result) == Status::Ok);
+
+    json::Object result;
+    const auto rc = osrm.MemoryReport(result);
+    BOOST_CHECK(rc == Status::Ok);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &dataset = result.values.at("dataset").get<json::Object>();
+    const auto dataset_bytes = dataset.values.at("bytes").get<json::Number>().value;
+    const auto resident_bytes = dataset.values.at("resident_bytes").get<json::Number>().value;
+    BOOST_CHECK_GT(dataset_bytes, 0);
+    BOOST_CHECK_LE(resident_bytes, dataset_bytes);
+
+    const auto &blocks = dataset.values.at("blocks").get<json::Array>().values;
+    BOOST_CHECK(!blocks.empty());
+    for (const auto &block : blocks)
+    {
+        const auto &block_object = block.get<json::Object>();
+        BOOST_CHECK(!block_object.values.at("name").get<json::String>().value.empty());
+        BOOST_CHECK_LE(block_object.values.at("resident_bytes").get<json::Number>().value,
+                       block_object.values.at("bytes").get<json::Number>().value);
+    }
+
+    const auto &heaps = result.values.at("heaps").get<json::Object>();
+    const auto &threads = heaps.values.at("threads").get<json::Array>().values;
+    BOOST_CHECK(!threads.empty());
+    BOOST_CHECK_GT(heaps.values.at("bytes").get<json::Number>().value, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -361,4 +361,36 @@ BOOST_AUTO_TEST_CASE(test_route_response_for_locations_across_components)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_route_with_lazy_loaded_guidance_data)
+{
+    const auto args = get_args();
+    auto osrm = getOSRM(args.at(0));
+
+    using namespace osrm;
+
+    // guidance data is not needed for tables and only loaded by the first route request
+    EngineConfig config;
+    config.storage_config = {args.at(0)};
+    config.use_shared_memory = false;
+    config.services = {"table"};
+    OSRM lazy_osrm{config};
+
+    const auto locations = get_locations_in_big_component();
+
+    RouteParameters params;
+    params.steps = true;
+    params.coordinates.push_back(locations.at(0));
+    params.coordinates.push_back(locations.at(1));
+
+    json::Object reference;
+    const auto reference_rc = osrm.Route(params, reference);
+    BOOST_CHECK(reference_rc == Status::Ok);
+
+    json::Object result;
+    const auto rc = lazy_osrm.Route(params, result);
+    BOOST_CHECK(rc == Status::Ok);
+
+    CHECK_EQUAL_JSON(reference, result);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -27,7 +27,11 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     unsigned GetNumberOfEdges() const override { return 0; }
     unsigned GetOutDegree(const NodeID /* n */) const override { return 0; }
     NodeID GetTarget(const EdgeID /* e */) const override { return SPECIAL_NODEID; }
-    const EdgeData &GetEdgeData(const EdgeID /* e */) const override { return foo; }
+    EdgeData GetEdgeData(const EdgeID /* e */) const override { return foo; }
+    EdgeSearchData GetEdgeSearchData(const EdgeID /* e */) const override
+    {
+        return foo.GetSearchData();
+    }
     EdgeID BeginEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     EdgeID EndEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     osrm::engine::datafacade::EdgeRange GetAdjacentEdgeRange(const NodeID /* node */) const override
@@ -204,7 +208,25 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     std::string GetPronunciationForID(const unsigned /* name_id */) const override { return ""; }
     std::string GetDestinationsForID(const unsigned /* name_id */) const override { return ""; }
     std::size_t GetCoreSize() const override { return 0; }
+    contractor::LevelID GetNumberOfLevels() const override { return 0; }
+    contractor::CellID GetCellID(const contractor::LevelID /* level */,
+                                 const NodeID /* node */) const override
+    {
+        return 0;
+    }
+    contractor::LevelID GetHighestDifferentLevel(const NodeID /* first */,
+                                                 const NodeID /* second */) const override
+    {
+        return 0;
+    }
+    contractor::Cell GetCell(const contractor::LevelID /* level */,
+                             const contractor::CellID /* cell */) const override
+    {
+        static const contractor::CellData empty_cell{0, 0, 0, 0};
+        return contractor::Cell{empty_cell, nullptr, nullptr};
+    }
     std::string GetTimestamp() const override { return ""; }
+    std::vector<engine::datafacade::MemoryBlock> GetMemoryBlocks() const override { return {}; }
     bool GetContinueStraightDefault() const override { return true; }
     double GetMapMatchingMaxSpeed() const override { return 180 / 3.6; }
     BearingClassID GetBearingClassID(const NodeID /*id*/) const override { return 0; }
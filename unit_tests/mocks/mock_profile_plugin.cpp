@@ -0,0 +1,73 @@
+// A small compiled profile for the tests of the plugin loader. It is built twice, the library
+// with MOCK_PROFILE_PLUGIN_WRONG_LAYOUT pretends to be built against other headers.
+
+#include "extractor/profile_plugin.hpp"
+
+#include <osmium/osm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace test
+{
+
+class MockProfilePlugin final : public extractor::ProfilePlugin
+{
+  public:
+    extractor::ProfileProperties GetProfileProperties() const override
+    {
+        extractor::ProfileProperties properties;
+        properties.SetTrafficSignalPenalty(2);
+        properties.SetUturnPenalty(20);
+        properties.use_turn_restrictions = true;
+        return properties;
+    }
+
+    std::vector<std::string> GetNameSuffixList() const override { return {"north", "south"}; }
+
+    std::vector<std::string> GetRestrictions() const override { return {"motorcar"}; }
+
+    void ProcessNode(const osmium::Node &node, extractor::ExtractionNode &result) const override
+    {
+        const char *barrier = node.get_value_by_key("barrier", "");
+        result.barrier = std::strcmp(barrier, "") != 0;
+    }
+
+    void ProcessWay(const osmium::Way &way, extractor::ExtractionWay &result) const override
+    {
+        if (way.get_value_by_key("highway") == nullptr)
+        {
+            return;
+        }
+        const bool oneway = std::strcmp(way.get_value_by_key("oneway", ""), "yes") == 0;
+        result.forward_speed = 36;
+        result.backward_speed = oneway ? 0 : 36;
+        result.name = way.get_value_by_key("name", "");
+        result.ref = way.get_value_by_key("ref", "");
+    }
+
+    double GetTurnPenalty(const double angle) const override { return angle < 0 ? -angle : angle; }
+};
+}
+}
+
+#ifdef MOCK_PROFILE_PLUGIN_WRONG_LAYOUT
+extern "C" OSRM_PROFILE_PLUGIN_EXPORT std::uint32_t osrm_profile_plugin_api_version()
+{
+    return osrm::extractor::PROFILE_PLUGIN_API_VERSION;
+}
+extern "C" OSRM_PROFILE_PLUGIN_EXPORT std::uint64_t osrm_profile_plugin_layout()
+{
+    return osrm::extractor::PROFILE_PLUGIN_LAYOUT + 1;
+}
+extern "C" OSRM_PROFILE_PLUGIN_EXPORT osrm::extractor::ProfilePlugin *osrm_create_profile_plugin()
+{
+    return new osrm::test::MockProfilePlugin();
+}
+#else
+OSRM_PROFILE_PLUGIN(osrm::test::MockProfilePlugin)
+#endif
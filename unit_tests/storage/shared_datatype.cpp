@@ -0,0 +1,183 @@
+#include "storage/shared_datatype.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(shared_datatype)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+namespace
+{
+const constexpr std::uint64_t HUGE_PAGE = 2 * 1024 * 1024;
+
+// A small block, a block that spans one and a half huge pages and an empty block
+SharedDataLayout makeLayout(const std::uint64_t large_block_alignment)
+{
+    SharedDataLayout layout;
+    layout.large_block_alignment = large_block_alignment;
+    layout.SetBlockSize<char>(SharedDataLayout::NAME_OFFSETS, 10);
+    layout.SetBlockSize<char>(SharedDataLayout::NAME_BLOCKS, 3 * HUGE_PAGE / 2);
+    return layout;
+}
+}
+
+BOOST_AUTO_TEST_CASE(align_block_offset)
+{
+    const auto packed = makeLayout(0);
+    BOOST_CHECK_EQUAL(packed.AlignBlockOffset(SharedDataLayout::NAME_OFFSETS, 5), 8);
+    BOOST_CHECK_EQUAL(packed.AlignBlockOffset(SharedDataLayout::NAME_BLOCKS, 5), 8);
+    BOOST_CHECK_EQUAL(packed.AlignBlockOffset(SharedDataLayout::NAME_BLOCKS, 8), 8);
+
+    const auto aligned = makeLayout(HUGE_PAGE);
+    // small blocks stay packed
+    BOOST_CHECK_EQUAL(aligned.AlignBlockOffset(SharedDataLayout::NAME_OFFSETS, 5), 8);
+    BOOST_CHECK_EQUAL(aligned.AlignBlockOffset(SharedDataLayout::NAME_CHAR_LIST, 5), 8);
+    // blocks of at least one huge page start on a huge page
+    BOOST_CHECK_EQUAL(aligned.AlignBlockOffset(SharedDataLayout::NAME_BLOCKS, 5), HUGE_PAGE);
+    BOOST_CHECK_EQUAL(aligned.AlignBlockOffset(SharedDataLayout::NAME_BLOCKS, HUGE_PAGE),
+                      HUGE_PAGE);
+    BOOST_CHECK_EQUAL(aligned.AlignBlockOffset(SharedDataLayout::NAME_BLOCKS, HUGE_PAGE + 1),
+                      2 * HUGE_PAGE);
+}
+
+BOOST_AUTO_TEST_CASE(block_offsets_without_alignment)
+{
+    const auto layout = makeLayout(0);
+    const auto canary = sizeof(CANARY);
+
+    BOOST_CHECK_EQUAL(layout.GetBlockSize(SharedDataLayout::NAME_OFFSETS), 12);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_OFFSETS), canary);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_BLOCKS),
+                      canary + 12 + 2 * canary);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_CHAR_LIST),
+                      canary + 12 + 2 * canary + 3 * HUGE_PAGE / 2 + 2 * canary);
+}
+
+BOOST_AUTO_TEST_CASE(block_offsets_with_large_block_alignment)
+{
+    const auto layout = makeLayout(HUGE_PAGE);
+    const auto canary = sizeof(CANARY);
+
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_OFFSETS), canary);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_BLOCKS), HUGE_PAGE);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_CHAR_LIST),
+                      HUGE_PAGE + 3 * HUGE_PAGE / 2 + 2 * canary);
+
+    // the start canary of every block lies between the end canary of the previous one and the
+    // block itself
+    for (int bid = 1; bid < SharedDataLayout::NUM_BLOCKS; ++bid)
+    {
+        const auto previous = static_cast<SharedDataLayout::BlockID>(bid - 1);
+        const auto current = static_cast<SharedDataLayout::BlockID>(bid);
+        BOOST_CHECK_GE(layout.GetBlockOffset(current),
+                       layout.GetBlockOffset(previous) + layout.GetBlockSize(previous) +
+                           2 * canary);
+        if (layout.GetBlockSize(current) >= HUGE_PAGE)
+        {
+            BOOST_CHECK_EQUAL(layout.GetBlockOffset(current) % HUGE_PAGE, 0);
+        }
+    }
+
+    BOOST_CHECK_GE(layout.GetSizeOfLayout(),
+                   layout.GetBlockOffset(SharedDataLayout::NAME_BLOCKS) +
+                       layout.GetBlockSize(SharedDataLayout::NAME_BLOCKS) + canary);
+}
+
+BOOST_AUTO_TEST_CASE(canaries_with_large_block_alignment)
+{
+    auto layout = makeLayout(HUGE_PAGE);
+    std::vector<char> memory(layout.GetSizeOfLayout());
+
+    layout.GetBlockPtr<char, true>(memory.data(), SharedDataLayout::NAME_OFFSETS);
+    layout.GetBlockPtr<char, true>(memory.data(), SharedDataLayout::NAME_BLOCKS);
+    BOOST_CHECK_NO_THROW(
+        layout.GetBlockPtr<char>(memory.data(), SharedDataLayout::NAME_OFFSETS));
+    BOOST_CHECK_NO_THROW(layout.GetBlockPtr<char>(memory.data(), SharedDataLayout::NAME_BLOCKS));
+
+    // the start canary of the aligned block is right in front of the huge page
+    BOOST_CHECK_EQUAL(memory[HUGE_PAGE - sizeof(CANARY)], CANARY[0]);
+    memory[HUGE_PAGE - 1] = 'X';
+    BOOST_CHECK_THROW(layout.GetBlockPtr<char>(memory.data(), SharedDataLayout::NAME_BLOCKS),
+                      util::exception);
+}
+
+namespace
+{
+// Names are evictable, the via nodes stay pinned, all other blocks are empty and pinned
+SharedDataLayout makeTieredLayout()
+{
+    SharedDataLayout layout;
+    layout.SetBlockSize<char>(SharedDataLayout::NAME_OFFSETS, 10);
+    layout.SetBlockSize<char>(SharedDataLayout::NAME_BLOCKS, 8);
+    layout.SetBlockSize<char>(SharedDataLayout::VIA_NODE_LIST, 20);
+    layout.residency[SharedDataLayout::NAME_OFFSETS] = BlockResidency::Mapped;
+    layout.residency[SharedDataLayout::NAME_BLOCKS] = BlockResidency::Mapped;
+    return layout;
+}
+}
+
+BOOST_AUTO_TEST_CASE(tiered_block_offsets)
+{
+    const auto layout = makeTieredLayout();
+    const auto canary = sizeof(CANARY);
+
+    // the offsets of a residency only depend on the blocks of the same residency
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_OFFSETS), canary);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_BLOCKS),
+                      canary + 12 + 2 * canary);
+    // NAME_CHAR_LIST and NAME_ID_LIST are empty pinned blocks in front of the via nodes
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::VIA_NODE_LIST), 5 * canary);
+    BOOST_CHECK_EQUAL(layout.GetBlockOffset(SharedDataLayout::NAME_CHAR_LIST), canary);
+
+    BOOST_CHECK_EQUAL(layout.GetSizeOfLayout(BlockResidency::Mapped),
+                      canary + 12 + 2 * canary + 8 + 2 * canary +
+                          SharedDataLayout::NUM_BLOCKS * 2 * canary);
+    BOOST_CHECK_GE(layout.GetSizeOfLayout(BlockResidency::Pinned),
+                   layout.GetBlockOffset(SharedDataLayout::VIA_NODE_LIST) + 20 + canary);
+    BOOST_CHECK_EQUAL(makeLayout(0).GetSizeOfLayout(BlockResidency::Mapped), 0);
+}
+
+BOOST_AUTO_TEST_CASE(tiered_canaries)
+{
+    auto layout = makeTieredLayout();
+    std::vector<char> pinned_memory(layout.GetSizeOfLayout(BlockResidency::Pinned));
+    std::vector<char> mapped_memory(layout.GetSizeOfLayout(BlockResidency::Mapped));
+
+    // write the canaries and fill every block, no block may overwrite a canary of another one
+    for (int bid = 0; bid < SharedDataLayout::NUM_BLOCKS; ++bid)
+    {
+        const auto block = static_cast<SharedDataLayout::BlockID>(bid);
+        char *ptr = layout.GetBlockPtr<char, true>(
+            pinned_memory.data(), mapped_memory.data(), block);
+        std::fill(ptr, ptr + layout.GetBlockSize(block), 'x');
+    }
+    for (int bid = 0; bid < SharedDataLayout::NUM_BLOCKS; ++bid)
+    {
+        const auto block = static_cast<SharedDataLayout::BlockID>(bid);
+        BOOST_CHECK_NO_THROW(
+            layout.GetBlockPtr<char>(pinned_memory.data(), mapped_memory.data(), block));
+    }
+
+    // the canaries of the names are in the mapped memory
+    const auto names_offset = layout.GetBlockOffset(SharedDataLayout::NAME_OFFSETS);
+    BOOST_CHECK(std::equal(CANARY, CANARY + sizeof(CANARY), mapped_memory.begin()));
+    BOOST_CHECK(std::equal(
+        CANARY, CANARY + sizeof(CANARY), mapped_memory.begin() + names_offset + 12));
+    BOOST_CHECK_EQUAL(mapped_memory[names_offset], 'x');
+
+    mapped_memory[names_offset + 12] = 'X';
+    BOOST_CHECK_THROW(layout.GetBlockPtr<char>(pinned_memory.data(),
+                                               mapped_memory.data(),
+                                               SharedDataLayout::NAME_OFFSETS),
+                      util::exception);
+    BOOST_CHECK_NO_THROW(layout.GetBlockPtr<char>(
+        pinned_memory.data(), mapped_memory.data(), SharedDataLayout::VIA_NODE_LIST));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
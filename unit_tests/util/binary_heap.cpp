@@ -157,4 +157,26 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(memory_usage_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    const auto empty_usage = heap.MemoryUsage();
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    const auto filled_usage = heap.MemoryUsage();
+    BOOST_CHECK_GT(filled_usage, empty_usage);
+    BOOST_CHECK_EQUAL(heap.NumberOfInsertedNodes(), NUM_NODES);
+
+    // the capacity of the inserted nodes is kept for the next query
+    heap.Clear();
+    BOOST_CHECK_GT(heap.MemoryUsage(), empty_usage);
+    BOOST_CHECK_EQUAL(heap.NumberOfInsertedNodes(), 0);
+    BOOST_CHECK_GE(heap.Capacity(), NUM_NODES);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+#include "util/parallel_stable_sort.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(parallel_stable_sort)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+struct Entry
+{
+    std::uint32_t key;
+    std::uint32_t position;
+};
+
+bool operator==(const Entry &lhs, const Entry &rhs)
+{
+    return lhs.key == rhs.key && lhs.position == rhs.position;
+}
+
+std::vector<Entry> makeRandomEntries(const std::size_t size, const std::uint32_t max_key)
+{
+    std::mt19937 generator(23);
+    std::uniform_int_distribution<std::uint32_t> key_distribution(0, max_key);
+
+    std::vector<Entry> entries(size);
+    for (std::uint32_t position = 0; position < size; ++position)
+    {
+        entries[position] = {key_distribution(generator), position};
+    }
+    return entries;
+}
+
+void checkSort(std::vector<Entry> entries)
+{
+    const auto by_key = [](const Entry &lhs, const Entry &rhs) { return lhs.key < rhs.key; };
+
+    auto expected = entries;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    parallelStableSort(entries.begin(), entries.end(), by_key);
+
+    BOOST_CHECK(entries == expected);
+}
+}
+
+BOOST_AUTO_TEST_CASE(small_ranges)
+{
+    checkSort({});
+    checkSort(makeRandomEntries(1, 10));
+    checkSort(makeRandomEntries(1000, 10));
+}
+
+BOOST_AUTO_TEST_CASE(many_duplicates)
+{
+    // the order of equal keys is only preserved if the merges are stable
+    checkSort(makeRandomEntries(1000000, 100));
+    checkSort(makeRandomEntries(1000000, 0));
+}
+
+BOOST_AUTO_TEST_CASE(unique_keys)
+{
+    checkSort(makeRandomEntries(1000003, 1u << 31));
+}
+
+BOOST_AUTO_TEST_CASE(presorted)
+{
+    auto entries = makeRandomEntries(500000, 1000);
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.key > rhs.key;
+    });
+    checkSort(entries);
+    std::reverse(entries.begin(), entries.end());
+    checkSort(entries);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,35 @@
+#include "util/resident_memory.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(resident_memory)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(touched_memory_is_resident)
+{
+    std::vector<char> buffer(1024 * 1024, 1);
+
+    BOOST_CHECK_EQUAL(residentBytes(buffer.data(), buffer.size()), buffer.size());
+    BOOST_CHECK_EQUAL(residentBytes(buffer.data() + 1, 100), 100);
+}
+
+BOOST_AUTO_TEST_CASE(empty_range)
+{
+    std::vector<char> buffer(16);
+
+    BOOST_CHECK_EQUAL(residentBytes(nullptr, 0), 0);
+    BOOST_CHECK_EQUAL(residentBytes(buffer.data(), 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(available_memory)
+{
+#ifdef __linux__
+    BOOST_CHECK_GT(availableMemoryBytes(), 0);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
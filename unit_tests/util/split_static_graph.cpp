@@ -0,0 +1,126 @@
+#include "util/split_static_graph.hpp"
+#include "contractor/query_edge.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(split_static_graph)
+
+using namespace osrm;
+using namespace osrm::util;
+
+using EdgeData = contractor::QueryEdge::EdgeData;
+using TestStaticGraph = StaticGraph<EdgeData>;
+using TestSplitGraph = SplitStaticGraph<EdgeData>;
+
+constexpr unsigned TEST_NUM_NODES = 500;
+constexpr unsigned TEST_NUM_EDGES = 3000;
+constexpr unsigned RANDOM_SEED = 23;
+
+namespace
+{
+std::vector<TestStaticGraph::InputEdge> makeRandomEdges()
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_distribution(0, TEST_NUM_NODES - 1);
+    std::uniform_int_distribution<int> weight_distribution(1, (1 << 29) - 1);
+    std::uniform_int_distribution<unsigned> direction_distribution(0, 2);
+
+    std::vector<TestStaticGraph::InputEdge> edges;
+    for (unsigned i = 0; i < TEST_NUM_EDGES; ++i)
+    {
+        EdgeData data;
+        data.weight = weight_distribution(generator);
+        data.id = i % 2 == 0 ? (1u << 31) - 1 - i : i;
+        data.shortcut = i % 2 == 0;
+        const auto direction = direction_distribution(generator);
+        data.forward = direction != 1;
+        data.backward = direction != 0;
+        edges.emplace_back(node_distribution(generator), node_distribution(generator), data);
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+void checkEqual(const TestStaticGraph &expected, const TestSplitGraph &actual)
+{
+    BOOST_REQUIRE_EQUAL(actual.GetNumberOfNodes(), expected.GetNumberOfNodes());
+    BOOST_REQUIRE_EQUAL(actual.GetNumberOfEdges(), expected.GetNumberOfEdges());
+    for (const auto node : irange(0u, TEST_NUM_NODES))
+    {
+        BOOST_REQUIRE_EQUAL(actual.BeginEdges(node), expected.BeginEdges(node));
+        BOOST_REQUIRE_EQUAL(actual.EndEdges(node), expected.EndEdges(node));
+        for (const auto edge : actual.GetAdjacentEdgeRange(node))
+        {
+            const auto &expected_data = expected.GetEdgeData(edge);
+            const auto &search_data = actual.GetEdgeSearchData(edge);
+            const auto &unpack_data = actual.GetEdgeUnpackData(edge);
+            BOOST_CHECK_EQUAL(actual.GetTarget(edge), expected.GetTarget(edge));
+            BOOST_CHECK_EQUAL(search_data.weight, expected_data.weight);
+            BOOST_CHECK_EQUAL(search_data.forward, expected_data.forward);
+            BOOST_CHECK_EQUAL(search_data.backward, expected_data.backward);
+            BOOST_CHECK_EQUAL(unpack_data.id, expected_data.id);
+            BOOST_CHECK_EQUAL(unpack_data.shortcut, expected_data.shortcut);
+
+            const EdgeData joined_data = actual.GetEdgeData(edge);
+            BOOST_CHECK_EQUAL(joined_data.id, expected_data.id);
+            BOOST_CHECK_EQUAL(joined_data.weight, expected_data.weight);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(split_test)
+{
+    const auto edges = makeRandomEdges();
+    const TestStaticGraph graph(TEST_NUM_NODES, edges);
+    const TestSplitGraph split_graph(TEST_NUM_NODES, edges);
+    checkEqual(graph, split_graph);
+
+    // the searches only read 8 bytes per edge
+    BOOST_CHECK_EQUAL(sizeof(TestSplitGraph::SearchEdgeArrayEntry), 8);
+    BOOST_CHECK_EQUAL(sizeof(TestSplitGraph::UnpackEdgeArrayEntry), 4);
+    BOOST_CHECK_LT(split_graph.GetEdgeArrayMemory().second, graph.GetEdgeArrayMemory().second);
+
+    for (const auto from : irange(0u, 50u))
+    {
+        for (const auto to : irange(0u, TEST_NUM_NODES))
+        {
+            const auto filter = [](const EdgeData &data) { return data.forward; };
+            BOOST_CHECK_EQUAL(split_graph.FindSmallestEdge(from, to, filter),
+                              graph.FindSmallestEdge(from, to, filter));
+            BOOST_CHECK_EQUAL(split_graph.FindEdgeInEitherDirection(from, to),
+                              graph.FindEdgeInEitherDirection(from, to));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(array_test)
+{
+    // the way the graph is loaded from the .hsgr file or shared memory
+    const auto edges = makeRandomEdges();
+    const TestStaticGraph graph(TEST_NUM_NODES, edges);
+
+    ShM<TestSplitGraph::NodeArrayEntry, false>::vector nodes;
+    ShM<TestSplitGraph::SearchEdgeArrayEntry, false>::vector search_edges;
+    ShM<TestSplitGraph::UnpackEdgeArrayEntry, false>::vector unpack_edges;
+    for (const auto node : irange(0u, TEST_NUM_NODES + 1))
+    {
+        nodes.push_back({node < TEST_NUM_NODES ? graph.BeginEdges(node) : TEST_NUM_EDGES});
+    }
+    for (const auto edge : irange(0u, TEST_NUM_EDGES))
+    {
+        search_edges.push_back({graph.GetTarget(edge), graph.GetEdgeData(edge).GetSearchData()});
+        unpack_edges.push_back(graph.GetEdgeData(edge).GetUnpackData());
+    }
+
+    const TestSplitGraph split_graph(nodes, search_edges, unpack_edges);
+    checkEqual(graph, split_graph);
+}
+
+BOOST_AUTO_TEST_SUITE_END()